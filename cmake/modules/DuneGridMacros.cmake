@@ -15,6 +15,24 @@ find_package(Psurface)
 include(AddPsurfaceFlags)
 find_package(AmiraMesh)
 include(AddAmiraMeshFlags)
+# zlib is used for compressed VTK output
+find_package(ZLIB)
+set(HAVE_ZLIB ${ZLIB_FOUND})
+if(ZLIB_FOUND)
+  include_directories(${ZLIB_INCLUDE_DIRS})
+  list(APPEND DUNE_LIBS ${ZLIB_LIBRARIES})
+endif(ZLIB_FOUND)
+# pthreads are used for asynchronous VTK output
+find_package(Threads)
+if(CMAKE_USE_PTHREADS_INIT)
+  set(HAVE_PTHREAD 1)
+  list(APPEND DUNE_LIBS ${CMAKE_THREAD_LIBS_INIT})
+endif(CMAKE_USE_PTHREADS_INIT)
+# OpenMP is used for threaded communication in YaspGrid, compressed VTK output
+# and the Gmsh reader; the flags are only added to the targets that want them
+find_package(OpenMP)
+set(HAVE_OPENMP ${OPENMP_FOUND})
+include(AddOpenMPFlags)
 
 set(DEFAULT_DGF_GRIDDIM 1)
 set(DEFAULT_DGF_WORLDDIM 1)
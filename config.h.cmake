@@ -73,6 +73,15 @@
 /* Do we have UG in at least version 3.9.1-patch10? */
 #define HAVE_UG_PATCH10 ${HAVE_UG_PATCH10}
 
+/* Define to 1 if zlib is found (used for compressed VTK output) */
+#cmakedefine HAVE_ZLIB 1
+
+/* Define to 1 if pthreads are found (used for asynchronous VTK output) */
+#cmakedefine HAVE_PTHREAD 1
+
+/* Define to 1 if the compiler supports OpenMP */
+#cmakedefine HAVE_OPENMP 1
+
 /* Grid type magic for DGF parser */
 @GRID_CONFIG_H_BOTTOM@
 /* end dune-grid */
@@ -15,6 +15,7 @@
 #include <fstream>
 
 #include <dune/grid/alugrid/3d/alu3dgridfactory.hh>
+#include <dune/grid/utility/alltoall.hh>
 
 #if HAVE_ALUGRID
 
@@ -55,6 +56,15 @@ namespace Dune
   }
 
 
+  template< class ALUGrid >
+  alu_inline
+  void ALU3dGridFactory< ALUGrid >::insertDistributedVertex ( const VertexType &pos, const size_t globalId )
+  {
+    insertVertex( pos, globalId );
+    distributed_ = true;
+  }
+
+
   template< class ALUGrid >
   alu_inline
   void ALU3dGridFactory< ALUGrid >
@@ -183,6 +193,7 @@ namespace Dune
 
     correctElementOrientation();
     numFacesInserted_ = boundaryIds_.size();
+    insertProcessBorders( communicator_ );
     if( addMissingBoundaries || ! faceTransformations_.empty() )
       recreateBoundaryIds();
 
@@ -683,6 +694,108 @@ namespace Dune
       reinsertBoundary( faceMap, faceIt, defaultId );
   }
 
+#if ALU3DGRID_PARALLEL
+  template< class ALUGrid >
+  alu_inline
+  void ALU3dGridFactory< ALUGrid >::insertProcessBorders ( MPI_Comm comm )
+  {
+    int distributed = distributed_;
+    MPI_Allreduce( MPI_IN_PLACE, &distributed, 1, MPI_INT, MPI_MAX, comm );
+    if( !distributed )
+      return;
+
+    int size;
+    MPI_Comm_size( comm, &size );
+
+    // find the faces belonging to only one local element
+    typedef typename FaceMap::iterator FaceIterator;
+    FaceMap faceMap;
+    const unsigned int numElements = elements_.size();
+    for( unsigned int n = 0; n < numElements; ++n )
+    {
+      for( unsigned int face = 0; face < numFaces; ++face )
+      {
+        FaceType key;
+        generateFace( elements_[ n ], face, key );
+        std::sort( key.begin(), key.end() );
+
+        const FaceIterator pos = faceMap.find( key );
+        if( pos != faceMap.end() )
+          faceMap.erase( pos );
+        else
+          faceMap.insert( std::make_pair( key, SubEntity( n, face ) ) );
+      }
+    }
+
+    // inserted boundary segments are no process borders
+    typedef typename BoundaryIdMap::iterator BoundaryIterator;
+    const BoundaryIterator bndEnd = boundaryIds_.end();
+    for( BoundaryIterator bndIt = boundaryIds_.begin(); bndIt != bndEnd; ++bndIt )
+    {
+      FaceType key = bndIt->first;
+      std::sort( key.begin(), key.end() );
+      faceMap.erase( key );
+    }
+
+    // send the global vertex ids of the remaining faces to the process
+    // given by the smallest id, which matches the faces of all processes
+    std::vector< std::vector< size_t > > faceIds( size ), receivedIds;
+    std::vector< std::vector< SubEntity > > faces( size );
+    const FaceIterator faceEnd = faceMap.end();
+    for( FaceIterator faceIt = faceMap.begin(); faceIt != faceEnd; ++faceIt )
+    {
+      std::vector< size_t > ids( numFaceCorners );
+      for( unsigned int i = 0; i < numFaceCorners; ++i )
+        ids[ i ] = globalId( faceIt->first[ i ] );
+      std::sort( ids.begin(), ids.end() );
+
+      const int p = ids[ 0 ] % size;
+      faceIds[ p ].insert( faceIds[ p ].end(), ids.begin(), ids.end() );
+      faces[ p ].push_back( faceIt->second );
+    }
+    allToAll( comm, faceIds, receivedIds );
+
+    // a face received from two processes is a process border on both
+    typedef std::pair< std::vector< size_t >, std::pair< int, int > > ReceivedFace;
+    std::vector< ReceivedFace > received;
+    for( int p = 0; p < size; ++p )
+    {
+      for( size_t i = 0; i < receivedIds[ p ].size(); i += numFaceCorners )
+      {
+        std::vector< size_t > ids( receivedIds[ p ].begin() + i, receivedIds[ p ].begin() + i + numFaceCorners );
+        received.push_back( ReceivedFace( ids, std::make_pair( p, int( i / numFaceCorners ) ) ) );
+      }
+    }
+    std::sort( received.begin(), received.end() );
+
+    std::vector< std::vector< int > > shared( size ), sharedFaces;
+    for( size_t i = 0; i < received.size(); )
+    {
+      size_t j = i+1;
+      while( (j < received.size()) && (received[ j ].first == received[ i ].first) )
+        ++j;
+      if( j - i > 2 )
+        DUNE_THROW( GridError, "Face shared by more than two elements." );
+      if( j - i == 2 )
+      {
+        for( size_t k = i; k < j; ++k )
+          shared[ received[ k ].second.first ].push_back( received[ k ].second.second );
+      }
+      i = j;
+    }
+    allToAll( comm, shared, sharedFaces );
+
+    for( int p = 0; p < size; ++p )
+    {
+      for( size_t i = 0; i < sharedFaces[ p ].size(); ++i )
+      {
+        const SubEntity &face = faces[ p ][ sharedFaces[ p ][ i ] ];
+        insertProcessBorder( face.first, face.second );
+      }
+    }
+  }
+#endif // #if ALU3DGRID_PARALLEL
+
 #if COMPILE_ALUGRID_LIB
   template class ALU3dGridFactory< ALUCubeGrid< 3, 3 > >;
   template class ALU3dGridFactory< ALUSimplexGrid< 3, 3 > >;
@@ -137,6 +137,18 @@ namespace Dune
     // for testing parallel GridFactory
     VertexId insertVertex ( const VertexType &pos, const size_t globalId );
 
+    /** \brief insert a vertex of a distributed macro grid
+     *
+     *  If vertices are inserted with this method, each process may insert
+     *  its own part of the macro grid.  The faces shared by the parts are
+     *  found from the global ids of their vertices in createGrid() and marked
+     *  as process borders.  Boundary projections are only used on rank 0.
+     *
+     *  \param[in]  pos       position of the vertex
+     *  \param[in]  globalId  id of the vertex, unique among all processes
+     */
+    virtual void insertDistributedVertex ( const VertexType &pos, const size_t globalId );
+
     /** \brief insert an element into the coarse grid
      *
      *  \note The order of the vertices must coincide with the vertex order in
@@ -277,6 +289,10 @@ namespace Dune
     void searchPeriodicNeighbor ( FaceMap &faceMap, const typename FaceMap::iterator &pos, const int defaultId  );
     void reinsertBoundary ( const FaceMap &faceMap, const typename FaceMap::const_iterator &pos, const int id );
     void recreateBoundaryIds ( const int defaultId = 1 );
+    void insertProcessBorders ( const No_Comm & ) {}
+#if ALU3DGRID_PARALLEL
+    void insertProcessBorders ( MPI_Comm comm );
+#endif // #if ALU3DGRID_PARALLEL
 
     int rank_;
 
@@ -290,6 +306,8 @@ namespace Dune
     unsigned int numFacesInserted_;
     bool realGrid_;
     const bool allowGridGeneration_;
+    // whether vertices were inserted with global ids
+    bool distributed_;
 
     MPICommunicatorType communicator_;
   };
@@ -458,6 +476,7 @@ namespace Dune
       numFacesInserted_ ( 0 ),
       realGrid_( true ),
       allowGridGeneration_( rank_ == 0 ),
+      distributed_( false ),
       communicator_( communicator )
   {}
 
@@ -471,6 +490,7 @@ namespace Dune
       numFacesInserted_ ( 0 ),
       realGrid_( true ),
       allowGridGeneration_( rank_ == 0 ),
+      distributed_( false ),
       communicator_( communicator )
   {}
 
@@ -484,6 +504,7 @@ namespace Dune
       numFacesInserted_ ( 0 ),
       realGrid_( realGrid ),
       allowGridGeneration_( true ),
+      distributed_( false ),
       communicator_( communicator )
   {}
 
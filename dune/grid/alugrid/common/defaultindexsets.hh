@@ -233,6 +233,21 @@ namespace Dune
       return EntitySpec< Entity, cc > :: subIndex( indexContainer( codim ), e, i );
     }
 
+    //! return the indices of all subentities of given codim of an entity,
+    //! the persistent container is looked up only once
+    template< int cc, class OutputIterator >
+    OutputIterator subIndices ( const typename remove_const< GridImp >::type::Traits::template Codim< cc >::Entity &e,
+                                unsigned int codim, OutputIterator out ) const
+    {
+      assert( (codim != 0) || (level_ < 0) || ( level_ == e.level() ) );
+      typedef typename remove_const< GridImp >::type::Traits::template Codim< cc >::Entity Entity;
+      const PersistentContainerType &container = indexContainer( codim );
+      const int n = ReferenceElements< typename GridType::ctype, dim-cc >::general( e.type() ).size( codim-cc );
+      for( int i = 0; i < n; ++i, ++out )
+        *out = EntitySpec< Entity, cc > :: subIndex( container, e, i );
+      return out;
+    }
+
     //! returns true if this set provides an index for given entity
     template<class EntityType>
     bool contains (const EntityType& en) const
@@ -330,6 +345,12 @@ namespace Dune
 
   };
 
+  //! DefaultIndexSet provides a native subIndices method
+  template< class GridImp, class IteratorImp >
+  struct IndexSetHasSubIndices< DefaultIndexSet< GridImp, IteratorImp > >
+  {
+    static const bool v = true;
+  };
 
 } // end namespace Dune
 #endif // #ifndef DUNE_DEFAULTINDEXSETS_HH
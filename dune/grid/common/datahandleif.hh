@@ -152,5 +152,26 @@ namespace Dune
 #undef CHECK_INTERFACE_IMPLEMENTATION
 #undef CHECK_AND_CALL_INTERFACE_IMPLEMENTATION
 
+  /** @brief Traits class telling whether a data handle may be used by several threads at once.
+
+     If v is true, a grid may call gather() or scatter() for different
+     entities concurrently, each thread using its own message buffer.
+     The default is false, specialize it for thread safe data handles.
+
+     \ingroup GICollectiveCommunication
+   */
+  template<class DataHandleImp>
+  struct IsThreadSafeDataHandle
+  {
+    static const bool v = false;
+  };
+
+  //! the interface class has the property of its implementation
+  template<class DataHandleImp, class DataTypeImp>
+  struct IsThreadSafeDataHandle< CommDataHandleIF<DataHandleImp,DataTypeImp> >
+  {
+    static const bool v = IsThreadSafeDataHandle<DataHandleImp>::v;
+  };
+
 } // end namespace Dune
 #endif
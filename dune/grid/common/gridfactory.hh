@@ -101,6 +101,22 @@ namespace Dune
     /** \brief Insert a vertex into the coarse grid */
     virtual void insertVertex(const FieldVector<ctype,dimworld>& pos) = 0;
 
+    /** \brief Insert a vertex of a distributed coarse grid
+        \param pos The position of the vertex
+        \param globalId An id of the vertex which is unique among all processes
+
+        For distributed grid creation each process inserts only its part of
+        the coarse grid.  A vertex shared by several processes is inserted on
+        each of them with the same global id, the grid uses these ids to find
+        the faces between the parts.  Vertices are numbered locally in the
+        order of insertion, as for insertVertex(const FieldVector&).
+     */
+    virtual void insertDistributedVertex(const FieldVector<ctype,dimworld>& pos,
+                                         const std::size_t globalId)
+    {
+      DUNE_THROW(GridError, "This grid does not support distributed grid creation!");
+    }
+
     /** \brief Insert an element into the coarse grid
         \param type The GeometryType of the new element
         \param vertices The vertices of the new element, using the DUNE numbering
@@ -9,6 +9,8 @@
 #include <vector>
 #include <dune/common/exceptions.hh>
 #include <dune/common/forloop.hh>
+#include <dune/common/typetraits.hh>
+#include <dune/geometry/referenceelements.hh>
 #include <dune/grid/common/grid.hh>
 
 
@@ -22,6 +24,20 @@ namespace Dune
 
 #include <dune/common/bartonnackmanifcheck.hh>
 
+  /** \brief Specialize with 'true' for index set implementations that provide
+             their own subIndices method.
+
+      If false (the default), IndexSet::subIndices loops over all subentities
+      and calls subIndex for each of them.
+
+      @ingroup IndexIdSets
+   */
+  template< class IndexSetImp >
+  struct IndexSetHasSubIndices
+  {
+    static const bool v = false;
+  };
+
   /** @brief Index Set %Interface base class.
 
      This class template is used as a base class for all index set implementations.
@@ -174,6 +190,43 @@ namespace Dune
       static const int cc = Entity::codimension;
       return asImp().template subIndex< cc >( e, i, codim );
     }
+
+    /** \brief Map all subentities of a given codimension to their indices.
+     *
+     *  Writes the indices of all subentities of codimension codim of e to out,
+     *  ordered by the subentity number within e. This is equivalent to calling
+     *  subIndex( e, i, codim ) for all i, but implementations may compute all
+     *  indices in one pass (see IndexSetHasSubIndices).
+     *
+     *  \tparam  cc              codimension of the entity
+     *  \tparam  OutputIterator  output iterator accepting IndexType
+     *
+     *  \param[in]  e      reference to codimension cc entity
+     *  \param[in]  codim  codimension of the subentities we're interested in
+     *                     (must satisfy cc <= codim <= dimension)
+     *  \param[in]  out    output iterator receiving the indices
+     *
+     *  \return output iterator pointing past the last index written
+     */
+    template< int cc, class OutputIterator >
+    OutputIterator subIndices ( const typename Traits::template Codim< cc >::Entity &e,
+                                unsigned int codim, OutputIterator out ) const
+    {
+      return subIndices< cc >( e, codim, out, integral_constant< bool, IndexSetHasSubIndices< IndexSetImp >::v >() );
+    }
+
+    /** \brief Map all subentities of a given codimension to their indices.
+     *
+     *  \note This method exists for convenience only.
+     *        It extracts the codimension from the type of the entity, which can
+     *        be guessed by the compiler.
+     */
+    template< class Entity, class OutputIterator >
+    OutputIterator subIndices ( const Entity &e, unsigned int codim, OutputIterator out ) const
+    {
+      static const int cc = Entity::codimension;
+      return subIndices< cc >( e, codim, out );
+    }
     //@}
 
 
@@ -240,6 +293,26 @@ namespace Dune
     //! Forbid the assignment operator
     IndexSet& operator=(const IndexSet&);
 
+    //! subIndices provided by the implementation
+    template< int cc, class OutputIterator >
+    OutputIterator subIndices ( const typename Traits::template Codim< cc >::Entity &e,
+                                unsigned int codim, OutputIterator out, true_type ) const
+    {
+      return asImp().template subIndices< cc >( e, codim, out );
+    }
+
+    //! default subIndices: call subIndex for each subentity
+    template< int cc, class OutputIterator >
+    OutputIterator subIndices ( const typename Traits::template Codim< cc >::Entity &e,
+                                unsigned int codim, OutputIterator out, false_type ) const
+    {
+      typedef typename remove_const< GridImp >::type::ctype ctype;
+      const int n = ReferenceElements< ctype, dimension-cc >::general( e.type() ).size( codim-cc );
+      for( int i = 0; i < n; ++i, ++out )
+        *out = asImp().template subIndex< cc >( e, i, codim );
+      return out;
+    }
+
     //!  Barton-Nackman trick
     IndexSetImp& asImp () {return static_cast<IndexSetImp &> (*this);}
     //!  Barton-Nackman trick
@@ -5,11 +5,13 @@
 #define DUNE_MCMGMAPPER_HH
 
 #include <iostream>
-#include <map>
+#include <vector>
 
 #include <dune/geometry/type.hh>
+#include <dune/geometry/typeindex.hh>
 #include <dune/geometry/referenceelements.hh>
 
+#include "capabilities.hh"
 #include "mapper.hh"
 
 /**
@@ -96,11 +98,26 @@ namespace Dune
    * There are two predefined Layout class templates for the common cases that
    * only elements or only vertices should be mapped: MCMGElementLayout and
    * MCMGVertexLayout.
+   *
+   * The offsets of the geometry types are stored in a dense array indexed by
+   * GlobalGeometryTypeIndex. If the grid has a single cube or simplex geometry
+   * type (see Capabilities::hasSingleGeometryType), all entities of a codimension
+   * share one geometry type and map() reduces to the index plus a constant.
    */
   template <typename GV, template<int> class Layout>
   class MultipleCodimMultipleGeomTypeMapper :
     public Mapper<typename GV::Grid,MultipleCodimMultipleGeomTypeMapper<GV,Layout> >
   {
+    enum { dim = GV::dimension };
+
+    // topology of the grid if it has only one geometry type
+    static const unsigned int topologyId = Capabilities::hasSingleGeometryType<typename GV::Grid>::topologyId;
+
+    // true if all entities of a codimension have the same geometry type,
+    // i.e., the grid consists of cubes only or of simplices only
+    static const bool singleGeometryType = Capabilities::hasSingleGeometryType<typename GV::Grid>::v
+                                           && ((topologyId >> 1) == 0 || (topologyId >> 1) == (((1u << dim) - 1) >> 1));
+
   public:
 
     // the following lines need to be skipped for intel compilers, because they
@@ -144,7 +161,9 @@ namespace Dune
     template<class EntityType>
     int map (const EntityType& e) const
     {
-      return is.index(e) + offset.find(e.type())->second;
+      if (singleGeometryType)
+        return is.index(e) + codimOffset[EntityType::codimension];
+      return is.index(e) + offset[GlobalGeometryTypeIndex::index(e.type())];
     }
 
     /** @brief Map subentity of codim 0 entity to array index.
@@ -156,10 +175,37 @@ namespace Dune
      */
     int map (const typename GV::template Codim<0>::Entity& e, int i, unsigned int codim) const
     {
+      if (singleGeometryType)
+      {
+        assert(codimOffset[codim]>=0);
+        return is.subIndex(e,i,codim) + codimOffset[codim];
+      }
       GeometryType gt=ReferenceElements<double,GV::dimension>::general(e.type()).type(i,codim);
-      std::map<GeometryType,int>::const_iterator it = offset.find(gt);
-      assert(it!=offset.end());
-      return is.subIndex(e,i,codim) + it->second;
+      assert(offset[GlobalGeometryTypeIndex::index(gt)]>=0);
+      return is.subIndex(e,i,codim) + offset[GlobalGeometryTypeIndex::index(gt)];
+    }
+
+    /** @brief Map all subentities of a given codimension of a codim 0 entity to array indices.
+
+       The indices are written in the order of the subentity numbers, i.e. the i-th
+       value written equals map(e,i,codim). The indices are obtained with a single
+       call to IndexSet::subIndices.
+
+       \param e Reference to codim 0 entity.
+       \param codim Codimension of the subentities
+       \param out Output iterator receiving the indices
+       \return Output iterator pointing past the last index written
+     */
+    template<class OutputIterator>
+    OutputIterator mapAll (const typename GV::template Codim<0>::Entity& e, unsigned int codim, OutputIterator out) const
+    {
+      if (singleGeometryType)
+      {
+        assert(codimOffset[codim]>=0);
+        return is.subIndices(e,codim,OffsetIterator<OutputIterator>(out,codimOffset[codim])).base();
+      }
+      const ReferenceElement<double,GV::dimension>& refElement = ReferenceElements<double,GV::dimension>::general(e.type());
+      return is.subIndices(e,codim,OffsetIterator<OutputIterator>(out,offset,refElement,codim)).base();
     }
 
     /** @brief Return total number of entities in the entity set managed by the mapper.
@@ -213,8 +259,11 @@ namespace Dune
     void update ()
     {
       n=0;     // zero data elements
+
+      // mark all geometry types as not contained
+      offset.assign(GlobalGeometryTypeIndex::size(GV::dimension),-1);
       for (int c=0; c<=GV::dimension; c++)
-        offset.clear();         // clear all maps
+        codimOffset[c] = -1;
 
       // Compute offsets for the different geometry types.
       // Note that mapper becomes invalid when the grid is modified.
@@ -222,15 +271,60 @@ namespace Dune
         for (size_t i=0; i<is.geomTypes(c).size(); i++)
           if (layout.contains(is.geomTypes(c)[i]))
           {
-            offset[is.geomTypes(c)[i]] = n;
+            offset[GlobalGeometryTypeIndex::index(is.geomTypes(c)[i])] = n;
+            codimOffset[c] = n;
             n += is.size(is.geomTypes(c)[i]);
           }
     }
 
   private:
+    // output iterator adding the geometry type offset to the indices written through it
+    template<class OutputIterator>
+    class OffsetIterator
+    {
+    public:
+      // constant offset
+      OffsetIterator (OutputIterator out, int offset)
+        : out_(out), offset_(offset), offsets_(0), refElement_(0), codim_(0), i_(0)
+      {}
+
+      // offset depending on the geometry type of the i-th subentity
+      OffsetIterator (OutputIterator out, const std::vector<int>& offsets,
+                      const ReferenceElement<double,GV::dimension>& refElement, unsigned int codim)
+        : out_(out), offset_(0), offsets_(&offsets), refElement_(&refElement), codim_(codim), i_(0)
+      {}
+
+      OffsetIterator& operator* () { return *this; }
+      OffsetIterator& operator++ () { return *this; }
+      OffsetIterator& operator++ (int) { return *this; }
+
+      template<class IndexType>
+      OffsetIterator& operator= (const IndexType& index)
+      {
+        if (offsets_)
+          *out_ = index + (*offsets_)[GlobalGeometryTypeIndex::index(refElement_->type(i_,codim_))];
+        else
+          *out_ = index + offset_;
+        ++out_;
+        ++i_;
+        return *this;
+      }
+
+      OutputIterator base () const { return out_; }
+
+    private:
+      OutputIterator out_;
+      int offset_;
+      const std::vector<int>* offsets_;
+      const ReferenceElement<double,GV::dimension>* refElement_;
+      unsigned int codim_;
+      int i_;
+    };
+
     int n;     // number of data elements required
     const typename GV::IndexSet& is;
-    std::map<GeometryType,int> offset;     // provide a map with all geometry types
+    std::vector<int> offset;     // offset for each geometry type, indexed by GlobalGeometryTypeIndex (-1 if not contained)
+    int codimOffset[GV::dimension+1];     // offset for each codim, only meaningful if singleGeometryType is true
     mutable Layout<GV::dimension> layout;     // get layout object
   };
 
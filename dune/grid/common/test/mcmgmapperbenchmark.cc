@@ -0,0 +1,140 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file
+    \brief A micro benchmark for MultipleCodimMultipleGeomTypeMapper::map
+
+    The mapper is compared with a reference implementation looking up the
+    geometry type offsets in a std::map (which is what the mapper used to do).
+    Both must yield the same indices; the timings are printed.
+ */
+
+#include <config.h>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+
+using namespace Dune;
+
+template<int dim>
+struct MCMGAllLayout
+{
+  bool contains (Dune::GeometryType gt) const { return true; }
+};
+
+// reference mapper with a std::map lookup per call
+template<class GridView>
+class ReferenceMapper
+{
+public:
+  ReferenceMapper (const GridView& gridView)
+    : is(gridView.indexSet())
+  {
+    int n=0;
+    for (int c=0; c<=GridView::dimension; c++)
+      for (size_t i=0; i<is.geomTypes(c).size(); i++)
+      {
+        offset[is.geomTypes(c)[i]] = n;
+        n += is.size(is.geomTypes(c)[i]);
+      }
+  }
+
+  template<class EntityType>
+  int map (const EntityType& e) const
+  {
+    return is.index(e) + offset.find(e.type())->second;
+  }
+
+  int map (const typename GridView::template Codim<0>::Entity& e, int i, unsigned int codim) const
+  {
+    GeometryType gt=ReferenceElements<double,GridView::dimension>::general(e.type()).type(i,codim);
+    return is.subIndex(e,i,codim) + offset.find(gt)->second;
+  }
+
+private:
+  const typename GridView::IndexSet& is;
+  std::map<GeometryType,int> offset;
+};
+
+template<class Mapper, class GridView>
+double benchmark (const Mapper& mapper, const GridView& gridView, int repeat, long& checksum)
+{
+  typedef typename GridView::template Codim<0>::Iterator Iterator;
+  static const int dim = GridView::dimension;
+
+  Timer timer;
+  checksum = 0;
+  for (int r=0; r<repeat; r++)
+    for (Iterator it=gridView.template begin<0>(); it!=gridView.template end<0>(); ++it)
+    {
+      checksum += mapper.map(*it);
+      const int corners = it->template count<dim>();
+      for (int i=0; i<corners; i++)
+        checksum += mapper.map(*it,i,dim);
+    }
+  return timer.elapsed();
+}
+
+template<class Grid>
+void checkGrid (const Grid& grid, int repeat)
+{
+  typedef typename Grid::LeafGridView GridView;
+  typedef LeafMultipleCodimMultipleGeomTypeMapper<Grid,MCMGAllLayout> Mapper;
+
+  const GridView gridView = grid.leafView();
+  Mapper mapper(grid);
+  ReferenceMapper<GridView> reference(gridView);
+
+  long sum, refsum;
+  const double t = benchmark(mapper,gridView,repeat,sum);
+  const double tref = benchmark(reference,gridView,repeat,refsum);
+
+  if (sum!=refsum)
+    DUNE_THROW(GridError, "Mapper indices differ from reference implementation!");
+
+  std::cout << "dim=" << Grid::dimension
+            << " elements=" << gridView.size(0)
+            << " mapper: " << t << "s"
+            << " std::map reference: " << tref << "s"
+            << " speedup: " << (t>0 ? tref/t : 0.0) << std::endl;
+}
+
+int main (int argc, char** argv) try
+{
+  // initialize MPI if neccessary
+  Dune::MPIHelper::instance(argc, argv);
+
+  {
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> s;
+    std::fill(s.begin(), s.end(), 64);
+    YaspGrid<2> grid(L,s);
+    checkGrid(grid,10);
+  }
+
+  {
+    Dune::FieldVector<double,3> L(1.0);
+    Dune::array<int,3> s;
+    std::fill(s.begin(), s.end(), 16);
+    YaspGrid<3> grid(L,s);
+    checkGrid(grid,10);
+  }
+
+  return 0;
+}
+catch (Exception &e) {
+  std::cerr << e << std::endl;
+  return 1;
+} catch (...) {
+  std::cerr << "Generic exception!" << std::endl;
+  return 2;
+}
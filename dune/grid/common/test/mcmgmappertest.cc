@@ -8,7 +8,9 @@
 #include <config.h>
 
 #include <iostream>
+#include <iterator>
 #include <set>
+#include <vector>
 
 #include <dune/grid/uggrid.hh>
 #include "../../../../doc/grids/gridfactory/hybridtestgrids.hh"
@@ -119,6 +121,42 @@ void checkFaceDataMapper(const Mapper& mapper, const IndexSet& indexSet)
 #endif
 }
 
+// /////////////////////////////////////////////////////////////////////////////////
+//   Layout containing all entities of all codimensions
+// /////////////////////////////////////////////////////////////////////////////////
+template<int dim>
+struct MCMGAllLayout
+{
+  bool contains (Dune::GeometryType gt) const { return true; }
+};
+
+// /////////////////////////////////////////////////////////////////////////////////
+//   Check whether mapAll yields the same indices as map for each subentity.
+// /////////////////////////////////////////////////////////////////////////////////
+template <class Mapper, class GridView>
+void checkMapAll(const Mapper& mapper, const GridView& gridView)
+{
+  const int dim = GridView::dimension;
+  typedef typename GridView::template Codim<0>::Iterator Iterator;
+
+  std::vector<int> indices;
+  for (Iterator eIt = gridView.template begin<0>(); eIt!=gridView.template end<0>(); ++eIt)
+  {
+    const ReferenceElement<double,dim>& refElement = ReferenceElements<double,dim>::general(eIt->type());
+    for (int codim=0; codim<=dim; codim++)
+    {
+      indices.clear();
+      mapper.mapAll(*eIt, codim, std::back_inserter(indices));
+      if (int(indices.size()) != refElement.size(codim))
+        DUNE_THROW(GridError, "mapAll yields " << indices.size() << " indices for codim " << codim
+                   << ", but the element has " << refElement.size(codim) << " subentities!");
+      for (int i=0; i<refElement.size(codim); i++)
+        if (indices[i] != mapper.map(*eIt, i, codim))
+          DUNE_THROW(GridError, "mapAll and map differ for subentity " << i << " of codim " << codim << "!");
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //   Run all the checks for a given grid.
 //////////////////////////////////////////////////////////////////////////////
@@ -135,6 +173,11 @@ void checkGrid(const Grid& grid) {
     leafMCMGMapper(grid, MCMGElementLayout<dimg>());
     checkElementDataMapper(leafMCMGMapper, grid.leafView());
   }
+  {   // check mapAll for all codimensions
+    LeafMultipleCodimMultipleGeomTypeMapper<Grid, MCMGAllLayout>
+    leafMCMGMapper(grid);
+    checkMapAll(leafMCMGMapper, grid.leafView());
+  }
 
   for (int i=2; i<=grid.maxLevel(); i++) {
     {     // check constructor without layout class
@@ -147,6 +190,11 @@ void checkGrid(const Grid& grid) {
       levelMCMGMapper(grid, i, MCMGElementLayout<dimg>());
       checkElementDataMapper(levelMCMGMapper, grid.levelView(i));
     }
+    {     // check mapAll for all codimensions
+      LevelMultipleCodimMultipleGeomTypeMapper<Grid, MCMGAllLayout>
+      levelMCMGMapper(grid, i);
+      checkMapAll(levelMCMGMapper, grid.levelView(i));
+    }
   }
 }
 
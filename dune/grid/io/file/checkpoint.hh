@@ -0,0 +1,740 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_GRID_IO_FILE_CHECKPOINT_HH
+#define DUNE_GRID_IO_FILE_CHECKPOINT_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/referenceelements.hh>
+#include <dune/geometry/type.hh>
+
+#include <dune/grid/common/exceptions.hh>
+#include <dune/grid/common/gridfactory.hh>
+
+/** @file
+    @brief Generic binary checkpoint / restart of hierarchic grids
+ */
+
+namespace Dune
+{
+
+  namespace Checkpoint
+  {
+
+    //! first bytes of every checkpoint file
+    static const char magic[ 8 ] = { 'D', 'U', 'N', 'E', 'C', 'K', 'P', 'T' };
+
+    //! version of the file format
+    static const unsigned int version = 1;
+
+    template< class T >
+    inline void writeBinary ( std::ostream &stream, const T *values, std::size_t n )
+    {
+      if( n > 0 )
+        stream.write( reinterpret_cast< const char * >( values ), n*sizeof( T ) );
+    }
+
+    template< class T >
+    inline void writeBinary ( std::ostream &stream, const T &value )
+    {
+      writeBinary( stream, &value, 1 );
+    }
+
+    template< class T >
+    inline void readBinary ( std::istream &stream, T *values, std::size_t n )
+    {
+      if( n > 0 )
+        stream.read( reinterpret_cast< char * >( values ), n*sizeof( T ) );
+      if( !stream )
+        DUNE_THROW( IOError, "Unexpected end of checkpoint." );
+    }
+
+    template< class T >
+    inline void readBinary ( std::istream &stream, T &value )
+    {
+      readBinary( stream, &value, 1 );
+    }
+
+    template< class T >
+    inline void readBinary ( std::istream &stream, std::vector< T > &values, std::size_t n )
+    {
+      values.resize( n );
+      readBinary( stream, (n > 0 ? &values[ 0 ] : 0), n );
+    }
+
+    //! compare two points lexicographically
+    template< class Point >
+    struct PointLess
+    {
+      bool operator() ( const Point &a, const Point &b ) const
+      {
+        return std::lexicographical_compare( a.begin(), a.end(), b.begin(), b.end() );
+      }
+    };
+
+    /** \brief append the lexicographically sorted corners of a subentity to a key
+     *
+     *  The key identifies an element or one of its subentities by its
+     *  geometry alone.  It neither depends on the order in which the grid
+     *  stores the corners nor on the order in which a grid factory inserts
+     *  the elements.
+     */
+    template< class Geometry, class ReferenceElement >
+    inline void appendKey ( const Geometry &geometry, const ReferenceElement &refElement,
+                            int subEntity, int codim, std::vector< double > &key )
+    {
+      typedef typename Geometry::GlobalCoordinate Point;
+      const int dimension = Geometry::mydimension;
+
+      const int corners = refElement.size( subEntity, codim, dimension );
+      std::vector< Point > points( corners );
+      for( int i = 0; i < corners; ++i )
+        points[ i ] = geometry.corner( refElement.subEntity( subEntity, codim, i, dimension ) );
+      std::sort( points.begin(), points.end(), PointLess< Point >() );
+
+      for( int i = 0; i < corners; ++i )
+        key.insert( key.end(), points[ i ].begin(), points[ i ].end() );
+    }
+
+
+
+    // Hierarchy
+    // ---------
+
+    /** \brief elements of a grid hierarchy in an order independent of the grid
+     *
+     *  Level 0 contains all macro elements, level l+1 the children of the
+     *  elements on level l, which are not leaf elements.  On each level, the
+     *  elements are sorted by their corner coordinates, so two grids with
+     *  the same macro grid and the same refinement tree produce the same
+     *  order, no matter how the trees were created.
+     */
+    template< class Grid >
+    class Hierarchy
+    {
+      typedef typename Grid::template Codim< 0 >::Entity Element;
+      typedef typename Grid::template Codim< 0 >::EntityPointer ElementPointer;
+      typedef typename Grid::template Codim< 0 >::EntitySeed ElementSeed;
+
+      typedef std::pair< std::vector< double >, ElementSeed > Entry;
+
+      struct EntryLess
+      {
+        bool operator() ( const Entry &a, const Entry &b ) const { return (a.first < b.first); }
+      };
+
+    public:
+      static const int dimension = Grid::dimension;
+      typedef typename Grid::ctype ctype;
+
+      //! collect the levels 0, ..., maxLevel
+      Hierarchy ( const Grid &grid, int maxLevel )
+        : grid_( grid ),
+          levels_( maxLevel+1 )
+      {
+        std::vector< Entry > entries;
+        typedef typename Grid::template Codim< 0 >::LevelIterator MacroIterator;
+        const MacroIterator end = grid.template lend< 0 >( 0 );
+        for( MacroIterator it = grid.template lbegin< 0 >( 0 ); it != end; ++it )
+          entries.push_back( entry( *it ) );
+        assign( entries, levels_[ 0 ] );
+
+        for( int level = 0; level < maxLevel; ++level )
+        {
+          entries.clear();
+          const std::vector< ElementSeed > &parents = levels_[ level ];
+          for( std::size_t i = 0; i < parents.size(); ++i )
+          {
+            const ElementPointer parent = grid.entityPointer( parents[ i ] );
+            if( parent->isLeaf() )
+              continue;
+
+            typedef typename Element::HierarchicIterator ChildIterator;
+            const ChildIterator cend = parent->hend( level+1 );
+            for( ChildIterator it = parent->hbegin( level+1 ); it != cend; ++it )
+            {
+              if( it->level() == level+1 )
+                entries.push_back( entry( *it ) );
+            }
+          }
+          assign( entries, levels_[ level+1 ] );
+        }
+      }
+
+      int maxLevel () const { return int( levels_.size() ) - 1; }
+
+      //! elements on the given level
+      const std::vector< ElementSeed > &elements ( int level ) const { return levels_[ level ]; }
+
+      //! one bit for each element on the given level, set if it is refined
+      void refined ( int level, std::vector< unsigned char > &bits ) const
+      {
+        const std::vector< ElementSeed > &elements = levels_[ level ];
+        bits.assign( (elements.size() + 7) / 8, 0 );
+        for( std::size_t i = 0; i < elements.size(); ++i )
+        {
+          if( !grid_.entityPointer( elements[ i ] )->isLeaf() )
+            bits[ i / 8 ] |= (1 << (i % 8));
+        }
+      }
+
+      /** \brief enumerate the subentities of the given codimension
+       *
+       *  The subentities are visited in the order of the elements, which
+       *  contain them first; within one element they are sorted by their
+       *  corners.
+       */
+      void subEntities ( int codim, std::vector< std::pair< ElementSeed, int > > &result ) const
+      {
+        typedef typename Grid::LocalIdSet::IdType Id;
+        const typename Grid::LocalIdSet &idSet = grid_.localIdSet();
+
+        std::set< Id > visited;
+        std::vector< std::pair< std::vector< double >, int > > subs;
+        result.clear();
+        for( std::size_t level = 0; level < levels_.size(); ++level )
+        {
+          const std::vector< ElementSeed > &elements = levels_[ level ];
+          for( std::size_t i = 0; i < elements.size(); ++i )
+          {
+            const ElementPointer element = grid_.entityPointer( elements[ i ] );
+            const ReferenceElement< ctype, dimension > &refElement
+              = ReferenceElements< ctype, dimension >::general( element->type() );
+
+            subs.resize( refElement.size( codim ) );
+            for( std::size_t j = 0; j < subs.size(); ++j )
+            {
+              subs[ j ].first.clear();
+              appendKey( element->geometry(), refElement, j, codim, subs[ j ].first );
+              subs[ j ].second = j;
+            }
+            std::sort( subs.begin(), subs.end() );
+
+            for( std::size_t j = 0; j < subs.size(); ++j )
+            {
+              if( visited.insert( idSet.subId( *element, subs[ j ].second, codim ) ).second )
+                result.push_back( std::make_pair( elements[ i ], subs[ j ].second ) );
+            }
+          }
+        }
+      }
+
+    private:
+      static Entry entry ( const Element &element )
+      {
+        Entry entry( std::vector< double >(), element.seed() );
+        const ReferenceElement< ctype, dimension > &refElement
+          = ReferenceElements< ctype, dimension >::general( element.type() );
+        appendKey( element.geometry(), refElement, 0, 0, entry.first );
+        return entry;
+      }
+
+      static void assign ( std::vector< Entry > &entries, std::vector< ElementSeed > &seeds )
+      {
+        std::sort( entries.begin(), entries.end(), EntryLess() );
+        seeds.clear();
+        seeds.reserve( entries.size() );
+        for( std::size_t i = 0; i < entries.size(); ++i )
+          seeds.push_back( entries[ i ].second );
+      }
+
+      const Grid &grid_;
+      std::vector< std::vector< ElementSeed > > levels_;
+    };
+
+  } // namespace Checkpoint
+
+
+
+  // CheckpointWriter
+  // ----------------
+
+  /** \brief write a hierarchic grid and data attached to it into a binary checkpoint
+   *
+   *  In contrast to the BackupRestoreFacility, which has to be implemented
+   *  by each grid, the checkpoint only uses the grid interface, so it works
+   *  for every sequential grid.  It contains
+   *  - the macro grid (vertex coordinates and element connectivity),
+   *  - the refinement tree, one bit for each element of each level
+   *    telling whether the element is refined,
+   *  - optionally, data sets of persistent containers.
+   *  .
+   *  The CheckpointReader restores the grid by creating the macro grid
+   *  through a GridFactory and replaying the refinement level by level,
+   *  which is much cheaper than parsing the original grid file and
+   *  repeating the adaptation that led to the hierarchy.
+   *
+   *  The file is written in the native byte order.  Boundary ids,
+   *  boundary projections and parametrized boundary segments are not
+   *  stored.  Parallel grids are not supported.
+   *
+   *  \tparam  Grid  type of grid
+   */
+  template< class Grid >
+  class CheckpointWriter
+  {
+    typedef Checkpoint::Hierarchy< Grid > Hierarchy;
+
+    typedef typename Grid::template Codim< 0 >::EntityPointer ElementPointer;
+    typedef typename Grid::template Codim< 0 >::EntitySeed ElementSeed;
+
+    struct DataSet
+    {
+      std::string name;
+      unsigned int codim;
+      unsigned int valueSize;
+      std::vector< char > values;
+    };
+
+  public:
+    static const int dimension = Grid::dimension;
+    static const int dimensionworld = Grid::dimensionworld;
+
+    /** \brief prepare a checkpoint of the current state of the grid
+     *
+     *  \throw NotImplemented The grid is distributed over several processes.
+     */
+    explicit CheckpointWriter ( const Grid &grid )
+      : grid_( grid ),
+        hierarchy_( grid, grid.maxLevel() )
+    {
+      if( grid.comm().size() > 1 )
+        DUNE_THROW( NotImplemented, "Checkpoints of parallel grids are not implemented." );
+    }
+
+    /** \brief add the values of a persistent container to the checkpoint
+     *
+     *  The values are copied byte by byte when this method is called, so
+     *  the value type has to be a plain data type (e.g., double or
+     *  FieldVector<double, n>).
+     *
+     *  \param[in]  name       name of the data set, used to read it back
+     *  \param[in]  container  a persistent container for the grid, e.g.,
+     *                         PersistentContainer< Grid, double >
+     */
+    template< class Container >
+    void addData ( const std::string &name, const Container &container )
+    {
+      typedef typename Container::Value Value;
+
+      DataSet dataSet;
+      dataSet.name = name;
+      dataSet.codim = container.codimension();
+      dataSet.valueSize = sizeof( Value );
+
+      std::vector< std::pair< ElementSeed, int > > subEntities;
+      hierarchy_.subEntities( container.codimension(), subEntities );
+      dataSet.values.resize( subEntities.size() * sizeof( Value ) );
+      for( std::size_t i = 0; i < subEntities.size(); ++i )
+      {
+        const ElementPointer element = grid_.entityPointer( subEntities[ i ].first );
+        const Value &value = container( *element, subEntities[ i ].second );
+        std::memcpy( &dataSet.values[ i*sizeof( Value ) ], &value, sizeof( Value ) );
+      }
+      dataSets_.push_back( dataSet );
+    }
+
+    //! write the checkpoint into a binary stream
+    void write ( std::ostream &stream ) const
+    {
+      using Checkpoint::writeBinary;
+
+      writeBinary( stream, Checkpoint::magic, 8 );
+      writeBinary( stream, Checkpoint::version );
+      writeBinary( stream, (unsigned int)dimension );
+      writeBinary( stream, (unsigned int)dimensionworld );
+
+      // macro grid, numbered by the level index set of level 0
+      typedef typename Grid::LevelGridView::IndexSet IndexSet;
+      const IndexSet &indexSet = grid_.levelIndexSet( 0 );
+
+      std::vector< double > coordinates( indexSet.size( dimension ) * dimensionworld );
+      typedef typename Grid::template Codim< dimension >::LevelIterator VertexIterator;
+      const VertexIterator vend = grid_.template lend< dimension >( 0 );
+      for( VertexIterator it = grid_.template lbegin< dimension >( 0 ); it != vend; ++it )
+      {
+        const FieldVector< typename Grid::ctype, dimensionworld > x = it->geometry().corner( 0 );
+        std::copy( x.begin(), x.end(), coordinates.begin() + indexSet.index( *it )*dimensionworld );
+      }
+      writeBinary( stream, (unsigned long long)(coordinates.size() / dimensionworld) );
+      writeBinary( stream, coordinates.empty() ? 0 : &coordinates[ 0 ], coordinates.size() );
+
+      const std::vector< ElementSeed > &macroElements = hierarchy_.elements( 0 );
+      writeBinary( stream, (unsigned long long)macroElements.size() );
+      std::vector< unsigned int > corners;
+      for( std::size_t i = 0; i < macroElements.size(); ++i )
+      {
+        const ElementPointer element = grid_.entityPointer( macroElements[ i ] );
+        corners.resize( element->template count< dimension >() );
+        for( std::size_t j = 0; j < corners.size(); ++j )
+          corners[ j ] = indexSet.subIndex( *element, j, dimension );
+        writeBinary( stream, (unsigned int)element->type().id() );
+        writeBinary( stream, (unsigned int)corners.size() );
+        writeBinary( stream, &corners[ 0 ], corners.size() );
+      }
+
+      // refinement tree
+      writeBinary( stream, (unsigned int)hierarchy_.maxLevel() );
+      std::vector< unsigned char > bits;
+      for( int level = 0; level < hierarchy_.maxLevel(); ++level )
+      {
+        hierarchy_.refined( level, bits );
+        writeBinary( stream, (unsigned long long)hierarchy_.elements( level ).size() );
+        writeBinary( stream, bits.empty() ? 0 : &bits[ 0 ], bits.size() );
+      }
+
+      // data sets
+      writeBinary( stream, (unsigned int)dataSets_.size() );
+      for( std::size_t i = 0; i < dataSets_.size(); ++i )
+      {
+        const DataSet &dataSet = dataSets_[ i ];
+        writeBinary( stream, (unsigned int)dataSet.name.size() );
+        writeBinary( stream, dataSet.name.data(), dataSet.name.size() );
+        writeBinary( stream, dataSet.codim );
+        writeBinary( stream, dataSet.valueSize );
+        writeBinary( stream, (unsigned long long)dataSet.values.size() );
+        writeBinary( stream, dataSet.values.empty() ? 0 : &dataSet.values[ 0 ], dataSet.values.size() );
+      }
+
+      if( !stream )
+        DUNE_THROW( IOError, "Could not write checkpoint." );
+    }
+
+    /** \brief write the checkpoint into a file
+     *
+     *  \throw IOError The file cannot be written.
+     */
+    void write ( const std::string &fileName ) const
+    {
+      std::ofstream stream( fileName.c_str(), std::ios::binary );
+      if( !stream )
+        DUNE_THROW( IOError, "Could not open " << fileName );
+      write( stream );
+    }
+
+  private:
+    const Grid &grid_;
+    Hierarchy hierarchy_;
+    std::vector< DataSet > dataSets_;
+  };
+
+
+
+  // CheckpointReader
+  // ----------------
+
+  /** \brief restore a hierarchic grid from a checkpoint written by CheckpointWriter
+   *
+   *  The grid is restored by createGrid(), which needs a GridFactory for
+   *  the grid, or by refine(), which replays the refinement on a macro
+   *  grid the caller created otherwise (e.g., a YaspGrid constructed with
+   *  the original parameters).  Afterwards, the data sets can be read into
+   *  persistent containers for the restored grid.
+   *
+   *  Macro elements and their children are identified by their corner
+   *  coordinates, so the restored grid need not number its entities as the
+   *  written one did.  The grid has to refine exactly the marked elements;
+   *  otherwise, restoring the grid fails with a GridError.
+   *
+   *  \tparam  Grid  type of grid
+   */
+  template< class Grid >
+  class CheckpointReader
+  {
+    typedef Checkpoint::Hierarchy< Grid > Hierarchy;
+
+    typedef typename Grid::template Codim< 0 >::EntityPointer ElementPointer;
+    typedef typename Grid::template Codim< 0 >::EntitySeed ElementSeed;
+
+    struct DataSet
+    {
+      unsigned int codim;
+      unsigned int valueSize;
+      std::vector< char > values;
+    };
+
+  public:
+    static const int dimension = Grid::dimension;
+    static const int dimensionworld = Grid::dimensionworld;
+
+    /** \brief read a checkpoint from a binary stream
+     *
+     *  \throw IOError The stream does not contain a checkpoint for this
+     *                 kind of grid.
+     */
+    explicit CheckpointReader ( std::istream &stream )
+      : grid_( 0 )
+    {
+      read( stream );
+    }
+
+    /** \brief read a checkpoint from a file
+     *
+     *  \throw IOError The file cannot be opened or does not contain a
+     *                 checkpoint for this kind of grid.
+     */
+    explicit CheckpointReader ( const std::string &fileName )
+      : grid_( 0 )
+    {
+      std::ifstream stream( fileName.c_str(), std::ios::binary );
+      if( !stream )
+        DUNE_THROW( IOError, "Could not open " << fileName );
+      read( stream );
+    }
+
+    /** \brief create the grid through a GridFactory and restore its hierarchy
+     *
+     *  The caller takes ownership of the returned grid.
+     */
+    Grid *createGrid ()
+    {
+      GridFactory< Grid > factory;
+      for( std::size_t i = 0; i < vertices_.size(); i += dimensionworld )
+      {
+        FieldVector< typename Grid::ctype, dimensionworld > x;
+        std::copy( vertices_.begin() + i, vertices_.begin() + i + dimensionworld, x.begin() );
+        factory.insertVertex( x );
+      }
+      std::vector< unsigned int > corners;
+      for( std::size_t i = 0; i < types_.size(); ++i )
+      {
+        corners.assign( corners_.begin() + offsets_[ i ], corners_.begin() + offsets_[ i+1 ] );
+        factory.insertElement( GeometryType( types_[ i ], dimension ), corners );
+      }
+
+      Grid *grid = factory.createGrid();
+      try
+      {
+        refine( *grid );
+      }
+      catch( ... )
+      {
+        delete grid;
+        throw;
+      }
+      return grid;
+    }
+
+    /** \brief restore the hierarchy on a macro grid created by the caller
+     *
+     *  The grid has to consist of the macro elements stored in the
+     *  checkpoint and must not be refined yet.
+     *
+     *  \throw GridError The macro grid does not match the checkpoint or the
+     *                   refinement could not be replayed.
+     */
+    void refine ( Grid &grid )
+    {
+      if( grid.comm().size() > 1 )
+        DUNE_THROW( NotImplemented, "Checkpoints of parallel grids are not implemented." );
+      if( grid.maxLevel() != 0 )
+        DUNE_THROW( GridError, "Checkpoint can only be restored on a macro grid." );
+      if( std::size_t( grid.size( 0, 0 ) ) != types_.size() )
+        DUNE_THROW( GridError, "Macro grid has " << grid.size( 0, 0 ) << " elements, but the checkpoint "
+                                                 << types_.size() << "." );
+
+      const int maxLevel = refined_.size();
+      for( int level = 0; level < maxLevel; ++level )
+      {
+        // element lists might not survive the adaptation, so collect them anew
+        const Hierarchy hierarchy( grid, level );
+        const std::vector< ElementSeed > &elements = hierarchy.elements( level );
+        if( elements.size() != counts_[ level ] )
+          DUNE_THROW( GridError, "Level " << level << " has " << elements.size()
+                                          << " elements, but the checkpoint " << counts_[ level ] << "." );
+
+        const std::vector< unsigned char > &bits = refined_[ level ];
+        std::size_t marks = 0;
+        for( std::size_t i = 0; i < elements.size(); ++i )
+        {
+          if( (bits[ i / 8 ] & (1 << (i % 8))) && grid.entityPointer( elements[ i ] )->isLeaf() )
+            ++marks;
+        }
+
+        if( marks == std::size_t( grid.size( 0 ) ) )
+        {
+          // uniform refinement, also works for grids that can only refine globally
+          grid.globalRefine( 1 );
+          continue;
+        }
+
+        for( std::size_t i = 0; i < elements.size(); ++i )
+        {
+          if( !(bits[ i / 8 ] & (1 << (i % 8))) )
+            continue;
+          const ElementPointer element = grid.entityPointer( elements[ i ] );
+          if( element->isLeaf() && !grid.mark( 1, *element ) )
+            DUNE_THROW( GridError, "Grid refused to mark an element for refinement." );
+        }
+        grid.preAdapt();
+        grid.adapt();
+        grid.postAdapt();
+      }
+
+      // make sure the grid did not refine more than requested
+      const Hierarchy hierarchy( grid, grid.maxLevel() );
+      if( hierarchy.maxLevel() != maxLevel )
+        DUNE_THROW( GridError, "Restored grid has " << hierarchy.maxLevel()
+                                                    << " levels, but the checkpoint " << maxLevel << "." );
+      std::vector< unsigned char > bits;
+      for( int level = 0; level < maxLevel; ++level )
+      {
+        hierarchy.refined( level, bits );
+        if( bits != refined_[ level ] )
+          DUNE_THROW( GridError, "Refinement of level " << level << " could not be restored." );
+      }
+
+      grid_ = &grid;
+    }
+
+    //! whether the checkpoint contains a data set of the given name
+    bool hasData ( const std::string &name ) const
+    {
+      return (dataSets_.find( name ) != dataSets_.end());
+    }
+
+    /** \brief copy a data set into a persistent container
+     *
+     *  The container has to belong to the grid restored by createGrid() or
+     *  refine() and have the codimension and value type of the container
+     *  the data set was written from.
+     *
+     *  \throw IOError The data set does not exist or does not match the
+     *                 container.
+     */
+    template< class Container >
+    void getData ( const std::string &name, Container &container ) const
+    {
+      typedef typename Container::Value Value;
+
+      if( !grid_ )
+        DUNE_THROW( InvalidStateException, "Grid has to be restored before reading data." );
+      const typename std::map< std::string, DataSet >::const_iterator pos = dataSets_.find( name );
+      if( pos == dataSets_.end() )
+        DUNE_THROW( IOError, "Checkpoint contains no data set '" << name << "'." );
+      const DataSet &dataSet = pos->second;
+      if( dataSet.codim != (unsigned int)container.codimension() )
+        DUNE_THROW( IOError, "Data set '" << name << "' has codimension " << dataSet.codim
+                                          << ", but the container " << container.codimension() << "." );
+      if( dataSet.valueSize != sizeof( Value ) )
+        DUNE_THROW( IOError, "Data set '" << name << "' has values of " << dataSet.valueSize
+                                          << " bytes, but the container of " << sizeof( Value ) << " bytes." );
+
+      std::vector< std::pair< ElementSeed, int > > subEntities;
+      Hierarchy( *grid_, grid_->maxLevel() ).subEntities( dataSet.codim, subEntities );
+      if( subEntities.size()*sizeof( Value ) != dataSet.values.size() )
+        DUNE_THROW( IOError, "Data set '" << name << "' does not match the grid." );
+      for( std::size_t i = 0; i < subEntities.size(); ++i )
+      {
+        const ElementPointer element = grid_->entityPointer( subEntities[ i ].first );
+        Value &value = container( *element, subEntities[ i ].second );
+        std::memcpy( &value, &dataSet.values[ i*sizeof( Value ) ], sizeof( Value ) );
+      }
+    }
+
+  private:
+    void read ( std::istream &stream )
+    {
+      using Checkpoint::readBinary;
+
+      char magic[ 8 ];
+      stream.read( magic, 8 );
+      if( !stream || !std::equal( magic, magic+8, Checkpoint::magic ) )
+        DUNE_THROW( IOError, "Stream does not contain a checkpoint." );
+      unsigned int version, dim, dimworld;
+      readBinary( stream, version );
+      if( version != Checkpoint::version )
+        DUNE_THROW( IOError, "Checkpoint has version " << version << ", expected " << Checkpoint::version << "." );
+      readBinary( stream, dim );
+      readBinary( stream, dimworld );
+      if( (dim != (unsigned int)dimension) || (dimworld != (unsigned int)dimensionworld) )
+        DUNE_THROW( IOError, "Checkpoint is for a grid of dimension " << dim << " in "
+                                                                      << dimworld << "d, not " << dimension << " in " << dimensionworld << "d." );
+
+      // macro grid
+      unsigned long long numVertices, numElements;
+      readBinary( stream, numVertices );
+      readBinary( stream, vertices_, numVertices*dimensionworld );
+
+      readBinary( stream, numElements );
+      types_.resize( numElements );
+      offsets_.assign( 1, 0 );
+      offsets_.reserve( numElements+1 );
+      for( std::size_t i = 0; i < types_.size(); ++i )
+      {
+        unsigned int numCorners;
+        readBinary( stream, types_[ i ] );
+        readBinary( stream, numCorners );
+        if( numCorners == 0 )
+          DUNE_THROW( IOError, "Element " << i << " has no corners." );
+        corners_.resize( offsets_.back() + numCorners );
+        readBinary( stream, &corners_[ offsets_.back() ], numCorners );
+        for( std::size_t j = offsets_.back(); j < corners_.size(); ++j )
+        {
+          if( corners_[ j ] >= numVertices )
+            DUNE_THROW( IOError, "Element " << i << " refers to nonexisting vertex " << corners_[ j ] << "." );
+        }
+        offsets_.push_back( corners_.size() );
+      }
+
+      // refinement tree
+      unsigned int maxLevel;
+      readBinary( stream, maxLevel );
+      refined_.resize( maxLevel );
+      counts_.resize( maxLevel );
+      for( unsigned int level = 0; level < maxLevel; ++level )
+      {
+        unsigned long long count;
+        readBinary( stream, count );
+        counts_[ level ] = count;
+        readBinary( stream, refined_[ level ], (count + 7) / 8 );
+      }
+
+      // data sets
+      unsigned int numDataSets;
+      readBinary( stream, numDataSets );
+      for( unsigned int i = 0; i < numDataSets; ++i )
+      {
+        unsigned int length;
+        readBinary( stream, length );
+        std::vector< char > name;
+        readBinary( stream, name, length );
+
+        DataSet &dataSet = dataSets_[ std::string( name.begin(), name.end() ) ];
+        readBinary( stream, dataSet.codim );
+        readBinary( stream, dataSet.valueSize );
+        unsigned long long size;
+        readBinary( stream, size );
+        readBinary( stream, dataSet.values, size );
+      }
+    }
+
+    std::vector< double > vertices_;
+    std::vector< unsigned int > types_;
+    std::vector< std::size_t > offsets_;
+    std::vector< unsigned int > corners_;
+
+    std::vector< std::vector< unsigned char > > refined_;
+    std::vector< std::size_t > counts_;
+
+    std::map< std::string, DataSet > dataSets_;
+
+    Grid *grid_;
+  };
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_GRID_IO_FILE_CHECKPOINT_HH
@@ -2,6 +2,16 @@
 // vi: set et ts=4 sw=2 sts=2:
 #include <config.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <clocale>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
 #include <dune/grid/io/file/dgfparser/blocks/basic.hh>
 
 namespace Dune
@@ -18,7 +28,8 @@ namespace Dune
         active(false),
         empty(true),
         identifier(id),
-        linecount(0)
+        linecount(0),
+        next_(0), lineBegin_(0), lineEnd_(0), entry_(0)
     {
       makeupcase( identifier );
       in.clear();
@@ -41,15 +52,19 @@ namespace Dune
     // with a # symbol.
     void BasicBlock :: getblock ( std :: istream &in )
     {
+      static const char *blanks = " \t\n\v\f\r";
+
       linecount = 0;
+      block_.clear();
+      std :: string line;
       while( in.good() )
       {
-        std :: string line;
         getline( in, line );
 
-        std :: istringstream linestream( line );
-        std :: string id;
-        linestream >> id;
+        const std::size_t begin = line.find_first_not_of( blanks );
+        if( begin == std::string::npos )
+          continue;
+        std :: string id( line, begin, line.find_first_of( blanks, begin ) - begin );
 
         makeupcase( id );
         if( id == identifier )
@@ -61,41 +76,170 @@ namespace Dune
       active = true;
       while( in.good() )
       {
-        std :: string line;
         getline( in, line );
 
         // strip comments
-        if( !line.empty() )
-        {
-          std::size_t comment = line.find( '%' );
-          if( comment != std::string::npos )
-            line.erase( comment );
-        }
+        std::size_t comment = line.find( '%' );
+        if( comment != std::string::npos )
+          line.erase( comment );
         if( line.empty() )
           continue;
 
-        std :: istringstream linestream( line );
-        char test = 0;
-        linestream >> test;
-        if( test == '#' )
+        const std::size_t first = line.find_first_not_of( blanks );
+        if( (first != std::string::npos) && (line[ first ] == '#') )
           return;
 
         ++linecount;
-        block << line << std :: endl;
+        block_ += line;
+        block_ += '\n';
       }
       DUNE_THROW( DGFException,
                   "Error reading from stream, expected \"#\" to end the block." );
     }
 
 
-    // get next line and store in string stream
+    // get next line in the block
     bool BasicBlock :: getnextline ()
     {
-      getline( block, oneline );
-      line.clear();
-      line.str( oneline );
       ++pos;
-      return !oneline.empty();
+      if( next_ >= block_.size() )
+      {
+        next_ = lineBegin_ = lineEnd_ = entry_ = block_.size();
+        return false;
+      }
+      lineBegin_ = entry_ = next_;
+      lineEnd_ = block_.find( '\n', next_ );
+      if( lineEnd_ == std::string::npos )
+        lineEnd_ = block_.size();
+      next_ = lineEnd_ + 1;
+      return (lineEnd_ > lineBegin_);
+    }
+
+
+    const char *BasicBlock :: skipblanks ()
+    {
+      while( (entry_ < lineEnd_) && std::isspace( static_cast< unsigned char >( block_[ entry_ ] ) ) )
+        ++entry_;
+      return (entry_ < lineEnd_ ? block_.c_str() + entry_ : 0);
+    }
+
+
+    static bool isDigit ( const char *p, const char *end )
+    {
+      return (p < end) && std::isdigit( static_cast< unsigned char >( *p ) );
+    }
+
+    bool BasicBlock :: getnextentry ( double &entry )
+    {
+      const char *begin = skipblanks();
+      if( !begin )
+        return fail();
+
+      // scan a number in the syntax of the "C" locale; like operator>>, do not
+      // accept inf, nan or hexadecimal numbers
+      const char *const lineEnd = block_.c_str() + lineEnd_;
+      const char *end = begin + ((*begin == '+') || (*begin == '-') ? 1 : 0);
+      const char *const mantissa = end;
+      while( isDigit( end, lineEnd ) )
+        ++end;
+      const char *point = 0;
+      if( (end < lineEnd) && (*end == '.') )
+      {
+        point = end++;
+        while( isDigit( end, lineEnd ) )
+          ++end;
+      }
+      if( end - mantissa == (point ? 1 : 0) )
+        return fail();
+      if( (end < lineEnd) && ((*end == 'e') || (*end == 'E')) )
+      {
+        const char *exponent = end + 1;
+        if( (exponent < lineEnd) && ((*exponent == '+') || (*exponent == '-')) )
+          ++exponent;
+        if( isDigit( exponent, lineEnd ) )
+        {
+          end = exponent;
+          while( isDigit( end, lineEnd ) )
+            ++end;
+        }
+      }
+
+      // strtod expects the decimal point of the current C locale, so the
+      // number is copied with the '.' replaced
+      const char *decimalPoint = std::localeconv()->decimal_point;
+      const std::size_t pointLength = std::strlen( decimalPoint );
+      char buffer[ 64 ];
+      std::string longNumber;
+      char *number = buffer;
+      if( std::size_t( end - begin ) + pointLength >= sizeof( buffer ) )
+      {
+        longNumber.resize( (end - begin) + pointLength + 1 );
+        number = &longNumber[ 0 ];
+      }
+      char *numberEnd = number;
+      if( point )
+      {
+        numberEnd = std::copy( begin, point, numberEnd );
+        numberEnd = std::copy( decimalPoint, decimalPoint + pointLength, numberEnd );
+        numberEnd = std::copy( point+1, end, numberEnd );
+      }
+      else
+        numberEnd = std::copy( begin, end, numberEnd );
+      *numberEnd = '\0';
+
+      char *stop;
+      errno = 0;
+      const double value = std::strtod( number, &stop );
+      // underflow is accepted, the denormalized value is returned
+      if( (stop != numberEnd) || ((errno == ERANGE) && (std::abs( value ) == HUGE_VAL)) )
+        return fail();
+      entry = value;
+      entry_ += end - begin;
+      return true;
+    }
+
+
+    bool BasicBlock :: getnextentry ( int &entry )
+    {
+      const char *begin = skipblanks();
+      if( !begin )
+        return fail();
+      char *end;
+      errno = 0;
+      const long value = std::strtol( begin, &end, 10 );
+      if( (end == begin) || (errno == ERANGE) || (value < INT_MIN) || (value > INT_MAX) )
+        return fail();
+      entry = int( value );
+      entry_ += end - begin;
+      return true;
+    }
+
+
+    bool BasicBlock :: getnextentry ( unsigned int &entry )
+    {
+      const char *begin = skipblanks();
+      if( !begin )
+        return fail();
+      char *end;
+      errno = 0;
+      const unsigned long value = std::strtoul( begin, &end, 10 );
+      if( (end == begin) || (errno == ERANGE) || (value > UINT_MAX) )
+        return fail();
+      entry = static_cast< unsigned int >( value );
+      entry_ += end - begin;
+      return true;
+    }
+
+
+    bool BasicBlock :: getnextentry ( std :: string &entry )
+    {
+      if( !skipblanks() )
+        return fail();
+      const std::size_t begin = entry_;
+      while( (entry_ < lineEnd_) && !std::isspace( static_cast< unsigned char >( block_[ entry_ ] ) ) )
+        ++entry_;
+      entry.assign( block_, begin, entry_ - begin );
+      return true;
     }
 
 
@@ -106,11 +250,11 @@ namespace Dune
       while( getnextline() )
       {
         std :: string ltoken;
-        line >> ltoken;
+        getnextentry( ltoken );
         makeupcase( ltoken );
         if( ltoken == token )
         {
-          getline( line, entry );
+          entry.assign( block_, entry_, lineEnd_ - entry_ );
           return true;
         }
       }
@@ -125,7 +269,7 @@ namespace Dune
       while( getnextline() )
       {
         std :: string ltoken;
-        line >> ltoken;
+        getnextentry( ltoken );
         makeupcase( ltoken );
         if( ltoken == token )
           return true;
@@ -4,6 +4,7 @@
 #define DUNE_DGF_BASICBLOCK_HH
 
 #include <cassert>
+#include <cstddef>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -31,36 +32,74 @@ namespace Dune
       bool empty;                // block was found but was empty
       std::string identifier;    // identifier of this block
       int linecount;             // total number of lines in the block
-      std::stringstream block;   // the block itself
-      std::string oneline;       // the active line in the block
+      std::string block_;        // the lines of the block, separated by '\n'
+      std::size_t next_;         // beginning of the next line in block_
+      std::size_t lineBegin_;    // beginning of the active line in block_
+      std::size_t lineEnd_;      // end of the active line in block_
+      std::size_t entry_;        // read position within the active line
 
       // get the block (if it exists)
       void getblock ( std::istream &in );
 
-      // count the number of lines in the block
-      // int countlines ();
+      // skip blanks in the active line, return 0 if the line is exhausted
+      const char *skipblanks ();
 
-    protected:
-      std::stringstream line; // the active line as string buffer
-                              // for use in the derived classes
+      // mark the active line as exhausted (like a failed stream)
+      bool fail ()
+      {
+        entry_ = lineEnd_;
+        return false;
+      }
 
+    protected:
       // go back to beginning of block
       void reset ()
       {
         pos = -1;
-        block.clear();
-        block.seekg( 0 );
+        next_ = lineBegin_ = lineEnd_ = entry_ = 0;
       }
 
-      // get next line and store in string stream
+      // get next line in the block
       bool getnextline ();
 
+      // the active line, e.g., for error messages
+      std::string currentline () const
+      {
+        return block_.substr( lineBegin_, lineEnd_ - lineBegin_ );
+      }
+
       // get next entry in line
       template< class ENTRY >
       bool getnextentry( ENTRY &entry )
       {
-        line >> entry;
-        return static_cast< bool >( line );
+        std::istringstream in( block_.substr( entry_, lineEnd_ - entry_ ) );
+        in >> entry;
+        if( !in )
+          return fail();
+        entry_ = (in.eof() ? lineEnd_ : entry_ + std::size_t( in.tellg() ));
+        return true;
+      }
+
+      // the common entries are parsed directly from the block
+      bool getnextentry ( double &entry );
+      bool getnextentry ( int &entry );
+      bool getnextentry ( unsigned int &entry );
+      bool getnextentry ( std::string &entry );
+
+      // character access for blocks with their own tokenizer,
+      // both return std::char_traits< char >::eof() at the end of the line
+      int peek () const
+      {
+        typedef std::char_traits< char > Traits;
+        return (entry_ < lineEnd_ ? Traits::to_int_type( block_[ entry_ ] ) : Traits::eof());
+      }
+
+      int get ()
+      {
+        const int c = peek();
+        if( entry_ < lineEnd_ )
+          ++entry_;
+        return c;
       }
 
       bool gettokenparam ( std :: string token, std :: string &entry );
@@ -41,12 +41,12 @@ namespace Dune
           }
 
           // check for parameter
-          std::string currentline = line.str();
-          std::size_t delimiter = currentline.find( DGFBoundaryParameter::delimiter );
+          std::string thisline = currentline();
+          std::size_t delimiter = thisline.find( DGFBoundaryParameter::delimiter );
           if( delimiter != std::string::npos )
           {
             parameter =
-              DGFBoundaryParameter::convert( currentline.substr( delimiter+1, std::string::npos ) );
+              DGFBoundaryParameter::convert( thisline.substr( delimiter+1, std::string::npos ) );
           }
 
           // create default domain data
@@ -79,12 +79,12 @@ namespace Dune
           }
 
           // check for parameter
-          std::string currentline = line.str();
-          std::size_t delimiter = currentline.find( DGFBoundaryParameter::delimiter );
+          std::string thisline = currentline();
+          std::size_t delimiter = thisline.find( DGFBoundaryParameter::delimiter );
           if( delimiter != std::string::npos )
           {
             parameter =
-              DGFBoundaryParameter::convert( currentline.substr( delimiter+1, std::string::npos ) );
+              DGFBoundaryParameter::convert( thisline.substr( delimiter+1, std::string::npos ) );
           }
 
           DomainData data( id, parameter );
@@ -109,7 +109,7 @@ namespace Dune
                                        << right.at(n-dimworld_)
                                        << " read but expected value larger or equal to "
                                        << left.at(n-dimworld_)
-                                       << std::endl << "Line was: '" << line.str() << "'");
+                                       << std::endl << "Line was: '" << currentline() << "'");
               }
             }
             n++;
@@ -121,7 +121,7 @@ namespace Dune
                        "ERROR in " << *this
                                    << "      wrong number of coordinates: "
                                    << n << " read but expected 2*" << dimworld_
-                                   << std::endl << "Line was: '" << line.str() << "'");
+                                   << std::endl << "Line was: '" << currentline() << "'");
           }
 
           Domain domain( left, right, data );
@@ -130,12 +130,12 @@ namespace Dune
       parameter = DGFBoundaryParameter::defaultValue();
 
       // get active line
-      std::string currentline = line.str();
-      if( !currentline.empty() )
+      std::string thisline = currentline();
+      if( !thisline.empty() )
       {
         // find delimiter and split line
-        std::size_t delimiter = currentline.find( DGFBoundaryParameter::delimiter );
-        std::string left = currentline.substr( 0, delimiter );
+        std::size_t delimiter = thisline.find( DGFBoundaryParameter::delimiter );
+        std::string left = thisline.substr( 0, delimiter );
 
         // read boundary id and boundary vertices from left hand side
         {
@@ -159,7 +159,7 @@ namespace Dune
         // read parameter from right hand side
         if( delimiter != std::string::npos )
         {
-          std::string strParam = currentline.substr( delimiter+1, std::string::npos );
+          std::string strParam = thisline.substr( delimiter+1, std::string::npos );
           parameter = DGFBoundaryParameter::convert( strParam );
         }
 
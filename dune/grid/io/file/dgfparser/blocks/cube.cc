@@ -98,7 +98,7 @@ namespace Dune
     }
 
 
-    int CubeBlock :: get ( std :: vector< std :: vector< unsigned int> > &cubes,
+    int CubeBlock :: get ( FlatArray< unsigned int > &cubes,
                            std :: vector< std :: vector< double > > &params,
                            int &nofp )
     {
@@ -107,14 +107,11 @@ namespace Dune
 
       std :: vector< unsigned int > cube( 1 << dimgrid );
       std :: vector< double > param( nofparams );
+      cubes.reserve( nofsimplex(), cube.size() );
       int nofcubes = 0;
       for( ; next( cube, param ); ++nofcubes )
       {
         cubes.push_back( cube );
-        /*
-           for( size_t j = 0; j < cube.size(); ++j )
-           cubes[ nofcubes ][ j ] = cubes[ j ];
-         */
         if( nofparams > 0 )
           params.push_back( param );
       }
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <vector>
 
+#include <dune/grid/io/file/dgfparser/flatarray.hh>
 #include <dune/grid/io/file/dgfparser/blocks/basic.hh>
 
 
@@ -29,7 +30,7 @@ namespace Dune
     public:
       CubeBlock ( std :: istream &in, int pnofvtx, int pvtxoffset, int &pdimgrid );
 
-      int get ( std :: vector< std :: vector< unsigned int> > &simplex,
+      int get ( FlatArray< unsigned int > &simplex,
                 std :: vector< std :: vector< double > > &params,
                 int &nofp );
 
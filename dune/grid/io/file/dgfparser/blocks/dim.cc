@@ -20,8 +20,7 @@ namespace Dune
                    "no dimension of world specified!");
       } else {
         getnextline();
-        line >> _dim;
-        if (_dim<1) {
+        if (!getnextentry(_dim) || (_dim<1)) {
           DUNE_THROW(DGFException,
                      "negative dimension of world specified!");
         }
@@ -30,8 +29,7 @@ namespace Dune
             _dimworld=_dim;
           else {
             getnextline();
-            line >> _dimworld;
-            if (_dimworld < _dim) {
+            if (!getnextentry(_dimworld) || (_dimworld < _dim)) {
               DUNE_THROW(DGFException,
                          "negative dimension of world smaller than dim!");
             }
@@ -97,7 +97,7 @@ namespace Dune
     }
 
 
-    int GeneralBlock :: get ( std :: vector< std :: vector< unsigned int> > &elements,
+    int GeneralBlock :: get ( FlatArray< unsigned int > &elements,
                               std :: vector< std :: vector< double > > &params,
                               int &nofp )
     {
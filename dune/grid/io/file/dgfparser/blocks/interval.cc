@@ -35,17 +35,16 @@ namespace Dune
     }
 
 
-    int IntervalBlock::getVtx ( int block, std::vector< std::vector< double > > &vtx ) const
+    int IntervalBlock::getVtx ( int block, FlatArray< double > &vtx ) const
     {
       dverb << "reading vertices for interval " << block << "... ";
 
       const Interval &interval = get( block );
 
       size_t old_size = vtx.size();
-      vtx.resize( old_size + nofvtx( block ) );
-      for( size_t i = old_size; i < vtx.size(); ++i )
-        vtx[ i ].resize( dimw() );
+      vtx.reserve( nofvtx( block ), dimw() );
 
+      std::vector< double > x( dimw() );
       size_t m = old_size;
       std::vector< int > i( dimw() );
       const int end = dimw()-1;
@@ -56,10 +55,10 @@ namespace Dune
         for( ; k > 0; --k )
           i[ k-1 ] = 0;
 
-        assert( m < vtx.size() );
         for( int j = 0; j < dimw(); ++j ) {
-          vtx[ m ][ j ] = interval.p[ 0 ][ j ] + double(i[ j ])*interval.h[ j ];
+          x[ j ] = interval.p[ 0 ][ j ] + double(i[ j ])*interval.h[ j ];
         }
+        vtx.push_back( x );
         ++m;
 
         // increase i[ k ] and go up for all finished loops
@@ -72,7 +71,7 @@ namespace Dune
     }
 
 
-    int IntervalBlock::getHexa ( int block, std::vector< std::vector< unsigned int > > &cubes, int offset ) const
+    int IntervalBlock::getHexa ( int block, FlatArray< unsigned int > &cubes, int offset ) const
     {
       dverb << "generating cubes for interval " << block << "... ";
 
@@ -81,10 +80,9 @@ namespace Dune
       const int verticesPerCube = 1 << dimw();
 
       size_t old_size = cubes.size();
-      cubes.resize( old_size + nofhexa( block ) );
-      for( size_t i = old_size; i < cubes.size(); ++i )
-        cubes[ i ].resize( verticesPerCube );
+      cubes.reserve( nofhexa( block ), verticesPerCube );
 
+      std::vector< unsigned int > cube( verticesPerCube );
       size_t m = old_size;
       std::vector< int > i( dimw() );
       const int end = dimw()-1;
@@ -95,17 +93,17 @@ namespace Dune
         for( ; k > 0; --k )
           i[ k-1 ] = 0;
 
-        assert( m < cubes.size() );
         for( int j = 0; j < verticesPerCube; ++j )
         {
-          cubes[ m ][ j ] = offset;
+          cube[ j ] = offset;
           int factor = 1;
           for( int d = 0; d < dimw(); ++d )
           {
-            cubes[ m ][ j ] += factor*(i[ d ] + ((j >> d) & 1));
+            cube[ j ] += factor*(i[ d ] + ((j >> d) & 1));
             factor *= interval.n[ d ]+1;
           }
         }
+        cubes.push_back( cube );
         ++m;
 
         // increase i[ k ] and go up for all finished loops
@@ -8,6 +8,7 @@
 
 #include <dune/common/array.hh>
 
+#include <dune/grid/io/file/dgfparser/flatarray.hh>
 #include <dune/grid/io/file/dgfparser/blocks/basic.hh>
 
 
@@ -35,8 +36,8 @@ namespace Dune
     public:
       explicit IntervalBlock ( std::istream &in );
 
-      void get ( std::vector< std::vector< double > > &vtx, int &nofvtx,
-                 std::vector< std::vector< unsigned int > > &simplex, int &nofsimpl )
+      void get ( FlatArray< double > &vtx, int &nofvtx,
+                 FlatArray< unsigned int > &simplex, int &nofsimpl )
       {
         for( size_t i = 0; i < intervals_.size(); ++i )
         {
@@ -46,7 +47,7 @@ namespace Dune
         }
       }
 
-      void get ( std::vector< std::vector< double > > &vtx, int &nofvtx )
+      void get ( FlatArray< double > &vtx, int &nofvtx )
       {
         for( size_t i = 0; i < intervals_.size(); ++i )
           nofvtx += getVtx( i, vtx );
@@ -67,8 +68,8 @@ namespace Dune
         return dimw_;
       }
 
-      int getVtx ( int block, std::vector< std::vector< double > > &vtx ) const;
-      int getHexa ( int block, std::vector< std::vector< unsigned int > > &cubes,
+      int getVtx ( int block, FlatArray< double > &vtx ) const;
+      int getHexa ( int block, FlatArray< unsigned int > &cubes,
                     int offset = 0 ) const;
 
       int nofvtx ( int block ) const
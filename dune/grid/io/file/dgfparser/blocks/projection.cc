@@ -447,7 +447,7 @@ namespace Dune
     {
       while( getnextline() )
       {
-        //std::cout << "Projection line:" << line.str() << std::endl;
+        //std::cout << "Projection line:" << currentline() << std::endl;
         nextToken();
 
         if( token.type == Token::functionKeyword )
@@ -733,8 +733,8 @@ namespace Dune
       int c;
 
       // eat white space
-      while( ((c = line.peek()) == ' ') || (c == '\t') || (c == '\r') )
-        line.get();
+      while( ((c = peek()) == ' ') || (c == '\t') || (c == '\r') )
+        get();
 
       // parse string literals
       if( ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) )
@@ -743,8 +743,8 @@ namespace Dune
         token.literal = "";
         while( ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) )
         {
-          token.literal += lowerCase( line.get() );
-          c = line.peek();
+          token.literal += lowerCase( get() );
+          c = peek();
         }
 
         if( token.literal == "default" )
@@ -770,53 +770,53 @@ namespace Dune
         while( (c >= '0') && (c <= '9') )
         {
           token.value = 10*token.value + double( c - '0' );
-          token.literal += char( line.get() );
-          c = line.peek();
+          token.literal += char( get() );
+          c = peek();
         }
         if( c == '.' )
         {
-          token.literal += line.get();
-          c = line.peek();
+          token.literal += get();
+          c = peek();
           double factor = 0.1;
           while( (c >= '0') && (c <= '9') )
           {
             token.value += factor * double( c - '0' );
-            token.literal += line.get();
+            token.literal += get();
             factor *= 0.1;
-            c = line.peek();
+            c = peek();
           }
         }
       }
       // parse single character tokens
       else if( c == ',' )
-        token.setSymbol( Token::comma, line.get() );
+        token.setSymbol( Token::comma, get() );
       else if( c == '=' )
-        token.setSymbol( Token::equals, line.get() );
+        token.setSymbol( Token::equals, get() );
       else if( c == '(' )
-        token.setSymbol( Token::openingParen, line.get() );
+        token.setSymbol( Token::openingParen, get() );
       else if( c == ')' )
-        token.setSymbol( Token::closingParen, line.get() );
+        token.setSymbol( Token::closingParen, get() );
       else if( c == '[' )
-        token.setSymbol( Token::openingBracket, line.get() );
+        token.setSymbol( Token::openingBracket, get() );
       else if( c == ']' )
-        token.setSymbol( Token::closingBracket, line.get() );
+        token.setSymbol( Token::closingBracket, get() );
       else if( c == '|' )
-        token.setSymbol( Token::normDelim, line.get() );
+        token.setSymbol( Token::normDelim, get() );
       else if( (c == '+') || (c == '-') )
-        token.setSymbol( Token::additiveOperator, line.get() );
+        token.setSymbol( Token::additiveOperator, get() );
       else if( c == '*' )
       {
-        c = line.get();
-        if( (line.peek() == '*') )
+        c = get();
+        if( (peek() == '*') )
         {
           token.type = Token::powerOperator;
-          line.get();
+          get();
         }
         else
           token.setSymbol( Token::multiplicativeOperator, c );
       }
       else if( c == '/' )
-        token.setSymbol( Token::multiplicativeOperator, line.get() );
+        token.setSymbol( Token::multiplicativeOperator, get() );
       // parse end of line
       else if( c == std::stringstream::traits_type::eof() )
         token.type = Token::endOfLine;
@@ -116,8 +116,6 @@ namespace Dune
       typedef std::map< std::string, const Expression * > FunctionMap;
       typedef std::pair< std::vector< unsigned int >, const Expression * > BoundaryFunction;
 
-      using BasicBlock::line;
-
       Token token;
       FunctionMap functions_;
       const Expression *defaultFunction_;
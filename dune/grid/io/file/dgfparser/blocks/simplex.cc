@@ -64,7 +64,7 @@ namespace Dune
 
 
     int SimplexBlock
-    :: get ( std :: vector< std :: vector< unsigned int > > &simplices,
+    :: get ( FlatArray< unsigned int > &simplices,
              std :: vector< std :: vector< double > > &params,
              int &nofp)
     {
@@ -73,14 +73,11 @@ namespace Dune
 
       std :: vector< unsigned int > simplex( dimgrid+1 );
       std :: vector< double > param( nofparams );
+      simplices.reserve( nofsimplex(), simplex.size() );
       int nofsimpl = 0;
       for( ; next( simplex, param ); ++nofsimpl )
       {
         simplices.push_back( simplex );
-        /*
-           for( size_t j = 0; j < simplex.size(); ++j )
-           simplices[ nofsimpl ][ j ] = simplex[ j ];
-         */
         if( nofparams > 0 )
           params.push_back( param );
       }
@@ -141,8 +138,8 @@ namespace Dune
 
 
     int SimplexBlock
-    :: cube2simplex ( std :: vector< std :: vector< double > > &vtx,
-                      std :: vector< std :: vector< unsigned int > > &elements,
+    :: cube2simplex ( const FlatArray< double > &vtx,
+                      FlatArray< unsigned int > &elements,
                       std :: vector< std :: vector< double > > &params )
     {
       static int offset3[6][4][3] = {{{0,0,0},{1,1,1},{1,0,0},{1,1,0}},
@@ -160,7 +157,7 @@ namespace Dune
 
       int dimgrid = 0;
       for( size_t n = elements[ 0 ].size(); n > 1; ++dimgrid, n /= 2 ) ;
-      if( size_t( 1 << dimgrid ) != elements[ 0 ].size() )
+      if( !elements.uniform() || (size_t( 1 << dimgrid ) != elements[ 0 ].size()) )
         DUNE_THROW( DGFException, "cube2simplex: all elements must be cubes." );
 
       dverb << "generating simplices...";
@@ -169,41 +166,40 @@ namespace Dune
       if( dimgrid == 1 )
         return elements.size();
 
-      std::vector< std::vector< unsigned int > > cubes;
+      FlatArray< unsigned int > cubes;
       std::vector< std::vector< double > > cubeparams;
       elements.swap( cubes );
       params.swap( cubeparams );
 
+      unsigned int simplex[ 4 ];
       if( dimgrid == 3 )
       {
-        elements.resize( 6*cubes.size() );
+        elements.reserve( 6*cubes.size(), 4 );
         if( cubeparams.size() > 0 )
-          params.resize( 6*cubes.size() );
-        for( size_t countsimpl = 0; countsimpl < elements.size(); ++countsimpl )
-          elements[ countsimpl ].resize( 4 );
+          params.reserve( 6*cubes.size() );
         for( size_t c = 0; c < cubes.size(); ++c )
         {
           for( int tetra = 0; tetra < 6; ++tetra )
           {
             for( int v = 0; v < 4; ++v )
             {
-              elements[ c*6+tetra ][ v ]
+              simplex[ v ]
                 = cubes[ c ][ offset3[ tetra ][ v ][ 0 ] +2*offset3[ tetra ][ v ][ 1 ] +4*offset3[ tetra ][ v ][ 2 ] ];
             }
+            elements.push_back( simplex, simplex+4 );
             if( cubeparams.size() > 0 )
-              params[ c*6+tetra ] = cubeparams[ c ];
+              params.push_back( cubeparams[ c ] );
           }
         }
       }
       else if( dimgrid == 2 )
       {
-        elements.resize( 2*cubes.size() );
+        elements.reserve( 2*cubes.size(), 3 );
         if( cubeparams.size() > 0 )
-          params.resize( 2*cubes.size() );
-        for( size_t countsimpl = 0; countsimpl < elements.size(); ++countsimpl )
-          elements[ countsimpl ].resize( 3 );
+          params.reserve( 2*cubes.size() );
         for( size_t c = 0; c < cubes.size(); ++c )
         {
+          FlatArray< unsigned int >::Row cube = cubes[ c ];
           int diag = 0;
           double mind = 0;
           for( int d = 0; d < 2; ++d )
@@ -212,7 +208,7 @@ namespace Dune
             double diaglen = 0;
             for( int i = 0; i < dimworld; ++i )
             {
-              const double dist = vtx[ cubes[ c ][ d ] ][ i ] - vtx[ cubes[ c ][ 3-d ] ][ i ];
+              const double dist = vtx[ cube[ d ] ][ i ] - vtx[ cube[ 3-d ] ][ i ];
               diaglen += dist*dist;
             }
             if( diaglen < mind )
@@ -223,22 +219,20 @@ namespace Dune
           }
           if( diag == 0 )
           {
-            int tmp0 = cubes[ c ][ 0 ];
-            cubes[ c ][ 0 ] = cubes[ c ][ 1 ];
-            cubes[ c ][ 1 ] = cubes[ c ][ 3 ];
-            cubes[ c ][ 3 ] = cubes[ c ][ 2 ];
-            cubes[ c ][ 2 ] = tmp0;
+            int tmp0 = cube[ 0 ];
+            cube[ 0 ] = cube[ 1 ];
+            cube[ 1 ] = cube[ 3 ];
+            cube[ 3 ] = cube[ 2 ];
+            cube[ 2 ] = tmp0;
           }
 
           for( int triangle = 0; triangle < 2; ++triangle )
           {
             for( int v = 0; v < 3; ++v )
-            {
-              elements[ c*2+triangle ][ v ]
-                = cubes[ c ][ offset2[ triangle ][ v ][ 0 ] + 2*offset2[ triangle ][ v ][ 1 ] ];
-            }
+              simplex[ v ] = cube[ offset2[ triangle ][ v ][ 0 ] + 2*offset2[ triangle ][ v ][ 1 ] ];
+            elements.push_back( simplex, simplex+3 );
             if( cubeparams.size() > 0 )
-              params[ c*2+triangle ] = cubeparams[ c ];
+              params.push_back( cubeparams[ c ] );
           }
         }
       }
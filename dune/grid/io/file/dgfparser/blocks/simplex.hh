@@ -6,6 +6,7 @@
 #include <iostream>
 #include <vector>
 
+#include <dune/grid/io/file/dgfparser/flatarray.hh>
 #include <dune/grid/io/file/dgfparser/blocks/basic.hh>
 
 namespace Dune
@@ -28,14 +29,14 @@ namespace Dune
     public:
       SimplexBlock ( std :: istream &in, int pnofvtx, int pvtxoffset, int &pdimgrid );
 
-      int get ( std :: vector< std :: vector< unsigned int > > &simplex,
+      int get ( FlatArray< unsigned int > &simplex,
                 std :: vector< std :: vector< double > > &params,
                 int &nofp );
 
       // cubes -> simplex
       static int
-      cube2simplex ( std :: vector< std :: vector< double > > &vtx,
-                     std :: vector< std :: vector< unsigned int > > &elements,
+      cube2simplex ( const FlatArray< double > &vtx,
+                     FlatArray< unsigned int > &elements,
                      std :: vector< std :: vector< double > > &params );
 
       // some information
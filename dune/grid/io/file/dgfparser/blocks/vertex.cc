@@ -58,7 +58,7 @@ namespace Dune
     }
 
 
-    int VertexBlock :: get ( std :: vector< std :: vector< double > > &points,
+    int VertexBlock :: get ( FlatArray< double > &points,
                              std :: vector< std :: vector< double > > &params,
                              int &nofp )
     {
@@ -67,6 +67,7 @@ namespace Dune
 
       std::vector< double > point( dimworld );
       std::vector< double > param( nofParam );
+      points.reserve( noflines(), dimworld );
       while( next( point, param ) )
       {
         points.push_back( point );
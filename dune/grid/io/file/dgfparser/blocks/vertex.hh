@@ -6,6 +6,7 @@
 #include <iostream>
 #include <vector>
 
+#include <dune/grid/io/file/dgfparser/flatarray.hh>
 #include <dune/grid/io/file/dgfparser/blocks/basic.hh>
 
 namespace Dune
@@ -27,7 +28,7 @@ namespace Dune
       // initialize vertex block
       VertexBlock ( std :: istream &in, int &pdimworld );
 
-      int get ( std :: vector< std :: vector< double > > &vtx,
+      int get ( FlatArray< double > &vtx,
                 std :: vector< std :: vector< double > > &param,
                 int &nofp );
 
@@ -100,9 +100,11 @@ namespace Dune
                                 GeometryType::cube, dimworld );
 
       const int nFaces = (eltype == simplex) ? dimworld+1 : 2*dimworld;
+      std::vector< unsigned int > element;
       for( int n = 0; n < dgf_.nofelements; ++n )
       {
-        factory_.insertElement( elementType, dgf_.elements[ n ] );
+        element.assign( dgf_.elements[ n ].begin(), dgf_.elements[ n ].end() );
+        factory_.insertElement( elementType, element );
         for( int face = 0; face <nFaces; ++face )
         {
           typedef DuneGridFormatParser::facemap_t::key_type Key;
@@ -244,9 +246,11 @@ namespace Dune
                                 GeometryType::cube, dimgrid );
 
       const int nFaces = (eltype == simplex) ? dimgrid+1 : 2*dimgrid;
+      std::vector< unsigned int > element;
       for( int n = 0; n < dgf_.nofelements; ++n )
       {
-        factory_.insertElement( elementType, dgf_.elements[ n ] );
+        element.assign( dgf_.elements[ n ].begin(), dgf_.elements[ n ].end() );
+        factory_.insertElement( elementType, element );
         for( int face = 0; face <nFaces; ++face )
         {
           typedef typename DuneGridFormatParser::facemap_t::key_type Key;
@@ -21,17 +21,6 @@
 #include "dgfparser.hh"
 
 
-namespace
-{
-  // helper method used below
-  double getfirst ( std::vector< double > v )
-  {
-    return v[ 0 ];
-  }
-}  // end anonymous namespace
-
-
-
 namespace Dune
 {
 
@@ -173,7 +162,7 @@ namespace Dune
     if( !( vertexBlock.isactive() || intervalBlock.isactive() ))
       DUNE_THROW( DGFException, "No readable block found" );
 
-    std::vector< std::vector< double > > vertices;
+    dgf::FlatArray< double > vertices;
 
     // read vertices first
     if( vertexBlock.isactive() )
@@ -202,7 +191,8 @@ namespace Dune
 
     // copy to vector of doubles
     std::vector< double > vtx( vertices.size() );
-    transform( vertices.begin(), vertices.end(), vtx.begin(), getfirst );
+    for( std::size_t i = 0; i < vertices.size(); ++i )
+      vtx[ i ] = vertices[ i ][ 0 ];
 
     // remove duplicates
     std::sort( vtx.begin(), vtx.end() );
@@ -2,6 +2,7 @@
 // vi: set et ts=4 sw=2 sts=2:
 #include <config.h>
 
+#include <algorithm>
 #include <cstdio>
 
 #include <dune/geometry/referenceelements.hh>
@@ -90,8 +91,8 @@ namespace Dune
   DuneGridFormatParser :: DuneGridFormatParser ( int rank, int size )
     : dimw( -1 ),
       dimgrid( -1 ),
-      vtx(0), nofvtx(0), vtxoffset(0), minVertexDistance(1e-12),
-      elements(0) , nofelements(0),
+      vtx(), nofvtx(0), vtxoffset(0), minVertexDistance(1e-12),
+      elements() , nofelements(0),
       bound(0) , nofbound(0),
       facemap(),
       haveBndParameters( false ),
@@ -482,9 +483,9 @@ namespace Dune
       }
     }
     for (size_t j=0; j<vtx.size(); j++) {
-      vtx[j-shift[j]]=vtx[j];
+      std::copy(vtx[j].begin(),vtx[j].end(),vtx[j-shift[j]].begin());
     }
-    vtx.resize(nofvtx);
+    vtx.truncate(nofvtx);
     assert(vtx.size()==size_t(nofvtx));
   }
 
@@ -585,7 +586,7 @@ namespace Dune
 
         v.resize( pos->first.size() );
         for( int i = 0; i < pos->first.size(); i++ )
-          v[ i ] = vtx[ pos->first[ i ] ];
+          v[ i ].assign( vtx[ pos->first[ i ] ].begin(), vtx[ pos->first[ i ] ].end() );
         const dgf::DomainData * data = dombound.contains( v );
         if ( data )
         {
@@ -815,17 +816,19 @@ namespace Dune
       int tmp;
       // first token is number of vertex which should equal i
       node >> nofvtx >> dimw >> nofvtxparams >> bnd;
-      vtx.resize(nofvtx);
+      vtx.clear();
+      vtx.reserve(nofvtx,dimw);
       if (nofvtxparams>0)
         vtxParams.resize(nofvtx);
+      std::vector<double> x(dimw);
       for (int i=0; i<nofvtx; i++) {
-        vtx[i].resize(dimw);
         int nr;
         node >> nr;
         // first token is number of vertex which should equal i
         assert(nr-offset==i);
         for (int v=0; v<dimw; v++)
-          node >> vtx[i][v];
+          node >> x[v];
+        vtx.push_back(x);
         if (nofvtxparams>0) {
           vtxParams[i].resize(nofvtxparams);
           for (int p=0; p<nofvtxparams; p++)
@@ -838,19 +841,21 @@ namespace Dune
     {
       int tmp;
       ele >> nofelements >> tmp >> nofelparams;
-      elements.resize(nofelements);
+      elements.clear();
+      elements.reserve(nofelements,dimw+1);
       if (nofelparams>0)
         elParams.resize(nofelements);
+      std::vector<unsigned int> simplex(dimw+1);
       for (int i=0; i<nofelements; i++) {
-        elements[i].resize(dimw+1);
         int nr;
         ele >> nr;
         assert(nr-offset==i);
         for (int v=0; v<dimw+1; v++) {
           int elno;
           ele >> elno;
-          elements[i][v] = elno - offset;
+          simplex[v] = elno - offset;
         }
+        elements.push_back(simplex);
         if (nofelparams>0) {
           elParams[i].resize(nofelparams);
           for (int p=0; p<nofelparams; p++)
@@ -927,10 +932,10 @@ namespace Dune
         if (elements[i].size()!=size_t(dimw+1))
           continue;
 
-        std::vector<double>& p0 = vtx[elements[i][1]];
-        std::vector<double>& p1 = vtx[elements[i][2]];
-        std::vector<double>& p2 = vtx[elements[i][3]];
-        std::vector<double>& q  = vtx[elements[i][0]];
+        const dgf::FlatArray<double>::ConstRow p0 = vtx[elements[i][1]];
+        const dgf::FlatArray<double>::ConstRow p1 = vtx[elements[i][2]];
+        const dgf::FlatArray<double>::ConstRow p2 = vtx[elements[i][3]];
+        const dgf::FlatArray<double>::ConstRow q  = vtx[elements[i][0]];
 
         double n[3];
         n[0] = -((p1[1]-p0[1]) *(p2[2]-p0[2]) - (p2[1]-p0[1]) *(p1[2]-p0[2])) ;
@@ -1079,7 +1084,7 @@ namespace Dune
     coord.resize(dimw);
     for (int j=0; j<dimw; j++)
       coord[j]=0.;
-    coord = vtx[i];
+    coord.assign(vtx[i].begin(),vtx[i].end());
     return vtxParams[i];
   }
 
@@ -28,7 +28,8 @@ namespace Dune
     inline const A &operator[] ( int i ) const;
     inline bool operator < ( const DGFEntityKey< A > &k ) const;
 
-    void orientation ( int base, std :: vector< std :: vector< double > > &vtx );
+    template< class Vertices >
+    void orientation ( int base, const Vertices &vtx );
     void print( std :: ostream &out = std :: cerr ) const;
 
     inline bool origKeySet () const;
@@ -81,26 +82,35 @@ namespace Dune
   // ElementFaceUtil
   // ---------------
 
+  /** \brief faces of the elements read by the DGF parser
+   *
+   *  An element is given by any container of vertex indices providing
+   *  size() and operator[], e.g., a std::vector or a row of a
+   *  dgf::FlatArray.
+   */
   struct ElementFaceUtil
   {
-    inline static int nofFaces ( int dim, std::vector< unsigned int > &element );
+    template< class Element >
+    inline static int nofFaces ( int dim, const Element &element );
     inline static int faceSize ( int dim, bool simpl );
 
+    template< class Element >
     static DGFEntityKey< unsigned int >
-    generateFace ( int dim, const std::vector< unsigned int > &element, int f );
+    generateFace ( int dim, const Element &element, int f );
 
   private:
-    template< int dim >
+    template< int dim, class Element >
     static DGFEntityKey< unsigned int >
-    generateCubeFace( const std::vector< unsigned int > &element, int f );
+    generateCubeFace( const Element &element, int f );
 
-    template< int dim >
+    template< int dim, class Element >
     static DGFEntityKey< unsigned int >
-    generateSimplexFace ( const std::vector< unsigned int > &element, int f );
+    generateSimplexFace ( const Element &element, int f );
   };
 
 
-  inline int ElementFaceUtil::nofFaces ( int dim, std::vector< unsigned int > &element )
+  template< class Element >
+  inline int ElementFaceUtil::nofFaces ( int dim, const Element &element )
   {
     switch( dim )
     {
@@ -72,18 +72,22 @@ namespace Dune
 
 
   template< class A >
+  template< class Vertices >
   inline void DGFEntityKey< A >
-  :: orientation ( int base, std::vector< std :: vector< double > > &vtx )
+  :: orientation ( int base, const Vertices &vtx )
   {
     if (key_.size()==3)  {
       assert( (size_t) origKey_[0] < vtx.size() );
-      std::vector<double>& p0 = vtx[origKey_[0]];
       assert( (size_t) origKey_[1] < vtx.size() );
-      std::vector<double>& p1 = vtx[origKey_[1]];
       assert( (size_t) origKey_[2] < vtx.size() );
-      std::vector<double>& p2 = vtx[origKey_[2]];
       assert( (size_t) base < vtx.size() );
-      std::vector<double>& q  = vtx[base];
+      double p0[3], p1[3], p2[3], q[3];
+      for (int j=0; j<3; j++) {
+        p0[j] = vtx[origKey_[0]][j];
+        p1[j] = vtx[origKey_[1]][j];
+        p2[j] = vtx[origKey_[2]][j];
+        q[j]  = vtx[base][j];
+      }
       double n[3];
       n[0] = (p1[1]-p0[1])*(p2[2]-p0[2])-(p2[1]-p0[1])*(p1[2]-p0[2]);
       n[1] = (p1[2]-p0[2])*(p2[0]-p0[0])-(p2[2]-p0[2])*(p1[0]-p0[0]);
@@ -111,10 +115,10 @@ namespace Dune
   // ElementFaceUtil
   // ---------------
 
-  template< int dim >
+  template< int dim, class Element >
   inline DGFEntityKey< unsigned int >
   ElementFaceUtil::generateCubeFace
-    ( const std::vector< unsigned int > &element, int f )
+    ( const Element &element, int f )
   {
     const ReferenceElement< double, dim > &refCube
       = ReferenceElements< double, dim >::cube();
@@ -126,10 +130,10 @@ namespace Dune
   }
 
 
-  template< int dim >
+  template< int dim, class Element >
   inline DGFEntityKey< unsigned int >
   ElementFaceUtil :: generateSimplexFace
-    ( const std :: vector< unsigned int > &element, int f )
+    ( const Element &element, int f )
   {
     const ReferenceElement< double, dim > &refSimplex
       = ReferenceElements< double, dim >::simplex();
@@ -141,8 +145,9 @@ namespace Dune
   }
 
 
+  template< class Element >
   inline DGFEntityKey< unsigned int >
-  ElementFaceUtil::generateFace ( int dim, const std::vector< unsigned int > &element, int f )
+  ElementFaceUtil::generateFace ( int dim, const Element &element, int f )
   {
     if( element.size() == size_t(dim+1) )
     {
@@ -150,11 +155,11 @@ namespace Dune
       switch( dim )
       {
       case 3 :
-        return generateSimplexFace< 3 >( element, f );
+        return generateSimplexFace< 3, Element >( element, f );
       case 2 :
-        return generateSimplexFace< 2 >( element, f );
+        return generateSimplexFace< 2, Element >( element, f );
       case 1 :
-        return generateSimplexFace< 1 >( element, f );
+        return generateSimplexFace< 1, Element >( element, f );
       default :
         DUNE_THROW( NotImplemented, "ElementUtil::generateFace not implemented for dim = " << dim << "." );
       }
@@ -165,11 +170,11 @@ namespace Dune
       switch( dim )
       {
       case 3 :
-        return generateCubeFace< 3 >( element, f );
+        return generateCubeFace< 3, Element >( element, f );
       case 2 :
-        return generateCubeFace< 2 >( element, f );
+        return generateCubeFace< 2, Element >( element, f );
       case 1 :
-        return generateCubeFace< 1 >( element, f );
+        return generateCubeFace< 1, Element >( element, f );
       default :
         DUNE_THROW( NotImplemented, "ElementUtil::generateFace not implemented for dim = " << dim << "." );
       }
@@ -0,0 +1,192 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_DGF_FLATARRAY_HH
+#define DUNE_DGF_FLATARRAY_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace Dune
+{
+
+  namespace dgf
+  {
+
+    // FlatArray
+    // ---------
+
+    /** \brief array of rows stored in one contiguous vector
+     *
+     *  The DGF parser keeps vertex coordinates and element connectivity in
+     *  this container instead of a std::vector of std::vectors, so a row
+     *  costs no allocation and no per row bookkeeping. Row i starts at
+     *  i*stride(). Only if rows of different length are inserted (e.g., a
+     *  Cube block followed by a Simplex block), an offset for each row is
+     *  stored in addition.
+     *
+     *  Rows are accessed through light weight proxies, which stay valid
+     *  until the next row is inserted.
+     */
+    template< class T >
+    class FlatArray
+    {
+      typedef FlatArray< T > This;
+
+    public:
+      typedef T value_type;
+      typedef std::size_t size_type;
+
+      template< class V >
+      class RowProxy
+      {
+        friend class FlatArray< T >;
+
+        RowProxy ( V *data, size_type size )
+          : data_( data ), size_( size )
+        {}
+
+      public:
+        typedef V *iterator;
+
+        //! a mutable row converts to a constant one
+        template< class W >
+        RowProxy ( const RowProxy< W > &other )
+          : data_( other.begin() ), size_( other.size() )
+        {}
+
+        V &operator[] ( size_type i ) const
+        {
+          assert( i < size_ );
+          return data_[ i ];
+        }
+
+        size_type size () const { return size_; }
+
+        iterator begin () const { return data_; }
+        iterator end () const { return data_ + size_; }
+
+      private:
+        V *data_;
+        size_type size_;
+      };
+
+      typedef RowProxy< T > Row;
+      typedef RowProxy< const T > ConstRow;
+
+      FlatArray ()
+        : size_( 0 ), stride_( 0 )
+      {}
+
+      //! number of rows
+      size_type size () const { return size_; }
+
+      bool empty () const { return (size_ == 0); }
+
+      //! common length of all rows, only meaningful if uniform() is true
+      size_type stride () const { return stride_; }
+
+      //! whether all rows have the same length
+      bool uniform () const { return offsets_.empty(); }
+
+      ConstRow operator[] ( size_type i ) const
+      {
+        assert( i < size_ );
+        return ConstRow( data() + begin( i ), end( i ) - begin( i ) );
+      }
+
+      Row operator[] ( size_type i )
+      {
+        assert( i < size_ );
+        return Row( data() + begin( i ), end( i ) - begin( i ) );
+      }
+
+      //! append a row
+      template< class Iterator >
+      void push_back ( Iterator first, Iterator last )
+      {
+        const size_type n = std::distance( first, last );
+        if( size_ == 0 )
+          stride_ = n;
+        else if( uniform() && (n != stride_) )
+        {
+          offsets_.resize( size_+1 );
+          for( size_type i = 0; i <= size_; ++i )
+            offsets_[ i ] = i*stride_;
+        }
+
+        data_.insert( data_.end(), first, last );
+        ++size_;
+        if( !uniform() )
+          offsets_.push_back( data_.size() );
+      }
+
+      //! append a row
+      void push_back ( const std::vector< T > &row )
+      {
+        push_back( row.begin(), row.end() );
+      }
+
+      //! reserve memory for rows of the given length
+      void reserve ( size_type rows, size_type length )
+      {
+        data_.reserve( data_.size() + rows*length );
+      }
+
+      //! remove all rows behind the first n ones
+      void truncate ( size_type n )
+      {
+        assert( n <= size_ );
+        if( n == size_ )
+          return;
+        if( n == 0 )
+          return clear();
+        data_.resize( end( n-1 ) );
+        if( !uniform() )
+          offsets_.resize( n+1 );
+        size_ = n;
+      }
+
+      void clear ()
+      {
+        data_.clear();
+        offsets_.clear();
+        size_ = 0;
+        stride_ = 0;
+      }
+
+      void swap ( This &other )
+      {
+        data_.swap( other.data_ );
+        offsets_.swap( other.offsets_ );
+        std::swap( size_, other.size_ );
+        std::swap( stride_, other.stride_ );
+      }
+
+    private:
+      size_type begin ( size_type i ) const
+      {
+        return (uniform() ? i*stride_ : offsets_[ i ]);
+      }
+
+      size_type end ( size_type i ) const
+      {
+        return (uniform() ? (i+1)*stride_ : offsets_[ i+1 ]);
+      }
+
+      const T *data () const { return (data_.empty() ? 0 : &data_[ 0 ]); }
+      T *data () { return (data_.empty() ? 0 : &data_[ 0 ]); }
+
+      std::vector< T > data_;
+      std::vector< size_type > offsets_;
+      size_type size_;
+      size_type stride_;
+    };
+
+  } // end namespace dgf
+
+} // end namespace Dune
+
+#endif // #ifndef DUNE_DGF_FLATARRAY_HH
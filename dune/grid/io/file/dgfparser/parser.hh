@@ -9,6 +9,7 @@
 #include <map>
 
 #include <dune/grid/io/file/dgfparser/entitykey.hh>
+#include <dune/grid/io/file/dgfparser/flatarray.hh>
 
 namespace Dune
 {
@@ -119,8 +120,8 @@ namespace Dune
     // dimension of world and problem: set through the readDuneGrid() method
     int dimw, dimgrid;
 
-    // vector of vertex coordinates
-    std::vector < std::vector < double > > vtx;
+    // vertex coordinates, one row of dimw entries per vertex
+    dgf::FlatArray< double > vtx;
 
     int nofvtx;
 
@@ -128,8 +129,8 @@ namespace Dune
 
     double minVertexDistance; // min. L^1 distance of distinct points
 
-    // vector of elements
-    std :: vector< std :: vector< unsigned int > > elements;
+    // vertex indices of the elements, one row per element
+    dgf::FlatArray< unsigned int > elements;
 
     int nofelements;
 
@@ -0,0 +1,266 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include <algorithm>
+#include <clocale>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/io/file/dgfparser/dgfwriter.hh>
+#include <dune/grid/io/file/dgfparser/flatarray.hh>
+#include <dune/grid/io/file/dgfparser/parser.hh>
+
+// gives access to the parsed vertices and elements
+struct TestParser
+  : public Dune::DuneGridFormatParser
+{
+  TestParser ()
+    : Dune::DuneGridFormatParser( 0, 1 )
+  {}
+
+  using Dune::DuneGridFormatParser::vtx;
+  using Dune::DuneGridFormatParser::elements;
+};
+
+template< class Row >
+bool equalRow ( const Row &row, const int *values, std::size_t size )
+{
+  return (row.size() == size) && std::equal( row.begin(), row.end(), values );
+}
+
+int checkFlatArray ()
+{
+  const int r0[] = { 0, 1, 2, 3 };
+  const int r1[] = { 4, 5, 6, 7 };
+  const int r2[] = { 8, 9, 10 };
+  int result = 0;
+
+  // rows of equal length are stored without offsets
+  Dune::dgf::FlatArray< int > a;
+  a.push_back( r0, r0+4 );
+  a.push_back( r1, r1+4 );
+  if( !a.uniform() || (a.stride() != 4) || (a.size() != 2) )
+  {
+    std::cerr << "FlatArray: two rows of length 4 are not uniform" << std::endl;
+    result = 1;
+  }
+
+  // a shorter row switches to offsets, the previous rows are kept
+  a.push_back( r2, r2+3 );
+  a.push_back( r0, r0+4 );
+  if( a.uniform() || (a.size() != 4)
+      || !equalRow( a[ 0 ], r0, 4 ) || !equalRow( a[ 1 ], r1, 4 )
+      || !equalRow( a[ 2 ], r2, 3 ) || !equalRow( a[ 3 ], r0, 4 ) )
+  {
+    std::cerr << "FlatArray: wrong rows of mixed length" << std::endl;
+    result = 1;
+  }
+
+  // rows are mutable through the proxies
+  a[ 2 ][ 1 ] = 42;
+  const Dune::dgf::FlatArray< int > &c = a;
+  if( c[ 2 ][ 1 ] != 42 )
+  {
+    std::cerr << "FlatArray: row was not modified" << std::endl;
+    result = 1;
+  }
+  a[ 2 ][ 1 ] = r2[ 1 ];
+
+  // truncate behind the row of different length and append again
+  a.truncate( 3 );
+  a.push_back( r1, r1+4 );
+  if( (a.size() != 4) || !equalRow( a[ 2 ], r2, 3 ) || !equalRow( a[ 3 ], r1, 4 ) )
+  {
+    std::cerr << "FlatArray: wrong rows after truncating mixed rows" << std::endl;
+    result = 1;
+  }
+  a.truncate( 1 );
+  a.push_back( r2, r2+3 );
+  if( (a.size() != 2) || !equalRow( a[ 0 ], r0, 4 ) || !equalRow( a[ 1 ], r2, 3 ) )
+  {
+    std::cerr << "FlatArray: wrong rows after truncating to one row" << std::endl;
+    result = 1;
+  }
+
+  // truncate uniform rows
+  Dune::dgf::FlatArray< int > b;
+  b.push_back( r0, r0+4 );
+  b.push_back( r1, r1+4 );
+  b.push_back( r0, r0+4 );
+  b.truncate( 2 );
+  b.push_back( r0, r0+4 );
+  if( !b.uniform() || (b.size() != 3) || !equalRow( b[ 1 ], r1, 4 ) || !equalRow( b[ 2 ], r0, 4 ) )
+  {
+    std::cerr << "FlatArray: wrong rows after truncating uniform rows" << std::endl;
+    result = 1;
+  }
+
+  // truncating all rows allows a new row length
+  b.truncate( 0 );
+  b.push_back( r2, r2+3 );
+  if( !b.uniform() || (b.stride() != 3) || (b.size() != 1) || !equalRow( b[ 0 ], r2, 3 ) )
+  {
+    std::cerr << "FlatArray: wrong row after truncating all rows" << std::endl;
+    result = 1;
+  }
+
+  a.swap( b );
+  if( (a.size() != 1) || (b.size() != 2) || !equalRow( b[ 1 ], r2, 3 ) )
+  {
+    std::cerr << "FlatArray: wrong rows after swap" << std::endl;
+    result = 1;
+  }
+  return result;
+}
+
+// write a YaspGrid with DGFWriter and parse it again; since all digits are
+// written, the coordinates have to be the same
+int checkRoundTrip ()
+{
+  typedef Dune::YaspGrid< 2 > Grid;
+  typedef Grid::LeafGridView GridView;
+  typedef std::pair< double, double > Coordinate;
+
+  Dune::FieldVector< double, 2 > L;
+  L[ 0 ] = 1.0;
+  L[ 1 ] = 0.7;
+  Dune::FieldVector< int, 2 > s;
+  s[ 0 ] = 3;
+  s[ 1 ] = 7;
+  Grid grid( L, s, Dune::FieldVector< bool, 2 >( false ), 0 );
+  const GridView gridView = grid.leafView();
+
+  std::stringstream dgf;
+  Dune::DGFWriter< GridView > writer( gridView );
+  writer.write( dgf );
+
+  TestParser parser;
+  if( !parser.readDuneGrid( dgf, 2, 2 ) )
+  {
+    std::cerr << "round trip: could not parse the written grid" << std::endl;
+    return 1;
+  }
+  if( (parser.vtx.size() != std::size_t( gridView.size( 2 ) ))
+      || (parser.elements.size() != std::size_t( gridView.size( 0 ) )) )
+  {
+    std::cerr << "round trip: parsed " << parser.vtx.size() << " vertices and "
+              << parser.elements.size() << " elements instead of "
+              << gridView.size( 2 ) << " and " << gridView.size( 0 ) << std::endl;
+    return 1;
+  }
+
+  // the elements are written in iteration order, the corners are compared
+  // as sets since the parser may reorder them
+  int result = 0;
+  std::size_t k = 0;
+  typedef GridView::Codim< 0 >::Iterator Iterator;
+  for( Iterator it = gridView.begin< 0 >(); it != gridView.end< 0 >(); ++it, ++k )
+  {
+    std::vector< Coordinate > expected, parsed;
+    for( int i = 0; i < it->geometry().corners(); ++i )
+    {
+      const Dune::FieldVector< double, 2 > x = it->geometry().corner( i );
+      expected.push_back( Coordinate( x[ 0 ], x[ 1 ] ) );
+    }
+    for( std::size_t i = 0; i < parser.elements[ k ].size(); ++i )
+    {
+      const unsigned int v = parser.elements[ k ][ i ];
+      parsed.push_back( Coordinate( parser.vtx[ v ][ 0 ], parser.vtx[ v ][ 1 ] ) );
+    }
+    std::sort( expected.begin(), expected.end() );
+    std::sort( parsed.begin(), parsed.end() );
+    if( parsed != expected )
+    {
+      std::cerr << "round trip: wrong corners of element " << k << std::endl;
+      result = 1;
+    }
+  }
+  return result;
+}
+
+// a Cube and a Simplex block give elements with different numbers of
+// vertices
+int checkMixedElements ()
+{
+  std::stringstream dgf;
+  dgf << "DGF\n"
+      << "Vertex\n"
+      << "0 0\n1 0\n2 0\n0 1\n1 1\n2 1.5e0\n"
+      << "#\n"
+      << "Cube\n"
+      << "0 1 3 4\n"
+      << "#\n"
+      << "Simplex\n"
+      << "1 2 5\n1 5 4\n"
+      << "#\n"
+      << "#\n";
+
+  TestParser parser;
+  if( !parser.readDuneGrid( dgf, 2, 2 ) )
+  {
+    std::cerr << "mixed elements: could not parse the grid" << std::endl;
+    return 1;
+  }
+
+  int result = 0;
+  if( (parser.vtx.size() != 6) || (parser.vtx[ 5 ][ 0 ] != 2.0) || (parser.vtx[ 5 ][ 1 ] != 1.5) )
+  {
+    std::cerr << "mixed elements: wrong vertices" << std::endl;
+    result = 1;
+  }
+  if( (parser.elements.size() != 3) || (parser.elements[ 0 ].size() != 4)
+      || (parser.elements[ 1 ].size() != 3) || (parser.elements[ 2 ].size() != 3) )
+  {
+    std::cerr << "mixed elements: wrong elements" << std::endl;
+    result = 1;
+  }
+  return result;
+}
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::MPIHelper::instance( argc, argv );
+
+  int result = checkFlatArray();
+  result += checkRoundTrip();
+  result += checkMixedElements();
+
+  // numbers in DGF files always use a '.', whatever the locale
+  const char *locales[] = { "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR" };
+  bool found = false;
+  for( int i = 0; (i < 6) && !found; ++i )
+    found = std::setlocale( LC_NUMERIC, locales[ i ] )
+            && (std::strcmp( std::localeconv()->decimal_point, "." ) != 0);
+  if( found )
+  {
+    std::cout << "parsing with LC_NUMERIC=" << std::setlocale( LC_NUMERIC, 0 ) << std::endl;
+    result += checkRoundTrip();
+    result += checkMixedElements();
+  }
+  else
+    std::cout << "no locale with a decimal comma found, skipping the locale check" << std::endl;
+  std::setlocale( LC_NUMERIC, "C" );
+
+  return (result > 0 ? 1 : 0);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
+catch( ... )
+{
+  std::cerr << "Generic exception!" << std::endl;
+  return 2;
+}
@@ -4,17 +4,20 @@
 #ifndef DUNE_GMSHREADER_HH
 #define DUNE_GMSHREADER_HH
 
-#include <cstdarg>
-#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
-#include <fstream>
 #include <iostream>
-#include <map>
+#include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
-#include <stdio.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
+#include <dune/common/array.hh>
 #include <dune/common/exceptions.hh>
 #include <dune/common/fvector.hh>
 
@@ -22,6 +25,8 @@
 
 #include <dune/grid/common/boundarysegment.hh>
 #include <dune/grid/common/gridfactory.hh>
+#include <dune/grid/io/file/mappedfile.hh>
+#include <dune/grid/utility/alltoall.hh>
 
 namespace Dune
 {
@@ -200,10 +205,44 @@ namespace Dune
   }   // end empty namespace
 
   //! dimension independent parts for GmshReaderParser
+  /**
+   * The file is mapped into memory as a whole (see MappedFile).  In ASCII
+   * files the node and element sections are cut into chunks at line
+   * boundaries which are parsed in parallel if OpenMP is enabled; in
+   * binary files the records of a block have a fixed size and are decoded
+   * in parallel.  Node ids are translated to vertex numbers with arrays
+   * indexed by the id, so the ids need not be consecutive.  The vertices
+   * and elements are then inserted into the factory in the order of the
+   * file.
+   */
   template<typename GridType>
   class GmshReaderParser
   {
   protected:
+    // node data parsed from one chunk of the file
+    struct NodeChunk
+    {
+      // id of each node
+      std::vector<int> id;
+      // three coordinates per node
+      std::vector<double> x;
+    };
+
+    // data of the elements parsed from one chunk of the file
+    struct ElementChunk
+    {
+      ElementChunk () : read(0) {}
+
+      // number of elements read, including the ones that are not used
+      std::size_t read;
+      // Gmsh type of each element used
+      std::vector<unsigned char> type;
+      // physical entity of each element used
+      std::vector<int> physical;
+      // node ids of the elements used, nodeCount(type) entries per element
+      std::vector<int> dofs;
+    };
+
     // private data
     Dune::GridFactory<GridType>& factory;
     bool verbose;
@@ -211,9 +250,16 @@ namespace Dune
     unsigned int number_of_real_vertices;
     int boundary_element_count;
     int element_count;
-    // read buffer
-    char buf[512];
     std::string fileName;
+    // contents of the file and current parse position
+    const char* file_begin;
+    const char* file_end;
+    const char* file_pos;
+    // whether the file is binary and has the other byte order
+    bool binary;
+    bool swap_bytes;
+    // global id of each vertex number in distributed reading, empty otherwise
+    std::vector<int> global_id;
     // exported data
     std::vector<int> boundary_id_to_physical_entity;
     std::vector<int> element_index_to_physical_entity;
@@ -226,148 +272,515 @@ namespace Dune
     // typedefs
     typedef FieldVector< double, dimWorld > GlobalVector;
 
-    // don't use something like
-    //   readfile(file, 1, "%s\n", buf);
-    // to skip the rest of of the line -- that will only skip the next
-    // whitespace-separated word!  Use skipline() instead.
-    void readfile(FILE * file, int cnt, const char * format,
-                  void* t1, void* t2 = 0, void* t3 = 0, void* t4 = 0,
-                  void* t5 = 0, void* t6 = 0, void* t7 = 0, void* t8 = 0,
-                  void* t9 = 0, void* t10 = 0)
+    // number of nodes of the Gmsh element types, -1 if the type is unknown
+    static int nodeCount (int elm_type)
+    {
+      static const int n[32] = {-1, 2, 3, 4, 4, 8, 6, 5, 3, 6, 9, 10, 27, 18, 14,
+                                1, 8, 20, 15, 13, 9, 10, 12, 15, 15, 21, 4, 5, 6,
+                                20, 35, 56};
+      return (elm_type >= 0 && elm_type < 32) ? n[elm_type] : -1;
+    }
+
+    // number of vertices of the supported Gmsh element types
+    static int vertexCount (int elm_type)
+    {
+      static const int n[12] = {-1, 2, 3, 4, 4, 8, 6, 5, 2, 3, -1, 4};
+      return n[elm_type];
+    }
+
+    // dimension of the supported Gmsh element types, -1 for the others
+    static int elementDim (int elm_type)
+    {
+      static const int d[12] = {-1, 1, 2, 2, 3, 3, 3, 3, 1, 2, -1, 3};
+      return (elm_type >= 0 && elm_type < 12) ? d[elm_type] : -1;
+    }
+
+    // whether the type is read as element or boundary segment at all
+    static bool isUsed (int elm_type)
+    {
+      const int d = elementDim(elm_type);
+      return d >= 0 && (d == dim || d == dim-1);
+    }
+
+    static bool isSpace (char c)
+    {
+      return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    // parse an integer in [p, e) after blanks, advance p behind it
+    static bool parseInt (const char*& p, const char* e, int& value)
+    {
+      while (p != e && (*p == ' ' || *p == '\t'))
+        ++p;
+      bool negative = false;
+      if (p != e && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+      if (p == e || *p < '0' || *p > '9')
+        return false;
+      long v = 0;
+      for (; p != e && *p >= '0' && *p <= '9'; ++p)
+        v = 10*v + (*p - '0');
+      value = negative ? -v : v;
+      return true;
+    }
+
+    // parse a floating point number in [p, e), advance p behind it
+    static bool parseDouble (const char*& p, const char* e, double& value)
+    {
+      char* q;
+      value = std::strtod(p, &q);
+      if (q == p || q > e)
+        return false;
+      p = q;
+      return true;
+    }
+
+    // read a value of type T from a binary file
+    template<class T>
+    static T binaryValue (const char* p, bool swap)
+    {
+      char bytes[sizeof(T)];
+      std::memcpy(bytes, p, sizeof(T));
+      if (swap)
+        std::reverse(bytes, bytes + sizeof(T));
+      T value;
+      std::memcpy(&value, bytes, sizeof(T));
+      return value;
+    }
+
+    // number of chunks a section is split into for parsing
+    static int numberOfChunks ()
+    {
+#ifdef _OPENMP
+      return 4*omp_get_max_threads();
+#else
+      return 1;
+#endif
+    }
+
+    // split [b, e) into n pieces at line boundaries
+    static std::vector<const char*> splitLines (const char* b, const char* e,
+                                                int n)
+    {
+      std::vector<const char*> bounds(1, b);
+      for (int i = 1; i < n; ++i)
+      {
+        const char* p = std::max(b + (e - b) / n * i, bounds.back());
+        p = std::find(p, e, '\n');
+        bounds.push_back(p == e ? e : p + 1);
+      }
+      bounds.push_back(e);
+      return bounds;
+    }
+
+    // parse the node lines in [p, e), on error return the position
+    static const char* parseNodes (const char* p, const char* e,
+                                   NodeChunk& chunk)
+    {
+      while (true)
+      {
+        while (p != e && isSpace(*p))
+          ++p;
+        if (p == e)
+          return 0;
+        const char* eol = std::find(p, e, '\n');
+        int id;
+        double x[ 3 ];
+        if (!parseInt(p, eol, id) || !parseDouble(p, eol, x[ 0 ])
+            || !parseDouble(p, eol, x[ 1 ]) || !parseDouble(p, eol, x[ 2 ]))
+          return p;
+        chunk.id.push_back(id);
+        chunk.x.insert(chunk.x.end(), x, x + 3);
+        p = eol;
+      }
+    }
+
+    // parse the element lines in [p, e), on error return the position
+    static const char* parseElements (const char* p, const char* e,
+                                      ElementChunk& chunk)
+    {
+      while (true)
+      {
+        while (p != e && isSpace(*p))
+          ++p;
+        if (p == e)
+          return 0;
+        const char* eol = std::find(p, e, '\n');
+        int id, elm_type, number_of_tags;
+        if (!parseInt(p, eol, id) || !parseInt(p, eol, elm_type)
+            || !parseInt(p, eol, number_of_tags))
+          return p;
+        ++chunk.read;
+
+        // k == 0: physical entity
+        // k == 1: elementary entity (not used here)
+        // k >= 2: mesh partitions (not used here either)
+        int physical_entity = -1;
+        for (int k = 0; k < number_of_tags; ++k)
+        {
+          int tag;
+          if (!parseInt(p, eol, tag))
+            return p;
+          if (k == 0)
+            physical_entity = tag;
+        }
+
+        // skip elements of unknown type or dimension
+        if (isUsed(elm_type))
+        {
+          for (int i = 0; i < nodeCount(elm_type); ++i)
+          {
+            int dof;
+            if (!parseInt(p, eol, dof))
+              return p;
+            chunk.dofs.push_back(dof);
+          }
+          chunk.type.push_back(elm_type);
+          chunk.physical.push_back(physical_entity);
+        }
+        p = eol;
+      }
+    }
+
+    void parseError (const char* p)
     {
-      off_t pos = ftello(file);
-      int c = fscanf(file, format, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10);
-      if (c != cnt)
-        DUNE_THROW(Dune::IOError, "Error parsing " << fileName << " "
-                   "file pos " << pos
-                                                   << ": Expected '" << format << "', only read " << c << " entries instead of " << cnt << ".");
+      DUNE_THROW(Dune::IOError, "Error parsing " << fileName << " "
+                 "file pos " << (p - file_begin));
+    }
+
+    void skipSpace ()
+    {
+      while (file_pos != file_end && isSpace(*file_pos))
+        ++file_pos;
     }
 
     // skip over the rest of the line, including the terminating newline
-    void skipline(FILE * file)
+    void skipline ()
     {
-      int c;
-      do {
-        c = std::fgetc(file);
-      } while(c != '\n' && c != EOF);
+      file_pos = std::find(file_pos, file_end, '\n');
+      if (file_pos != file_end)
+        ++file_pos;
     }
 
-  public:
+    // return the next whitespace-separated word
+    std::string readWord ()
+    {
+      skipSpace();
+      const char* b = file_pos;
+      while (file_pos != file_end && !isSpace(*file_pos))
+        ++file_pos;
+      return std::string(b, file_pos);
+    }
 
-    GmshReaderParser(Dune::GridFactory<GridType>& _factory, bool v, bool i) :
-      factory(_factory), verbose(v), insert_boundary_segments(i) {}
+    void expect (const std::string& word)
+    {
+      if (readWord() != word)
+        DUNE_THROW(Dune::IOError, "expected " << word << " in " << fileName);
+    }
 
-    std::vector<int> & boundaryIdMap()
+    int readInt ()
     {
-      return boundary_id_to_physical_entity;
+      skipSpace();
+      int value;
+      if (!parseInt(file_pos, file_end, value))
+        parseError(file_pos);
+      return value;
     }
 
-    std::vector<int> & elementIndexMap()
+    // find the given marker behind the current position
+    const char* findMarker (const std::string& marker)
     {
-      return element_index_to_physical_entity;
+      const char* p = std::search(file_pos, file_end,
+                                  marker.begin(), marker.end());
+      if (p == file_end)
+        DUNE_THROW(Dune::IOError, "expected " << marker << " in " << fileName);
+      return p;
     }
 
-    void read (const std::string& f)
+    // make sure n more bytes of binary data follow
+    void checkBinarySize (std::size_t n)
     {
-      if (verbose) std::cout << "Reading " << dim << "d Gmsh grid..." << std::endl;
+      if (std::size_t(file_end - file_pos) < n)
+        DUNE_THROW(Dune::IOError, "unexpected end of " << fileName);
+    }
 
-      // open file name, we use C I/O
-      fileName = f;
-      FILE* file = fopen(fileName.c_str(),"r");
-      if (file==0)
-        DUNE_THROW(Dune::IOError, "Could not open " << fileName);
+    // parse the node lines in [b, e) in chunks
+    void parseNodeLines (const char* b, const char* e,
+                         std::vector<NodeChunk>& chunks)
+    {
+      const std::vector<const char*> bounds =
+        splitLines(b, e, numberOfChunks());
+      chunks.resize(bounds.size() - 1);
+      std::vector<const char*> errors(chunks.size(), 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (long c = 0; c < long(chunks.size()); ++c)
+        errors[c] = parseNodes(bounds[c], bounds[c+1], chunks[c]);
+      for (std::size_t c = 0; c < errors.size(); ++c)
+        if (errors[c] != 0)
+          parseError(errors[c]);
+    }
 
-      //=========================================
-      // Header: Read vertices into vector
-      //         Check vertices that are needed
-      //=========================================
+    // size of a node record in a binary file: id and three coordinates
+    static std::size_t nodeRecordSize ()
+    {
+      return sizeof(int) + 3*sizeof(double);
+    }
 
-      number_of_real_vertices = 0;
-      boundary_element_count = 0;
-      element_count = 0;
+    // decode the binary node records [first, first+count) behind data
+    void decodeNodes (const char* data, long first, long count,
+                      NodeChunk& chunk)
+    {
+      chunk.id.resize(count);
+      chunk.x.resize(3*count);
+      const std::size_t recordSize = nodeRecordSize();
+      const bool swap = swap_bytes;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+      for (long i = 0; i < count; ++i)
+      {
+        const char* record = data + (first + i)*recordSize;
+        chunk.id[i] = binaryValue<int>(record, swap);
+        for (int j = 0; j < 3; ++j)
+          chunk.x[3*i+j] =
+            binaryValue<double>(record + sizeof(int) + j*sizeof(double), swap);
+      }
+    }
 
-      // process header
-      double version_number;
-      int file_type, data_size;
+    // parse the element lines in [b, e) in chunks
+    void parseElementLines (const char* b, const char* e,
+                            std::vector<ElementChunk>& chunks)
+    {
+      const std::vector<const char*> bounds =
+        splitLines(b, e, numberOfChunks());
+      chunks.resize(bounds.size() - 1);
+      std::vector<const char*> errors(chunks.size(), 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (long c = 0; c < long(chunks.size()); ++c)
+        errors[c] = parseElements(bounds[c], bounds[c+1], chunks[c]);
+      for (std::size_t c = 0; c < errors.size(); ++c)
+        if (errors[c] != 0)
+          parseError(errors[c]);
+    }
 
-      readfile(file,1,"%s\n",buf);
-      if (strcmp(buf,"$MeshFormat")!=0)
-        DUNE_THROW(Dune::IOError, "expected $MeshFormat in first line");
-      readfile(file,3,"%lg %d %d\n",&version_number,&file_type,&data_size);
-      if( (version_number < 2.0) || (version_number > 2.2) )
-        DUNE_THROW(Dune::IOError, "can only read Gmsh version 2 files");
-      if (verbose) std::cout << "version " << version_number << " Gmsh file detected" << std::endl;
-      readfile(file,1,"%s\n",buf);
-      if (strcmp(buf,"$EndMeshFormat")!=0)
-        DUNE_THROW(Dune::IOError, "expected $EndMeshFormat");
+    // a block of elements of the same type and number of tags in a binary file
+    struct ElementBlock
+    {
+      int elm_type;
+      int number_of_following;
+      int number_of_tags;
+      // first record of the block
+      const char* data;
+
+      // size of a record: id, tags and nodes
+      std::size_t recordSize () const
+      {
+        return (1 + number_of_tags + nodeCount(elm_type))*sizeof(int);
+      }
+    };
 
-      // node section
-      int number_of_nodes;
+    // find the blocks of a binary element section
+    void readElementBlocks (std::vector<ElementBlock>& blocks,
+                            int number_of_elements)
+    {
+      int done = 0;
+      while (done < number_of_elements)
+      {
+        checkBinarySize(3*sizeof(int));
+        ElementBlock block;
+        block.elm_type = binaryValue<int>(file_pos, swap_bytes);
+        block.number_of_following =
+          binaryValue<int>(file_pos + sizeof(int), swap_bytes);
+        block.number_of_tags =
+          binaryValue<int>(file_pos + 2*sizeof(int), swap_bytes);
+        if (nodeCount(block.elm_type) < 0 || block.number_of_following <= 0
+            || block.number_of_tags < 0)
+          parseError(file_pos);
+        file_pos += 3*sizeof(int);
+
+        const std::size_t size = block.number_of_following * block.recordSize();
+        checkBinarySize(size);
+        block.data = file_pos;
+        blocks.push_back(block);
+        file_pos += size;
+        done += block.number_of_following;
+      }
+    }
 
-      readfile(file,1,"%s\n",buf);
-      if (strcmp(buf,"$Nodes")!=0)
-        DUNE_THROW(Dune::IOError, "expected $Nodes");
-      readfile(file,1,"%d\n",&number_of_nodes);
-      if (verbose) std::cout << "file contains " << number_of_nodes << " nodes" << std::endl;
+    // decode the records [first, first+count) of a block
+    void decodeElements (const ElementBlock& block, long first, long count,
+                         ElementChunk& chunk)
+    {
+      chunk.read = count;
+      if (!isUsed(block.elm_type))
+        return;
 
-      // read nodes
-      std::vector< GlobalVector > nodes( number_of_nodes+1 );       // store positions
+      const int nodes = nodeCount(block.elm_type);
+      const int number_of_tags = block.number_of_tags;
+      chunk.type.assign(count, block.elm_type);
+      chunk.physical.resize(count);
+      chunk.dofs.resize(std::size_t(count) * nodes);
+      const std::size_t recordSize = block.recordSize();
+      const bool swap = swap_bytes;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+      for (long i = 0; i < count; ++i)
       {
-        int id;
-        double x[ 3 ];
-        for( int i = 1; i <= number_of_nodes; ++i )
-        {
-          readfile(file,4, "%d %lg %lg %lg\n", &id, &x[ 0 ], &x[ 1 ], &x[ 2 ] );
-          if( id != i )
-            DUNE_THROW( Dune::IOError, "Expected id " << i << "(got id " << id << "." );
+        const char* record = block.data + (first + i)*recordSize;
+        chunk.physical[i] = (number_of_tags > 0)
+                            ? binaryValue<int>(record + sizeof(int), swap) : -1;
+        const char* dofs = record + (1 + number_of_tags)*sizeof(int);
+        for (int k = 0; k < nodes; ++k)
+          chunk.dofs[i*nodes+k] = binaryValue<int>(dofs + k*sizeof(int), swap);
+      }
+    }
 
-          // just store node position
-          for( int j = 0; j < dimWorld; ++j )
-            nodes[ i ][ j ] = x[ j ];
+    void readNodes (std::vector<NodeChunk>& chunks, int number_of_nodes)
+    {
+      if (binary)
+      {
+        checkBinarySize(number_of_nodes * nodeRecordSize());
+        chunks.resize(1);
+        decodeNodes(file_pos, 0, number_of_nodes, chunks[0]);
+        file_pos += number_of_nodes * nodeRecordSize();
+      }
+      else
+      {
+        const char* sectionEnd = findMarker("$EndNodes");
+        parseNodeLines(file_pos, sectionEnd, chunks);
+        file_pos = sectionEnd;
+      }
+      expect("$EndNodes");
+    }
+
+    void readElements (std::vector<ElementChunk>& chunks,
+                       int number_of_elements)
+    {
+      if (binary)
+      {
+        std::vector<ElementBlock> blocks;
+        readElementBlocks(blocks, number_of_elements);
+        chunks.resize(blocks.size());
+        for (std::size_t b = 0; b < blocks.size(); ++b)
+          decodeElements(blocks[b], 0, blocks[b].number_of_following, chunks[b]);
+      }
+      else
+      {
+        const char* sectionEnd = findMarker("$EndElements");
+        parseElementLines(file_pos, sectionEnd, chunks);
+        file_pos = sectionEnd;
+      }
+      expect("$EndElements");
+    }
+
+    // number of elements read, including the ones that are not used
+    static std::size_t elementsRead (const std::vector<ElementChunk>& chunks)
+    {
+      std::size_t read = 0;
+      for (std::size_t c = 0; c < chunks.size(); ++c)
+        read += chunks[c].read;
+      return read;
+    }
+
+    // append an element to a chunk
+    static void append (ElementChunk& chunk, int elm_type, int physical_entity,
+                        const int* dofs)
+    {
+      ++chunk.read;
+      chunk.type.push_back(elm_type);
+      chunk.physical.push_back(physical_entity);
+      chunk.dofs.insert(chunk.dofs.end(), dofs, dofs + nodeCount(elm_type));
+    }
+
+    // read the header up to the number of nodes
+    int readHeader ()
+    {
+      expect("$MeshFormat");
+      skipSpace();
+      double version_number;
+      if (!parseDouble(file_pos, file_end, version_number))
+        parseError(file_pos);
+      const int file_type = readInt();
+      const int data_size = readInt();
+      if( (version_number < 2.0) || (version_number > 2.2) )
+        DUNE_THROW(Dune::IOError, "can only read Gmsh version 2 files");
+      if (verbose) std::cout << "version " << version_number << " Gmsh file detected" << std::endl;
+      binary = (file_type == 1);
+      swap_bytes = false;
+      if (binary)
+      {
+        if (data_size != int(sizeof(double)))
+          DUNE_THROW(Dune::IOError, "can only read binary Gmsh files with "
+                     "double precision");
+        // the integer 1 written in the byte order of the file
+        skipline();
+        checkBinarySize(sizeof(int));
+        if (binaryValue<int>(file_pos, false) != 1)
+        {
+          if (binaryValue<int>(file_pos, true) != 1)
+            DUNE_THROW(Dune::IOError, "can not determine the byte order of "
+                       << fileName);
+          swap_bytes = true;
         }
-        readfile(file,1,"%s\n",buf);
-        if (strcmp(buf,"$EndNodes")!=0)
-          DUNE_THROW(Dune::IOError, "expected $EndNodes");
+        file_pos += sizeof(int);
+        if (verbose) std::cout << "binary file detected" << std::endl;
       }
+      expect("$EndMeshFormat");
 
-      // element section
-      readfile(file,1,"%s\n",buf);
-      if (strcmp(buf,"$Elements")!=0)
-        DUNE_THROW(Dune::IOError, "expected $Elements");
-      int number_of_elements;
-      readfile(file,1,"%d\n",&number_of_elements);
+      // skip sections like $PhysicalNames up to the node section
+      std::string section = readWord();
+      while (section != "$Nodes")
+      {
+        if (section.size() < 2 || section[0] != '$')
+          DUNE_THROW(Dune::IOError, "expected $Nodes");
+        file_pos = findMarker("$End" + section.substr(1));
+        readWord();
+        section = readWord();
+      }
+
+      const int number_of_nodes = readInt();
+      skipline();
+      if (verbose) std::cout << "file contains " << number_of_nodes << " nodes" << std::endl;
+      return number_of_nodes;
+    }
+
+    // read the number of elements
+    int readElementHeader ()
+    {
+      expect("$Elements");
+      const int number_of_elements = readInt();
+      skipline();
       if (verbose) std::cout << "file contains " << number_of_elements << " elements" << std::endl;
+      return number_of_elements;
+    }
 
+    // insert the vertices, elements and boundary segments into the factory
+    void insertElements (const std::vector<ElementChunk>& elementChunks,
+                         std::vector<int>& renumber,
+                         const std::vector< GlobalVector >& nodes)
+    {
       //=========================================
       // Pass 1: Renumber needed vertices
       //=========================================
 
-      long section_element_offset = ftell(file);
-      std::map<int,unsigned int> renumber;
-      for (int i=1; i<=number_of_elements; i++)
+      for (std::size_t c = 0; c < elementChunks.size(); ++c)
       {
-        int id, elm_type, number_of_tags;
-        readfile(file,3,"%d %d %d ",&id,&elm_type,&number_of_tags);
-        for (int k=1; k<=number_of_tags; k++)
+        const ElementChunk& chunk = elementChunks[c];
+        const int* dofs = chunk.dofs.empty() ? 0 : &chunk.dofs[0];
+        for (std::size_t e = 0; e < chunk.type.size(); ++e)
         {
-          int blub;
-          readfile(file,1,"%d ",&blub);
-          // k == 1: physical entity (not used here)
-          // k == 2: elementary entity (not used here either)
-          // if version_number < 2.2:
-          //   k == 3: mesh partition 0
-          // else
-          //   k == 3: number of mesh partitions
-          //   k => 4: mesh partition k-4
+          pass1HandleElement(chunk.type[e], dofs, renumber, nodes);
+          dofs += nodeCount(chunk.type[e]);
         }
-        pass1HandleElement(file, elm_type, renumber, nodes);
       }
       if (verbose) std::cout << "number of real vertices = " << number_of_real_vertices << std::endl;
       if (verbose) std::cout << "number of boundary elements = " << boundary_element_count << std::endl;
       if (verbose) std::cout << "number of elements = " << element_count << std::endl;
-      readfile(file,1,"%s\n",buf);
-      if (strcmp(buf,"$EndElements")!=0)
-        DUNE_THROW(Dune::IOError, "expected $EndElements");
       boundary_id_to_physical_entity.resize(boundary_element_count);
       element_index_to_physical_entity.resize(element_count);
 
@@ -375,89 +788,531 @@ namespace Dune
       // Pass 2: Insert boundary segments and elements
       //==============================================
 
-      fseek(file, section_element_offset, SEEK_SET);
       boundary_element_count = 0;
       element_count = 0;
-      for (int i=1; i<=number_of_elements; i++)
+      for (std::size_t c = 0; c < elementChunks.size(); ++c)
       {
-        int id, elm_type, number_of_tags;
-        readfile(file,3,"%d %d %d ",&id,&elm_type,&number_of_tags);
-        int physical_entity = -1;
-        std::vector<int> mesh_partitions;
-        if ( version_number < 2.2 )
+        const ElementChunk& chunk = elementChunks[c];
+        const int* dofs = chunk.dofs.empty() ? 0 : &chunk.dofs[0];
+        for (std::size_t e = 0; e < chunk.type.size(); ++e)
         {
-          mesh_partitions.resize(1);
+          pass2HandleElement(chunk.type[e], dofs, renumber, nodes,
+                             chunk.physical[e]);
+          dofs += nodeCount(chunk.type[e]);
         }
-        for (int k=1; k<=number_of_tags; k++)
+      }
+    }
+
+#if HAVE_MPI
+    // the processes owning the nodes in distributed reading
+    struct NodeOwners
+    {
+      // ranges is [first id, last id] for each process
+      explicit NodeOwners (const std::vector<int>& ranges)
+      {
+        for (std::size_t p = 0; 2*p < ranges.size(); ++p)
         {
-          int blub;
-          readfile(file,1,"%d ",&blub);
-          if (k==1) physical_entity = blub;
-          // k == 2: elementary entity (not used here)
-          if ( version_number < 2.2 )
-          {
-            if (k==3) mesh_partitions[0] = blub;
-          }
-          else
-          {
-            if (k > 3)
-              mesh_partitions[k-4] = blub;
-            else
-              mesh_partitions.resize(blub);
-          }
+          if (ranges[2*p] > ranges[2*p+1])
+            continue;
+          if (!last.empty() && ranges[2*p] <= last.back())
+            DUNE_THROW(Dune::NotImplemented, "distributed reading of Gmsh "
+                       "files requires increasing node ids");
+          first.push_back(ranges[2*p]);
+          last.push_back(ranges[2*p+1]);
+          rank.push_back(p);
         }
-        pass2HandleElement(file, elm_type, renumber, nodes, physical_entity);
       }
-      readfile(file,1,"%s\n",buf);
-      if (strcmp(buf,"$EndElements")!=0)
-        DUNE_THROW(Dune::IOError, "expected $EndElements");
 
-      fclose(file);
+      // the process owning the node, -1 if there is none
+      int find (int id) const
+      {
+        const std::size_t i =
+          std::upper_bound(first.begin(), first.end(), id) - first.begin();
+        return (i > 0 && id <= last[i-1]) ? rank[i-1] : -1;
+      }
+
+      std::vector<int> first, last, rank;
+    };
+
+    // throw on all processes if an error occurred on one of them
+    void checkAll (MPI_Comm comm, const std::string& error)
+    {
+      int failed = !error.empty();
+      MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, comm);
+      if (!error.empty())
+        DUNE_THROW(Dune::IOError, error);
+      if (failed)
+        DUNE_THROW(Dune::IOError, "Error reading " << fileName
+                                                   << " on another process");
     }
 
-    // dimension dependent routines
-    void pass1HandleElement(FILE* file, const int elm_type,
-                            std::map<int,unsigned int> & renumber,
-                            const std::vector< GlobalVector > & nodes)
+    // find the given marker behind the current position, each process
+    // searches a part of the rest of the file
+    const char* findMarker (const std::string& marker, MPI_Comm comm)
+    {
+      int rank, size;
+      MPI_Comm_rank(comm, &rank);
+      MPI_Comm_size(comm, &size);
+      const std::size_t length = file_end - file_pos;
+      const char* b = file_pos + length / size * rank;
+      const char* e = (rank == size-1) ? file_end
+                      : std::min(file_end, file_pos + length / size * (rank+1) + marker.size() - 1);
+      const char* p = std::search(b, e, marker.begin(), marker.end());
+      long offset = (p == e) ? std::numeric_limits<long>::max()
+                    : long(p - file_begin);
+      MPI_Allreduce(MPI_IN_PLACE, &offset, 1, MPI_LONG, MPI_MIN, comm);
+      if (offset == std::numeric_limits<long>::max())
+        DUNE_THROW(Dune::IOError, "expected " << marker << " in " << fileName);
+      return file_begin + offset;
+    }
+
+    // size of a boundary segment record: type, physical entity and nodes
+    static std::size_t segmentSize (const int* record)
     {
-      // some data about gmsh elements
-      const int nDofs[12]      = {-1, 2, 3, 4, 4, 8, 6, 5, 3, 6, -1, 10};
-      const int nVertices[12]  = {-1, 2, 3, 4, 4, 8, 6, 5, 2, 3, -1, 4};
-      const int elementDim[12] = {-1, 1, 2, 2, 3, 3, 3, 3, 1, 2, -1, 3};
+      return 2 + nodeCount(record[0]);
+    }
 
-      // test whether we support the element type
-      if ( not (elm_type >= 0 && elm_type < 12         // index in suitable range?
-                && (elementDim[elm_type] == dim || elementDim[elm_type] == (dim-1) ) ) )         // real element or boundary element?
+    // whether a local element contains all vertices of a boundary segment
+    static bool containsSegment (const std::vector< std::pair<int, int> >& incidence,
+                                 const ElementChunk& elements,
+                                 const std::vector<std::size_t>& offsets,
+                                 int elm_type, const int* dofs)
+    {
+      typedef std::vector< std::pair<int, int> >::const_iterator Iterator;
+      const Iterator begin = std::lower_bound(incidence.begin(), incidence.end(),
+                                              std::make_pair(dofs[0], 0));
+      for (Iterator it = begin; it != incidence.end() && it->first == dofs[0]; ++it)
       {
-        skipline(file);         // skip rest of line if element is unknown
-        return;
+        const int* element = &elements.dofs[offsets[it->second]];
+        const int* elementEnd = element + vertexCount(elements.type[it->second]);
+        bool contained = true;
+        for (int i = 1; contained && i < vertexCount(elm_type); ++i)
+          contained = (std::find(element, elementEnd, dofs[i]) != elementEnd);
+        if (contained)
+          return true;
       }
+      return false;
+    }
+#endif // #if HAVE_MPI
 
-      // The format string for parsing is n times '%d' in a row
-      std::string formatString = "%d";
-      for (int i=1; i<nDofs[elm_type]; i++)
-        formatString += " %d";
-      formatString += "\n";
+  public:
 
-      // '10' is the largest number of dofs we may encounter in a .msh file
-      std::vector<int> elementDofs(10);
+    GmshReaderParser(Dune::GridFactory<GridType>& _factory, bool v, bool i) :
+      factory(_factory), verbose(v), insert_boundary_segments(i) {}
+
+    std::vector<int> & boundaryIdMap()
+    {
+      return boundary_id_to_physical_entity;
+    }
+
+    std::vector<int> & elementIndexMap()
+    {
+      return element_index_to_physical_entity;
+    }
+
+    void read (const std::string& f)
+    {
+      if (verbose) std::cout << "Reading " << dim << "d Gmsh grid..." << std::endl;
+
+      // map the whole file into memory
+      fileName = f;
+      const MappedFile file(fileName);
+      file_begin = file_pos = file.begin();
+      file_end = file.end();
+
+      //=========================================
+      // Header: Read vertices into vector
+      //         Check vertices that are needed
+      //=========================================
+
+      number_of_real_vertices = 0;
+      boundary_element_count = 0;
+      element_count = 0;
+      global_id.clear();
+
+      const int number_of_nodes = readHeader();
+
+      std::vector<NodeChunk> nodeChunks;
+      readNodes(nodeChunks, number_of_nodes);
+
+      // store the positions in an array indexed by the node id; the
+      // vertex number of a node is -2 if the id does not occur and -1 if
+      // the node is not used by any element
+      int maxId = 0;
+      std::size_t nodesRead = 0;
+      for (std::size_t c = 0; c < nodeChunks.size(); ++c)
+      {
+        nodesRead += nodeChunks[c].id.size();
+        for (std::size_t i = 0; i < nodeChunks[c].id.size(); ++i)
+        {
+          if (nodeChunks[c].id[i] < 0)
+            DUNE_THROW(Dune::IOError, "negative node id " << nodeChunks[c].id[i]
+                                                          << " in " << fileName);
+          maxId = std::max(maxId, nodeChunks[c].id[i]);
+        }
+      }
+      if (nodesRead != std::size_t(number_of_nodes))
+        DUNE_THROW(Dune::IOError, fileName << " contains " << nodesRead
+                                           << " nodes instead of " << number_of_nodes);
+
+      std::vector< GlobalVector > nodes( maxId+1 );
+      std::vector< int > renumber( maxId+1, -2 );
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (long c = 0; c < long(nodeChunks.size()); ++c)
+        for (std::size_t i = 0; i < nodeChunks[c].id.size(); ++i)
+        {
+          const int id = nodeChunks[c].id[i];
+          renumber[ id ] = -1;
+          for( int j = 0; j < dimWorld; ++j )
+            nodes[ id ][ j ] = nodeChunks[c].x[ 3*i+j ];
+        }
+      std::vector<NodeChunk>().swap(nodeChunks);
 
-      readfile(file,nDofs[elm_type], formatString.c_str(),
-               &(elementDofs[0]),&(elementDofs[1]),&(elementDofs[2]),
-               &(elementDofs[3]),&(elementDofs[4]),&(elementDofs[5]),
-               &(elementDofs[6]),&(elementDofs[7]),&(elementDofs[8]),
-               &(elementDofs[9]));
+      // element section
+      const int number_of_elements = readElementHeader();
+      std::vector<ElementChunk> elementChunks;
+      readElements(elementChunks, number_of_elements);
+      if (elementsRead(elementChunks) != std::size_t(number_of_elements))
+        DUNE_THROW(Dune::IOError, fileName << " contains " << elementsRead(elementChunks)
+                                           << " elements instead of " << number_of_elements);
+
+      insertElements(elementChunks, renumber, nodes);
+    }
 
+#if HAVE_MPI
+    /** \brief read the part of this process of a distributed grid
+     *
+     *  Collective operation on all processes of comm.  Each process parses a
+     *  contiguous part of the node and of the element section.  The nodes
+     *  needed by the elements of a process are requested from the processes
+     *  which have parsed them, and each boundary segment is passed to the
+     *  process which owns the element it belongs to.  The vertices are
+     *  inserted into the factory with their node id as global id, see
+     *  GridFactoryInterface::insertDistributedVertex().
+     *
+     *  \note The node ids have to be increasing within the node section,
+     *        as written by Gmsh, but need not be contiguous.
+     */
+    void readDistributed (const std::string& f, MPI_Comm comm)
+    {
+      int rank, size;
+      MPI_Comm_rank(comm, &rank);
+      MPI_Comm_size(comm, &size);
+      verbose = verbose && (rank == 0);
+      if (verbose) std::cout << "Reading " << dim << "d Gmsh grid on " << size << " processes..." << std::endl;
+
+      // map the whole file into memory, only the parts parsed here are read
+      fileName = f;
+      const MappedFile file(fileName);
+      file_begin = file_pos = file.begin();
+      file_end = file.end();
+
+      number_of_real_vertices = 0;
+      boundary_element_count = 0;
+      element_count = 0;
+      global_id.clear();
+
+      std::string error;
+      const int number_of_nodes = readHeader();
+
+      // each process parses a contiguous part of the node section
+      std::vector<NodeChunk> nodeChunks;
+      if (binary)
+      {
+        checkBinarySize(number_of_nodes * nodeRecordSize());
+        const long first = long(number_of_nodes) * rank / size;
+        const long last = long(number_of_nodes) * (rank+1) / size;
+        nodeChunks.resize(1);
+        decodeNodes(file_pos, first, last - first, nodeChunks[0]);
+        file_pos += number_of_nodes * nodeRecordSize();
+      }
+      else
+      {
+        const char* sectionEnd = findMarker("$EndNodes", comm);
+        const std::vector<const char*> bounds = splitLines(file_pos, sectionEnd, size);
+        try {
+          parseNodeLines(bounds[rank], bounds[rank+1], nodeChunks);
+        } catch (Dune::Exception& e) {
+          error = e.what();
+        }
+        checkAll(comm, error);
+        file_pos = sectionEnd;
+      }
+      expect("$EndNodes");
+
+      // each process parses a contiguous part of the element section
+      const int number_of_elements = readElementHeader();
+      std::vector<ElementChunk> elementChunks;
+      if (binary)
+      {
+        std::vector<ElementBlock> blocks;
+        readElementBlocks(blocks, number_of_elements);
+        const long first = long(number_of_elements) * rank / size;
+        const long last = long(number_of_elements) * (rank+1) / size;
+        long offset = 0;
+        for (std::size_t b = 0; b < blocks.size(); ++b)
+        {
+          const long begin = std::max(first, offset);
+          const long end = std::min(last, offset + blocks[b].number_of_following);
+          if (begin < end)
+          {
+            elementChunks.push_back(ElementChunk());
+            decodeElements(blocks[b], begin - offset, end - begin, elementChunks.back());
+          }
+          offset += blocks[b].number_of_following;
+        }
+      }
+      else
+      {
+        const char* sectionEnd = findMarker("$EndElements", comm);
+        const std::vector<const char*> bounds = splitLines(file_pos, sectionEnd, size);
+        try {
+          parseElementLines(bounds[rank], bounds[rank+1], elementChunks);
+        } catch (Dune::Exception& e) {
+          error = e.what();
+        }
+        checkAll(comm, error);
+        file_pos = sectionEnd;
+      }
+      expect("$EndElements");
+      long elements_read = elementsRead(elementChunks);
+      MPI_Allreduce(MPI_IN_PLACE, &elements_read, 1, MPI_LONG, MPI_SUM, comm);
+      if (elements_read != number_of_elements)
+        DUNE_THROW(Dune::IOError, fileName << " contains " << elements_read
+                                           << " elements instead of " << number_of_elements);
+
+      // the node ids parsed here, which have to increase through the file
+      // but may have gaps
+      std::vector<int> ownedIds;
+      for (std::size_t c = 0; c < nodeChunks.size(); ++c)
+        for (std::size_t i = 0; i < nodeChunks[c].id.size(); ++i)
+        {
+          const int id = nodeChunks[c].id[i];
+          if (id < 0)
+            error = "negative node id in " + fileName;
+          else if (!ownedIds.empty() && id <= ownedIds.back())
+            error = "distributed reading of Gmsh files requires increasing "
+                    "node ids, which " + fileName + " does not have";
+          ownedIds.push_back(id);
+        }
+      checkAll(comm, error);
+
+      // the ranges of node ids parsed by the processes
+      int range[ 2 ] = { std::numeric_limits<int>::max(), -1 };
+      if (!ownedIds.empty())
+      {
+        range[ 0 ] = ownedIds.front();
+        range[ 1 ] = ownedIds.back();
+      }
+      std::vector<int> ranges(2*size);
+      MPI_Allgather(range, 2, MPI_INT, &ranges[0], 2, MPI_INT, comm);
+      const NodeOwners owners(ranges);
+
+      // positions of the nodes parsed here, in the order of ownedIds
+      std::vector<double> owned;
+      for (std::size_t c = 0; c < nodeChunks.size(); ++c)
+        owned.insert(owned.end(), nodeChunks[c].x.begin(), nodeChunks[c].x.end());
+      std::vector<NodeChunk>().swap(nodeChunks);
+
+      // separate the elements from the boundary segments
+      ElementChunk elements, segments;
+      for (std::size_t c = 0; c < elementChunks.size(); ++c)
+      {
+        const ElementChunk& chunk = elementChunks[c];
+        const int* dofs = chunk.dofs.empty() ? 0 : &chunk.dofs[0];
+        for (std::size_t e = 0; e < chunk.type.size(); ++e)
+        {
+          append(elementDim(chunk.type[e]) == dim ? elements : segments,
+                 chunk.type[e], chunk.physical[e], dofs);
+          dofs += nodeCount(chunk.type[e]);
+        }
+      }
+      std::vector<ElementChunk>().swap(elementChunks);
+
+      // request the vertices of the elements from their owners
+      std::vector<int> needed;
+      std::vector<std::size_t> offsets(elements.type.size());
+      std::vector< std::pair<int, int> > incidence;
+      for (std::size_t e = 0, offset = 0; e < elements.type.size(); ++e)
+      {
+        offsets[e] = offset;
+        for (int i = 0; i < vertexCount(elements.type[e]); ++i)
+        {
+          needed.push_back(elements.dofs[offset+i]);
+          incidence.push_back(std::make_pair(elements.dofs[offset+i], int(e)));
+        }
+        offset += nodeCount(elements.type[e]);
+      }
+      std::sort(needed.begin(), needed.end());
+      needed.erase(std::unique(needed.begin(), needed.end()), needed.end());
+      std::sort(incidence.begin(), incidence.end());
+
+      std::vector< std::vector<int> > requests(size), requested;
+      for (std::size_t i = 0; i < needed.size(); ++i)
+      {
+        const int p = owners.find(needed[i]);
+        if (p < 0)
+        {
+          error = "element refers to unknown node in " + fileName;
+          break;
+        }
+        requests[p].push_back(needed[i]);
+      }
+      checkAll(comm, error);
+      allToAll(comm, requests, requested);
+
+      // the processes using each node parsed here, sorted by id
+      std::vector< std::pair<int, int> > users;
+      for (int p = 0; p < size; ++p)
+        for (std::size_t i = 0; i < requested[p].size(); ++i)
+          users.push_back(std::make_pair(requested[p][i], p));
+      std::sort(users.begin(), users.end());
+
+      // send the boundary segments to the owner of their first node, which
+      // forwards them to all processes using that node
+      std::vector< std::vector<int> > segmentsOut(size), segmentsIn;
+      for (std::size_t s = 0, offset = 0; s < segments.type.size(); ++s)
+      {
+        const int p = owners.find(segments.dofs[offset]);
+        if (p < 0)
+        {
+          error = "boundary segment refers to unknown node in " + fileName;
+          break;
+        }
+        segmentsOut[p].push_back(segments.type[s]);
+        segmentsOut[p].push_back(segments.physical[s]);
+        segmentsOut[p].insert(segmentsOut[p].end(), segments.dofs.begin() + offset,
+                              segments.dofs.begin() + offset + nodeCount(segments.type[s]));
+        offset += nodeCount(segments.type[s]);
+      }
+      checkAll(comm, error);
+      segments = ElementChunk();
+      allToAll(comm, segmentsOut, segmentsIn);
+
+      std::vector< std::vector<int> > forward(size), candidates;
+      for (int p = 0; p < size; ++p)
+        for (std::size_t i = 0; i < segmentsIn[p].size(); i += segmentSize(&segmentsIn[p][i]))
+        {
+          const int* record = &segmentsIn[p][i];
+          typedef std::vector< std::pair<int, int> >::const_iterator Iterator;
+          Iterator it = std::lower_bound(users.begin(), users.end(), std::make_pair(record[2], 0));
+          for (; it != users.end() && it->first == record[2]; ++it)
+            forward[it->second].insert(forward[it->second].end(), record, record + segmentSize(record));
+        }
+      allToAll(comm, forward, candidates);
+
+      // keep the segments which are a face of a local element
+      for (int p = 0; p < size; ++p)
+        for (std::size_t i = 0; i < candidates[p].size(); i += segmentSize(&candidates[p][i]))
+        {
+          const int* record = &candidates[p][i];
+          if (containsSegment(incidence, elements, offsets, record[0], record + 2))
+            append(segments, record[0], record[1], record + 2);
+        }
+
+      // request the remaining nodes of the segments, e.g. the midpoints of
+      // quadratic segments
+      std::vector<int> extra;
+      for (std::size_t i = 0; i < segments.dofs.size(); ++i)
+        if (!std::binary_search(needed.begin(), needed.end(), segments.dofs[i]))
+          extra.push_back(segments.dofs[i]);
+      std::sort(extra.begin(), extra.end());
+      extra.erase(std::unique(extra.begin(), extra.end()), extra.end());
+
+      std::vector< std::vector<int> > extraRequests(size), extraRequested;
+      for (std::size_t i = 0; i < extra.size(); ++i)
+      {
+        const int p = owners.find(extra[i]);
+        if (p < 0)
+        {
+          error = "boundary segment refers to unknown node in " + fileName;
+          break;
+        }
+        extraRequests[p].push_back(extra[i]);
+      }
+      checkAll(comm, error);
+      allToAll(comm, extraRequests, extraRequested);
+
+      // send the positions of the requested nodes; a node may be missing
+      // even if its id is in the range of the owner
+      std::vector< std::vector<double> > positionsOut(size), positionsIn;
+      for (int p = 0; p < size && error.empty(); ++p)
+      {
+        requested[p].insert(requested[p].end(), extraRequested[p].begin(), extraRequested[p].end());
+        for (std::size_t i = 0; i < requested[p].size(); ++i)
+        {
+          const std::size_t k =
+            std::lower_bound(ownedIds.begin(), ownedIds.end(), requested[p][i]) - ownedIds.begin();
+          if (k == ownedIds.size() || ownedIds[k] != requested[p][i])
+          {
+            error = "element refers to unknown node in " + fileName;
+            break;
+          }
+          positionsOut[p].insert(positionsOut[p].end(), &owned[3*k], &owned[3*k] + 3);
+        }
+      }
+      checkAll(comm, error);
+      allToAll(comm, positionsOut, positionsIn);
+
+      // number all nodes used here consecutively in the order of their ids
+      std::vector< std::pair<int, const double*> > received;
+      for (int p = 0; p < size; ++p)
+      {
+        requests[p].insert(requests[p].end(), extraRequests[p].begin(), extraRequests[p].end());
+        for (std::size_t i = 0; i < requests[p].size(); ++i)
+          received.push_back(std::make_pair(requests[p][i], &positionsIn[p][3*i]));
+      }
+      std::sort(received.begin(), received.end());
+      std::vector< GlobalVector > nodes(received.size());
+      global_id.resize(received.size());
+      for (std::size_t i = 0; i < received.size(); ++i)
+      {
+        global_id[i] = received[i].first;
+        for( int j = 0; j < dimWorld; ++j )
+          nodes[ i ][ j ] = received[i].second[ j ];
+      }
+      for (std::size_t i = 0; i < elements.dofs.size(); ++i)
+        elements.dofs[i] = std::lower_bound(global_id.begin(), global_id.end(), elements.dofs[i]) - global_id.begin();
+      for (std::size_t i = 0; i < segments.dofs.size(); ++i)
+        segments.dofs[i] = std::lower_bound(global_id.begin(), global_id.end(), segments.dofs[i]) - global_id.begin();
+
+      std::vector<ElementChunk> chunks(2);
+      std::swap(chunks[0], elements);
+      std::swap(chunks[1], segments);
+      std::vector<int> renumber(nodes.size(), -1);
+      insertElements(chunks, renumber, nodes);
+      global_id.clear();
+    }
+#endif // #if HAVE_MPI
+
+    // dimension dependent routines
+    void pass1HandleElement(const int elm_type, const int* elementDofs,
+                            std::vector<int> & renumber,
+                            const std::vector< GlobalVector > & nodes)
+    {
       // insert each vertex if it hasn't been inserted already
-      for (int i=0; i<nVertices[elm_type]; i++)
-        if (renumber.find(elementDofs[i])==renumber.end())
+      for (int i=0; i<vertexCount(elm_type); i++)
+      {
+        const int id = elementDofs[i];
+        if (id < 0 || id >= int(renumber.size()) || renumber[id] == -2)
+          DUNE_THROW(Dune::IOError, "element refers to unknown node " << id
+                                                                      << " in " << fileName);
+        if (renumber[id] == -1)
         {
-          renumber[elementDofs[i]] = number_of_real_vertices++;
-          factory.insertVertex(nodes[elementDofs[i]]);
+          renumber[id] = number_of_real_vertices++;
+          if (global_id.empty())
+            factory.insertVertex(nodes[id]);
+          else
+          {
+            factory.insertDistributedVertex(nodes[id], global_id[id]);
+          }
         }
+      }
 
       // count elements and boundary elements
-      if (elementDim[elm_type] == dim)
+      if (elementDim(elm_type) == dim)
         element_count++;
       else
         boundary_element_count++;
@@ -502,38 +1357,15 @@ namespace Dune
 
 
 
-    virtual void pass2HandleElement(FILE* file, const int elm_type,
-                                    std::map<int,unsigned int> & renumber,
+    virtual void pass2HandleElement(const int elm_type, const int* dofs,
+                                    const std::vector<int> & renumber,
                                     const std::vector< GlobalVector > & nodes,
                                     const int physical_entity)
     {
-      // some data about gmsh elements
-      const int nDofs[12]      = {-1, 2, 3, 4, 4, 8, 6, 5, 3, 6, -1, 10};
-      const int nVertices[12]  = {-1, 2, 3, 4, 4, 8, 6, 5, 2, 3, -1, 4};
-      const int elementDim[12] = {-1, 1, 2, 2, 3, 3, 3, 3, 1, 2, -1, 3};
-
-      // test whether we support the element type
-      if ( not (elm_type >= 0 && elm_type < 12         // index in suitable range?
-                && (elementDim[elm_type] == dim || elementDim[elm_type] == (dim-1) ) ) )         // real element or boundary element?
-      {
-        skipline(file);         // skip rest of line if element is unknown
-        return;
-      }
-
-      // The format string for parsing is n times '%d' in a row
-      std::string formatString = "%d";
-      for (int i=1; i<nDofs[elm_type]; i++)
-        formatString += " %d";
-      formatString += "\n";
-
       // '10' is the largest number of dofs we may encounter in a .msh file
-      std::vector<int> elementDofs(10);
-
-      readfile(file,nDofs[elm_type], formatString.c_str(),
-               &(elementDofs[0]),&(elementDofs[1]),&(elementDofs[2]),
-               &(elementDofs[3]),&(elementDofs[4]),&(elementDofs[5]),
-               &(elementDofs[6]),&(elementDofs[7]),&(elementDofs[8]),
-               &(elementDofs[9]));
+      array<int, 10> elementDofs;
+      for (int i=0; i<nodeCount(elm_type); i++)
+        elementDofs[i] = dofs[i];
 
       // correct differences between gmsh and Dune in the local vertex numbering
       switch (elm_type)
@@ -552,13 +1384,13 @@ namespace Dune
 
       // renumber corners to account for the explicitly given vertex
       // numbering in the file
-      std::vector<unsigned int> vertices(nVertices[elm_type]);
+      std::vector<unsigned int> vertices(vertexCount(elm_type));
 
-      for (int i=0; i<nVertices[elm_type]; i++)
+      for (int i=0; i<vertexCount(elm_type); i++)
         vertices[i] = renumber[elementDofs[i]];
 
       // If it is an element, insert it as such
-      if (elementDim[elm_type] == dim) {
+      if (elementDim(elm_type) == dim) {
 
         switch (elm_type)
         {
@@ -629,7 +1461,7 @@ namespace Dune
       }
 
       // count elements and boundary elements
-      if (elementDim[elm_type] == dim) {
+      if (elementDim(elm_type) == dim) {
         element_index_to_physical_entity[element_count] = physical_entity;
         element_count++;
       } else {
@@ -656,6 +1488,9 @@ namespace Dune
      All grids in a gmsh file live in three-dimensional Euclidean space.  If the world dimension
      of the grid type that you are reading the file into is less than three, the remaining coordinates
      are simply ignored.
+
+     Files in the ASCII and in the binary variant of the format version 2 can be read.  Binary files
+     written on a machine with a different byte order are converted.
    */
   template<typename GridType>
   class GmshReader
@@ -718,6 +1553,48 @@ namespace Dune
       boundary_id_to_physical_entity.swap(parser.boundaryIdMap());
       element_index_to_physical_entity.swap(parser.elementIndexMap());
     }
+
+#if HAVE_MPI
+    /** \brief read the part of this process of a distributed grid
+     *
+     *  Collective operation on all processes of comm.  Each process reads
+     *  only a part of the file and inserts the elements of its part, the
+     *  vertices of these elements and the boundary segments on their faces
+     *  into its factory.  The vertices are inserted with the Gmsh node id as
+     *  global id, so the factory has to support distributed grid creation,
+     *  see GridFactoryInterface::insertDistributedVertex().
+     *
+     *  The node ids have to be increasing within the node section, as in all
+     *  files written by Gmsh, but need not be contiguous.
+     */
+    static void readDistributed (Dune::GridFactory<Grid>& factory,
+                                 const std::string& fileName, MPI_Comm comm,
+                                 bool verbose = true, bool insert_boundary_segments=true)
+    {
+      // create parse object
+      GmshReaderParser<Grid> parser(factory,verbose,insert_boundary_segments);
+      parser.readDistributed(fileName, comm);
+    }
+
+    /** \brief read the part of this process of a distributed grid
+     *
+     *  As above, the physical entities are those of the boundary segments
+     *  and elements inserted on this process.
+     */
+    static void readDistributed (Dune::GridFactory<Grid>& factory,
+                                 const std::string& fileName, MPI_Comm comm,
+                                 std::vector<int>& boundary_id_to_physical_entity,
+                                 std::vector<int>& element_index_to_physical_entity,
+                                 bool verbose = true, bool insert_boundary_segments=true)
+    {
+      // create parse object
+      GmshReaderParser<Grid> parser(factory,verbose,insert_boundary_segments);
+      parser.readDistributed(fileName, comm);
+
+      boundary_id_to_physical_entity.swap(parser.boundaryIdMap());
+      element_index_to_physical_entity.swap(parser.elementIndexMap());
+    }
+#endif // #if HAVE_MPI
   };
 
   /** \} */
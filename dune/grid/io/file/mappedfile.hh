@@ -0,0 +1,115 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_GRID_IO_FILE_MAPPEDFILE_HH
+#define DUNE_GRID_IO_FILE_MAPPEDFILE_HH
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DUNE_GRID_HAVE_MMAP 1
+#endif
+
+#include <dune/common/exceptions.hh>
+
+/** @file
+    @brief Provides read-only access to the whole contents of a file
+ */
+
+namespace Dune
+{
+
+  /** \brief Read-only view of the contents of a file
+   *
+   * On POSIX systems the file is mapped into memory, so the pages are read
+   * on demand by the operating system and may be parsed by several threads
+   * at once without copying.  Elsewhere, or if the file cannot be mapped,
+   * the contents are read into a buffer.
+   *
+   * The contents are not terminated by a null character.
+   */
+  class MappedFile
+  {
+  public:
+    /** \brief Map the given file
+     *
+     * \throw IOError The file cannot be opened.
+     */
+    explicit MappedFile ( const std::string &fileName )
+      : data_(0), size_(0), mapped_(false)
+    {
+#if DUNE_GRID_HAVE_MMAP
+      const int fd = ::open(fileName.c_str(), O_RDONLY);
+      if (fd < 0)
+        DUNE_THROW(IOError, "Could not open " << fileName);
+      struct stat st;
+      if (::fstat(fd, &st) != 0)
+      {
+        ::close(fd);
+        DUNE_THROW(IOError, "Could not determine the size of " << fileName);
+      }
+      const bool empty = (st.st_size == 0);
+      if (!empty)
+      {
+        void *p = ::mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+          data_ = static_cast< const char * >(p);
+          size_ = st.st_size;
+          mapped_ = true;
+        }
+      }
+      ::close(fd);
+      if (mapped_ || empty)
+        return;
+#endif
+      std::ifstream file(fileName.c_str(), std::ios::binary);
+      if (!file)
+        DUNE_THROW(IOError, "Could not open " << fileName);
+      file.seekg(0, std::ios::end);
+      buffer_.resize(std::size_t(file.tellg()));
+      file.seekg(0, std::ios::beg);
+      if (!buffer_.empty())
+        file.read(&buffer_[0], buffer_.size());
+      if (!file)
+        DUNE_THROW(IOError, "Could not read " << fileName);
+      data_ = buffer_.empty() ? 0 : &buffer_[0];
+      size_ = buffer_.size();
+    }
+
+    ~MappedFile ()
+    {
+#if DUNE_GRID_HAVE_MMAP
+      if (mapped_)
+        ::munmap(const_cast< char * >(data_), size_);
+#endif
+    }
+
+    //! first character of the file
+    const char *begin () const { return data_; }
+    //! one past the last character of the file
+    const char *end () const { return data_ + size_; }
+    //! size of the file in bytes
+    std::size_t size () const { return size_; }
+
+  private:
+    // not copyable, the mapping is owned by this object
+    MappedFile ( const MappedFile & );
+    MappedFile &operator= ( const MappedFile & );
+
+    const char *data_;
+    std::size_t size_;
+    bool mapped_;
+    std::vector< char > buffer_;
+  };
+
+} // namespace Dune
+
+#endif // DUNE_GRID_IO_FILE_MAPPEDFILE_HH
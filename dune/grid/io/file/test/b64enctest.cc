@@ -0,0 +1,116 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#if HAVE_CONFIG_H
+#include "config.h" // autoconf defines, needed by the dune headers
+#endif
+
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/grid/io/file/vtk/b64enc.hh>
+#include <dune/grid/io/file/vtk/streams.hh>
+
+// straightforward bitwise encoder as reference
+std::string referenceEncode(const std::string& in)
+{
+  std::string out;
+  unsigned bits = 0;
+  int nbits = 0;
+  for (std::size_t i = 0; i < in.size(); ++i)
+  {
+    bits = (bits << 8) | (unsigned char)in[i];
+    nbits += 8;
+    while (nbits >= 6)
+    {
+      nbits -= 6;
+      out += Dune::base64table[(bits >> nbits) & 63];
+    }
+  }
+  if (nbits > 0)
+    out += Dune::base64table[(bits << (6-nbits)) & 63];
+  while (out.size() % 4 != 0)
+    out += '=';
+  return out;
+}
+
+std::string encode(const std::string& in)
+{
+  std::vector<char> out((in.size()+2)/3*4 + 1);
+  const std::size_t n = Dune::base64Encode(in.data(), in.size(), &out[0]);
+  return std::string(&out[0], n);
+}
+
+int check(const std::string& what, const std::string& in,
+          const std::string& result, const std::string& expected)
+{
+  if (result == expected)
+    return 0;
+  std::cerr << what << " of " << in.size() << " bytes yields \"" << result
+            << "\" instead of \"" << expected << "\"" << std::endl;
+  return 1;
+}
+
+int main()
+{
+  int result = 0;
+
+  // test vectors of RFC 4648, section 10
+  const char* rfc[][2] = {
+    { "", "" },
+    { "f", "Zg==" },
+    { "fo", "Zm8=" },
+    { "foo", "Zm9v" },
+    { "foob", "Zm9vYg==" },
+    { "fooba", "Zm9vYmE=" },
+    { "foobar", "Zm9vYmFy" }
+  };
+  for (int i = 0; i < 7; ++i)
+  {
+    result += check("RFC 4648 encoder", rfc[i][0], encode(rfc[i][0]), rfc[i][1]);
+    result += check("RFC 4648 reference", rfc[i][0], referenceEncode(rfc[i][0]), rfc[i][1]);
+  }
+
+  // all lengths from 0 to 50 bytes, i.e. all three padding cases with and
+  // without the 12 byte blocks of the SSSE3 path, at all alignments
+  // relative to a 16 byte boundary
+  std::string data(16+50, 0);
+  for (std::size_t i = 0; i < data.size(); ++i)
+    data[i] = char(37*i + 11);
+  for (std::size_t offset = 0; offset < 16; ++offset)
+    for (std::size_t n = 0; n <= 50; ++n)
+    {
+      const std::string in = data.substr(offset, n);
+      result += check("base64Encode", in, encode(in), referenceEncode(in));
+    }
+
+  // all byte values, so that every character of the table is produced
+  std::string bytes(256*3, 0);
+  for (std::size_t i = 0; i < bytes.size(); ++i)
+    bytes[i] = char(i % 256 ^ (i / 256) * 85);
+  result += check("base64Encode", bytes, encode(bytes), referenceEncode(bytes));
+
+  // Base64Stream splits the input into blocks and encodes arrays directly
+  const std::size_t sizes[] = { 1, 2, 3, 50, Dune::Base64Stream::blockBytes - 1,
+                                Dune::Base64Stream::blockBytes + 1,
+                                3*Dune::Base64Stream::blockBytes + 2 };
+  for (int i = 0; i < 7; ++i)
+  {
+    std::string in(sizes[i], 0);
+    for (std::size_t j = 0; j < in.size(); ++j)
+      in[j] = char(j*j + 3*j);
+    std::ostringstream s;
+    {
+      Dune::Base64Stream b64(s);
+      // a single item first, so the array does not start on a triple
+      b64.write(in[0]);
+      b64.write(in.data()+1, in.size()-1);
+    }
+    result += check("Base64Stream", in, s.str(), referenceEncode(in));
+  }
+
+  return result > 0 ? 1 : 0;
+}
@@ -0,0 +1,186 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#if HAVE_CONFIG_H
+#include "config.h" // autoconf defines, needed by the dune headers
+#endif
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/onedgrid.hh>
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/io/file/checkpoint.hh>
+#include <dune/grid/utility/persistentcontainer.hh>
+
+// store the center of each element and the sum of the coordinates of each
+// vertex, so the restored values can be compared with the restored geometry
+template<class Grid>
+void fillData(const Grid& grid,
+              Dune::PersistentContainer<Grid, double>& cellData,
+              Dune::PersistentContainer<Grid, double>& vertexData)
+{
+  const int dim = Grid::dimension;
+  for (int level = 0; level <= grid.maxLevel(); ++level)
+  {
+    typedef typename Grid::template Codim<0>::LevelIterator Iterator;
+    const Iterator end = grid.template lend<0>(level);
+    for (Iterator it = grid.template lbegin<0>(level); it != end; ++it)
+    {
+      cellData[*it] = it->geometry().center()[0];
+      for (int i = 0; i < it->template count<dim>(); ++i)
+      {
+        const Dune::FieldVector<double, Grid::dimensionworld> x = it->geometry().corner(i);
+        double sum = 0;
+        for (int j = 0; j < Grid::dimensionworld; ++j)
+          sum += x[j];
+        vertexData(*it, i) = sum;
+      }
+    }
+  }
+}
+
+// compare the hierarchy and the data of a restored grid with the original one
+template<class Grid>
+int compare(const std::string& name, const Grid& grid, const Grid& restored,
+            Dune::CheckpointReader<Grid>& reader)
+{
+  int result = 0;
+  if (restored.maxLevel() != grid.maxLevel())
+  {
+    std::cerr << name << ": restored " << restored.maxLevel()
+              << " levels instead of " << grid.maxLevel() << std::endl;
+    return 1;
+  }
+  for (int level = 0; level <= grid.maxLevel(); ++level)
+  {
+    if (restored.size(level, 0) != grid.size(level, 0))
+    {
+      std::cerr << name << ": level " << level << " has "
+                << restored.size(level, 0) << " elements instead of "
+                << grid.size(level, 0) << std::endl;
+      result = 1;
+    }
+  }
+  if (restored.size(0) != grid.size(0))
+  {
+    std::cerr << name << ": restored " << restored.size(0)
+              << " leaf elements instead of " << grid.size(0) << std::endl;
+    result = 1;
+  }
+
+  Dune::PersistentContainer<Grid, double> cellData(restored, 0);
+  Dune::PersistentContainer<Grid, double> vertexData(restored, Grid::dimension);
+  reader.getData("center", cellData);
+  reader.getData("coordinates", vertexData);
+
+  Dune::PersistentContainer<Grid, double> cellCheck(restored, 0);
+  Dune::PersistentContainer<Grid, double> vertexCheck(restored, Grid::dimension);
+  fillData(restored, cellCheck, vertexCheck);
+
+  typedef typename Dune::PersistentContainer<Grid, double>::ConstIterator Iterator;
+  for (Iterator it = cellData.begin(), check = cellCheck.begin(); it != cellData.end(); ++it, ++check)
+  {
+    if (*it != *check)
+    {
+      std::cerr << name << ": wrong cell data " << *it << " != " << *check << std::endl;
+      result = 1;
+    }
+  }
+  for (Iterator it = vertexData.begin(), check = vertexCheck.begin(); it != vertexData.end(); ++it, ++check)
+  {
+    if (*it != *check)
+    {
+      std::cerr << name << ": wrong vertex data " << *it << " != " << *check << std::endl;
+      result = 1;
+    }
+  }
+  return result;
+}
+
+template<class Grid>
+void writeCheckpoint(const Grid& grid, std::ostream& stream)
+{
+  Dune::PersistentContainer<Grid, double> cellData(grid, 0);
+  Dune::PersistentContainer<Grid, double> vertexData(grid, Grid::dimension);
+  fillData(grid, cellData, vertexData);
+
+  Dune::CheckpointWriter<Grid> writer(grid);
+  writer.addData("center", cellData);
+  writer.addData("coordinates", vertexData);
+  writer.write(stream);
+}
+
+// locally refined OneDGrid, restored through its grid factory
+int checkOneDGrid()
+{
+  typedef Dune::OneDGrid Grid;
+  Grid grid(16, 0.0, 1.0);
+  for (int i = 0; i < 4; ++i)
+  {
+    typedef Grid::Codim<0>::LeafIterator Iterator;
+    for (Iterator it = grid.leafbegin<0>(); it != grid.leafend<0>(); ++it)
+      if (it->geometry().center()[0] < 0.5 / (i+1))
+        grid.mark(1, *it);
+    grid.preAdapt();
+    grid.adapt();
+    grid.postAdapt();
+  }
+
+  std::stringstream stream;
+  writeCheckpoint(grid, stream);
+
+  Dune::CheckpointReader<Grid> reader(stream);
+  if (!reader.hasData("center") || reader.hasData("nonexisting"))
+  {
+    std::cerr << "OneDGrid: wrong data sets" << std::endl;
+    return 1;
+  }
+  Grid* restored = reader.createGrid();
+  const int result = compare("OneDGrid", grid, *restored, reader);
+  delete restored;
+  return result;
+}
+
+// globally refined YaspGrid, restored on a macro grid created by the caller
+int checkYaspGrid()
+{
+  typedef Dune::YaspGrid<2> Grid;
+  Dune::FieldVector<double, 2> L(1.0);
+  Dune::FieldVector<int, 2> s(4);
+  Dune::FieldVector<bool, 2> periodic(false);
+  Grid grid(L, s, periodic, 0);
+  grid.globalRefine(2);
+
+  std::stringstream stream;
+  writeCheckpoint(grid, stream);
+
+  Dune::CheckpointReader<Grid> reader(stream);
+  Grid restored(L, s, periodic, 0);
+  reader.refine(restored);
+  return compare("YaspGrid", grid, restored, reader);
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper::instance(argc, argv);
+
+    int result = 0;
+    result += checkOneDGrid();
+    result += checkYaspGrid();
+    return result > 0 ? 1 : 0;
+
+  } catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+}
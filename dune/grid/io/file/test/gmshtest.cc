@@ -4,6 +4,10 @@
 #include "config.h"
 #define DISABLE_DEPRECATED_METHOD_CHECK 1
 
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
 #include <dune/common/parallel/mpihelper.hh>
 
 // dune grid includes
@@ -73,6 +77,139 @@ void testReadingGrid( const std::string& filename, int refinements )
   vtkWriter.write( vtkName.str() );
 }
 
+#if HAVE_MPI
+// a grid which is never created; its factory records what the reader
+// inserts, so that sequential and distributed reading can be compared
+// without a grid supporting distributed creation
+template< int dim >
+struct RecordingGrid
+{
+  enum { dimension = dim, dimensionworld = dim };
+  typedef double ctype;
+
+  template< int codim >
+  struct Codim
+  {
+    typedef int Entity;
+  };
+};
+
+namespace Dune
+{
+  template< int dim >
+  class GridFactory< RecordingGrid< dim > >
+    : public GridFactoryInterface< RecordingGrid< dim > >
+  {
+    typedef FieldVector< double, dim > Vertex;
+
+  public:
+    GridFactory ()
+      : elements( 0 ), boundarySegments( 0 )
+    {}
+
+    virtual void insertVertex ( const Vertex &pos )
+    {
+      globalIds.push_back( globalIds.size() );
+    }
+
+    virtual void insertDistributedVertex ( const Vertex &pos, const std::size_t globalId )
+    {
+      globalIds.push_back( globalId );
+    }
+
+    virtual void insertElement ( const GeometryType &type, const std::vector< unsigned int > &vertices )
+    {
+      ++elements;
+    }
+
+    virtual void insertBoundarySegment ( const std::vector< unsigned int > &vertices )
+    {
+      ++boundarySegments;
+    }
+
+    virtual void insertBoundarySegment ( const std::vector< unsigned int > &vertices,
+                                         const shared_ptr< BoundarySegment< dim, dim > > &boundarySegment )
+    {
+      ++boundarySegments;
+    }
+
+    virtual RecordingGrid< dim > *createGrid ()
+    {
+      return 0;
+    }
+
+    std::vector< unsigned long > globalIds;
+    long elements;
+    long boundarySegments;
+  };
+}
+
+// read a file sequentially and distributed on the processes of comm, the
+// global numbers of elements, vertices and boundary segments have to agree
+template< int dim >
+int testReadingDistributed ( const std::string &filename, MPI_Comm comm )
+{
+  typedef RecordingGrid< dim > Grid;
+  GridFactory< Grid > sequential, distributed;
+  GmshReader< Grid >::read( sequential, filename, false );
+  GmshReader< Grid >::readDistributed( distributed, filename, comm, false );
+
+  int rank, size;
+  MPI_Comm_rank( comm, &rank );
+  MPI_Comm_size( comm, &size );
+
+  long counts[ 2 ] = { distributed.elements, distributed.boundarySegments };
+  MPI_Allreduce( MPI_IN_PLACE, counts, 2, MPI_LONG, MPI_SUM, comm );
+
+  // vertices shared by several processes are counted once
+  int n = distributed.globalIds.size();
+  std::vector< int > sizes( size ), displs( size, 0 );
+  MPI_Allgather( &n, 1, MPI_INT, &sizes[ 0 ], 1, MPI_INT, comm );
+  for( int p = 1; p < size; ++p )
+    displs[ p ] = displs[ p-1 ] + sizes[ p-1 ];
+  std::vector< unsigned long > ids( displs.back() + sizes.back() + 1 );
+  distributed.globalIds.push_back( 0 );
+  MPI_Allgatherv( &distributed.globalIds[ 0 ], n, MPI_UNSIGNED_LONG,
+                  &ids[ 0 ], &sizes[ 0 ], &displs[ 0 ], MPI_UNSIGNED_LONG, comm );
+  ids.pop_back();
+  std::sort( ids.begin(), ids.end() );
+  const long vertices = std::unique( ids.begin(), ids.end() ) - ids.begin();
+
+  if( counts[ 0 ] == sequential.elements && vertices == long( sequential.globalIds.size() )
+      && counts[ 1 ] == sequential.boundarySegments )
+    return 0;
+  if( rank == 0 )
+    std::cerr << filename << " read on " << size << " processes: "
+              << counts[ 0 ] << " elements, " << vertices << " vertices and "
+              << counts[ 1 ] << " boundary segments instead of "
+              << sequential.elements << ", " << sequential.globalIds.size()
+              << " and " << sequential.boundarySegments << std::endl;
+  return 1;
+}
+
+// two triangles and a quadrilateral with node ids which are increasing, but
+// not contiguous
+void writeGappedFile ( const std::string &filename )
+{
+  std::ofstream file( filename.c_str() );
+  file << "$MeshFormat\n2.2 0 8\n$EndMeshFormat\n"
+       << "$Nodes\n6\n"
+       << "3 0 0 0\n7 1 0 0\n8 2 0 0\n20 0 1 0\n21 1 1 0\n40 2 1 0\n"
+       << "$EndNodes\n"
+       << "$Elements\n9\n"
+       << "1 1 2 1 1 3 7\n"
+       << "2 1 2 1 1 7 8\n"
+       << "3 1 2 1 1 8 40\n"
+       << "4 1 2 1 1 40 21\n"
+       << "5 1 2 1 1 21 20\n"
+       << "6 1 2 1 1 20 3\n"
+       << "7 2 2 2 2 3 7 20\n"
+       << "8 2 2 2 2 7 21 20\n"
+       << "9 3 2 2 2 7 8 40 21\n"
+       << "$EndElements\n";
+}
+#endif // #if HAVE_MPI
+
 int main( int argc, char** argv )
 try
 {
@@ -90,6 +227,31 @@ try
   std::string pyramid(  path ); pyramid  += "pyramid.msh";
   std::string pyr2nd(   path ); pyr2nd   += "pyramid2ndorder.msh";
 
+  int result = 0;
+#if HAVE_MPI
+  // distributed reading on a single process and on all processes
+  std::cout << "reading distributed" << std::endl;
+  const Dune::MPIHelper &mpiHelper = Dune::MPIHelper::instance( argc, argv );
+  if( mpiHelper.rank() == 0 )
+    writeGappedFile( "gmshtest-gapped-ids.msh" );
+  MPI_Barrier( mpiHelper.getCommunicator() );
+  const MPI_Comm comms[ 2 ] = { MPI_COMM_SELF, mpiHelper.getCommunicator() };
+  for( int c = 0; c < 2; ++c )
+  {
+    result += testReadingDistributed< 1 >( path + "oned-testgrid.msh", comms[ c ] );
+    result += testReadingDistributed< 1 >( path + "oned-testgrid-binary.msh", comms[ c ] );
+    result += testReadingDistributed< 2 >( path + "hybrid-testgrid-2d.msh", comms[ c ] );
+    result += testReadingDistributed< 2 >( path + "hybrid-testgrid-2d-binary.msh", comms[ c ] );
+    result += testReadingDistributed< 2 >( circ2nd, comms[ c ] );
+    result += testReadingDistributed< 3 >( path + "hybrid-testgrid-3d.msh", comms[ c ] );
+    result += testReadingDistributed< 2 >( "gmshtest-gapped-ids.msh", comms[ c ] );
+  }
+
+  // the grids below are read on each process, which is tested sequentially
+  if( mpiHelper.size() > 1 )
+    return result > 0 ? 1 : 0;
+#endif // #if HAVE_MPI
+
   // test reading of unstructured grids
 #if HAVE_UG
   std::cout << "reading UGGrid<2>" << std::endl;
@@ -104,6 +266,9 @@ try
   std::cout << "reading hybrid UGGrid<2>" << std::endl;
   testReadingGrid<UGGrid<2> >( path + "hybrid-testgrid-2d.msh", refinements );
 
+  std::cout << "reading hybrid UGGrid<2> from a binary file" << std::endl;
+  testReadingGrid<UGGrid<2> >( path + "hybrid-testgrid-2d-binary.msh", refinements );
+
   std::cout << "reading UGGrid<3>" << std::endl;
   testReadingGrid<UGGrid<3> >( pyramid, refinements );
 
@@ -138,7 +303,10 @@ try
   std::cout << "reading OneDGrid" << std::endl;
   testReadingGrid<OneDGrid>( path + "oned-testgrid.msh", refinements );
 
-  return 0;
+  std::cout << "reading OneDGrid from a binary file" << std::endl;
+  testReadingGrid<OneDGrid>( path + "oned-testgrid-binary.msh", refinements );
+
+  return result > 0 ? 1 : 0;
 
 }
 catch ( Dune::Exception &e )
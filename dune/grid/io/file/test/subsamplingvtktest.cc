@@ -5,6 +5,7 @@
 #include "config.h" // autoconf defines, needed by the dune headers
 
 // dune headers
+#include <dune/common/exceptions.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
@@ -12,6 +13,9 @@
 #include <dune/grid/yaspgrid.hh>
 
 #include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
 #include <vector>
 #include <unistd.h>
 
@@ -62,8 +66,16 @@ public:
 
 };
 
+std::string readFile( const std::string &fileName )
+{
+  std::ifstream file( fileName.c_str() );
+  return std::string( std::istreambuf_iterator<char>(file),
+                      std::istreambuf_iterator<char>() );
+}
+
 template< class GridView >
-void doWrite( const GridView &gridView, bool coerceToSimplex)
+void doWrite( const GridView &gridView, bool coerceToSimplex,
+              bool parallel = false)
 {
   enum { dim = GridView :: dimension };
 
@@ -71,7 +83,8 @@ void doWrite( const GridView &gridView, bool coerceToSimplex)
   std::vector<int> celldata(is.size(0));
   for(std::size_t i = 0; i < celldata.size(); ++i) celldata[i] = i;
 
-  Dune :: SubsamplingVTKWriter< GridView > vtk( gridView, 1, coerceToSimplex);
+  Dune :: SubsamplingVTKWriter< GridView >
+  vtk( gridView, 1, coerceToSimplex, Dune::VTK::float32, parallel);
   // disabled due to FS#676: vtk.addVertexData(vertexdata,"vertexData");
   vtk.addCellData(celldata,"cellData");
 
@@ -79,10 +92,24 @@ void doWrite( const GridView &gridView, bool coerceToSimplex)
   vtk.addCellData(new VTKVectorFunction<GridView>("cell"));
 
   char name[256];
-  snprintf(name,256,"subsamplingvtktest-%iD-%s-ascii",
-           dim, (coerceToSimplex ? "simplex" : "natural"));
+  snprintf(name,256,"subsamplingvtktest-%iD-%s-ascii%s",
+           dim, (coerceToSimplex ? "simplex" : "natural"),
+           (parallel ? "-parallel" : ""));
   vtk.write(name);
 
+  // the threads must produce the same file as the serial evaluation
+  if(parallel && gridView.comm().size() == 1)
+  {
+    char serialName[256];
+    snprintf(serialName,256,"subsamplingvtktest-%iD-%s-ascii",
+             dim, (coerceToSimplex ? "simplex" : "natural"));
+    if(readFile(std::string(name) + ".vtu")
+       != readFile(std::string(serialName) + ".vtu"))
+      DUNE_THROW(Dune::Exception, "parallel evaluation wrote a different file "
+                 "than the serial evaluation");
+    return;
+  }
+
   snprintf(name,256,"subsamplingvtktest-%iD-%s-appendedraw",
            dim, (coerceToSimplex ? "simplex" : "natural"));
   vtk.write(name, Dune::VTK::appendedraw);
@@ -117,6 +144,9 @@ void vtkCheck(int* n, double* h)
   doWrite( g.leafView(), true);
   doWrite( g.levelView( 0 ), true);
   doWrite( g.levelView( g.maxLevel() ), true);
+
+  doWrite( g.leafView(), false, true);
+  doWrite( g.leafView(), true, true);
 }
 
 int main(int argc, char **argv)
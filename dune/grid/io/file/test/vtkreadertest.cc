@@ -0,0 +1,385 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#if HAVE_CONFIG_H
+#include "config.h" // autoconf defines, needed by the dune headers
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/onedgrid.hh>
+#include <dune/grid/yaspgrid.hh>
+#if HAVE_UG
+#include <dune/grid/uggrid.hh>
+#endif
+#include <dune/grid/io/file/vtk/vtkreader.hh>
+#include <dune/grid/io/file/vtk/vtkwriter.hh>
+
+typedef Dune::OneDGrid Grid;
+typedef Grid::LeafGridView GridView;
+
+const char* VTKDataMode(Dune::VTK::DataMode dm)
+{
+  switch(dm)
+  {
+  case Dune::VTK::conforming :
+    return "conforming";
+  case Dune::VTK::nonconforming :
+    return "nonconforming";
+  }
+  return "";
+}
+
+// read a file written from a grid on [0,1] and compare the data with the
+// coordinates of the entities of the created grid; OneDGrid does not provide
+// insertion indices, so the values are compared as sorted sequences
+int checkFile(const std::string& fileName, int elements, bool mergePoints)
+{
+  Dune::GridFactory<Grid> factory;
+  Dune::VTKReader<Grid> reader(mergePoints);
+  reader.read(factory, fileName);
+  Grid* grid = factory.createGrid();
+  const GridView gridView = grid->leafView();
+
+  int result = 0;
+  if (int(reader.elements()) != elements
+      || int(reader.vertices()) != elements + 1
+      || gridView.size(0) != elements || gridView.size(1) != elements + 1)
+  {
+    std::cerr << fileName << ": read " << reader.elements() << " elements and "
+              << reader.vertices() << " vertices" << std::endl;
+    result = 1;
+  }
+
+  std::vector<double> cellData, vertexData;
+  reader.cellData("center", cellData);
+  reader.pointData("coordinate", vertexData);
+
+  std::vector<double> centers, coordinates;
+  typedef GridView::Codim<0>::Iterator Iterator;
+  for (Iterator it = gridView.begin<0>(); it != gridView.end<0>(); ++it)
+    centers.push_back(it->geometry().center()[0]);
+  typedef GridView::Codim<1>::Iterator VertexIterator;
+  for (VertexIterator it = gridView.begin<1>(); it != gridView.end<1>(); ++it)
+    coordinates.push_back(it->geometry().corner(0)[0]);
+
+  std::sort(cellData.begin(), cellData.end());
+  std::sort(vertexData.begin(), vertexData.end());
+  std::sort(centers.begin(), centers.end());
+  std::sort(coordinates.begin(), coordinates.end());
+  if (cellData.size() != centers.size()
+      || !std::equal(cellData.begin(), cellData.end(), centers.begin()))
+  {
+    std::cerr << fileName << ": wrong cell data" << std::endl;
+    result = 1;
+  }
+  if (vertexData.size() != coordinates.size()
+      || !std::equal(vertexData.begin(), vertexData.end(), coordinates.begin()))
+  {
+    std::cerr << fileName << ": wrong vertex data" << std::endl;
+    result = 1;
+  }
+
+  delete grid;
+  return result;
+}
+
+int doCheck(Dune::VTK::DataMode dm)
+{
+  const int elements = 16;
+  Grid grid(elements, 0.0, 1.0);
+  const GridView gridView = grid.leafView();
+
+  std::vector<double> center(gridView.size(0));
+  std::vector<double> coordinate(gridView.size(1));
+  typedef GridView::Codim<0>::Iterator Iterator;
+  for (Iterator it = gridView.begin<0>(); it != gridView.end<0>(); ++it)
+  {
+    center[gridView.indexSet().index(*it)] = it->geometry().center()[0];
+    for (int i = 0; i < 2; ++i)
+      coordinate[gridView.indexSet().subIndex(*it, i, 1)] =
+        it->geometry().corner(i)[0];
+  }
+
+  Dune::VTKWriter<GridView> vtk(gridView, dm);
+  vtk.addCellData(center, "center", 1, Dune::VTK::float64);
+  vtk.addVertexData(coordinate, "coordinate", 1, Dune::VTK::float64);
+
+  Dune::VTK::OutputType types[] = {
+    Dune::VTK::ascii, Dune::VTK::base64, Dune::VTK::appendedraw,
+    Dune::VTK::appendedbase64
+#if HAVE_ZLIB
+    , Dune::VTK::appendedcompressed
+#endif
+  };
+  const char* typeNames[] = {
+    "ascii", "base64", "appendedraw", "appendedbase64", "appendedcompressed"
+  };
+
+  // nonconforming output contains a copy of each vertex per element
+  const bool merge = (dm == Dune::VTK::nonconforming);
+
+  int result = 0;
+  for (std::size_t t = 0; t < sizeof(types)/sizeof(types[0]); ++t)
+  {
+    char name[256];
+    snprintf(name, 256, "vtkreadertest-%s-%s", VTKDataMode(dm), typeNames[t]);
+    result += checkFile(vtk.write(name, types[t]), elements, merge);
+
+    snprintf(name, 256, "vtkreadertest-%s-%s-parallel", VTKDataMode(dm),
+             typeNames[t]);
+    result += checkFile(vtk.pwrite(name, ".", "", types[t]), elements, merge);
+  }
+  return result;
+}
+
+#if HAVE_UG
+// scalar identifying a point
+template<int dim>
+double pointValue(const Dune::FieldVector<double, dim>& x)
+{
+  double value = 0;
+  for (int i = 0; i < dim; ++i)
+    value += std::pow(10.0, i) * x[i];
+  return value;
+}
+
+// compare the elements and vertices of a UGGrid read from fileName with the
+// expected corners of each element (in Dune numbering); the cell data "id"
+// selects the expected element, the point data "value" has to be
+// pointValue() of the vertex, both are looked up by the insertion index
+template<int dim>
+int checkUGFile(const std::string& fileName,
+                const std::vector<std::vector<Dune::FieldVector<double, dim> > >& expected)
+{
+  typedef Dune::UGGrid<dim> UGrid;
+  typedef typename UGrid::LeafGridView UGridView;
+
+  Dune::GridFactory<UGrid> factory;
+  Dune::VTKReader<UGrid> reader;
+  reader.read(factory, fileName);
+  UGrid* grid = factory.createGrid();
+  const UGridView gridView = grid->leafView();
+
+  std::vector<double> id, value;
+  reader.cellData("id", id);
+  reader.pointData("value", value);
+
+  int result = 0;
+  if (gridView.size(0) != int(expected.size()) || id.size() != expected.size())
+  {
+    std::cerr << fileName << ": read " << gridView.size(0) << " elements and "
+              << id.size() << " ids instead of " << expected.size() << std::endl;
+    result = 1;
+  }
+
+  typedef typename UGridView::template Codim<0>::Iterator Iterator;
+  for (Iterator it = gridView.template begin<0>(); it != gridView.template end<0>(); ++it)
+  {
+    const std::size_t k = std::size_t(id[factory.insertionIndex(*it)]);
+    if (k >= expected.size() || it->geometry().corners() != int(expected[k].size()))
+    {
+      std::cerr << fileName << ": element " << k << " has the wrong type" << std::endl;
+      result = 1;
+      continue;
+    }
+    for (int i = 0; i < it->geometry().corners(); ++i)
+      if ((it->geometry().corner(i) - expected[k][i]).two_norm() > 1e-12)
+      {
+        std::cerr << fileName << ": corner " << i << " of element " << k
+                  << " is " << it->geometry().corner(i) << " instead of "
+                  << expected[k][i] << std::endl;
+        result = 1;
+      }
+  }
+
+  typedef typename UGridView::template Codim<dim>::Iterator VertexIterator;
+  for (VertexIterator it = gridView.template begin<dim>(); it != gridView.template end<dim>(); ++it)
+    if (std::abs(value[factory.insertionIndex(*it)] - pointValue<dim>(it->geometry().corner(0))) > 1e-12)
+    {
+      std::cerr << fileName << ": wrong point data at " << it->geometry().corner(0) << std::endl;
+      result = 1;
+    }
+
+  delete grid;
+  return result;
+}
+
+// write a YaspGrid (VTK quadrilaterals or hexahedra, renumbered by the
+// writer) and read it into a UGGrid, whose elements have to have the
+// corners of the written elements
+template<int dim>
+int checkYaspToUG()
+{
+  typedef Dune::YaspGrid<dim> YGrid;
+  typedef typename YGrid::LeafGridView YGridView;
+
+  Dune::FieldVector<double, dim> L(1.0);
+  Dune::FieldVector<int, dim> s(3);
+  s[0] = 4;
+  YGrid grid(L, s, Dune::FieldVector<bool, dim>(false), 0);
+  const YGridView gridView = grid.leafView();
+
+  std::vector<std::vector<Dune::FieldVector<double, dim> > > expected(gridView.size(0));
+  std::vector<double> id(gridView.size(0)), value(gridView.size(dim));
+  typedef typename YGridView::template Codim<0>::Iterator Iterator;
+  for (Iterator it = gridView.template begin<0>(); it != gridView.template end<0>(); ++it)
+  {
+    const int index = gridView.indexSet().index(*it);
+    id[index] = index;
+    for (int i = 0; i < it->geometry().corners(); ++i)
+    {
+      expected[index].push_back(it->geometry().corner(i));
+      value[gridView.indexSet().subIndex(*it, i, dim)] = pointValue<dim>(it->geometry().corner(i));
+    }
+  }
+
+  Dune::VTKWriter<YGridView> vtk(gridView);
+  vtk.addCellData(id, "id", 1, Dune::VTK::float64);
+  vtk.addVertexData(value, "value", 1, Dune::VTK::float64);
+
+  Dune::VTK::OutputType types[] = {
+    Dune::VTK::ascii, Dune::VTK::base64, Dune::VTK::appendedraw
+#if HAVE_ZLIB
+    , Dune::VTK::appendedcompressed
+#endif
+  };
+  const char* typeNames[] = {
+    "ascii", "base64", "appendedraw", "appendedcompressed"
+  };
+
+  int result = 0;
+  for (std::size_t t = 0; t < sizeof(types)/sizeof(types[0]); ++t)
+  {
+    char name[256];
+    snprintf(name, 256, "vtkreadertest-yasp-%dd-%s", dim, typeNames[t]);
+    result += checkUGFile<dim>(vtk.write(name, types[t]), expected);
+  }
+  return result;
+}
+
+// write an ASCII file by hand
+void writeFile(const std::string& fileName, int npoints, const char* points,
+               const char* values, int ncells, const char* connectivity,
+               const char* offsets, const char* types, const char* ids)
+{
+  std::ofstream file(fileName.c_str());
+  file << "<?xml version=\"1.0\"?>\n"
+       << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n"
+       << "<UnstructuredGrid>\n"
+       << "<Piece NumberOfCells=\"" << ncells << "\" NumberOfPoints=\"" << npoints << "\">\n"
+       << "<PointData Scalars=\"value\">\n"
+       << "<DataArray type=\"Float64\" Name=\"value\" NumberOfComponents=\"1\" format=\"ascii\">\n"
+       << values << "\n</DataArray>\n</PointData>\n"
+       << "<CellData Scalars=\"id\">\n"
+       << "<DataArray type=\"Float64\" Name=\"id\" NumberOfComponents=\"1\" format=\"ascii\">\n"
+       << ids << "\n</DataArray>\n</CellData>\n"
+       << "<Points>\n"
+       << "<DataArray type=\"Float64\" Name=\"Coordinates\" NumberOfComponents=\"3\" format=\"ascii\">\n"
+       << points << "\n</DataArray>\n</Points>\n"
+       << "<Cells>\n"
+       << "<DataArray type=\"Int32\" Name=\"connectivity\" NumberOfComponents=\"1\" format=\"ascii\">\n"
+       << connectivity << "\n</DataArray>\n"
+       << "<DataArray type=\"Int32\" Name=\"offsets\" NumberOfComponents=\"1\" format=\"ascii\">\n"
+       << offsets << "\n</DataArray>\n"
+       << "<DataArray type=\"UInt8\" Name=\"types\" NumberOfComponents=\"1\" format=\"ascii\">\n"
+       << types << "\n</DataArray>\n"
+       << "</Cells>\n</Piece>\n</UnstructuredGrid>\n</VTKFile>\n";
+}
+
+// a pixel, a quadrilateral and a triangle (VTK types 8, 9 and 5)
+int checkMixed2d()
+{
+  typedef Dune::FieldVector<double, 2> X;
+  const X p[7] = { X(0), X(0), X(0), X(0), X(0), X(0), X(0) };
+  std::vector<X> x(p, p+7);
+  x[1][0] = 1; x[2][0] = 2;
+  x[3][1] = 1; x[4][0] = 1; x[4][1] = 1; x[5][0] = 2; x[5][1] = 1;
+  x[6][0] = 1; x[6][1] = 2;
+
+  std::ostringstream points, values;
+  for (int i = 0; i < 7; ++i)
+  {
+    points << x[i][0] << " " << x[i][1] << " 0\n";
+    values << pointValue<2>(x[i]) << "\n";
+  }
+
+  // the pixel is in Dune order, the quadrilateral is renumbered
+  const int corners[3][4] = { { 0, 1, 3, 4 }, { 1, 2, 4, 5 }, { 3, 4, 6, -1 } };
+  std::vector<std::vector<X> > expected(3);
+  for (int c = 0; c < 3; ++c)
+    for (int i = 0; i < 4 && corners[c][i] >= 0; ++i)
+      expected[c].push_back(x[corners[c][i]]);
+
+  writeFile("vtkreadertest-mixed-2d.vtu", 7, points.str().c_str(),
+            values.str().c_str(), 3, "0 1 3 4  1 2 5 4  3 4 6", "4 8 11",
+            "8 9 5", "0 1 2");
+  return checkUGFile<2>("vtkreadertest-mixed-2d.vtu", expected);
+}
+
+// a voxel and a hexahedron (VTK types 11 and 12)
+int checkMixed3d()
+{
+  typedef Dune::FieldVector<double, 3> X;
+  // point (i,j,k) has the number i + 3*j + 6*k
+  std::vector<X> x(12);
+  std::ostringstream points, values;
+  for (int n = 0; n < 12; ++n)
+  {
+    x[n][0] = n % 3;
+    x[n][1] = (n / 3) % 2;
+    x[n][2] = n / 6;
+    points << x[n][0] << " " << x[n][1] << " " << x[n][2] << "\n";
+    values << pointValue<3>(x[n]) << "\n";
+  }
+
+  // the voxel is in Dune order, the hexahedron is renumbered
+  const int corners[2][8] = { { 0, 1, 3, 4, 6, 7, 9, 10 },
+                              { 1, 2, 4, 5, 7, 8, 10, 11 } };
+  std::vector<std::vector<X> > expected(2);
+  for (int c = 0; c < 2; ++c)
+    for (int i = 0; i < 8; ++i)
+      expected[c].push_back(x[corners[c][i]]);
+
+  writeFile("vtkreadertest-mixed-3d.vtu", 12, points.str().c_str(),
+            values.str().c_str(), 2,
+            "0 1 3 4 6 7 9 10  1 2 5 4 7 8 11 10", "8 16", "11 12", "0 1");
+  return checkUGFile<3>("vtkreadertest-mixed-3d.vtu", expected);
+}
+#endif // HAVE_UG
+
+int main(int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper::instance(argc, argv);
+
+    int result = 0;
+    result += doCheck(Dune::VTK::conforming);
+    result += doCheck(Dune::VTK::nonconforming);
+#if HAVE_UG
+    result += checkYaspToUG<2>();
+    result += checkYaspToUG<3>();
+    result += checkMixed2d();
+    result += checkMixed3d();
+#endif
+    return result > 0 ? 1 : 0;
+
+  } catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+}
@@ -63,7 +63,8 @@ public:
 };
 
 template< class GridView >
-void doWrite( const GridView &gridView, Dune::VTK::DataMode dm )
+void doWrite( const GridView &gridView, Dune::VTK::DataMode dm,
+              unsigned maxPending = 0, bool cacheGrid = false )
 {
   enum { dim = GridView :: dimension };
 
@@ -73,9 +74,13 @@ void doWrite( const GridView &gridView, Dune::VTK::DataMode dm )
 
   std::stringstream name;
   name << "vtktest-" << dim << "D-" << VTKDataMode(dm);
+  if (maxPending > 0)
+    name << "-async";
+  if (cacheGrid)
+    name << "-cached";
   Dune :: VTKSequenceWriter< GridView >
-  vtk( gridView, name.str(), ".", "", dm );
-
+  vtk( gridView, name.str(), ".", "", dm, maxPending );
+  vtk.cacheGrid(cacheGrid);
 
   vtk.addVertexData(vertexdata,"vertexData");
   vtk.addCellData(celldata,"cellData");
@@ -87,6 +92,7 @@ void doWrite( const GridView &gridView, Dune::VTK::DataMode dm )
     vtk.write(time);
     time += 0.1;
   }
+  vtk.flush();
 }
 
 template<int dim>
@@ -103,6 +109,9 @@ void vtkCheck(int* n, double* h)
   doWrite( g.template levelView< VTK_Partition >( 0 ), Dune::VTK::nonconforming );
   doWrite( g.template levelView< VTK_Partition >( g.maxLevel() ), Dune::VTK::conforming );
   doWrite( g.template levelView< VTK_Partition >( g.maxLevel() ), Dune::VTK::nonconforming );
+  doWrite( g.template leafView< VTK_Partition >(), Dune::VTK::conforming, 2 );
+  doWrite( g.template leafView< VTK_Partition >(), Dune::VTK::conforming, 0, true );
+  doWrite( g.template leafView< VTK_Partition >(), Dune::VTK::nonconforming, 0, true );
 }
 
 int main(int argc, char **argv)
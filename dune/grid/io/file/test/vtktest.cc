@@ -7,15 +7,22 @@
 #endif
 
 #include <algorithm>
+#include <bitset>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <ostream>
+#include <string>
 #include <vector>
 
 #include <unistd.h>
 
+#include <dune/common/array.hh>
+#include <dune/common/exceptions.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <dune/grid/io/file/vtk/structuredvtkwriter.hh>
 #include <dune/grid/io/file/vtk/vtkwriter.hh>
 #include <dune/grid/yaspgrid.hh>
 
@@ -31,6 +38,16 @@ const char* VTKDataMode(Dune::VTK::DataMode dm)
   return "";
 }
 
+// read the contents of a file
+std::string readFile(const std::string& name)
+{
+  std::ifstream file(name.c_str(), std::ios::binary);
+  if(!file)
+    DUNE_THROW(Dune::IOError, "Could not read " << name);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
 template< class GridView >
 class VTKVectorFunction
   : public Dune :: VTKWriter< GridView > :: VTKFunction
@@ -85,10 +102,16 @@ void doWrite( const GridView &gridView, Dune :: VTK :: DataMode dm )
   const typename GridView :: IndexSet &is = gridView.indexSet();
   std::vector<int> vertexdata(is.size(dim),dim);
   std::vector<int> celldata(is.size(0),0);
+  std::vector<double> cellvalues(is.size(0));
+  for (std::size_t i=0; i<cellvalues.size(); ++i)
+    cellvalues[i] = 0.5*i;
 
   Dune :: VTKWriter< GridView > vtk( gridView, dm );
   vtk.addVertexData(vertexdata,"vertexData");
   vtk.addCellData(celldata,"cellData");
+  vtk.addVertexData(vertexdata,"vertexDataFloat64",1,Dune::VTK::float64);
+  vtk.addCellData(celldata,"cellDataInt32",1,Dune::VTK::int32);
+  vtk.addCellData(cellvalues,"cellDataFloat64",1,Dune::VTK::float64);
 
   vtk.addVertexData(new VTKVectorFunction<GridView>("vertex"));
   vtk.addCellData(new VTKVectorFunction<GridView>("cell"));
@@ -101,10 +124,71 @@ void doWrite( const GridView &gridView, Dune :: VTK :: DataMode dm )
   vtk.write(name, Dune::VTK::base64);
 
   snprintf(name,256,"vtktest-%iD-%s-appendedraw", dim, VTKDataMode(dm));
-  vtk.write(name, Dune::VTK::appendedraw);
+  const std::string rawName = vtk.write(name, Dune::VTK::appendedraw);
 
   snprintf(name,256,"vtktest-%iD-%s-appendedbase64", dim, VTKDataMode(dm));
   vtk.write(name, Dune::VTK::appendedbase64);
+
+#if HAVE_ZLIB
+  snprintf(name,256,"vtktest-%iD-%s-appendedcompressed", dim, VTKDataMode(dm));
+  vtk.write(name, Dune::VTK::appendedcompressed);
+#endif
+
+  snprintf(name,256,"vtktest-%iD-%s-shared", dim, VTKDataMode(dm));
+  const std::string sharedName = vtk.writeShared(name);
+  // with one process the shared file has to be the appendedraw file
+  if(gridView.comm().size() == 1 && readFile(sharedName) != readFile(rawName))
+    DUNE_THROW(Dune::IOError, sharedName << " differs from " << rawName);
+
+  snprintf(name,256,"vtktest-%iD-%s-aggregated", dim, VTKDataMode(dm));
+  vtk.writeAggregated(name, 2);
+}
+
+// check the extension of a file written by the StructuredVTKWriter
+void checkExtension( const std::string &fileName, const std::string &ext )
+{
+  if( fileName.size() < ext.size()
+      || fileName.substr(fileName.size() - ext.size()) != ext )
+    DUNE_THROW(Dune::Exception, fileName << " should have the extension "
+               << ext);
+}
+
+// write ImageData (.vti) for equidistant grids and RectilinearGrid (.vtr)
+// for tensor product grids
+template< class GridView >
+void doStructuredWrite( const GridView &gridView, const std::string &kind,
+                        const std::string &ext )
+{
+  enum { dim = GridView :: dimension };
+
+  const typename GridView :: IndexSet &is = gridView.indexSet();
+  std::vector<double> vertexdata(is.size(dim));
+  std::vector<double> celldata(is.size(0));
+  for (std::size_t i=0; i<vertexdata.size(); ++i)
+    vertexdata[i] = 0.25*i;
+  for (std::size_t i=0; i<celldata.size(); ++i)
+    celldata[i] = 0.5*i;
+
+  Dune :: StructuredVTKWriter< GridView > vtk( gridView );
+  vtk.addVertexData(vertexdata,"vertexDataFloat64",1,Dune::VTK::float64);
+  vtk.addCellData(celldata,"cellDataFloat64",1,Dune::VTK::float64);
+  vtk.addVertexData(new VTKVectorFunction<GridView>("vertex"));
+  vtk.addCellData(new VTKVectorFunction<GridView>("cell"));
+
+  // write() produces a parallel file if there are several processes
+  const std::string serialExt =
+    gridView.comm().size() > 1 ? ".p" + ext.substr(1) : ext;
+
+  char name[256];
+  snprintf(name,256,"vtktest-%iD-%s-ascii", dim, kind.c_str());
+  checkExtension(vtk.write(name), serialExt);
+
+  snprintf(name,256,"vtktest-%iD-%s-appendedraw", dim, kind.c_str());
+  checkExtension(vtk.write(name, Dune::VTK::appendedraw), serialExt);
+
+  snprintf(name,256,"vtktest-%iD-%s-parallel", dim, kind.c_str());
+  checkExtension(vtk.pwrite(name, ".", "", Dune::VTK::appendedbase64),
+                 ".p" + ext.substr(1));
 }
 
 template<int dim>
@@ -135,6 +219,18 @@ void vtkCheck(const Dune::MPIHelper &mpiHelper, int* n, double* h)
            Dune::VTK::conforming );
   doWrite( g.template levelView< VTK_Partition >( g.maxLevel() ),
            Dune::VTK::nonconforming );
+  doStructuredWrite( g.template leafView< VTK_Partition >(), "structured",
+                     ".vti" );
+
+  // tensor product grid with cells growing in each direction
+  Dune::array<std::vector<typename Grid::ctype>, dim> coords;
+  for (int i=0; i<dim; ++i)
+    for (int k=0; k<=n[i]; ++k)
+      coords[i].push_back(h[i]*k*k/(n[i]*n[i]));
+  Dune::YaspGrid<dim> t(mpiHelper.getCommunicator(), coords,
+                        std::bitset<dim>(0), 0);
+  doStructuredWrite( t.template leafView< VTK_Partition >(), "rectilinear",
+                     ".vtr" );
 }
 
 int main(int argc, char **argv)
@@ -5,11 +5,14 @@
 #define DUNE_GRID_IO_FILE_VTK_HH
 
 /** \file
-    \brief Convenience header which includes all available VTK writers
+    \brief Convenience header which includes all available VTK writers and
+           the VTK reader
  */
 
 #include "vtk/boundarywriter.hh"
+#include "vtk/structuredvtkwriter.hh"
 #include "vtk/subsamplingvtkwriter.hh"
+#include "vtk/vtkreader.hh"
 #include "vtk/vtksequencewriter.hh"
 #include "vtk/vtkwriter.hh"
 #include "vtk/volumewriter.hh"
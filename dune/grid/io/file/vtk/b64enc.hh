@@ -5,6 +5,11 @@
 #define DUNE_GRID_IO_FILE_VTK_B64ENC_HH
 
 #include <assert.h>
+#include <cstddef>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 
 namespace Dune {
 
@@ -72,6 +77,94 @@ namespace Dune {
     b64data data;
   };
 
+  /** @brief encode the complete triples of a buffer
+   *
+   * Encodes the first n/3*3 bytes of in and writes n/3*4 characters to out.
+   * If SSSE3 is available, 12 bytes are encoded at once; the remaining
+   * triples are encoded one by one.
+   *
+   * @returns The number of bytes encoded.
+   */
+  inline std::size_t base64EncodeTriples(const char* in, std::size_t n,
+                                         char* out)
+  {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(in);
+    const unsigned char* end = p + n/3*3;
+
+#ifdef __SSSE3__
+    // see W. Mula, D. Lemire: Faster Base64 Encoding and Decoding using AVX2
+    // Instructions.  Each loaded vector of 16 bytes yields 16 characters
+    // from its first 12 bytes.
+    const __m128i shuffle = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                          7, 6, 8, 7, 10, 9, 11, 10);
+    const __m128i shift = _mm_setr_epi8('a'-26, '0'-52, '0'-52, '0'-52,
+                                        '0'-52, '0'-52, '0'-52, '0'-52,
+                                        '0'-52, '0'-52, '0'-52, '+'-62,
+                                        '/'-63, 'A', 0, 0);
+    while (end - p >= 16)
+    {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      v = _mm_shuffle_epi8(v, shuffle);
+      // split each group of three bytes into four six bit indices
+      const __m128i hi =
+        _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)),
+                        _mm_set1_epi32(0x04000040));
+      const __m128i lo =
+        _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)),
+                        _mm_set1_epi32(0x01000010));
+      const __m128i idx = _mm_or_si128(hi, lo);
+      // map the indices to characters by adding a per range offset
+      __m128i range = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+      const __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+      range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+      const __m128i chars = _mm_add_epi8(_mm_shuffle_epi8(shift, range), idx);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);
+      p += 12;
+      out += 16;
+    }
+#endif
+
+    for (; p != end; p += 3, out += 4)
+    {
+      const unsigned v = (unsigned(p[0]) << 16) | (unsigned(p[1]) << 8) | p[2];
+      out[0] = base64table[v >> 18];
+      out[1] = base64table[(v >> 12) & 63];
+      out[2] = base64table[(v >> 6) & 63];
+      out[3] = base64table[v & 63];
+    }
+    return n/3*3;
+  }
+
+  /** @brief base64 encode a buffer
+   *
+   * Encodes n bytes of in and writes (n+2)/3*4 characters to out, including
+   * the end-marker if n is not a multiple of three.
+   *
+   * @returns The number of characters written.
+   */
+  inline std::size_t base64Encode(const char* in, std::size_t n, char* out)
+  {
+    const std::size_t done = base64EncodeTriples(in, n, out);
+    out += done/3*4;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(in) + done;
+    switch (n - done)
+    {
+    case 1 :
+      out[0] = base64table[p[0] >> 2];
+      out[1] = base64table[(p[0] & 3) << 4];
+      out[2] = '=';
+      out[3] = '=';
+      break;
+    case 2 :
+      out[0] = base64table[p[0] >> 2];
+      out[1] = base64table[((p[0] & 3) << 4) | (p[1] >> 4)];
+      out[2] = base64table[(p[1] & 15) << 2];
+      out[3] = '=';
+      break;
+    }
+    return (n+2)/3*4;
+  }
+
   /** @} */
 
 } // namespace Dune
@@ -45,11 +45,11 @@ namespace Dune
       //! Ouput is to the file is appended raw binary
       appendedraw,
       //! Ouput is to the file is appended base64 binary
-      appendedbase64
+      appendedbase64,
+      //! Ouput is zlib compressed and appended raw binary (requires zlib)
+      appendedcompressed
       // //! Output to the file is compressed inline binary.
       // binarycompressed,
-      // //! Ouput is compressed and appended to the file.
-      // compressedappended
     };
     //! Whether to produce conforming or non-conforming output.
     /**
@@ -78,6 +78,82 @@ namespace Dune
       nonconforming
     };
 
+    //! Precision of the values written to a data array
+    /**
+     * \code
+     * #include <dune/grid/io/file/vtk/common.hh>
+     * \endcode
+     *
+     * Each precision corresponds to one VTK data type and one C++ type
+     * (int, unsigned char, unsigned, float and double, respectively).
+     */
+    enum Precision {
+      //! VTK type Int32
+      int32,
+      //! VTK type UInt8
+      uint8,
+      //! VTK type UInt32
+      uint32,
+      //! VTK type Float32
+      float32,
+      //! VTK type Float64
+      float64
+    };
+
+    //! map precision to its VTK name in data array
+    /**
+     * \code
+     * #include <dune/grid/io/file/vtk/common.hh>
+     * \endcode
+     */
+    inline std::string toString(Precision p)
+    {
+      switch(p) {
+      case int32 :   return "Int32";
+      case uint8 :   return "UInt8";
+      case uint32 :  return "UInt32";
+      case float32 : return "Float32";
+      case float64 : return "Float64";
+      }
+      DUNE_THROW(IOError, "VTK: unsupported Precision " << p);
+    }
+
+    //! map C++ type to the corresponding Precision
+    /**
+     * \code
+     * #include <dune/grid/io/file/vtk/common.hh>
+     * \endcode
+     *
+     * Only defined for the types listed in the documentation of Precision.
+     */
+    template<typename T>
+    struct PrecisionTraits;
+
+    template<>
+    struct PrecisionTraits<int> {
+      static const Precision value = int32;
+    };
+
+    template<>
+    struct PrecisionTraits<unsigned char> {
+      static const Precision value = uint8;
+    };
+
+    template<>
+    struct PrecisionTraits<unsigned> {
+      static const Precision value = uint32;
+    };
+
+    template<>
+    struct PrecisionTraits<float> {
+      static const Precision value = float32;
+    };
+
+    template<>
+    struct PrecisionTraits<double> {
+      static const Precision value = float64;
+    };
+
     //////////////////////////////////////////////////////////////////////
     //
     //  PrintType
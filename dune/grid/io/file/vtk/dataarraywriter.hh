@@ -4,8 +4,17 @@
 #ifndef DUNE_GRID_IO_FILE_VTK_DATAARRAYWRITER_HH
 #define DUNE_GRID_IO_FILE_VTK_DATAARRAYWRITER_HH
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <deque>
 #include <ostream>
 #include <string>
+#include <vector>
+
+#if HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/indent.hh>
@@ -19,6 +28,9 @@
 
     This file contains classes to help writing data in the difeerent VTK
     output modes
+
+    The output type VTK::appendedcompressed is only available if zlib was
+    found, otherwise DataArrayWriterFactory throws NotImplemented for it.
  */
 
 namespace Dune
@@ -47,6 +59,11 @@ namespace Dune
      * would be written, the actual writing has to happen later independent of
      * the writer).  Finally, in the destructor, the stream is put back in a
      * sane state.  That usually means writing something line "</DataArray>".
+     *
+     * Data may also be handed over in blocks of consecutive elements with
+     * write(const T*, std::size_t), which costs only one virtual call per
+     * block.  The implementations in this file override it to encode the
+     * whole block at once.
      */
     template<class T>
     class DataArrayWriter
@@ -54,6 +71,12 @@ namespace Dune
     public:
       //! write one data element
       virtual void write (T data) = 0;
+      //! write n consecutive data elements
+      virtual void write (const T* data, std::size_t n)
+      {
+        for (std::size_t i = 0; i < n; ++i)
+          write(data[i]);
+      }
       //! whether calls to write may be skipped
       virtual bool writeIsNoop() const { return false; }
       //! virtual destructor
@@ -97,6 +120,20 @@ namespace Dune
         if (counter%numPerLine==0) s << "\n";
       }
 
+      //! write n consecutive data elements to output stream
+      void write (const T* data, std::size_t n)
+      {
+        typedef typename PrintType<T>::Type PT;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          if(counter%numPerLine==0) s << indent;
+          else s << " ";
+          s << (PT) data[i];
+          counter++;
+          if (counter%numPerLine==0) s << "\n";
+        }
+      }
+
       //! finish output; writes end tag
       ~AsciiDataArrayWriter ()
       {
@@ -140,8 +177,8 @@ namespace Dune
 
         // write indentation for the data chunk
         s << indent+1;
-        // store size
-        unsigned long int size = ncomps*nitems*sizeof(T);
+        // store size, the header of an array is a 32 bit integer
+        unsigned int size = ncomps*nitems*sizeof(T);
         b64.write(size);
         b64.flush();
       }
@@ -152,6 +189,12 @@ namespace Dune
         b64.write(data);
       }
 
+      //! write n consecutive data elements to output stream
+      void write (const T* data, std::size_t n)
+      {
+        b64.write(data, n);
+      }
+
       //! finish output; writes end tag
       ~BinaryDataArrayWriter ()
       {
@@ -202,6 +245,9 @@ namespace Dune
       //! write one data element to output stream (noop)
       void write (T data) { }
 
+      //! write n consecutive data elements to output stream (noop)
+      void write (const T* data, std::size_t n) { }
+
       //! whether calls to write may be skipped
       bool writeIsNoop() const { return true; }
     };
@@ -243,10 +289,140 @@ namespace Dune
       //! write one data element to output stream (noop)
       void write (T data) { }
 
+      //! write n consecutive data elements to output stream (noop)
+      void write (const T* data, std::size_t n) { }
+
       //! whether calls to write may be skipped
       bool writeIsNoop() const { return true; }
     };
 
+    //! size of the uncompressed blocks for VTK::appendedcompressed
+    const std::size_t compressionBlockSize = 32768;
+
+    //! compress data in the block layout of vtkZLibDataCompressor
+    /**
+     * \param data  Uncompressed data.
+     * \param bytes Size of the uncompressed data in bytes.
+     * \param out   Receives the header and the compressed blocks.
+     *
+     * The data is split into blocks of compressionBlockSize bytes which are
+     * compressed independently of each other, in parallel if OpenMP is
+     * enabled.  The header consists of 32 bit unsigned integers: number of
+     * blocks, uncompressed block size, uncompressed size of the last block
+     * if it is partial (0 otherwise) and the compressed size of each block.
+     */
+    inline void zlibCompressBlocks(const char* data, std::size_t bytes,
+                                   std::vector<char>& out)
+    {
+#if HAVE_ZLIB
+      typedef unsigned int HeaderType;
+      const std::size_t nblocks =
+        (bytes + compressionBlockSize - 1) / compressionBlockSize;
+
+      std::vector<HeaderType> header(3 + nblocks);
+      header[0] = nblocks;
+      header[1] = compressionBlockSize;
+      header[2] = bytes % compressionBlockSize;
+
+      std::vector<std::vector<char> > blocks(nblocks);
+      int failed = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:failed)
+#endif
+      for (long b = 0; b < long(nblocks); ++b)
+      {
+        const std::size_t begin = b*compressionBlockSize;
+        const uLong size = std::min(compressionBlockSize, bytes - begin);
+        uLongf csize = compressBound(size);
+        blocks[b].resize(csize);
+        if (compress2(reinterpret_cast<Bytef*>(&blocks[b][0]), &csize,
+                      reinterpret_cast<const Bytef*>(data + begin), size,
+                      Z_DEFAULT_COMPRESSION) != Z_OK)
+          ++failed;
+        header[3+b] = csize;
+      }
+      if (failed > 0)
+        DUNE_THROW(IOError, "Dune::VTK::zlibCompressBlocks: compression of "
+                   << failed << " blocks failed");
+
+      std::size_t total = header.size()*sizeof(HeaderType);
+      for (std::size_t b = 0; b < nblocks; ++b)
+        total += header[3+b];
+      out.resize(total);
+
+      char* p = &out[0];
+      std::memcpy(p, &header[0], header.size()*sizeof(HeaderType));
+      p += header.size()*sizeof(HeaderType);
+      for (std::size_t b = 0; b < nblocks; ++b)
+      {
+        std::memcpy(p, &blocks[b][0], header[3+b]);
+        p += header[3+b];
+      }
+#else
+      DUNE_THROW(NotImplemented, "Dune::VTK::zlibCompressBlocks: "
+                 "dune-grid was built without zlib");
+#endif
+    }
+
+    //! a streaming writer for data array tags, uses appended zlib compressed format
+    /**
+     * In contrast to the other appended writers this writer needs the data
+     * already in the main section: the offsets of subsequent arrays depend
+     * on the size of the compressed data.  The data is collected in memory
+     * in a buffer owned by the DataArrayWriterFactory, which compresses it
+     * in DataArrayWriterFactory::finish() and keeps the result for the
+     * appended section, where NakedCompressedDataArrayWriter writes it.
+     * Hence the destructor does not throw.
+     */
+    template<class T>
+    class AppendedCompressedDataArrayWriter : public DataArrayWriter<T>
+    {
+    public:
+      //! make a new data array writer
+      /**
+       * \param s         Stream to write to.
+       * \param name      Name of array to write.
+       * \param ncomps    Number of components of the array.
+       * \param nitems    Number of cells for cell data/Number of vertices for
+       *                  point data.
+       * \param offset    Offset of the compressed data in the appended
+       *                  section.
+       * \param data      Buffer receiving the uncompressed bytes.
+       * \param indent    Indentation to use.  This is uses as-is for the
+       *                  header line.
+       */
+      AppendedCompressedDataArrayWriter(std::ostream& s, std::string name,
+                                        int ncomps, unsigned nitems,
+                                        unsigned offset,
+                                        std::vector<char>& data,
+                                        const Indent& indent)
+        : data_(data)
+      {
+        TypeName<T> tn;
+        s << indent << "<DataArray type=\"" << tn() << "\" "
+          << "Name=\"" << name << "\" ";
+        s << "NumberOfComponents=\"" << ncomps << "\" ";
+        s << "format=\"appended\" offset=\""<< offset << "\" />\n";
+        data_.reserve(ncomps*nitems*sizeof(T));
+      }
+
+      //! collect one data element
+      void write (T d)
+      {
+        write(&d, 1);
+      }
+
+      //! collect n consecutive data elements
+      void write (const T* d, std::size_t n)
+      {
+        const char* bytes = reinterpret_cast<const char*>(d);
+        data_.insert(data_.end(), bytes, bytes + n*sizeof(T));
+      }
+
+    private:
+      std::vector<char>& data_;
+    };
+
     //////////////////////////////////////////////////////////////////////
     //
     //  Naked ArrayWriters for the appended section
@@ -268,8 +444,8 @@ namespace Dune
                                  int nitems)
         : b64(theStream)
       {
-        // store size
-        unsigned long int size = ncomps*nitems*sizeof(T);
+        // store size, the header of an array is a 32 bit integer
+        unsigned int size = ncomps*nitems*sizeof(T);
         b64.write(size);
         b64.flush();
       }
@@ -280,6 +456,12 @@ namespace Dune
         b64.write(data);
       }
 
+      //! write n consecutive data elements to output stream
+      void write (const T* data, std::size_t n)
+      {
+        b64.write(data, n);
+      }
+
     private:
       Base64Stream b64;
     };
@@ -310,6 +492,93 @@ namespace Dune
       {
         s.write(data);
       }
+
+      //! write n consecutive data elements to output stream
+      void write (const T* data, std::size_t n)
+      {
+        s.write(data, n);
+      }
+    };
+
+    //! a writer for appended data arrays, writes zlib compressed data
+    /**
+     * The data has already been compressed by an
+     * AppendedCompressedDataArrayWriter in the main section.  The
+     * constructor writes it, calls to write() are noops.
+     */
+    template<class T>
+    class NakedCompressedDataArrayWriter : public DataArrayWriter<T>
+    {
+    public:
+      //! make a new data array writer
+      /**
+       * \param s     Stream to write to.
+       * \param store Queue of compressed arrays; the first one is written
+       *              and removed.
+       */
+      NakedCompressedDataArrayWriter(std::ostream& s,
+                                     std::deque<std::vector<char> >& store)
+      {
+        if(store.empty())
+          DUNE_THROW(IOError, "Dune::VTK::NakedCompressedDataArrayWriter: "
+                     "no compressed data left for the appended section");
+        s.write(&store.front()[0], store.front().size());
+        store.pop_front();
+      }
+
+      //! write one data element to output stream (noop)
+      void write (T data) { }
+
+      //! write n consecutive data elements to output stream (noop)
+      void write (const T* data, std::size_t n) { }
+
+      //! whether calls to write may be skipped
+      bool writeIsNoop() const { return true; }
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    //
+    //  ArrayWriter for in-memory copies
+    //
+
+    //! a writer which appends the raw bytes of the data to a buffer
+    /**
+     * Used by VTUWriter to stage the contents of a file in memory (see
+     * VTUStage).
+     */
+    template<class T>
+    class BufferDataArrayWriter : public DataArrayWriter<T>
+    {
+    public:
+      //! make a new data array writer
+      /**
+       * \param buffer_ Buffer to append to.
+       * \param ncomps  Number of components of the array.
+       * \param nitems  Number of cells for cell data/Number of vertices for
+       *                point data.
+       */
+      BufferDataArrayWriter(std::vector<char>& buffer_, int ncomps,
+                            int nitems)
+        : buffer(buffer_)
+      {
+        buffer.reserve(buffer.size() + ncomps*nitems*sizeof(T));
+      }
+
+      //! append one data element to the buffer
+      void write (T data)
+      {
+        write(&data, 1);
+      }
+
+      //! append n consecutive data elements to the buffer
+      void write (const T* data, std::size_t n)
+      {
+        const char* p = reinterpret_cast<const char*>(data);
+        buffer.insert(buffer.end(), p, p + n*sizeof(T));
+      }
+
+    private:
+      std::vector<char>& buffer;
     };
 
     //////////////////////////////////////////////////////////////////////
@@ -331,6 +600,10 @@ namespace Dune
       unsigned offset;
       //! whether we are in the main or in the appended section writing phase
       Phase phase;
+      //! compressed arrays waiting for the appended section
+      std::deque<std::vector<char> > compressed;
+      //! whether the last entry of compressed still has to be compressed
+      bool pending;
 
     public:
       //! create a DataArrayWriterFactory
@@ -344,8 +617,14 @@ namespace Dune
        * an active one should be OK however.
        */
       inline DataArrayWriterFactory(OutputType type_, std::ostream& stream_)
-        : type(type_), stream(stream_), offset(0), phase(main)
-      { }
+        : type(type_), stream(stream_), offset(0), phase(main), pending(false)
+      {
+#if ! HAVE_ZLIB
+        if(type == appendedcompressed)
+          DUNE_THROW(NotImplemented, "Dune::VTK::DataArrayWriterFactory: "
+                     "appendedcompressed output requires zlib");
+#endif
+      }
 
       //! signal start of the appeneded section
       /**
@@ -359,17 +638,39 @@ namespace Dune
        * not be called after a call to this method.
        */
       inline bool beginAppended() {
+        finish();
         phase = appended;
         switch(type) {
         case ascii :          return false;
         case base64 :         return false;
         case appendedraw :    return true;
         case appendedbase64 : return true;
+        case appendedcompressed : return true;
         }
         DUNE_THROW(IOError, "Dune::VTK::DataArrayWriter: unsupported "
                    "OutputType " << type);
       }
 
+      //! complete the data of the last DataArrayWriter of the main section
+      /**
+       * For appendedcompressed output this compresses the data collected by
+       * the last AppendedCompressedDataArrayWriter and advances the offset;
+       * for all other types it does nothing.  It is called by make() and
+       * beginAppended(), and should be called by the user of the factory
+       * after the last DataArrayWriter of the main section has been
+       * destroyed.  Errors in the compression are thrown from here.
+       */
+      inline void finish() {
+        if(!pending)
+          return;
+        pending = false;
+        std::vector<char> data;
+        data.swap(compressed.back());
+        zlibCompressBlocks(data.empty() ? 0 : &data[0], data.size(),
+                           compressed.back());
+        offset += compressed.back().size();
+      }
+
       //! query encoding string for appended data
       const std::string& appendedEncoding() const {
         static const std::string rawString = "raw";
@@ -382,6 +683,7 @@ namespace Dune
                      "appended encoding for OutputType " << type);
         case appendedraw :    return rawString;
         case appendedbase64 : return base64String;
+        case appendedcompressed : return rawString;
         }
         DUNE_THROW(IOError, "DataArrayWriterFactory::appendedEncoding(): "
                    "unsupported OutputType " << type);
@@ -419,6 +721,16 @@ namespace Dune
             return new AppendedBase64DataArrayWriter<T>(stream, name, ncomps,
                                                         nitems, offset,
                                                         indent);
+          case appendedcompressed :
+            // the offset depends on the compressed size of the previous array
+            finish();
+            compressed.push_back(std::vector<char>());
+            pending = true;
+            return new AppendedCompressedDataArrayWriter<T>(stream, name,
+                                                            ncomps, nitems,
+                                                            offset,
+                                                            compressed.back(),
+                                                            indent);
           }
           break;
         case appended :
@@ -430,6 +742,8 @@ namespace Dune
             return new NakedRawDataArrayWriter<T>(stream, ncomps, nitems);
           case appendedbase64 :
             return new NakedBase64DataArrayWriter<T>(stream, ncomps, nitems);
+          case appendedcompressed :
+            return new NakedCompressedDataArrayWriter<T>(stream, compressed);
           }
           break;
         }
@@ -4,7 +4,9 @@
 #ifndef DUNE_GRID_IO_FILE_VTK_FUNCTION_HH
 #define DUNE_GRID_IO_FILE_VTK_FUNCTION_HH
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/fvector.hh>
@@ -13,6 +15,7 @@
 #include <dune/geometry/referenceelements.hh>
 
 #include <dune/grid/common/mcmgmapper.hh>
+#include <dune/grid/io/file/vtk/common.hh>
 
 /** @file
     @author Peter Bastian, Christian Engwer
@@ -24,6 +27,66 @@ namespace Dune
   //! \addtogroup VTK
   //! \{
 
+  namespace VTK {
+
+    //! Description of an array holding one value per entity
+    /**
+     * \code
+     * #include <dune/grid/io/file/vtk/function.hh>
+     * \endcode
+     *
+     * See VTKFunction::values().  If data is 0, there is no such array.
+     */
+    struct ValueArray
+    {
+      //! pointer to the first value
+      const void* data;
+      //! type of the values
+      Precision type;
+      //! number of values
+      std::size_t size;
+
+      //! no array
+      ValueArray() : data(0), type(float32), size(0) {}
+
+      //! array of n values of type T
+      template<class T>
+      ValueArray(const T* data_, std::size_t n)
+        : data(data_), type(PrecisionTraits<T>::value), size(n)
+      {}
+    };
+
+    //! contiguous values of a container; none for general containers
+    template<class V>
+    ValueArray valueArray(const V&) { return ValueArray(); }
+
+    //! contiguous values of a std::vector
+    template<class A>
+    ValueArray valueArray(const std::vector<double, A>& v)
+    { return v.empty() ? ValueArray() : ValueArray(&v[0], v.size()); }
+
+    //! contiguous values of a std::vector
+    template<class A>
+    ValueArray valueArray(const std::vector<float, A>& v)
+    { return v.empty() ? ValueArray() : ValueArray(&v[0], v.size()); }
+
+    //! contiguous values of a std::vector
+    template<class A>
+    ValueArray valueArray(const std::vector<int, A>& v)
+    { return v.empty() ? ValueArray() : ValueArray(&v[0], v.size()); }
+
+    //! contiguous values of a std::vector
+    template<class A>
+    ValueArray valueArray(const std::vector<unsigned, A>& v)
+    { return v.empty() ? ValueArray() : ValueArray(&v[0], v.size()); }
+
+    //! contiguous values of a std::vector
+    template<class A>
+    ValueArray valueArray(const std::vector<unsigned char, A>& v)
+    { return v.empty() ? ValueArray() : ValueArray(&v[0], v.size()); }
+
+  } // namespace VTK
+
   //////////////////////////////////////////////////////////////////////
   //
   //  Base VTKFunction
@@ -56,9 +119,56 @@ namespace Dune
     virtual double evaluate (int comp, const Entity& e,
                              const Dune::FieldVector<ctype,dim>& xi) const = 0;
 
+    //! evaluate all components in the entity e at local coordinates xi
+    /*! Evaluate all ncomps() components at once and store them
+       consecutively.  The VTKWriter calls this once per entity and collects
+       the results of a whole block of entities in one buffer, so
+       implementations should override it if the components can be computed
+       together.  The default implementation calls evaluate() for each
+       component.
+       @param[in]  e      reference to grid entity of codimension 0
+       @param[in]  xi     point in local coordinates of the reference element
+                         of e
+       @param[out] result pointer to storage for ncomps() values
+     */
+    virtual void evaluateAll (const Entity& e,
+                              const Dune::FieldVector<ctype,dim>& xi,
+                              double* result) const
+    {
+      const int nc = ncomps();
+      for (int comp=0; comp<nc; ++comp)
+        result[comp] = evaluate(comp,e,xi);
+    }
+
     //! get name
     virtual std::string name () const = 0;
 
+    //! precision with which the values are written to the file
+    /**
+     * The values are always computed as double; they are converted to the
+     * type corresponding to this precision on output.  The default is
+     * VTK::float32.
+     */
+    virtual VTK::Precision precision () const
+    {
+      return VTK::float32;
+    }
+
+    //! the values of a scalar function stored in one array
+    /**
+     * Functions with one component which store one value per entity in an
+     * array, indexed by a MultipleCodimMultipleGeomTypeMapper of the
+     * GridView (element layout for cell data, vertex layout for vertex
+     * data), may describe that array here.  If the VTKWriter visits the
+     * entities in the order of the mapper, it writes the array as a whole
+     * instead of calling evaluate().  The default returns an empty
+     * description, i.e. the function is always evaluated.
+     */
+    virtual VTK::ValueArray values () const
+    {
+      return VTK::ValueArray();
+    }
+
     //! virtual destructor
     virtual ~VTKFunction () {}
   };
@@ -103,6 +213,8 @@ namespace Dune
     int mycomp_;
     //! mapper used to map elements to indices
     Mapper mapper;
+    //! precision of the output
+    VTK::Precision prec_;
 
   public:
     typedef typename Base::Entity Entity;
@@ -122,12 +234,34 @@ namespace Dune
       return v[mapper.map(e)*ncomps_+mycomp_];
     }
 
+    //! evaluate all components (there is only one)
+    virtual void evaluateAll (const Entity& e,
+                              const Dune::FieldVector<ctype,dim>& xi,
+                              double* result) const
+    {
+      result[0] = v[mapper.map(e)*ncomps_+mycomp_];
+    }
+
     //! get name
     virtual std::string name () const
     {
       return s;
     }
 
+    //! get output precision
+    virtual VTK::Precision precision () const
+    {
+      return prec_;
+    }
+
+    //! the vector, if it is a std::vector holding a single component
+    virtual VTK::ValueArray values () const
+    {
+      if (ncomps_ != 1)
+        return VTK::ValueArray();
+      return VTK::valueArray(v);
+    }
+
     //! construct from a vector and a name
     /**
      * \param gv     GridView to operate on (used to instantiate a
@@ -144,14 +278,17 @@ namespace Dune
      *               vector.
      * \param mycomp Number of the field component this function is
      *               responsible for.
+     * \param prec   Precision with which the values are written.
      */
     P0VTKFunction(const GV &gv, const V &v_, const std::string &s_,
-                  int ncomps=1, int mycomp=0 )
+                  int ncomps=1, int mycomp=0,
+                  VTK::Precision prec = VTK::float32 )
       : v( v_ ),
         s( s_ ),
         ncomps_(ncomps),
         mycomp_(mycomp),
-        mapper( gv )
+        mapper( gv ),
+        prec_( prec )
     {
       if (v.size()!=(unsigned int)(mapper.size()*ncomps_))
         DUNE_THROW(IOError, "P0VTKFunction: size mismatch");
@@ -206,6 +343,8 @@ namespace Dune
     int mycomp_;
     //! mapper used to map elements to indices
     Mapper mapper;
+    //! precision of the output
+    VTK::Precision prec_;
 
   public:
     typedef typename Base::Entity Entity;
@@ -221,6 +360,22 @@ namespace Dune
     //! evaluate
     virtual double evaluate (int comp, const Entity& e,
                              const Dune::FieldVector<ctype,dim>& xi) const
+    {
+      return v[mapper.map(e,nearestCorner(e,xi),dim)*ncomps_+mycomp_];
+    }
+
+    //! evaluate all components (there is only one)
+    virtual void evaluateAll (const Entity& e,
+                              const Dune::FieldVector<ctype,dim>& xi,
+                              double* result) const
+    {
+      result[0] = v[mapper.map(e,nearestCorner(e,xi),dim)*ncomps_+mycomp_];
+    }
+
+  private:
+    //! number of the corner of e closest to xi (in local coordinates)
+    static int nearestCorner (const Entity& e,
+                              const Dune::FieldVector<ctype,dim>& xi)
     {
       double min=1E100;
       int imin=-1;
@@ -237,15 +392,30 @@ namespace Dune
           imin = i;
         }
       }
-      return v[mapper.map(e,imin,dim)*ncomps_+mycomp_];
+      return imin;
     }
 
+  public:
     //! get name
     virtual std::string name () const
     {
       return s;
     }
 
+    //! get output precision
+    virtual VTK::Precision precision () const
+    {
+      return prec_;
+    }
+
+    //! the vector, if it is a std::vector holding a single component
+    virtual VTK::ValueArray values () const
+    {
+      if (ncomps_ != 1)
+        return VTK::ValueArray();
+      return VTK::valueArray(v);
+    }
+
     //! construct from a vector and a name
     /**
      * \param gv     GridView to operate on (used to instantiate a
@@ -262,14 +432,17 @@ namespace Dune
      *               vector.
      * \param mycomp Number of the field component this function is
      *               responsible for.
+     * \param prec   Precision with which the values are written.
      */
     P1VTKFunction(const GV& gv, const V &v_, const std::string &s_,
-                  int ncomps=1, int mycomp=0 )
+                  int ncomps=1, int mycomp=0,
+                  VTK::Precision prec = VTK::float32 )
       : v( v_ ),
         s( s_ ),
         ncomps_(ncomps),
         mycomp_(mycomp),
-        mapper( gv )
+        mapper( gv ),
+        prec_( prec )
     {
       if (v.size()!=(unsigned int)(mapper.size()*ncomps_))
         DUNE_THROW(IOError,"P1VTKFunction: size mismatch");
@@ -210,6 +210,20 @@ namespace Dune {
                << " NumberOfComponents=\"" << ncomps << "\"/>\n";
       }
 
+      //! Add an array to the output file
+      /**
+       * \param name   Name of the array.
+       * \param ncomps Number of components in each vector of the array.
+       * \param prec   The datatype of the array.
+       */
+      inline void addArray(const std::string& name, unsigned ncomps,
+                           Precision prec) {
+        stream << indent << "<PDataArray"
+               << " type=\"" << toString(prec) << "\""
+               << " Name=\"" << name << "\""
+               << " NumberOfComponents=\"" << ncomps << "\"/>\n";
+      }
+
       //! Add a serial piece to the output file
       inline void addPiece(const std::string& filename) {
         stream << indent << "<Piece "
@@ -0,0 +1,393 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_GRID_IO_FILE_VTK_SHAREDVTUWRITER_HH
+#define DUNE_GRID_IO_FILE_VTK_SHAREDVTUWRITER_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/indent.hh>
+#if HAVE_MPI
+#include <dune/common/parallel/mpicollectivecommunication.hh>
+#endif
+
+#include <dune/grid/io/file/vtk/common.hh>
+#include <dune/grid/io/file/vtk/vtuwriter.hh>
+
+namespace Dune {
+
+  //! \addtogroup VTK
+  //! \{
+
+  namespace VTK {
+
+#if HAVE_MPI
+    //! MPI communicator of a collective communication object
+    /**
+     * Communication objects which are not based on MPI (sequential grids)
+     * yield MPI_COMM_SELF.
+     *
+     * \throw NotImplemented c is not based on MPI but has more than one
+     *                       process.
+     */
+    template<class C>
+    MPI_Comm mpiCommunicator(const C& c)
+    {
+      if(c.size() > 1)
+        DUNE_THROW(NotImplemented, "Dune::VTK::mpiCommunicator: the "
+                   "collective communication has " << c.size() << " processes "
+                   "but is not based on MPI");
+      return MPI_COMM_SELF;
+    }
+
+    //! MPI communicator of a collective communication object
+    inline MPI_Comm mpiCommunicator(const CollectiveCommunication<MPI_Comm>& c)
+    {
+      return c;
+    }
+#endif
+
+    //! Write the pieces of several processes into one .vtu/.vtp file
+    /**
+     * Each process contributes the contents of its VTUStage as one Piece
+     * element of a common file, the data arrays are stored in an appended
+     * raw section.  The position of each piece in the file follows from
+     * exclusive prefix sums over the sizes of the pieces, so no process
+     * needs to know the data of the others.
+     *
+     * The processes may be split into groups, each group writes its own
+     * file.  write() writes the file of a group collectively with MPI-IO,
+     * every process writes its own part.  gather() sends the pieces to the
+     * first process of the group (the aggregator), which writes the file
+     * alone.
+     *
+     * Without MPI there is only one process, and both methods write a
+     * file with a single piece.
+     */
+    class SharedVTUWriter {
+#if HAVE_MPI
+      MPI_Comm comm;
+      // whether comm was created by the constructor
+      bool ownComm;
+#endif
+      int rank;
+      int size;
+      int group_;
+      int groups_;
+
+      // maximal number of bytes passed to a single MPI call
+      static std::size_t chunkSize() { return std::size_t(1) << 26; }
+
+    public:
+      //! all processes of the communication object write one file
+      /**
+       * \param cc Collective communication object, e.g. the one of a grid
+       *           view.
+       */
+      template<class C>
+      explicit SharedVTUWriter(const C& cc)
+        : rank(0), size(1), group_(0), groups_(1)
+      {
+#if HAVE_MPI
+        comm = mpiCommunicator(cc);
+        ownComm = false;
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_size(comm, &size);
+#endif
+      }
+
+      //! split the processes of the communication object into groups
+      /**
+       * \param cc        Collective communication object, e.g. the one of a
+       *                  grid view.
+       * \param groupSize Number of consecutive processes writing one file.
+       *                  If 0, the processes of one node (sharing memory)
+       *                  form a group; this requires MPI 3.
+       *
+       * \throw NotImplemented groupSize is 0 and MPI is older than 3.0.
+       */
+      template<class C>
+      SharedVTUWriter(const C& cc, int groupSize)
+        : rank(0), size(1), group_(0), groups_(1)
+      {
+#if HAVE_MPI
+        MPI_Comm all = mpiCommunicator(cc);
+        int allRank;
+        MPI_Comm_rank(all, &allRank);
+        if(groupSize > 0)
+          MPI_Comm_split(all, allRank / groupSize, allRank, &comm);
+        else {
+#if MPI_VERSION >= 3
+          MPI_Comm_split_type(all, MPI_COMM_TYPE_SHARED, allRank,
+                              MPI_INFO_NULL, &comm);
+#else
+          DUNE_THROW(NotImplemented, "SharedVTUWriter: groups of the "
+                     "processes of a node require MPI 3");
+#endif
+        }
+        ownComm = true;
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_size(comm, &size);
+
+        // number the groups in the order of their first processes
+        int first = (rank == 0);
+        MPI_Exscan(&first, &group_, 1, MPI_INT, MPI_SUM, all);
+        if(allRank == 0)
+          group_ = 0;
+        MPI_Bcast(&group_, 1, MPI_INT, 0, comm);
+        MPI_Allreduce(&first, &groups_, 1, MPI_INT, MPI_SUM, all);
+#endif
+      }
+
+      ~SharedVTUWriter()
+      {
+#if HAVE_MPI
+        if(ownComm)
+          MPI_Comm_free(&comm);
+#endif
+      }
+
+      //! index of the group of this process
+      int group() const { return group_; }
+
+      //! number of groups, i.e. number of files written
+      int groups() const { return groups_; }
+
+      //! write the pieces of the group collectively with MPI-IO
+      /**
+       * \param stage    The piece of this process.
+       * \param filename Name of the file of the group.
+       *
+       * Must be called by all processes of the group.
+       *
+       * \throw IOError Opening or writing the file failed.
+       */
+      void write(const VTUStage& stage, const std::string& filename) const
+      {
+#if HAVE_MPI
+        std::string xml;
+        std::vector<char> data;
+        prepare(stage, xml, data);
+
+        // position of the blocks of this process in the file
+        long long sizes[2] = { (long long)xml.size(), (long long)data.size() };
+        long long starts[2] = { 0, 0 };
+        long long totals[2];
+        MPI_Exscan(sizes, starts, 2, MPI_LONG_LONG_INT, MPI_SUM, comm);
+        if(rank == 0)
+          starts[0] = starts[1] = 0;
+        MPI_Allreduce(sizes, totals, 2, MPI_LONG_LONG_INT, MPI_SUM, comm);
+
+        MPI_File file;
+        if(MPI_File_open(comm, const_cast<char*>(filename.c_str()),
+                         MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
+                         &file) != MPI_SUCCESS)
+          DUNE_THROW(IOError, "SharedVTUWriter: could not open " << filename);
+        bool ok = MPI_File_set_size(file, 0) == MPI_SUCCESS;
+        ok = writeAll(file, starts[0], xml.data(), xml.size()) && ok;
+        ok = writeAll(file, totals[0] + starts[1],
+                      data.empty() ? 0 : &data[0], data.size()) && ok;
+        MPI_File_close(&file);
+        if(!ok)
+          DUNE_THROW(IOError, "SharedVTUWriter: could not write " << filename);
+#else
+        gather(stage, filename);
+#endif
+      }
+
+      //! write the pieces of the group by its first process
+      /**
+       * \param stage    The piece of this process.
+       * \param filename Name of the file of the group; only used by the
+       *                 first process of the group.
+       *
+       * Must be called by all processes of the group.  The aggregator
+       * receives and writes the data of one process at a time.
+       *
+       * \throw IOError Opening or writing the file failed.
+       */
+      void gather(const VTUStage& stage, const std::string& filename) const
+      {
+        std::string xml;
+        std::vector<char> data;
+        prepare(stage, xml, data);
+
+        std::ofstream file;
+        int ok = 1;
+        if(rank == 0) {
+          file.open(filename.c_str(), std::ios::binary);
+          ok = file.is_open();
+        }
+#if HAVE_MPI
+        MPI_Bcast(&ok, 1, MPI_INT, 0, comm);
+#endif
+        if(!ok)
+          DUNE_THROW(IOError, "SharedVTUWriter: could not open " << filename);
+
+        if(rank == 0) {
+          file.write(xml.data(), xml.size());
+#if HAVE_MPI
+          std::vector<char> buffer;
+          for(int r = 1; r < size; ++r)
+            receive(file, r, buffer);
+#endif
+          file.write(data.empty() ? 0 : &data[0], data.size());
+#if HAVE_MPI
+          for(int r = 1; r < size; ++r)
+            receive(file, r, buffer);
+#endif
+          file.close();
+          ok = !file.fail();
+        }
+#if HAVE_MPI
+        else {
+          send(xml.data(), xml.size());
+          send(data.empty() ? 0 : &data[0], data.size());
+        }
+        MPI_Bcast(&ok, 1, MPI_INT, 0, comm);
+#endif
+        if(!ok)
+          DUNE_THROW(IOError, "SharedVTUWriter: could not write " << filename);
+      }
+
+    private:
+      // not copyable, the writer may own a communicator
+      SharedVTUWriter(const SharedVTUWriter&);
+      SharedVTUWriter& operator=(const SharedVTUWriter&);
+
+      //! produce the blocks of this process
+      /**
+       * xml receives the Piece element, data the appended data of the
+       * piece.  The first process adds the beginning of the file to xml,
+       * the last one adds the beginning of the appended section to xml and
+       * the end of the file to data.  The file consists of the xml blocks
+       * of all processes followed by their data blocks.
+       */
+      void prepare(const VTUStage& stage, std::string& xml,
+                   std::vector<char>& data) const
+      {
+        // position of the piece in the appended section
+        long long offset = 0;
+#if HAVE_MPI
+        long long bytes = stage.appendedRawSize();
+        MPI_Exscan(&bytes, &offset, 1, MPI_LONG_LONG_INT, MPI_SUM, comm);
+        if(rank == 0)
+          offset = 0;
+#endif
+
+        const std::string fileType =
+          stage.fileType == polyData ? "PolyData" : "UnstructuredGrid";
+        std::ostringstream s;
+        Indent indent;
+        if(rank == 0) {
+          s << indent << "<?xml version=\"1.0\"?>\n";
+          s << indent << "<VTKFile"
+            << " type=\"" << fileType << "\""
+            << " version=\"0.1\""
+            << " byte_order=\"" << getEndiannessString() << "\">\n";
+          ++indent;
+          s << indent << "<" << fileType << ">\n";
+        }
+        else
+          ++indent;
+        ++indent;
+        stage.writeRawPiece(s, indent, offset);
+        --indent;
+        if(rank == size-1) {
+          s << indent << "</" << fileType << ">\n";
+          s << indent << "<AppendedData encoding=\"raw\">\n";
+          ++indent;
+          s << indent << "_";
+        }
+        xml = s.str();
+
+        data.clear();
+        stage.appendRawData(data);
+        if(rank == size-1) {
+          std::ostringstream end;
+          end << "\n";
+          --indent;
+          end << indent << "</AppendedData>\n";
+          --indent;
+          end << indent << "</VTKFile>\n";
+          const std::string& e = end.str();
+          data.insert(data.end(), e.begin(), e.end());
+        }
+      }
+
+#if HAVE_MPI
+      //! collective write in chunks, returns false on failure
+      bool writeAll(MPI_File file, long long position, const char* buffer,
+                    std::size_t bytes) const
+      {
+        static char dummy;
+        if(bytes == 0)
+          buffer = &dummy;
+
+        // all processes must take part in each collective call
+        long long chunks = (bytes + chunkSize() - 1) / chunkSize();
+        long long maxChunks;
+        MPI_Allreduce(&chunks, &maxChunks, 1, MPI_LONG_LONG_INT, MPI_MAX,
+                      comm);
+        int error = 0;
+        for(long long i = 0; i < maxChunks; ++i) {
+          const std::size_t begin = std::min<std::size_t>(bytes,
+                                                          i*chunkSize());
+          const std::size_t n = std::min(bytes - begin, chunkSize());
+          MPI_Status status;
+          if(MPI_File_write_at_all(file, position + begin,
+                                   const_cast<char*>(buffer + begin), n,
+                                   MPI_BYTE, &status) != MPI_SUCCESS)
+            error = 1;
+        }
+        int anyError;
+        MPI_Allreduce(&error, &anyError, 1, MPI_INT, MPI_MAX, comm);
+        return anyError == 0;
+      }
+
+      //! send a block to the aggregator
+      void send(const char* buffer, std::size_t bytes) const
+      {
+        long long n = bytes;
+        MPI_Send(&n, 1, MPI_LONG_LONG_INT, 0, 0, comm);
+        for(std::size_t begin = 0; begin < bytes; begin += chunkSize())
+          MPI_Send(const_cast<char*>(buffer + begin),
+                   std::min(bytes - begin, chunkSize()), MPI_BYTE, 0, 0,
+                   comm);
+      }
+
+      //! receive a block from process r and write it to the file
+      void receive(std::ofstream& file, int r,
+                   std::vector<char>& buffer) const
+      {
+        long long n;
+        MPI_Recv(&n, 1, MPI_LONG_LONG_INT, r, 0, comm, MPI_STATUS_IGNORE);
+        const std::size_t bytes = n;
+        buffer.resize(std::min(bytes, chunkSize()));
+        for(std::size_t begin = 0; begin < bytes; begin += chunkSize()) {
+          const std::size_t count = std::min(bytes - begin, chunkSize());
+          MPI_Recv(&buffer[0], count, MPI_BYTE, r, 0, comm,
+                   MPI_STATUS_IGNORE);
+          file.write(&buffer[0], count);
+        }
+      }
+#endif
+    };
+
+  } // namespace VTK
+
+  //! \} group VTK
+
+} // namespace Dune
+
+#endif // DUNE_GRID_IO_FILE_VTK_SHAREDVTUWRITER_HH
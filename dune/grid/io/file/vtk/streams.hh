@@ -4,30 +4,43 @@
 #ifndef DUNE_GRID_IO_FILE_VTK_STREAMS_HH
 #define DUNE_GRID_IO_FILE_VTK_STREAMS_HH
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <ostream>
+#include <vector>
 
 #include <dune/grid/io/file/vtk/b64enc.hh>
 
 namespace Dune {
 
   //! class to base64 encode a stream of data
+  /**
+   * The data is collected in a buffer and encoded by base64Encode() in
+   * blocks of blockBytes bytes.  The text of each block is passed to the
+   * underlying stream with a single call to write().  Large arrays passed
+   * to write(const X*, std::size_t) are encoded directly from the array
+   * without copying them into the buffer.
+   */
   class Base64Stream {
     std::ostream& s;
-    b64chunk chunk;
-    char obuf[4];
+    // collected input, its size is always a multiple of three
+    std::vector<char> ibuf;
+    std::vector<char> obuf;
+    std::size_t fill;
 
   public:
+    //! number of input bytes encoded at once
+    static const std::size_t blockBytes = 3*4096;
+
     //! Construct a Base64Stream
     /**
      * \param s_ The stream the resulting base64-encoded text will be written
      *           to.
      */
     Base64Stream(std::ostream& s_)
-      : s(s_)
-    {
-      // reset chunk
-      chunk.txt.read(0,0);
-    }
+      : s(s_), ibuf(blockBytes), obuf(blockBytes/3*4), fill(0)
+    { }
 
     //! encode a data item
     /**
@@ -39,16 +52,27 @@ namespace Dune {
     template <class X>
     void write(X & data)
     {
-      char* p = reinterpret_cast<char*>(&data);
-      for (size_t len = sizeof(X); len > 0; len--,p++)
+      const char* p = reinterpret_cast<const char*>(&data);
+      if (fill + sizeof(X) <= blockBytes)
       {
-        chunk.txt.put(*p);
-        if (chunk.txt.size == 3)
-        {
-          chunk.data.write(obuf);
-          s.write(obuf,4);
-        }
+        std::memcpy(&ibuf[fill], p, sizeof(X));
+        fill += sizeof(X);
+        if (fill == blockBytes)
+          encodeBuffer();
       }
+      else
+        append(p, sizeof(X));
+    }
+
+    //! encode n consecutive data items
+    /**
+     * Equivalent to calling write() for each of the n items starting at
+     * data.
+     */
+    template <class X>
+    void write(const X* data, std::size_t n)
+    {
+      append(reinterpret_cast<const char*>(data), n*sizeof(X));
     }
 
     //! flush the current unwritten data to the stream.
@@ -56,15 +80,15 @@ namespace Dune {
      * If the size of the received input is not a multiple of three bytes, an
      * end-marker will be written.
      *
-     * Calling this function a second time without calling b64enc() or calling
+     * Calling this function a second time without calling write() or calling
      * it right after construction has no effect.
      */
     void flush()
     {
-      if (chunk.txt.size > 0)
+      if (fill > 0)
       {
-        chunk.data.write(obuf);
-        s.write(obuf,4);
+        s.write(&obuf[0], base64Encode(&ibuf[0], fill, &obuf[0]));
+        fill = 0;
       }
     }
 
@@ -75,6 +99,42 @@ namespace Dune {
     ~Base64Stream() {
       flush();
     }
+
+  private:
+    //! encode and write the full buffer
+    void encodeBuffer()
+    {
+      base64EncodeTriples(&ibuf[0], blockBytes, &obuf[0]);
+      s.write(&obuf[0], obuf.size());
+      fill = 0;
+    }
+
+    //! add bytes to the input
+    void append(const char* p, std::size_t bytes)
+    {
+      // complete the buffer
+      if (fill > 0)
+      {
+        const std::size_t n = std::min(bytes, blockBytes - fill);
+        std::memcpy(&ibuf[fill], p, n);
+        fill += n;
+        p += n;
+        bytes -= n;
+        if (fill < blockBytes)
+          return;
+        encodeBuffer();
+      }
+      // encode whole blocks directly from the input
+      for (; bytes >= blockBytes; p += blockBytes, bytes -= blockBytes)
+      {
+        base64EncodeTriples(p, blockBytes, &obuf[0]);
+        s.write(&obuf[0], obuf.size());
+      }
+      // keep the rest
+      if (bytes > 0)
+        std::memcpy(&ibuf[0], p, bytes);
+      fill = bytes;
+    }
   };
 
   //! write out data in binary
@@ -93,6 +153,13 @@ namespace Dune {
       char* p = reinterpret_cast<char*>(&data);
       s.write(p,sizeof(T));
     }
+
+    //! write n consecutive data items to stream
+    template<class T>
+    void write (const T* data, std::size_t n)
+    {
+      s.write(reinterpret_cast<const char*>(data),n*sizeof(T));
+    }
   private:
     std::ostream& s;
   };
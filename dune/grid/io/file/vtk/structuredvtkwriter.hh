@@ -0,0 +1,635 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_GRID_IO_FILE_VTK_STRUCTUREDVTKWRITER_HH
+#define DUNE_GRID_IO_FILE_VTK_STRUCTUREDVTKWRITER_HH
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/array.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/path.hh>
+#include <dune/common/shared_ptr.hh>
+#include <dune/grid/common/capabilities.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+#include <dune/grid/io/file/vtk/vtiwriter.hh>
+#include <dune/grid/io/file/vtk/vtkwriter.hh>
+#include <dune/grid/io/file/vtk/vtrwriter.hh>
+
+/** @file
+    @brief Provides ImageData and RectilinearGrid output for Cartesian grids
+ */
+
+namespace Dune
+{
+  /**
+   * @brief Writer for grid functions on Cartesian grids in the VTK ImageData
+   *        and RectilinearGrid formats.
+   * @ingroup VTK
+   *
+   * For grids with Capabilities::isCartesian, e.g. YaspGrid and SGrid, the
+   * coordinates, connectivity, offsets and types of the unstructured format
+   * are implicit.  If all cells have the same size, the grid is written as
+   * ImageData (.vti), which stores only the extent, origin and spacing.
+   * Otherwise, e.g. for a tensor product YaspGrid, it is written as
+   * RectilinearGrid (.vtr), which stores the coordinates of the points in
+   * each direction.  In parallel, each process writes the extent of its
+   * interior cells and rank 0 writes a .pvti or .pvtr file describing the
+   * decomposition.  Ranks must own a box of cells, as is the case for the
+   * Torus decomposition of YaspGrid.
+   *
+   * For all other grids the output is the same as for the VTKWriter.
+   *
+   * The data is added as for the VTKWriter.  Since neighboring pieces
+   * share the points on their common boundary, the vertex data is always
+   * written in conforming mode.
+   */
+  template< class GridView >
+  class StructuredVTKWriter
+    : public VTKWriter<GridView>
+  {
+    typedef VTKWriter<GridView> Base;
+    typedef typename GridView::Grid Grid;
+    typedef typename GridView::ctype DT;
+    enum { n = GridView::dimension };
+    enum { w = GridView::dimensionworld };
+
+    typedef typename Base::CellIterator CellIterator;
+    typedef typename Base::FunctionIterator FunctionIterator;
+    typedef typename Base::VTKFunctionPtr VTKFunctionPtr;
+    using Base::cellBegin;
+    using Base::cellEnd;
+    using Base::celldata;
+    using Base::gridView_;
+    using Base::vertexdata;
+
+  public:
+    typedef typename Base::VTKFunction VTKFunction;
+
+    //! whether the grid is written as ImageData or RectilinearGrid
+    static const bool structured =
+      Capabilities::isCartesian<Grid>::v && int(n) == int(w);
+
+    /**
+     * @brief Construct a StructuredVTKWriter working on a specific GridView.
+     *
+     * @param gridView The gridView the grid functions live on.
+     * @param dm       The data mode, only used if the grid is not Cartesian.
+     */
+    explicit StructuredVTKWriter ( const GridView &gridView,
+                                   VTK::DataMode dm = VTK::conforming )
+      : Base(gridView, dm)
+    { }
+
+    /** \brief write output
+     *
+     *  Writes a .vti (.vtr) file for serial runs and .vti (.vtr) files and
+     *  a .pvti (.pvtr) file for parallel runs, like VTKWriter::write().
+     *
+     *  \param[in]  name  basic name to write (may not contain a path)
+     *  \param[in]  type  type of output (e.g,, ASCII) (optional)
+     *
+     *  \throw NotImplemented The interior cells of a process do not form a
+     *                        box of cells of a tensor product grid.  This is
+     *                        thrown on all processes.
+     */
+    std::string write ( const std::string &name,
+                        VTK::OutputType type = VTK::ascii )
+    {
+      if (!structured)
+        return Base::write(name, type);
+      if (gridView_.comm().size() > 1)
+        return pwrite(name, "", "", type);
+
+      buildStructure();
+      const std::string pieceName =
+        extension(this->getSerialPieceName(name, ""), pieceExtension());
+      writePieceFile(pieceName, type);
+      return pieceName;
+    }
+
+    /** \brief write output into a given directory
+     *
+     * \param name       Base name of the output files.
+     * \param path       Directory where to put the .pvti (.pvtr) file.
+     * \param extendpath Directory where to put the .vti (.vtr) file of this
+     *                   process, relative to path.
+     * \param type       How to encode the data in the file.
+     *
+     * See VTKWriter::pwrite().
+     */
+    std::string pwrite ( const std::string & name, const std::string & path,
+                         const std::string & extendpath,
+                         VTK::OutputType type = VTK::ascii )
+    {
+      if (!structured)
+        return Base::pwrite(name, path, extendpath, type);
+
+      const int rank = gridView_.comm().rank();
+      const int size = gridView_.comm().size();
+      const std::string piecepath = concatPaths(path, extendpath);
+      const std::string relpiecepath = relativePath(path, piecepath);
+
+      buildStructure();
+      writePieceFile(extension(this->getParallelPieceName(name, piecepath,
+                                                          rank, size),
+                               pieceExtension()),
+                     type);
+
+      // rank 0 needs the extents of all pieces for the parallel file
+      std::vector<int> extents(6*size);
+      gridView_.comm().gather(&pieceExtent_[0], &extents[0], 6, 0);
+      gridView_.comm().barrier();
+
+      const std::string fullname =
+        extension(this->getParallelHeaderName(name, path, size),
+                  std::string(".p") + pieceExtension().substr(1));
+      if (rank == 0)
+      {
+        std::ofstream file;
+        file.exceptions(std::ios_base::badbit | std::ios_base::failbit |
+                        std::ios_base::eofbit);
+        file.open(fullname.c_str());
+        if (!file.is_open())
+          DUNE_THROW(IOError, "Could not write to parallel file "
+                     << fullname);
+        if (rectilinear_)
+        {
+          VTK::PVTRWriter writer(file);
+          writer.beginMain(wholeExtent_);
+          writeParallelHeader(writer, name, relpiecepath, extents);
+        }
+        else
+        {
+          VTK::PVTIWriter writer(file);
+          writer.beginMain(wholeExtent_, origin_, spacing_);
+          writeParallelHeader(writer, name, relpiecepath, extents);
+        }
+        file.close();
+      }
+      gridView_.comm().barrier();
+      return fullname;
+    }
+
+  private:
+    typedef MultipleCodimMultipleGeomTypeMapper< GridView, MCMGElementLayout >
+    ElementMapper;
+    typedef MultipleCodimMultipleGeomTypeMapper< GridView, MCMGVertexLayout >
+    VertexMapper;
+
+    //! replace the extension of a file name
+    static std::string extension (const std::string& name,
+                                  const std::string& ext)
+    {
+      return name.substr(0, name.rfind('.')) + ext;
+    }
+
+    //! extension of the piece files
+    std::string pieceExtension () const
+    {
+      return rectilinear_ ? ".vtr" : ".vti";
+    }
+
+    //! number of cells (points) in direction d of the piece
+    int cells (int d) const
+    {
+      return pieceExtent_[2*d+1] - pieceExtent_[2*d];
+    }
+
+    //! tolerance for comparing coordinates in direction d
+    double tolerance (int d) const
+    {
+      const std::vector<double>& x = coordinates_[d];
+      return x.empty() ? 0.0 : 1e-8*(x.back() - x.front());
+    }
+
+    //! sort the coordinates x of this process and merge them with those of
+    //! all other processes, coordinates closer than the tolerance are merged
+    void gatherCoordinates (std::vector<double>& x) const
+    {
+      std::sort(x.begin(), x.end());
+      x.erase(std::unique(x.begin(), x.end()), x.end());
+
+      // all processes contribute the same number of values, padded with
+      // values which are removed again
+      const double pad = std::numeric_limits<double>::max();
+      const int count = gridView_.comm().max(int(x.size()));
+      if (count == 0)
+        return;
+      x.resize(count, pad);
+      std::vector<double> all(count*gridView_.comm().size());
+      gridView_.comm().allgather(&x[0], count, &all[0]);
+      std::sort(all.begin(), all.end());
+      all.erase(std::find(all.begin(), all.end(), pad), all.end());
+
+      x.clear();
+      const double tol = 1e-8*(all.back() - all.front());
+      for (std::size_t i=0; i<all.size(); ++i)
+        if (x.empty() || all[i] - x.back() > tol)
+          x.push_back(all[i]);
+    }
+
+    //! compute extents, coordinates and the index of each cell
+    /**
+     * This is collective, errors are thrown on all processes.
+     */
+    void buildStructure ()
+    {
+      // lower left and upper right corners of the cells in iteration order
+      std::vector<double> lower, upper;
+      for (int d=0; d<n; ++d)
+        coordinates_[d].clear();
+      for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
+      {
+        const typename GridView::template Codim<0>::Geometry& g =
+          it->geometry();
+        const FieldVector<DT, w> x0 = g.corner(0);
+        const FieldVector<DT, w> x1 = g.corner((1<<n)-1);
+        for (int d=0; d<n; ++d)
+        {
+          lower.push_back(x0[d]);
+          upper.push_back(x1[d]);
+          coordinates_[d].push_back(x0[d]);
+          coordinates_[d].push_back(x1[d]);
+        }
+      }
+      for (int d=0; d<n; ++d)
+        gatherCoordinates(coordinates_[d]);
+
+      // integer positions of the cells, the upper corner of each cell has
+      // to be the next coordinate
+      std::ostringstream error;
+      const std::size_t ncells = lower.size() / n;
+      cellIndex_.resize(lower.size());
+      array<int, n> lo, hi;
+      std::fill(lo.begin(), lo.end(), std::numeric_limits<int>::max());
+      std::fill(hi.begin(), hi.end(), -1);
+      for (std::size_t c=0; c<ncells; ++c)
+        for (int d=0; d<n; ++d)
+        {
+          const std::vector<double>& x = coordinates_[d];
+          const double tol = tolerance(d);
+          const int i = std::lower_bound(x.begin(), x.end(),
+                                         lower[c*n+d] - tol) - x.begin();
+          if (i+1 >= int(x.size())
+              || std::abs(x[i+1] - upper[c*n+d]) > tol)
+          {
+            if (error.str().empty())
+              error << "the cells of process " << gridView_.comm().rank()
+                    << " do not form a tensor product grid with the cells "
+                    << "of all processes";
+            cellIndex_[c*n+d] = 0;
+            continue;
+          }
+          cellIndex_[c*n+d] = i;
+          lo[d] = std::min(lo[d], i);
+          hi[d] = std::max(hi[d], i);
+        }
+
+      // the grid is ImageData if all cells have the same size
+      rectilinear_ = false;
+      for (int d=0; d<n; ++d)
+      {
+        const std::vector<double>& x = coordinates_[d];
+        for (std::size_t i=1; i+1<x.size(); ++i)
+          rectilinear_ = rectilinear_
+                         || std::abs((x[i+1] - x[i]) - (x[1] - x[0]))
+                         > 1e-8*(x[1] - x[0]);
+      }
+
+      // ImageData and RectilinearGrid are always three dimensional
+      std::fill(wholeExtent_.begin(), wholeExtent_.end(), 0);
+      std::fill(pieceExtent_.begin(), pieceExtent_.end(), 0);
+      std::fill(origin_.begin(), origin_.end(), 0.0);
+      std::fill(spacing_.begin(), spacing_.end(), 1.0);
+      std::size_t boxCells = 1;
+      for (int d=0; d<n; ++d)
+      {
+        // an empty piece has the extent 0 0
+        if (ncells == 0 || !error.str().empty())
+        {
+          lo[d] = 0;
+          hi[d] = -1;
+        }
+        pieceExtent_[2*d] = lo[d];
+        pieceExtent_[2*d+1] = hi[d] + 1;
+        boxCells *= cells(d);
+        const std::vector<double>& x = coordinates_[d];
+        if (x.size() >= 2)
+        {
+          wholeExtent_[2*d+1] = x.size() - 1;
+          origin_[d] = x[0];
+          spacing_[d] = x[1] - x[0];
+        }
+      }
+      if (ncells > 0 && error.str().empty() && boxCells != ncells)
+        error << "the interior cells of process " << gridView_.comm().rank()
+              << " do not form a box";
+
+      // throw on all processes, not only on those with an error
+      if (gridView_.comm().max(int(!error.str().empty())))
+        DUNE_THROW(NotImplemented, "StructuredVTKWriter: "
+                   << (error.str().empty() ? "the cells of another process "
+                       "do not fit into a box of a tensor product grid"
+                       : error.str()));
+
+      ncells_ = ncells;
+      npoints_ = 1;
+      for (int d=0; d<n; ++d)
+        npoints_ *= (ncells > 0) ? cells(d) + 1 : 0;
+
+      // can the arrays of P0/P1 functions be written as they are?
+      cellsInOrder_ = vertsInOrder_ = false;
+      if (gridView_.comm().size() == 1)
+      {
+        ElementMapper elementMapper(gridView_);
+        VertexMapper vertexMapper(gridView_);
+        cellsInOrder_ = (elementMapper.size() == int(ncells_));
+        vertsInOrder_ = (vertexMapper.size() == int(npoints_));
+        std::size_t c = 0;
+        for (CellIterator it=cellBegin(); it!=cellEnd(); ++it, ++c)
+        {
+          cellsInOrder_ = cellsInOrder_
+                          && elementMapper.map(*it) == int(cellPosition(c));
+          for (int i=0; vertsInOrder_ && i<(1<<n); ++i)
+            vertsInOrder_ = (vertexMapper.map(*it, i, n)
+                             == int(pointPosition(c, i)));
+        }
+      }
+    }
+
+    //! position of the c-th cell of the iteration in the piece
+    std::size_t cellPosition (std::size_t c) const
+    {
+      std::size_t pos = 0;
+      for (int d=n-1; d>=0; --d)
+        pos = pos*cells(d) + (cellIndex_[c*n+d] - pieceExtent_[2*d]);
+      return pos;
+    }
+
+    //! position of corner i of the c-th cell of the iteration in the piece
+    std::size_t pointPosition (std::size_t c, int i) const
+    {
+      std::size_t pos = 0;
+      for (int d=n-1; d>=0; --d)
+        pos = pos*(cells(d)+1)
+              + (cellIndex_[c*n+d] - pieceExtent_[2*d] + ((i>>d)&1));
+      return pos;
+    }
+
+    //! names of the default scalars and vectors fields
+    static void defaultFields (const std::list<VTKFunctionPtr>& data,
+                               std::string& scalars, std::string& vectors)
+    {
+      scalars = vectors = "";
+      for (FunctionIterator it=data.begin(); it!=data.end(); ++it)
+        if ((*it)->ncomps()==1 && scalars.empty())
+          scalars = (*it)->name();
+        else if ((*it)->ncomps()>1 && vectors.empty())
+          vectors = (*it)->name();
+    }
+
+    //! write the .vti or .vtr file of this process
+    void writePieceFile (const std::string& pieceName, VTK::OutputType type)
+    {
+      std::ofstream file;
+      file.exceptions(std::ios_base::badbit | std::ios_base::failbit |
+                      std::ios_base::eofbit);
+      file.open(pieceName.c_str(), std::ios::binary);
+      if (!file.is_open())
+        DUNE_THROW(IOError, "Could not write to piece file " << pieceName);
+      if (rectilinear_)
+      {
+        VTK::VTRWriter writer(file, type);
+        writer.beginMain(wholeExtent_, pieceExtent_);
+        writeAllData(writer);
+        writer.endMain();
+
+        if (writer.beginAppended())
+          writeAllData(writer);
+        writer.endAppended();
+      }
+      else
+      {
+        VTK::VTIWriter writer(file, type);
+        writer.beginMain(wholeExtent_, pieceExtent_, origin_, spacing_);
+        writeAllData(writer);
+        writer.endMain();
+
+        if (writer.beginAppended())
+          writeAllData(writer);
+        writer.endAppended();
+      }
+      file.close();
+    }
+
+    //! ImageData has no coordinates
+    void writeCoordinates (VTK::VTIWriter&)
+    { }
+
+    //! write the coordinates of the points of the piece in each direction
+    void writeCoordinates (VTK::VTRWriter& writer)
+    {
+      const char* names[] = { "x", "y", "z" };
+      writer.beginCoordinates();
+      for (int d=0; d<3; ++d)
+      {
+        const unsigned ncoords = pieceExtent_[2*d+1] - pieceExtent_[2*d] + 1;
+        shared_ptr<VTK::DataArrayWriter<double> > p
+          (writer.makeArrayWriter<double>(names[d], 1, ncoords));
+        if(p->writeIsNoop())
+          continue;
+        for (unsigned i=0; i<ncoords; ++i)
+          p->write(d < n && !coordinates_[d].empty() ?
+                   coordinates_[d][pieceExtent_[2*d] + i] : 0.0);
+      }
+      writer.endCoordinates();
+    }
+
+    template<class Writer>
+    void writeAllData (Writer& writer)
+    {
+      std::string scalars, vectors;
+      if (!vertexdata.empty())
+      {
+        defaultFields(vertexdata, scalars, vectors);
+        writer.beginPointData(scalars, vectors);
+        for (FunctionIterator it=vertexdata.begin(); it!=vertexdata.end();
+             ++it)
+          writeStructuredFunction(writer, **it, true);
+        writer.endPointData();
+      }
+      if (!celldata.empty())
+      {
+        defaultFields(celldata, scalars, vectors);
+        writer.beginCellData(scalars, vectors);
+        for (FunctionIterator it=celldata.begin(); it!=celldata.end(); ++it)
+          writeStructuredFunction(writer, **it, false);
+        writer.endCellData();
+      }
+      writeCoordinates(writer);
+    }
+
+    //! write the values of f on the points or cells of the piece
+    template<class Writer>
+    void writeStructuredFunction (Writer& writer,
+                                  const VTKFunction& f, bool vertices)
+    {
+      switch(f.precision()) {
+      case VTK::int32 :
+        writeTypedStructuredFunction<int>(writer, f, vertices);
+        return;
+      case VTK::uint8 :
+        writeTypedStructuredFunction<unsigned char>(writer, f, vertices);
+        return;
+      case VTK::uint32 :
+        writeTypedStructuredFunction<unsigned>(writer, f, vertices);
+        return;
+      case VTK::float32 :
+        writeTypedStructuredFunction<float>(writer, f, vertices);
+        return;
+      case VTK::float64 :
+        writeTypedStructuredFunction<double>(writer, f, vertices);
+        return;
+      }
+      DUNE_THROW(IOError, "StructuredVTKWriter: unsupported Precision "
+                 << f.precision() << " of function " << f.name());
+    }
+
+    //! write the values of f with data type T
+    /**
+     * The values are evaluated into an array in the order of the piece.
+     * If the function provides its values as an array which is in this
+     * order already, it is written directly.
+     */
+    template<class T, class Writer>
+    void writeTypedStructuredFunction (Writer& writer,
+                                       const VTKFunction& f, bool vertices)
+    {
+      unsigned writecomps = f.ncomps();
+      if(writecomps == 2) writecomps = 3;
+      const std::size_t nitems = vertices ? npoints_ : ncells_;
+      shared_ptr<VTK::DataArrayWriter<T> > p
+        (writer.template makeArrayWriter<T>(f.name(), writecomps, nitems));
+      if(p->writeIsNoop())
+        return;
+
+      const VTK::ValueArray values = f.values();
+      if(values.data != 0 && values.size == nitems && writecomps == 1
+         && (vertices ? vertsInOrder_ : cellsInOrder_))
+      {
+        Base::writeValueArray(*p, values);
+        return;
+      }
+
+      std::vector<double> buffer(nitems*writecomps, 0.0);
+      std::size_t c = 0;
+      if (vertices)
+      {
+        std::vector<bool> done(nitems, false);
+        FieldVector<DT, n> xi;
+        for (CellIterator it=cellBegin(); it!=cellEnd(); ++it, ++c)
+          for (int i=0; i<(1<<n); ++i)
+          {
+            const std::size_t pos = pointPosition(c, i);
+            if (done[pos])
+              continue;
+            done[pos] = true;
+            for (int d=0; d<n; ++d)
+              xi[d] = (i>>d)&1;
+            f.evaluateAll(*it, xi, &buffer[pos*writecomps]);
+          }
+      }
+      else
+        for (CellIterator it=cellBegin(); it!=cellEnd(); ++it, ++c)
+          f.evaluateAll(*it, it.position(),
+                        &buffer[cellPosition(c)*writecomps]);
+      if (!buffer.empty())
+        Base::writeValues(*p, &buffer[0], buffer.size());
+    }
+
+    //! write the .pvti or .pvtr file
+    /**
+     * The main section has been begun by the caller.
+     */
+    template<class Writer>
+    void writeParallelHeader (Writer& writer, const std::string& piecename,
+                              const std::string& piecepath,
+                              const std::vector<int>& extents) const
+    {
+      std::string scalars, vectors;
+      defaultFields(vertexdata, scalars, vectors);
+      writer.beginPointData(scalars, vectors);
+      for (FunctionIterator it=vertexdata.begin(); it!=vertexdata.end(); ++it)
+        writer.addArray((*it)->name(), (*it)->ncomps() == 2 ? 3
+                        : (*it)->ncomps(), (*it)->precision());
+      writer.endPointData();
+
+      defaultFields(celldata, scalars, vectors);
+      writer.beginCellData(scalars, vectors);
+      for (FunctionIterator it=celldata.begin(); it!=celldata.end(); ++it)
+        writer.addArray((*it)->name(), (*it)->ncomps() == 2 ? 3
+                        : (*it)->ncomps(), (*it)->precision());
+      writer.endCellData();
+      addCoordinates(writer);
+
+      const int size = extents.size() / 6;
+      for (int i=0; i<size; ++i)
+      {
+        VTK::Extent extent;
+        std::copy(&extents[6*i], &extents[6*i] + 6, extent.begin());
+        // pieces without cells are not written
+        if (extent[1] == extent[0])
+          continue;
+        writer.addPiece(extent,
+                        extension(this->getParallelPieceName(piecename,
+                                                             piecepath,
+                                                             i, size),
+                                  pieceExtension()));
+      }
+      writer.endMain();
+    }
+
+    //! ImageData has no coordinates
+    static void addCoordinates (VTK::PVTIWriter&)
+    { }
+
+    //! declare the coordinate arrays of the pieces
+    static void addCoordinates (VTK::PVTRWriter& writer)
+    {
+      writer.beginCoordinates();
+      writer.addArray("x", 1, VTK::float64);
+      writer.addArray("y", 1, VTK::float64);
+      writer.addArray("z", 1, VTK::float64);
+      writer.endCoordinates();
+    }
+
+    //! extent of the whole grid and of the piece of this process
+    VTK::Extent wholeExtent_;
+    VTK::Extent pieceExtent_;
+    //! whether the cells differ in size, i.e. the output is RectilinearGrid
+    bool rectilinear_;
+    //! coordinates of the points of the whole grid in each direction
+    array<std::vector<double>, n> coordinates_;
+    //! origin and spacing of ImageData output
+    array<double, 3> origin_;
+    array<double, 3> spacing_;
+    std::size_t ncells_;
+    std::size_t npoints_;
+    //! integer position of each cell, n entries per cell in iteration order
+    std::vector<int> cellIndex_;
+    //! whether the mapper indices equal the positions in the piece
+    bool cellsInOrder_;
+    bool vertsInOrder_;
+  };
+
+} // namespace Dune
+
+#endif // DUNE_GRID_IO_FILE_VTK_STRUCTUREDVTKWRITER_HH
@@ -4,7 +4,11 @@
 #ifndef DUNE_SUBSAMPLINGVTKWRITER_HH
 #define DUNE_SUBSAMPLINGVTKWRITER_HH
 
+#include <algorithm>
+#include <cstddef>
+#include <map>
 #include <ostream>
+#include <vector>
 
 #include <dune/common/indent.hh>
 #include <dune/geometry/type.hh>
@@ -30,6 +34,12 @@ namespace Dune
    * (VTK)</a>.  In contrast to the regular VTKWriter, this Writer allows
    * subsampling of the elements via VirtualRefinement.  The
    * SubSamplingVTKWriter always writes nonconforming data.
+   *
+   * The refinement of each geometry type is computed only once.  The
+   * functions are evaluated for blocks of elements.  If parallel evaluation
+   * is requested in the constructor and the code is compiled with OpenMP,
+   * the elements of a block are evaluated by several threads; in that case
+   * VTKFunction::evaluate() has to be safe to call concurrently.
    */
   template< class GridView >
   class SubsamplingVTKWriter
@@ -46,9 +56,17 @@ namespace Dune
 
     typedef typename Base::CellIterator CellIterator;
     typedef typename Base::FunctionIterator FunctionIterator;
+    typedef typename Base::VTKFunction VTKFunction;
+    typedef typename GridView::template Codim< 0 >::Entity Entity;
+    typedef typename GridView::Grid::template Codim< 0 >::EntityPointer EntityPointer;
+    typedef typename GridView::Grid::template Codim< 0 >::EntitySeed EntitySeed;
+    typedef FieldVector< ctype, dim > LocalCoordinate;
+    using Base::blockSize;
     using Base::cellBegin;
     using Base::cellEnd;
     using Base::celldata;
+    using Base::coordPrecision_;
+    using Base::gridView_;
     using Base::ncells;
     using Base::ncorners;
     using Base::nvertices;
@@ -67,13 +85,22 @@ namespace Dune
      * @param coerceToSimplex_ Set this to true to always triangulate elements
      *                         into simplices, even where it's not necessary
      *                         (i.e. for hypercubes).
+     * @param coordPrecision   Precision of the vertex coordinates in the
+     *                         file.
+     * @param parallel_        Set this to true to evaluate the functions with
+     *                         several OpenMP threads.  Only do this if all
+     *                         added VTKFunctions may be evaluated
+     *                         concurrently.  Without OpenMP this has no
+     *                         effect.
      *
      * The datamode is always nonconforming.
      */
     explicit SubsamplingVTKWriter (const GridView &gridView,
-                                   unsigned int level_, bool coerceToSimplex_ = false)
-      : Base(gridView, VTK::nonconforming)
-        , level(level_), coerceToSimplex(coerceToSimplex_)
+                                   unsigned int level_, bool coerceToSimplex_ = false,
+                                   VTK::Precision coordPrecision = VTK::float32,
+                                   bool parallel_ = false)
+      : Base(gridView, VTK::nonconforming, coordPrecision)
+        , level(level_), coerceToSimplex(coerceToSimplex_), parallel(parallel_)
     { }
 
   private:
@@ -83,6 +110,95 @@ namespace Dune
       return geometryType;
     }
 
+    //! the subsampling of one geometry type
+    struct Pattern
+    {
+      //! local coordinates of the subvertices
+      std::vector<LocalCoordinate> vertices;
+      //! local coordinates of the centers of the subcells
+      std::vector<LocalCoordinate> cells;
+      //! corners of the subcells in VTK numbering, relative to the first
+      //! subvertex of the element
+      std::vector<int> connectivity;
+      //! number of corners of each subcell
+      unsigned int cornersPerCell;
+      //! VTK type of the subcells
+      unsigned char vtkType;
+    };
+
+    //! the subsampling of the given geometry type, computed on first use
+    const Pattern &pattern(const GeometryType &geometryType);
+
+    //! an element of a block and the points to evaluate it at
+    struct BlockCell
+    {
+      BlockCell(const EntitySeed &seed_,
+                const std::vector<LocalCoordinate> &points_,
+                std::size_t offset_)
+        : seed(seed_), points(&points_), offset(offset_)
+      { }
+
+      EntitySeed seed;
+      const std::vector<LocalCoordinate> *points;
+      //! number of the first point in the block
+      std::size_t offset;
+    };
+
+    //! evaluates a function at the points of an element
+    class FunctionEvaluator
+    {
+    public:
+      FunctionEvaluator(const VTKFunction &f, unsigned int writecomps)
+        : f_(f), writecomps_(writecomps)
+      { }
+
+      unsigned int comps() const { return writecomps_; }
+
+      void operator()(const Entity &e,
+                      const std::vector<LocalCoordinate> &points,
+                      double *values) const
+      {
+        const unsigned int ncomps = f_.ncomps();
+        for(std::size_t i = 0; i < points.size(); ++i)
+        {
+          f_.evaluateAll(e, points[i], values);
+          // expand 2D-Vectors to 3D
+          std::fill(values+ncomps, values+writecomps_, 0.0);
+          values += writecomps_;
+        }
+      }
+
+    private:
+      const VTKFunction &f_;
+      unsigned int writecomps_;
+    };
+
+    //! computes the global coordinates of the points of an element
+    class CoordinateEvaluator
+    {
+    public:
+      unsigned int comps() const { return 3; }
+
+      void operator()(const Entity &e,
+                      const std::vector<LocalCoordinate> &points,
+                      double *values) const
+      {
+        const typename Entity::Geometry geometry = e.geometry();
+        for(std::size_t i = 0; i < points.size(); ++i)
+        {
+          const FieldVector<ctype, dimw> x = geometry.global(points[i]);
+          for (int j=0; j<std::min(int(dimw),3); j++)
+            values[j] = x[j];
+          for (int j=std::min(int(dimw),3); j<3; j++)
+            values[j] = 0;
+          values += 3;
+        }
+      }
+    };
+
+    //! number of subvertices or subcells evaluated together
+    static const std::size_t itemsPerBlock = 64*blockSize;
+
   protected:
     //! count the vertices, cells and corners
     virtual void countEntities(int &nvertices, int &ncells, int &ncorners);
@@ -99,6 +215,34 @@ namespace Dune
     //! write the connectivity array
     virtual void writeGridCells(VTK::VTUWriter& writer);
 
+  private:
+    //! write the values of f on the subsampled cells or vertices
+    void writeSubsampledFunction(VTK::VTUWriter& writer,
+                                 const typename Base::VTKFunction& f,
+                                 bool vertices);
+
+    //! write the values of f with data type T
+    template<class T>
+    void writeTypedSubsampledFunction(VTK::VTUWriter& writer,
+                                      const typename Base::VTKFunction& f,
+                                      bool vertices);
+
+    //! write the positions of vertices with data type T
+    template<class T>
+    void writeTypedSubsampledPoints(VTK::VTUWriter& writer);
+
+    //! evaluate at the subvertices or subcell centers of all cells and
+    //! write the values to p
+    template<class T, class Evaluator>
+    void writeSubsampledValues(VTK::DataArrayWriter<T>& p,
+                               const Evaluator& evaluator, bool vertices);
+
+    //! evaluate a block of cells into values
+    template<class Evaluator>
+    void evaluateBlock(const Evaluator& evaluator,
+                       const std::vector<BlockCell>& cells,
+                       std::vector<double>& values, std::size_t n) const;
+
   public:
     using Base::addVertexData;
 
@@ -112,8 +256,47 @@ namespace Dune
 
     unsigned int level;
     bool coerceToSimplex;
+    bool parallel;
+    // the subsampling of each geometry type, by topology id
+    std::map<unsigned int, Pattern> patterns_;
   };
 
+  //! the subsampling of the given geometry type, computed on first use
+  template <class GridView>
+  const typename SubsamplingVTKWriter<GridView>::Pattern &
+  SubsamplingVTKWriter<GridView>::pattern(const GeometryType &geometryType)
+  {
+    typename std::map<unsigned int, Pattern>::iterator pos =
+      patterns_.find(geometryType.id());
+    if(pos != patterns_.end())
+      return pos->second;
+
+    Pattern &result = patterns_[geometryType.id()];
+    const GeometryType coerceTo = subsampledGeometryType(geometryType);
+    Refinement &refinement = buildRefinement<dim, ctype>(geometryType, coerceTo);
+
+    result.vertices.reserve(refinement.nVertices(level));
+    for(SubVertexIterator sit = refinement.vBegin(level),
+        send = refinement.vEnd(level);
+        sit != send; ++sit)
+      result.vertices.push_back(sit.coords());
+
+    result.cells.reserve(refinement.nElements(level));
+    result.cornersPerCell = refinement.eBegin(level).vertexIndices().size();
+    result.connectivity.reserve(refinement.nElements(level) * result.cornersPerCell);
+    for(SubElementIterator sit = refinement.eBegin(level),
+        send = refinement.eEnd(level);
+        sit != send; ++sit)
+    {
+      result.cells.push_back(sit.coords());
+      IndexVector indices = sit.vertexIndices();
+      for(unsigned int ii = 0; ii < indices.size(); ++ii)
+        result.connectivity.push_back(indices[VTK::renumber(coerceTo, ii)]);
+    }
+    result.vtkType = VTK::geometryType(coerceTo);
+    return result;
+  }
+
   //! count the vertices, cells and corners
   template <class GridView>
   void SubsamplingVTKWriter<GridView>::countEntities(int &nvertices, int &ncells, int &ncorners)
@@ -123,11 +306,10 @@ namespace Dune
     ncorners = 0;
     for (CellIterator it=this->cellBegin(); it!=cellEnd(); ++it)
     {
-      Refinement &refinement = buildRefinement<dim, ctype>(it->type(), subsampledGeometryType(it->type()));
-
-      ncells += refinement.nElements(level);
-      nvertices += refinement.nVertices(level);
-      ncorners += refinement.nElements(level) * refinement.eBegin(level).vertexIndices().size();
+      const Pattern &pat = pattern(it->type());
+      ncells += pat.cells.size();
+      nvertices += pat.vertices.size();
+      ncorners += pat.connectivity.size();
     }
   }
 
@@ -155,32 +337,7 @@ namespace Dune
 
     writer.beginCellData(scalars, vectors);
     for (FunctionIterator it=celldata.begin(); it!=celldata.end(); ++it)
-    {
-      // vtk file format: a vector data always should have 3 comps (with 3rd
-      // comp = 0 in 2D case)
-      unsigned writecomps = (*it)->ncomps();
-      if(writecomps == 2) writecomps = 3;
-
-      shared_ptr<VTK::DataArrayWriter<float> > p
-        (writer.makeArrayWriter<float>((*it)->name(), writecomps, ncells));
-      if(!p->writeIsNoop())
-        for (CellIterator i=cellBegin(); i!=cellEnd(); ++i)
-        {
-          Refinement &refinement =
-            buildRefinement<dim, ctype>(i->type(),
-                                        subsampledGeometryType(i->type()));
-          for(SubElementIterator sit = refinement.eBegin(level),
-              send = refinement.eEnd(level);
-              sit != send; ++sit)
-          {
-            for (int j=0; j<(*it)->ncomps(); j++)
-              p->write((*it)->evaluate(j,*i,sit.coords()));
-            // expand 2D-Vectors to 3D
-            for(unsigned j = (*it)->ncomps(); j < writecomps; j++)
-              p->write(0.0);
-          }
-        }
-    }
+      writeSubsampledFunction(writer, **it, false);
     writer.endCellData();
   }
 
@@ -208,65 +365,176 @@ namespace Dune
 
     writer.beginPointData(scalars, vectors);
     for (FunctionIterator it=vertexdata.begin(); it!=vertexdata.end(); ++it)
-    {
-      // vtk file format: a vector data always should have 3 comps (with 3rd
-      // comp = 0 in 2D case)
-      unsigned writecomps = (*it)->ncomps();
-      if(writecomps == 2) writecomps = 3;
-
-      shared_ptr<VTK::DataArrayWriter<float> > p
-        (writer.makeArrayWriter<float>((*it)->name(), writecomps, nvertices));
-      if(!p->writeIsNoop())
-        for (CellIterator i=cellBegin(); i!=cellEnd(); ++i)
-        {
-          Refinement &refinement =
-            buildRefinement<dim, ctype>(i->type(),
-                                        subsampledGeometryType(i->type()));
-          for(SubVertexIterator sit = refinement.vBegin(level),
-              send = refinement.vEnd(level);
-              sit != send; ++sit)
-          {
-            for (int j=0; j<(*it)->ncomps(); j++)
-              p->write((*it)->evaluate(j,*i,sit.coords()));
-            // vtk file format: a vector data always should have 3 comps (with
-            // 3rd comp = 0 in 2D case)
-            for(unsigned j = (*it)->ncomps(); j < writecomps; j++)
-              p->write(0.0);
-          }
-        }
-    }
+      writeSubsampledFunction(writer, **it, true);
     writer.endPointData();
   }
 
+  //! write the values of f on the subsampled cells or vertices
+  template <class GridView>
+  void SubsamplingVTKWriter<GridView>::
+  writeSubsampledFunction(VTK::VTUWriter& writer,
+                          const typename Base::VTKFunction& f, bool vertices)
+  {
+    switch(f.precision()) {
+    case VTK::int32 :
+      writeTypedSubsampledFunction<int>(writer, f, vertices);
+      return;
+    case VTK::uint8 :
+      writeTypedSubsampledFunction<unsigned char>(writer, f, vertices);
+      return;
+    case VTK::uint32 :
+      writeTypedSubsampledFunction<unsigned>(writer, f, vertices);
+      return;
+    case VTK::float32 :
+      writeTypedSubsampledFunction<float>(writer, f, vertices);
+      return;
+    case VTK::float64 :
+      writeTypedSubsampledFunction<double>(writer, f, vertices);
+      return;
+    }
+    DUNE_THROW(IOError, "SubsamplingVTKWriter: unsupported Precision "
+               << f.precision() << " of function " << f.name());
+  }
+
+  //! write the values of f with data type T
+  template <class GridView>
+  template <class T>
+  void SubsamplingVTKWriter<GridView>::
+  writeTypedSubsampledFunction(VTK::VTUWriter& writer,
+                               const typename Base::VTKFunction& f,
+                               bool vertices)
+  {
+    // vtk file format: a vector data always should have 3 comps (with 3rd
+    // comp = 0 in 2D case)
+    unsigned writecomps = f.ncomps();
+    if(writecomps == 2) writecomps = 3;
+
+    shared_ptr<VTK::DataArrayWriter<T> > p
+      (writer.makeArrayWriter<T>(f.name(), writecomps,
+                                 vertices ? nvertices : ncells));
+    if(p->writeIsNoop())
+      return;
+
+    writeSubsampledValues(*p, FunctionEvaluator(f, writecomps), vertices);
+  }
+
   //! write the positions of vertices
   template <class GridView>
   void SubsamplingVTKWriter<GridView>::writeGridPoints(VTK::VTUWriter& writer)
   {
     writer.beginPoints();
 
-    shared_ptr<VTK::DataArrayWriter<float> > p
-      (writer.makeArrayWriter<float>("Coordinates", 3, nvertices));
+    switch(coordPrecision_) {
+    case VTK::float32 :
+      writeTypedSubsampledPoints<float>(writer);
+      break;
+    case VTK::float64 :
+      writeTypedSubsampledPoints<double>(writer);
+      break;
+    default :
+      DUNE_THROW(IOError, "SubsamplingVTKWriter: unsupported Precision "
+                 << coordPrecision_ << " for coordinates");
+    }
+
+    writer.endPoints();
+  }
+
+  //! write the positions of vertices with data type T
+  template <class GridView>
+  template <class T>
+  void SubsamplingVTKWriter<GridView>::writeTypedSubsampledPoints(VTK::VTUWriter& writer)
+  {
+    shared_ptr<VTK::DataArrayWriter<T> > p
+      (writer.makeArrayWriter<T>("Coordinates", 3, nvertices));
     if(!p->writeIsNoop())
-      for (CellIterator i=cellBegin(); i!=cellEnd(); ++i)
+      writeSubsampledValues(*p, CoordinateEvaluator(), true);
+  }
+
+  //! evaluate at the subvertices or subcell centers of all cells and write
+  //! the values to p
+  /**
+   * The cells are collected in blocks of about itemsPerBlock subvertices or
+   * subcells.  Each block is evaluated into one preallocated buffer, where
+   * every cell knows the position of its first value, and the buffer is
+   * then written as a whole.
+   */
+  template <class GridView>
+  template <class T, class Evaluator>
+  void SubsamplingVTKWriter<GridView>::
+  writeSubsampledValues(VTK::DataArrayWriter<T>& p,
+                        const Evaluator& evaluator, bool vertices)
+  {
+    const unsigned int comps = evaluator.comps();
+    std::vector<BlockCell> cells;
+    std::vector<double> values;
+    std::vector<T> block;
+    std::size_t items = 0;
+    for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
+    {
+      const Pattern &pat = pattern(it->type());
+      const std::vector<LocalCoordinate> &points =
+        vertices ? pat.vertices : pat.cells;
+      cells.push_back(BlockCell(it->seed(), points, items));
+      items += points.size();
+      if(items >= itemsPerBlock)
       {
-        Refinement &refinement =
-          buildRefinement<dim, ctype>(i->type(),
-                                      subsampledGeometryType(i->type()));
-        for(SubVertexIterator sit = refinement.vBegin(level),
-            send = refinement.vEnd(level);
-            sit != send; ++sit)
-        {
-          FieldVector<ctype, dimw> coords = i->geometry().global(sit.coords());
-          for (int j=0; j<std::min(int(dimw),3); j++)
-            p->write(coords[j]);
-          for (int j=std::min(int(dimw),3); j<3; j++)
-            p->write(0.0);
-        }
+        evaluateBlock(evaluator, cells, values, items*comps);
+        Base::writeBlock(p, &values[0], block, items*comps);
+        cells.clear();
+        items = 0;
       }
-    // free the VTK::DataArrayWriter before touching the stream
-    p.reset();
+    }
+    if(items > 0)
+    {
+      evaluateBlock(evaluator, cells, values, items*comps);
+      Base::writeBlock(p, &values[0], block, items*comps);
+    }
+  }
 
-    writer.endPoints();
+  //! evaluate a block of cells into values
+  template <class GridView>
+  template <class Evaluator>
+  void SubsamplingVTKWriter<GridView>::
+  evaluateBlock(const Evaluator& evaluator,
+                const std::vector<BlockCell>& cells,
+                std::vector<double>& values, std::size_t n) const
+  {
+    values.resize(n);
+    const unsigned int comps = evaluator.comps();
+
+    // the grid need not be thread safe, so the entities are obtained before
+    // the threads are started
+    std::vector<EntityPointer> entities;
+    entities.reserve(cells.size());
+    for (std::size_t c = 0; c < cells.size(); ++c)
+      entities.push_back(gridView_.grid().entityPointer(cells[c].seed));
+
+    if(!parallel)
+    {
+      for (std::size_t c = 0; c < cells.size(); ++c)
+        evaluator(*entities[c], *cells[c].points, &values[cells[c].offset*comps]);
+      return;
+    }
+
+    int failed = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:failed)
+#endif
+    for (long c = 0; c < long(cells.size()); ++c)
+    {
+      try {
+        evaluator(*entities[c], *cells[c].points, &values[cells[c].offset*comps]);
+      }
+      catch (...) {
+        ++failed;
+      }
+    }
+
+    // exceptions must not leave the parallel loop, so evaluate the block
+    // again to pass the exception on
+    if(failed > 0)
+      for (std::size_t c = 0; c < cells.size(); ++c)
+        evaluator(*entities[c], *cells[c].points, &values[cells[c].offset*comps]);
   }
 
   //! write the connectivity array
@@ -281,22 +549,17 @@ namespace Dune
         (writer.makeArrayWriter<int>("connectivity", 1, ncorners));
       // The offset within the index numbering
       if(!p1->writeIsNoop()) {
+        std::vector<int> connectivity;
+        connectivity.reserve(ncorners);
         int offset = 0;
         for (CellIterator i=cellBegin(); i!=cellEnd(); ++i)
         {
-          GeometryType coercedToType = subsampledGeometryType(i->type());
-          Refinement &refinement =
-            buildRefinement<dim, ctype>(i->type(), coercedToType);
-          for(SubElementIterator sit = refinement.eBegin(level),
-              send = refinement.eEnd(level);
-              sit != send; ++sit)
-          {
-            IndexVector indices = sit.vertexIndices();
-            for(unsigned int ii = 0; ii < indices.size(); ++ii)
-              p1->write(offset+indices[VTK::renumber(coercedToType, ii)]);
-          }
-          offset += refinement.nVertices(level);
+          const Pattern &pat = pattern(i->type());
+          for(std::size_t ii = 0; ii < pat.connectivity.size(); ++ii)
+            connectivity.push_back(offset+pat.connectivity[ii]);
+          offset += pat.vertices.size();
         }
+        Base::writeArray(*p1, connectivity);
       }
     }
 
@@ -306,21 +569,19 @@ namespace Dune
         (writer.makeArrayWriter<int>("offsets", 1, ncells));
       if(!p2->writeIsNoop()) {
         // The offset into the connectivity array
+        std::vector<int> offsets;
+        offsets.reserve(ncells);
         int offset = 0;
         for (CellIterator i=cellBegin(); i!=cellEnd(); ++i)
         {
-          Refinement &refinement =
-            buildRefinement<dim, ctype>(i->type(),
-                                        subsampledGeometryType(i->type()));
-          unsigned int verticesPerCell =
-            refinement.eBegin(level).vertexIndices().size();
-          for(int element = 0; element < refinement.nElements(level);
-              ++element)
+          const Pattern &pat = pattern(i->type());
+          for(std::size_t element = 0; element < pat.cells.size(); ++element)
           {
-            offset += verticesPerCell;
-            p2->write(offset);
+            offset += pat.cornersPerCell;
+            offsets.push_back(offset);
           }
         }
+        Base::writeArray(*p2, offsets);
       }
     }
 
@@ -329,16 +590,16 @@ namespace Dune
     {
       shared_ptr<VTK::DataArrayWriter<unsigned char> > p3
         (writer.makeArrayWriter<unsigned char>("types", 1, ncells));
-      if(!p3->writeIsNoop())
+      if(!p3->writeIsNoop()) {
+        std::vector<unsigned char> types;
+        types.reserve(ncells);
         for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
         {
-          GeometryType coerceTo = subsampledGeometryType(it->type());
-          Refinement &refinement =
-            buildRefinement<dim, ctype>(it->type(), coerceTo);
-          int vtktype = VTK::geometryType(coerceTo);
-          for(int i = 0; i < refinement.nElements(level); ++i)
-            p3->write(vtktype);
+          const Pattern &pat = pattern(it->type());
+          types.insert(types.end(), pat.cells.size(), pat.vtkType);
         }
+        Base::writeArray(*p3, types);
+      }
     }
 
     writer.endCells();
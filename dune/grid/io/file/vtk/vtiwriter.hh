@@ -0,0 +1,378 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_GRID_IO_FILE_VTK_VTIWRITER_HH
+#define DUNE_GRID_IO_FILE_VTK_VTIWRITER_HH
+
+#include <ostream>
+#include <string>
+
+#include <dune/common/array.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/indent.hh>
+
+#include <dune/grid/io/file/vtk/common.hh>
+#include <dune/grid/io/file/vtk/dataarraywriter.hh>
+
+namespace Dune {
+
+  //! \addtogroup VTK
+  //! \{
+
+  namespace VTK {
+
+    //! extent of a structured piece: first and last point index per direction
+    typedef array<int, 6> Extent;
+
+    //! write an extent as the value of a VTK attribute
+    inline std::ostream& writeExtent(std::ostream& s, const Extent& extent)
+    {
+      for (int i = 0; i < 6; ++i)
+        s << (i > 0 ? " " : "") << extent[i];
+      return s;
+    }
+
+    //! write a point in space as the value of a VTK attribute
+    /**
+     * All digits are written since the coordinates of all points are
+     * derived from these values.
+     */
+    inline std::ostream& writeTriple(std::ostream& s,
+                                     const array<double, 3>& x)
+    {
+      const std::streamsize precision = s.precision(17);
+      s << x[0] << " " << x[1] << " " << x[2];
+      s.precision(precision);
+      return s;
+    }
+
+    //! Dump a .vti file's contents to a stream
+    /**
+     * This will help generating a .vti file for a piece of a grid which is
+     * an axis parallel box of equal cells.  Only the extent, origin and
+     * spacing of the grid are written, the coordinates and the cells are
+     * implicit.  Cell data is ordered by cell index, point data by point
+     * index, with the x index running fastest.  Typical use is like this:
+     * \code
+     * {
+     *   // create writer, writes begin tag
+     *   VTIWriter writer(std::cout, appendedraw);
+     *
+     *   // write the main header
+     *   writer.beginMain(wholeExtent, pieceExtent, origin, spacing);
+     *   dump_data(writer);
+     *   writer.endMain();
+     *
+     *   // write the appended section, if required
+     *   if(writer.beginAppended())
+     *     dump_data(writer);
+     *   writer.endAppended();
+     *
+     *   // end scope so the destructor gets called and the closing tag is written
+     * }
+     * \endcode
+     *
+     * where dump_data writes the point data and cell data sections just as
+     * for a VTUWriter.
+     */
+    class VTIWriter {
+    public:
+      std::ostream& stream;
+      enum Phase { main, appended } phase;
+
+    private:
+      DataArrayWriterFactory factory;
+      Indent indent;
+
+      bool doAppended;
+
+    public:
+      //! create a VTIWriter object
+      /**
+       * \param stream_    Stream to write to.
+       * \param outputType How to encode data.
+       *
+       * Create object and write header.
+       */
+      inline VTIWriter(std::ostream& stream_, OutputType outputType)
+        : stream(stream_), phase(main), factory(outputType, stream),
+          doAppended(false)
+      {
+        stream << indent << "<?xml version=\"1.0\"?>\n";
+        stream << indent << "<VTKFile"
+               << " type=\"ImageData\""
+               << " version=\"0.1\""
+               << " byte_order=\"" << getEndiannessString() << "\"";
+        if(outputType == appendedcompressed)
+          stream << " compressor=\"vtkZLibDataCompressor\"";
+        stream << ">\n";
+        ++indent;
+      }
+
+      //! write footer
+      inline ~VTIWriter() {
+        --indent;
+        stream << indent << "</VTKFile>\n"
+               << std::flush;
+      }
+
+      //! start PointData section
+      /**
+       * \param scalars Name of field to which should be marked as default
+       *                scalars field.  If this is the empty string, don't set
+       *                any default.
+       * \param vectors Name of field to which should be marked as default
+       *                vectors field.  If this is the empty string, don't set
+       *                any default.
+       */
+      inline void beginPointData(const std::string& scalars = "",
+                                 const std::string& vectors = "") {
+        if(phase == appended)
+          return;
+        stream << indent << "<PointData";
+        if(scalars != "") stream << " Scalars=\"" << scalars << "\"";
+        if(vectors != "") stream << " Vectors=\"" << vectors << "\"";
+        stream << ">\n";
+        ++indent;
+      }
+      //! finish PointData section
+      inline void endPointData() {
+        if(phase == appended)
+          return;
+        --indent;
+        stream << indent << "</PointData>\n";
+      }
+
+      //! start CellData section
+      /**
+       * \param scalars Name of field to which should be marked as default
+       *                scalars field.  If this is the empty string, don't set
+       *                any default.
+       * \param vectors Name of field to which should be marked as default
+       *                vectors field.  If this is the empty string, don't set
+       *                any default.
+       */
+      inline void beginCellData(const std::string& scalars = "",
+                                const std::string& vectors = "") {
+        if(phase == appended)
+          return;
+        stream << indent << "<CellData";
+        if(scalars != "") stream << " Scalars=\"" << scalars << "\"";
+        if(vectors != "") stream << " Vectors=\"" << vectors << "\"";
+        stream << ">\n";
+        ++indent;
+      }
+      //! finish CellData section
+      inline void endCellData() {
+        if(phase == appended)
+          return;
+        --indent;
+        stream << indent << "</CellData>\n";
+      }
+
+      //! start the main ImageData section
+      /**
+       * \param wholeExtent Extent of the whole grid.
+       * \param pieceExtent Extent of the piece in this file.
+       * \param origin      Coordinates of the point with index (0,0,0).
+       * \param spacing     Size of the cells in each direction.
+       */
+      inline void beginMain(const Extent& wholeExtent,
+                            const Extent& pieceExtent,
+                            const array<double, 3>& origin,
+                            const array<double, 3>& spacing) {
+        stream << indent << "<ImageData WholeExtent=\"";
+        writeExtent(stream, wholeExtent) << "\" Origin=\"";
+        writeTriple(stream, origin) << "\" Spacing=\"";
+        writeTriple(stream, spacing) << "\">\n";
+        ++indent;
+        stream << indent << "<Piece Extent=\"";
+        writeExtent(stream, pieceExtent) << "\">\n";
+        ++indent;
+        phase = main;
+      }
+      //! finish the main ImageData section
+      inline void endMain() {
+        factory.finish();
+        --indent;
+        stream << indent << "</Piece>\n";
+        --indent;
+        stream << indent << "</ImageData>\n";
+      }
+
+      //! start the appended data section
+      /**
+       * \returns Whether an appended section is required, see
+       *          VTUWriter::beginAppended().
+       */
+      inline bool beginAppended() {
+        doAppended = factory.beginAppended();
+        if(doAppended) {
+          stream << indent << "<AppendedData"
+                 << " encoding=\"" << factory.appendedEncoding() << "\">\n";
+          ++indent;
+          // mark begin of data
+          stream << indent << "_";
+        }
+        phase = appended;
+        return doAppended;
+      }
+      //! finish the appended data section
+      inline void endAppended() {
+        if(doAppended) {
+          stream << "\n";
+          --indent;
+          stream << indent << "</AppendedData>\n";
+        }
+      }
+
+      //! aquire a DataArrayWriter
+      /**
+       * \tparam T Type of the data to write.
+       *
+       * \param name   Name of the array to write.
+       * \param ncomps Number of components of the vectors in the array.
+       * \param nitems Number of vectors in the array (number of cells/number
+       *               of points).
+       *
+       * The returned object should be freed with delete.
+       */
+      template<typename T>
+      DataArrayWriter<T>* makeArrayWriter(const std::string& name,
+                                          unsigned ncomps, unsigned nitems) {
+        return factory.make<T>(name, ncomps, nitems, indent);
+      }
+    };
+
+    //! Dump a .pvti file's contents to a stream
+    /**
+     * Typical use is like this:
+     * \code
+     * {
+     *   PVTIWriter writer(std::cout);
+     *   writer.beginMain(wholeExtent, origin, spacing);
+     *
+     *   writer.beginPointData();
+     *   for(each point data field)
+     *     writer.addArray(field.name, field.ncomps, field.precision);
+     *   writer.endPointData();
+     *
+     *   writer.beginCellData();
+     *   for(each cell data field)
+     *     writer.addArray(field.name, field.ncomps, field.precision);
+     *   writer.endCellData();
+     *
+     *   for(each serial piece)
+     *     writer.addPiece(piece.extent, piece.filename);
+     *
+     *   writer.endMain();
+     * }
+     * \endcode
+     */
+    class PVTIWriter {
+      std::ostream& stream;
+
+      Indent indent;
+
+    public:
+      //! create a PVTIWriter object and write the header
+      inline explicit PVTIWriter(std::ostream& stream_)
+        : stream(stream_)
+      {
+        stream << indent << "<?xml version=\"1.0\"?>\n";
+        stream << indent << "<VTKFile"
+               << " type=\"PImageData\""
+               << " version=\"0.1\""
+               << " byte_order=\"" << getEndiannessString() << "\">\n";
+        ++indent;
+      }
+
+      //! write footer
+      inline ~PVTIWriter() {
+        --indent;
+        stream << indent << "</VTKFile>\n"
+               << std::flush;
+      }
+
+      //! start PointData section
+      inline void beginPointData(const std::string& scalars = "",
+                                 const std::string& vectors = "") {
+        stream << indent << "<PPointData";
+        if(scalars != "") stream << " Scalars=\"" << scalars << "\"";
+        if(vectors != "") stream << " Vectors=\"" << vectors << "\"";
+        stream << ">\n";
+        ++indent;
+      }
+      //! finish PointData section
+      inline void endPointData() {
+        --indent;
+        stream << indent << "</PPointData>\n";
+      }
+
+      //! start CellData section
+      inline void beginCellData(const std::string& scalars = "",
+                                const std::string& vectors = "") {
+        stream << indent << "<PCellData";
+        if(scalars != "") stream << " Scalars=\"" << scalars << "\"";
+        if(vectors != "") stream << " Vectors=\"" << vectors << "\"";
+        stream << ">\n";
+        ++indent;
+      }
+      //! finish CellData section
+      inline void endCellData() {
+        --indent;
+        stream << indent << "</PCellData>\n";
+      }
+
+      //! start the main PImageData section
+      /**
+       * \param wholeExtent Extent of the whole grid.
+       * \param origin      Coordinates of the point with index (0,0,0).
+       * \param spacing     Size of the cells in each direction.
+       * \param ghostLevel  Set the GhostLevel attribute.
+       */
+      inline void beginMain(const Extent& wholeExtent,
+                            const array<double, 3>& origin,
+                            const array<double, 3>& spacing,
+                            unsigned int ghostLevel = 0) {
+        stream << indent << "<PImageData WholeExtent=\"";
+        writeExtent(stream, wholeExtent) << "\" GhostLevel=\"" << ghostLevel
+                                         << "\" Origin=\"";
+        writeTriple(stream, origin) << "\" Spacing=\"";
+        writeTriple(stream, spacing) << "\">\n";
+        ++indent;
+      }
+      //! finish the main PImageData section
+      inline void endMain() {
+        --indent;
+        stream << indent << "</PImageData>\n";
+      }
+
+      //! Add an array to the output file
+      /**
+       * \param name   Name of the array.
+       * \param ncomps Number of components of the vectors in the array.
+       * \param prec   Precision of the array.
+       */
+      inline void addArray(const std::string& name, unsigned ncomps,
+                           Precision prec) {
+        stream << indent << "<PDataArray"
+               << " type=\"" << toString(prec) << "\""
+               << " Name=\"" << name << "\""
+               << " NumberOfComponents=\"" << ncomps << "\"/>\n";
+      }
+
+      //! Add a serial piece to the output file
+      inline void addPiece(const Extent& extent, const std::string& filename) {
+        stream << indent << "<Piece Extent=\"";
+        writeExtent(stream, extent) << "\" Source=\"" << filename << "\"/>\n";
+      }
+    };
+
+  } // namespace VTK
+
+  //! \} group VTK
+
+} // namespace Dune
+
+#endif // DUNE_GRID_IO_FILE_VTK_VTIWRITER_HH
@@ -0,0 +1,1067 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_GRID_IO_FILE_VTK_VTKREADER_HH
+#define DUNE_GRID_IO_FILE_VTK_VTKREADER_HH
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stdint.h>
+
+#if HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/geometry/type.hh>
+
+#include <dune/grid/common/gridfactory.hh>
+#include <dune/grid/io/file/vtk/b64enc.hh>
+#include <dune/grid/io/file/vtk/common.hh>
+
+/** @file
+    @author Dune-Grid team
+    @brief Reader for the VTK XML formats written by the VTKWriter
+ */
+
+namespace Dune
+{
+  //! \addtogroup VTK
+  //! \{
+
+  namespace VTK {
+
+    //! a tag of an XML file
+    struct XMLTag
+    {
+      std::string name;
+      //! whether this is an end tag (</name>)
+      bool closing;
+      //! whether this is an empty element tag (<name/>)
+      bool empty;
+      std::map<std::string, std::string> attributes;
+
+      //! the value of an attribute, or def if the tag has no such attribute
+      std::string attribute(const std::string& key,
+                            const std::string& def = "") const
+      {
+        std::map<std::string, std::string>::const_iterator it =
+          attributes.find(key);
+        return it == attributes.end() ? def : it->second;
+      }
+    };
+
+    //! read the next tag from an XML stream
+    /**
+     * Text, comments, processing instructions and the document type are
+     * skipped.  After the call the stream is positioned directly behind the
+     * tag.
+     *
+     * \returns false at the end of the stream.
+     */
+    inline bool readXMLTag(std::istream& s, XMLTag& tag)
+    {
+      char c;
+      do {
+        if (!s.ignore(std::numeric_limits<std::streamsize>::max(), '<'))
+          return false;
+        if (!s.get(c))
+          return false;
+        if (c == '!' && s.peek() == '-') {
+          // comment, may contain '>'
+          std::string end;
+          while (s.get(c) && !(c == '>' && end.size() >= 2
+                               && end.compare(end.size()-2, 2, "--") == 0))
+            end += c;
+          c = '!';
+        }
+        else if (c == '!' || c == '?')
+          s.ignore(std::numeric_limits<std::streamsize>::max(), '>');
+      } while (c == '!' || c == '?');
+
+      tag.name.clear();
+      tag.attributes.clear();
+      tag.closing = (c == '/');
+      tag.empty = false;
+      if (!tag.closing)
+        s.putback(c);
+
+      std::string text;
+      char quote = 0;
+      while (s.get(c)) {
+        if (quote) {
+          if (c == quote)
+            quote = 0;
+        }
+        else if (c == '"' || c == '\'')
+          quote = c;
+        else if (c == '>')
+          break;
+        text += c;
+      }
+      if (c != '>')
+        DUNE_THROW(IOError, "VTKReader: unterminated XML tag");
+      if (!text.empty() && text[text.size()-1] == '/') {
+        tag.empty = true;
+        text.erase(text.size()-1);
+      }
+
+      const char* space = " \t\r\n";
+      std::size_t pos = text.find_first_of(space);
+      tag.name = text.substr(0, pos);
+      while ((pos = text.find_first_not_of(space, pos)) != std::string::npos) {
+        std::size_t eq = text.find('=', pos);
+        if (eq == std::string::npos)
+          DUNE_THROW(IOError, "VTKReader: malformed attribute in tag <"
+                     << tag.name << ">");
+        std::string key = text.substr(pos, eq - pos);
+        key.erase(key.find_last_not_of(space) + 1);
+        std::size_t begin = text.find_first_of("\"'", eq);
+        if (begin == std::string::npos)
+          DUNE_THROW(IOError, "VTKReader: unquoted attribute " << key
+                     << " in tag <" << tag.name << ">");
+        std::size_t end = text.find(text[begin], begin + 1);
+        tag.attributes[key] = text.substr(begin + 1, end - begin - 1);
+        pos = end + 1;
+      }
+      return true;
+    }
+
+    //! source of the decoded bytes of a binary data array
+    class ByteSource
+    {
+    public:
+      virtual ~ByteSource() {}
+
+      //! read exactly n bytes
+      /**
+       * \throw IOError if the data ends before.
+       */
+      virtual void read(char* buf, std::size_t n) = 0;
+
+      //! drop the rest of a separately encoded block
+      /**
+       * In base64 encoding the header of an array and its data are encoded
+       * separately, so the last group of the header may contain padding.
+       */
+      virtual void endBlock() {}
+    };
+
+    //! byte source reading unencoded bytes from a stream
+    class RawByteSource : public ByteSource
+    {
+    public:
+      explicit RawByteSource(std::istream& s_) : s(s_) {}
+
+      void read(char* buf, std::size_t n)
+      {
+        s.read(buf, n);
+        if (std::size_t(s.gcount()) != n)
+          DUNE_THROW(IOError, "VTKReader: unexpected end of data");
+      }
+
+    private:
+      std::istream& s;
+    };
+
+    //! byte source decoding base64 from a stream
+    /**
+     * Only as many characters as needed are read from the stream, i.e. the
+     * stream is positioned directly behind the data when everything has
+     * been read.  Whitespace between the characters is skipped.
+     */
+    class Base64ByteSource : public ByteSource
+    {
+    public:
+      explicit Base64ByteSource(std::istream& s_)
+        : s(s_), nrest(0), prest(0)
+      {}
+
+      void read(char* buf, std::size_t n)
+      {
+        while (n > 0 && prest < nrest) {
+          *buf++ = rest[prest++];
+          --n;
+        }
+        const std::size_t chunk = 4096;
+        while (n > 0) {
+          const std::size_t quads = std::min((n + 2) / 3, chunk);
+          readChars(4*quads);
+          for (std::size_t q = 0; q < quads; ++q) {
+            char bytes[3];
+            const std::size_t k = decodeQuad(&chars[4*q], bytes);
+            if (k < 3 && (q + 1 < quads || n > k))
+              DUNE_THROW(IOError, "VTKReader: unexpected end of base64 data");
+            const std::size_t m = std::min(k, n);
+            std::memcpy(buf, bytes, m);
+            buf += m;
+            n -= m;
+            // keep the remainder of the last group
+            nrest = k - m;
+            prest = 0;
+            std::memcpy(rest, bytes + m, nrest);
+          }
+        }
+      }
+
+      void endBlock()
+      {
+        nrest = prest = 0;
+      }
+
+    private:
+      // read m characters, skipping whitespace
+      void readChars(std::size_t m)
+      {
+        chars.resize(m);
+        std::size_t got = 0;
+        while (got < m) {
+          s.read(&chars[got], m - got);
+          const std::size_t k = s.gcount();
+          if (k == 0)
+            DUNE_THROW(IOError, "VTKReader: unexpected end of base64 data");
+          std::size_t j = got;
+          for (std::size_t i = got; i < got + k; ++i)
+            if (!std::isspace(static_cast<unsigned char>(chars[i])))
+              chars[j++] = chars[i];
+          got = j;
+        }
+      }
+
+      // decode one group of four characters, returns the number of bytes
+      static std::size_t decodeQuad(const char* in, char* out)
+      {
+        const signed char* table = decodeTable();
+        const int a = table[static_cast<unsigned char>(in[0])];
+        const int b = table[static_cast<unsigned char>(in[1])];
+        const int c = table[static_cast<unsigned char>(in[2])];
+        const int d = table[static_cast<unsigned char>(in[3])];
+        if (a < 0 || b < 0 || c == -1 || d == -1 || (c == -2 && d != -2))
+          DUNE_THROW(IOError, "VTKReader: invalid base64 data");
+        out[0] = (a << 2) | (b >> 4);
+        if (c == -2)
+          return 1;
+        out[1] = (b << 4) | (c >> 2);
+        if (d == -2)
+          return 2;
+        out[2] = (c << 6) | d;
+        return 3;
+      }
+
+      // value of each character, -1 for invalid characters, -2 for '='
+      static const signed char* decodeTable()
+      {
+        struct Table
+        {
+          signed char v[256];
+          Table()
+          {
+            std::fill(v, v + 256, -1);
+            for (int i = 0; i < 64; ++i)
+              v[static_cast<unsigned char>(base64table[i])] = i;
+            v[static_cast<unsigned char>('=')] = -2;
+          }
+        };
+        static const Table table;
+        return table.v;
+      }
+
+      std::istream& s;
+      std::vector<char> chars;
+      char rest[3];
+      std::size_t nrest;
+      std::size_t prest;
+    };
+
+    //! read a value of the header of a binary data array
+    inline unsigned long readHeaderValue(ByteSource& src, int headerBytes,
+                                         bool swap)
+    {
+      char buf[8];
+      src.read(buf, headerBytes);
+      if (swap)
+        std::reverse(buf, buf + headerBytes);
+      if (headerBytes == 8) {
+        uint64_t v;
+        std::memcpy(&v, buf, 8);
+        return v;
+      }
+      uint32_t v;
+      std::memcpy(&v, buf, 4);
+      return v;
+    }
+
+#if HAVE_ZLIB
+    //! byte source decompressing data in the block layout of vtkZLibDataCompressor
+    /**
+     * The blocks are decompressed one at a time while reading.
+     */
+    class ZLibByteSource : public ByteSource
+    {
+    public:
+      //! read the compression header from in
+      ZLibByteSource(ByteSource& in_, int headerBytes, bool swap)
+        : in(in_), next(0), pos(0)
+      {
+        const unsigned long nblocks = readHeaderValue(in, headerBytes, swap);
+        blockSize = readHeaderValue(in, headerBytes, swap);
+        lastSize = readHeaderValue(in, headerBytes, swap);
+        csizes.resize(nblocks);
+        for (unsigned long b = 0; b < nblocks; ++b)
+          csizes[b] = readHeaderValue(in, headerBytes, swap);
+        in.endBlock();
+      }
+
+      //! total size of the uncompressed data
+      std::size_t size() const
+      {
+        if (csizes.empty())
+          return 0;
+        return (csizes.size() - 1)*blockSize + (lastSize ? lastSize : blockSize);
+      }
+
+      void read(char* buf, std::size_t n)
+      {
+        while (n > 0) {
+          if (pos == block.size())
+            decompress();
+          const std::size_t m = std::min(n, block.size() - pos);
+          std::memcpy(buf, &block[pos], m);
+          buf += m;
+          n -= m;
+          pos += m;
+        }
+      }
+
+    private:
+      void decompress()
+      {
+        if (next == csizes.size())
+          DUNE_THROW(IOError, "VTKReader: unexpected end of compressed data");
+        cbuf.resize(csizes[next]);
+        if (!cbuf.empty())
+          in.read(&cbuf[0], cbuf.size());
+        uLongf size = (next + 1 == csizes.size() && lastSize) ? lastSize
+                      : blockSize;
+        block.resize(size);
+        if (uncompress(reinterpret_cast<Bytef*>(&block[0]), &size,
+                       reinterpret_cast<const Bytef*>(&cbuf[0]), cbuf.size())
+            != Z_OK || size != block.size())
+          DUNE_THROW(IOError, "VTKReader: decompression of block " << next
+                     << " failed");
+        ++next;
+        pos = 0;
+      }
+
+      ByteSource& in;
+      std::size_t blockSize;
+      std::size_t lastSize;
+      std::vector<unsigned long> csizes;
+      std::size_t next;
+      std::vector<char> cbuf;
+      std::vector<char> block;
+      std::size_t pos;
+    };
+#endif
+
+    //! size in bytes of a VTK data type
+    inline std::size_t typeSize(const std::string& type)
+    {
+      if (type == "Int8" || type == "UInt8") return 1;
+      if (type == "Int16" || type == "UInt16") return 2;
+      if (type == "Int32" || type == "UInt32" || type == "Float32") return 4;
+      if (type == "Int64" || type == "UInt64" || type == "Float64") return 8;
+      DUNE_THROW(IOError, "VTKReader: unsupported data type " << type);
+    }
+
+    //! read n values of type S from src and convert them to T
+    template<class S, class T>
+    void readValuesAs(ByteSource& src, bool swap, std::size_t n, T* out)
+    {
+      if (is_same<S, T>::value && !swap) {
+        src.read(reinterpret_cast<char*>(out), n*sizeof(T));
+        return;
+      }
+      const std::size_t chunk = 8192;
+      std::vector<char> buf(std::min(n, chunk)*sizeof(S));
+      for (std::size_t i = 0; i < n; i += chunk) {
+        const std::size_t m = std::min(chunk, n - i);
+        src.read(&buf[0], m*sizeof(S));
+        for (std::size_t j = 0; j < m; ++j) {
+          char* p = &buf[j*sizeof(S)];
+          if (swap)
+            std::reverse(p, p + sizeof(S));
+          S v;
+          std::memcpy(&v, p, sizeof(S));
+          out[i+j] = T(v);
+        }
+      }
+    }
+
+    //! read n values of the VTK data type type from src and convert them to T
+    template<class T>
+    void readValues(ByteSource& src, const std::string& type, bool swap,
+                    std::size_t n, T* out)
+    {
+      if (type == "Int8") readValuesAs<int8_t>(src, swap, n, out);
+      else if (type == "UInt8") readValuesAs<uint8_t>(src, swap, n, out);
+      else if (type == "Int16") readValuesAs<int16_t>(src, swap, n, out);
+      else if (type == "UInt16") readValuesAs<uint16_t>(src, swap, n, out);
+      else if (type == "Int32") readValuesAs<int32_t>(src, swap, n, out);
+      else if (type == "UInt32") readValuesAs<uint32_t>(src, swap, n, out);
+      else if (type == "Int64") readValuesAs<int64_t>(src, swap, n, out);
+      else if (type == "UInt64") readValuesAs<uint64_t>(src, swap, n, out);
+      else if (type == "Float32") readValuesAs<float>(src, swap, n, out);
+      else if (type == "Float64") readValuesAs<double>(src, swap, n, out);
+      else DUNE_THROW(IOError, "VTKReader: unsupported data type " << type);
+    }
+
+  } // namespace VTK
+
+  //! Reader for the VTK XML file formats
+  /**
+   * \code
+   * #include <dune/grid/io/file/vtk/vtkreader.hh>
+   * \endcode
+   *
+   * Reads serial (.vtu, .vtp) and parallel (.pvtu, .pvtp) files as written
+   * by the VTKWriter into a GridFactory.  All output types of the VTKWriter
+   * are supported, i.e. ascii, base64 and appended raw or base64 data, as
+   * well as zlib compressed data if dune-grid was built with zlib.  A file
+   * may contain several pieces, as written by VTKWriter::writeShared().
+   *
+   * The header of a file is parsed tag by tag.  Arrays in an appended
+   * section are read afterwards piece by piece, seeking to their offset and
+   * converting the values in small chunks, so that only the arrays of one
+   * piece are held in memory at a time.
+   *
+   * The cell and point data are kept by the reader and can be copied into
+   * user vectors after reading.  They are ordered by the insertion index of
+   * the elements and vertices, use GridFactory::insertionIndex() to get
+   * the position of the values of an entity of the created grid.
+   *
+   * Each piece of a parallel file contains its own copy of the points on
+   * the piece boundaries, and files written in nonconforming mode contain
+   * one copy of each point per element.  Such points are identified by
+   * their coordinates.  This is always done if the input consists of more
+   * than one piece and can be enabled for single pieces in the constructor.
+   *
+   * \tparam GridType Type of the grid to read.
+   */
+  template<class GridType>
+  class VTKReader
+  {
+  public:
+    typedef GridType Grid;
+
+    enum { dimension = Grid::dimension };
+    enum { dimensionworld = Grid::dimensionworld };
+
+    //! create a reader
+    /**
+     * \param mergePoints Identify points with equal coordinates even if the
+     *                    input consists of a single piece, e.g. for files
+     *                    written in nonconforming mode.
+     * \param verbose     Print information while reading.
+     */
+    explicit VTKReader(bool mergePoints = false, bool verbose = false)
+      : mergePoints_(mergePoints), verbose_(verbose)
+    {}
+
+    //! read a file and insert its points and cells into a grid factory
+    /**
+     * \param factory  Factory to insert the vertices and elements into.
+     * \param fileName Name of a serial (.vtu, .vtp) or parallel (.pvtu,
+     *                 .pvtp) file.
+     *
+     * The data of previously read files is discarded.
+     *
+     * \throw IOError The file cannot be read or contains cells which are not
+     *                elements of the grid.
+     */
+    void read(GridFactory<Grid>& factory, const std::string& fileName)
+    {
+      pointData_.clear();
+      cellData_.clear();
+      points_.clear();
+      nvertices_ = nelements_ = 0;
+      npieces_ = 0;
+
+      if (verbose_)
+        std::cout << "Reading VTK file " << fileName << std::endl;
+
+      std::ifstream file(fileName.c_str(), std::ios::binary);
+      if (!file)
+        DUNE_THROW(IOError, "VTKReader: could not open " << fileName);
+
+      VTK::XMLTag tag;
+      if (!VTK::readXMLTag(file, tag) || tag.name != "VTKFile")
+        DUNE_THROW(IOError, "VTKReader: " << fileName
+                   << " is not a VTK XML file");
+      const std::string type = tag.attribute("type");
+      if (type == "PUnstructuredGrid" || type == "PPolyData") {
+        std::vector<std::string> sources;
+        while (VTK::readXMLTag(file, tag))
+          if (tag.name == "Piece" && !tag.closing)
+            sources.push_back(piecePath(fileName, tag.attribute("Source")));
+        file.close();
+        for (std::size_t i = 0; i < sources.size(); ++i)
+          readPieces(factory, sources[i], sources.size() > 1);
+      }
+      else {
+        file.close();
+        readPieces(factory, fileName, false);
+      }
+      points_.clear();
+
+      if (verbose_)
+        std::cout << "Inserted " << nvertices_ << " vertices and "
+                  << nelements_ << " elements from " << npieces_
+                  << " pieces" << std::endl;
+    }
+
+    //! number of vertices inserted by the last call of read()
+    std::size_t vertices() const { return nvertices_; }
+
+    //! number of elements inserted by the last call of read()
+    std::size_t elements() const { return nelements_; }
+
+    //! names of the point data fields
+    std::vector<std::string> pointDataNames() const
+    {
+      return names(pointData_);
+    }
+
+    //! names of the cell data fields
+    std::vector<std::string> cellDataNames() const
+    {
+      return names(cellData_);
+    }
+
+    //! number of components of a point data field
+    int pointDataComponents(const std::string& name) const
+    {
+      return field(pointData_, name).ncomps;
+    }
+
+    //! number of components of a cell data field
+    int cellDataComponents(const std::string& name) const
+    {
+      return field(cellData_, name).ncomps;
+    }
+
+    //! copy a point data field into a vector
+    /**
+     * \param name   Name of the field.
+     * \param values Vector to copy into, it is resized to the number of
+     *               vertices times the number of components of the field.
+     *               The components of the vertex with insertion index i
+     *               are stored at positions i*ncomps,...,(i+1)*ncomps-1.
+     *
+     * \throw IOError There is no point data field with that name.
+     */
+    template<class V>
+    void pointData(const std::string& name, V& values) const
+    {
+      copy(field(pointData_, name), values);
+    }
+
+    //! copy a cell data field into a vector
+    /**
+     * \param name   Name of the field.
+     * \param values Vector to copy into, it is resized to the number of
+     *               elements times the number of components of the field.
+     *               The components of the element with insertion index i
+     *               are stored at positions i*ncomps,...,(i+1)*ncomps-1.
+     *
+     * \throw IOError There is no cell data field with that name.
+     */
+    template<class V>
+    void cellData(const std::string& name, V& values) const
+    {
+      copy(field(cellData_, name), values);
+    }
+
+  private:
+    //! values of a data field
+    struct Field
+    {
+      int ncomps;
+      std::vector<double> values;
+    };
+    typedef std::map<std::string, Field> FieldMap;
+
+    //! how binary data is stored in a file
+    struct Format
+    {
+      bool swap;
+      int headerBytes;
+      bool compressed;
+      bool base64;
+      std::streampos appended;
+    };
+
+    //! a data array in the appended section
+    struct Array
+    {
+      std::string section;
+      std::string name;
+      std::string type;
+      int ncomps;
+      std::streamoff offset;
+    };
+
+    //! the contents of a Piece element
+    struct Piece
+    {
+      std::size_t npoints;
+      std::size_t ncells;
+      bool polyData;
+      std::vector<double> coordinates;
+      std::vector<unsigned long> connectivity;
+      std::vector<unsigned long> offsets;
+      std::vector<int> types;
+      FieldMap pointData;
+      FieldMap cellData;
+      std::vector<Array> appended;
+
+      //! free the memory of the piece
+      void release()
+      {
+        std::vector<double>().swap(coordinates);
+        std::vector<unsigned long>().swap(connectivity);
+        std::vector<unsigned long>().swap(offsets);
+        std::vector<int>().swap(types);
+        FieldMap().swap(pointData);
+        FieldMap().swap(cellData);
+      }
+    };
+
+    //! key for identifying points by their coordinates
+    struct Point
+    {
+      double x[3];
+      bool operator<(const Point& other) const
+      {
+        return std::lexicographical_compare(x, x + 3, other.x, other.x + 3);
+      }
+    };
+
+    // path of a piece file relative to the directory of the parallel file
+    static std::string piecePath(const std::string& fileName,
+                                 const std::string& source)
+    {
+      if (source.empty())
+        DUNE_THROW(IOError, "VTKReader: Piece without Source in "
+                   << fileName);
+      if (source[0] == '/')
+        return source;
+      const std::size_t pos = fileName.rfind('/');
+      if (pos == std::string::npos)
+        return source;
+      return fileName.substr(0, pos + 1) + source;
+    }
+
+    // read the pieces of a serial file
+    void readPieces(GridFactory<Grid>& factory, const std::string& fileName,
+                    bool merge)
+    {
+      std::ifstream file(fileName.c_str(), std::ios::binary);
+      if (!file)
+        DUNE_THROW(IOError, "VTKReader: could not open " << fileName);
+
+      VTK::XMLTag tag;
+      if (!VTK::readXMLTag(file, tag) || tag.name != "VTKFile")
+        DUNE_THROW(IOError, "VTKReader: " << fileName
+                   << " is not a VTK XML file");
+      const std::string type = tag.attribute("type");
+      if (type != "UnstructuredGrid" && type != "PolyData")
+        DUNE_THROW(IOError, "VTKReader: unsupported file type " << type
+                   << " in " << fileName);
+
+      Format format;
+      format.swap = tag.attribute("byte_order", VTK::getEndiannessString())
+                    != VTK::getEndiannessString();
+      format.headerBytes =
+        tag.attribute("header_type", "UInt32") == "UInt64" ? 8 : 4;
+      format.compressed = !tag.attribute("compressor").empty();
+      format.base64 = false;
+      if (format.compressed
+          && tag.attribute("compressor") != "vtkZLibDataCompressor")
+        DUNE_THROW(IOError, "VTKReader: unsupported compressor "
+                   << tag.attribute("compressor") << " in " << fileName);
+
+      std::vector<Piece> pieces;
+      std::string section;
+      bool appended = false;
+      while (!appended && VTK::readXMLTag(file, tag)) {
+        if (tag.name == "Piece" && !tag.closing) {
+          pieces.push_back(Piece());
+          Piece& piece = pieces.back();
+          piece.polyData = (type == "PolyData");
+          piece.npoints = toNumber(tag.attribute("NumberOfPoints", "0"));
+          piece.ncells = toNumber(tag.attribute(piece.polyData ?
+                                                "NumberOfLines" :
+                                                "NumberOfCells", "0"));
+          if (piece.polyData
+              && (toNumber(tag.attribute("NumberOfVerts", "0")) > 0
+                  || toNumber(tag.attribute("NumberOfStrips", "0")) > 0
+                  || toNumber(tag.attribute("NumberOfPolys", "0")) > 0))
+            DUNE_THROW(IOError, "VTKReader: only lines are supported in "
+                       "PolyData files");
+        }
+        else if (tag.name == "DataArray" && !tag.closing) {
+          if (pieces.empty())
+            DUNE_THROW(IOError, "VTKReader: DataArray outside of a Piece in "
+                       << fileName);
+          Array array;
+          array.section = section;
+          array.name = tag.attribute("Name");
+          array.type = tag.attribute("type");
+          array.ncomps = toNumber(tag.attribute("NumberOfComponents", "1"));
+          array.offset = toNumber(tag.attribute("offset", "0"));
+          const std::string f = tag.attribute("format");
+          if (f == "appended")
+            pieces.back().appended.push_back(array);
+          else if (f == "ascii" || f == "binary") {
+            if (tag.empty)
+              DUNE_THROW(IOError, "VTKReader: DataArray " << array.name
+                         << " without data in " << fileName);
+            format.base64 = (f == "binary");
+            readArray(file, format, f == "ascii", array, pieces.back());
+          }
+          else
+            DUNE_THROW(IOError, "VTKReader: unsupported format " << f
+                       << " of DataArray " << array.name);
+        }
+        else if (tag.name == "AppendedData" && !tag.closing) {
+          const std::string encoding = tag.attribute("encoding");
+          if (encoding != "raw" && encoding != "base64")
+            DUNE_THROW(IOError, "VTKReader: unsupported encoding "
+                       << encoding << " of the appended data in "
+                       << fileName);
+          format.base64 = (encoding == "base64");
+          char c;
+          while (file.get(c) && c != '_')
+            if (!std::isspace(static_cast<unsigned char>(c)))
+              DUNE_THROW(IOError, "VTKReader: appended data does not start "
+                         "with '_' in " << fileName);
+          format.appended = file.tellg();
+          appended = true;
+        }
+        else if (tag.name == "PointData" || tag.name == "CellData"
+                 || tag.name == "Points" || tag.name == "Cells"
+                 || tag.name == "Lines")
+          section = (tag.closing || tag.empty) ? "" : tag.name;
+      }
+
+      for (std::size_t i = 0; i < pieces.size(); ++i) {
+        Piece& piece = pieces[i];
+        if (!piece.appended.empty() && !appended)
+          DUNE_THROW(IOError, "VTKReader: " << fileName
+                     << " has no appended data");
+        for (std::size_t j = 0; j < piece.appended.size(); ++j) {
+          file.clear();
+          file.seekg(format.appended + piece.appended[j].offset);
+          readArray(file, format, false, piece.appended[j], piece);
+        }
+        insertPiece(factory, piece, merge || mergePoints_ || pieces.size() > 1);
+        piece.release();
+      }
+    }
+
+    // read the data of an array into its destination in the piece
+    void readArray(std::istream& s, const Format& format, bool ascii,
+                   const Array& array, Piece& piece)
+    {
+      if (array.section == "Points") {
+        if (array.ncomps != 3)
+          DUNE_THROW(IOError, "VTKReader: points must have 3 components");
+        readValues(s, format, ascii, array, piece.coordinates);
+      }
+      else if (array.section == "Cells" || array.section == "Lines") {
+        if (array.name == "connectivity")
+          readValues(s, format, ascii, array, piece.connectivity);
+        else if (array.name == "offsets")
+          readValues(s, format, ascii, array, piece.offsets);
+        else if (array.name == "types")
+          readValues(s, format, ascii, array, piece.types);
+      }
+      else if (array.section == "PointData" || array.section == "CellData") {
+        Field& field = (array.section == "PointData" ? piece.pointData
+                        : piece.cellData)[array.name];
+        field.ncomps = array.ncomps;
+        readValues(s, format, ascii, array, field.values);
+      }
+    }
+
+    // read the values of an array, starting at the current stream position
+    template<class T>
+    void readValues(std::istream& s, const Format& format, bool ascii,
+                    const Array& array, std::vector<T>& values)
+    {
+      values.clear();
+      if (ascii) {
+        double v;
+        while ((s >> std::ws) && s.peek() != '<' && (s >> v))
+          values.push_back(T(v));
+        if (!s)
+          DUNE_THROW(IOError, "VTKReader: invalid ascii data in DataArray "
+                     << array.name);
+        return;
+      }
+
+      VTK::RawByteSource raw(s);
+      VTK::Base64ByteSource b64(s);
+      VTK::ByteSource& src = format.base64 ? static_cast<VTK::ByteSource&>(b64)
+                             : static_cast<VTK::ByteSource&>(raw);
+      const std::size_t size = VTK::typeSize(array.type);
+      if (format.compressed) {
+#if HAVE_ZLIB
+        VTK::ZLibByteSource zsrc(src, format.headerBytes, format.swap);
+        values.resize(zsrc.size() / size);
+        if (!values.empty())
+          VTK::readValues(zsrc, array.type, format.swap, values.size(),
+                          &values[0]);
+#else
+        DUNE_THROW(NotImplemented, "VTKReader: reading compressed data "
+                   "requires zlib");
+#endif
+      }
+      else {
+        values.resize(VTK::readHeaderValue(src, format.headerBytes,
+                                           format.swap) / size);
+        src.endBlock();
+        if (!values.empty())
+          VTK::readValues(src, array.type, format.swap, values.size(),
+                          &values[0]);
+      }
+    }
+
+    // insert the points and cells of a piece into the factory
+    void insertPiece(GridFactory<Grid>& factory, const Piece& piece,
+                     bool merge)
+    {
+      if (piece.coordinates.size() != 3*piece.npoints)
+        DUNE_THROW(IOError, "VTKReader: piece has " << piece.npoints
+                   << " points, but " << piece.coordinates.size()/3
+                   << " coordinates");
+      if (piece.offsets.size() != piece.ncells
+          || (!piece.polyData && piece.types.size() != piece.ncells))
+        DUNE_THROW(IOError, "VTKReader: piece has " << piece.ncells
+                   << " cells, but " << piece.offsets.size()
+                   << " offsets and " << piece.types.size() << " types");
+      if (npieces_ > 0 && (piece.pointData.size() != pointData_.size()
+                           || piece.cellData.size() != cellData_.size()))
+        DUNE_THROW(IOError, "VTKReader: the pieces contain different data "
+                   "fields");
+
+      // points
+      std::vector<unsigned int> vertex(piece.npoints);
+      std::vector<bool> inserted(piece.npoints, true);
+      for (std::size_t p = 0; p < piece.npoints; ++p) {
+        const double* x = &piece.coordinates[3*p];
+        if (merge) {
+          Point key;
+          std::copy(x, x + 3, key.x);
+          std::pair<typename std::map<Point, unsigned int>::iterator, bool>
+          r = points_.insert(std::make_pair(key, unsigned(nvertices_)));
+          if (!r.second) {
+            vertex[p] = r.first->second;
+            inserted[p] = false;
+            continue;
+          }
+        }
+        FieldVector<typename Grid::ctype, dimensionworld> pos;
+        for (int i = 0; i < dimensionworld; ++i)
+          pos[i] = x[i];
+        factory.insertVertex(pos);
+        vertex[p] = nvertices_++;
+      }
+
+      // point data of newly inserted points
+      for (typename FieldMap::const_iterator it = piece.pointData.begin();
+           it != piece.pointData.end(); ++it) {
+        const Field& in = it->second;
+        Field& out = addField(pointData_, it->first, in, piece.npoints);
+        out.values.resize(nvertices_*in.ncomps);
+        for (std::size_t p = 0; p < piece.npoints; ++p)
+          if (inserted[p])
+            std::copy(&in.values[p*in.ncomps], &in.values[(p+1)*in.ncomps],
+                      &out.values[vertex[p]*in.ncomps]);
+      }
+
+      // cells
+      std::vector<unsigned int> corners;
+      for (std::size_t c = 0; c < piece.ncells; ++c) {
+        const std::size_t begin = c > 0 ? piece.offsets[c-1] : 0;
+        const std::size_t end = piece.offsets[c];
+        bool vtkOrder;
+        std::size_t ncorners;
+        const Dune::GeometryType gt =
+          geometryType(piece.polyData ? VTK::line : piece.types[c],
+                       vtkOrder, ncorners);
+        if (int(gt.dim()) != dimension)
+          DUNE_THROW(IOError, "VTKReader: cell of type " << gt
+                     << " in a grid of dimension " << dimension);
+        if (end < begin || end - begin != ncorners
+            || end > piece.connectivity.size())
+          DUNE_THROW(IOError, "VTKReader: cell " << c << " of type " << gt
+                     << " has " << end - begin << " corners");
+        corners.resize(ncorners);
+        for (std::size_t i = 0; i < ncorners; ++i) {
+          const unsigned long p = piece.connectivity[begin + i];
+          if (p >= piece.npoints)
+            DUNE_THROW(IOError, "VTKReader: cell " << c
+                       << " refers to point " << p);
+          corners[vtkOrder ? VTK::renumber(gt, i) : i] = vertex[p];
+        }
+        factory.insertElement(gt, corners);
+      }
+      nelements_ += piece.ncells;
+
+      // cell data
+      for (typename FieldMap::const_iterator it = piece.cellData.begin();
+           it != piece.cellData.end(); ++it) {
+        Field& out = addField(cellData_, it->first, it->second, piece.ncells);
+        out.values.insert(out.values.end(), it->second.values.begin(),
+                          it->second.values.end());
+      }
+
+      ++npieces_;
+    }
+
+    // the field name of map, checks the size of the field of a piece
+    Field& addField(FieldMap& map, const std::string& name, const Field& in,
+                    std::size_t nitems)
+    {
+      if (in.values.size() != nitems*in.ncomps)
+        DUNE_THROW(IOError, "VTKReader: data field " << name << " has "
+                   << in.values.size() << " values, expected "
+                   << nitems*in.ncomps);
+      typename FieldMap::iterator it = map.find(name);
+      if (it == map.end()) {
+        if (npieces_ > 0)
+          DUNE_THROW(IOError, "VTKReader: data field " << name
+                     << " is missing in previous pieces");
+        Field& out = map[name];
+        out.ncomps = in.ncomps;
+        return out;
+      }
+      if (it->second.ncomps != in.ncomps)
+        DUNE_THROW(IOError, "VTKReader: data field " << name
+                   << " has different numbers of components in the pieces");
+      return it->second;
+    }
+
+    // Dune geometry type and number of corners of a VTK cell type; vtkOrder
+    // tells whether the corners have to be renumbered with VTK::renumber()
+    static Dune::GeometryType geometryType(int type, bool& vtkOrder,
+                                           std::size_t& ncorners)
+    {
+      // VTK_PIXEL and VTK_VOXEL are a quadrilateral and a hexahedron with
+      // corners in Dune order
+      const int pixel = 8;
+      const int voxel = 11;
+
+      vtkOrder = true;
+      switch (type) {
+      case VTK::vertex :
+        ncorners = 1;
+        return Dune::GeometryType(Dune::GeometryType::simplex, 0);
+      case VTK::line :
+        ncorners = 2;
+        return Dune::GeometryType(Dune::GeometryType::simplex, 1);
+      case VTK::triangle :
+        ncorners = 3;
+        return Dune::GeometryType(Dune::GeometryType::simplex, 2);
+      case pixel :
+        vtkOrder = false;
+      // fall through
+      case VTK::quadrilateral :
+        ncorners = 4;
+        return Dune::GeometryType(Dune::GeometryType::cube, 2);
+      case VTK::tetrahedron :
+        ncorners = 4;
+        return Dune::GeometryType(Dune::GeometryType::simplex, 3);
+      case VTK::pyramid :
+        ncorners = 5;
+        return Dune::GeometryType(Dune::GeometryType::pyramid, 3);
+      case VTK::prism :
+        ncorners = 6;
+        return Dune::GeometryType(Dune::GeometryType::prism, 3);
+      case voxel :
+        vtkOrder = false;
+      // fall through
+      case VTK::hexahedron :
+        ncorners = 8;
+        return Dune::GeometryType(Dune::GeometryType::cube, 3);
+      default :
+        DUNE_THROW(IOError, "VTKReader: unsupported VTK cell type " << type);
+      }
+    }
+
+    static std::size_t toNumber(const std::string& s)
+    {
+      std::istringstream stream(s);
+      std::size_t n;
+      if (!(stream >> n))
+        DUNE_THROW(IOError, "VTKReader: invalid number \"" << s << "\"");
+      return n;
+    }
+
+    static std::vector<std::string> names(const FieldMap& map)
+    {
+      std::vector<std::string> result;
+      for (typename FieldMap::const_iterator it = map.begin();
+           it != map.end(); ++it)
+        result.push_back(it->first);
+      return result;
+    }
+
+    static const Field& field(const FieldMap& map, const std::string& name)
+    {
+      typename FieldMap::const_iterator it = map.find(name);
+      if (it == map.end())
+        DUNE_THROW(IOError, "VTKReader: no data field " << name);
+      return it->second;
+    }
+
+    template<class V>
+    static void copy(const Field& field, V& values)
+    {
+      values.resize(field.values.size());
+      for (std::size_t i = 0; i < field.values.size(); ++i)
+        values[i] = field.values[i];
+    }
+
+    bool mergePoints_;
+    bool verbose_;
+    FieldMap pointData_;
+    FieldMap cellData_;
+    // inserted points, only used when merging points
+    std::map<Point, unsigned int> points_;
+    std::size_t nvertices_;
+    std::size_t nelements_;
+    std::size_t npieces_;
+  };
+
+  //! \} group VTK
+
+} // namespace Dune
+
+#endif // DUNE_GRID_IO_FILE_VTK_VTKREADER_HH
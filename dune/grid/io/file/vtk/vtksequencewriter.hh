@@ -4,7 +4,24 @@
 #ifndef DUNE_VTKSEQUENCE_HH
 #define DUNE_VTKSEQUENCE_HH
 
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/path.hh>
+#include <dune/common/shared_ptr.hh>
 #include <dune/grid/io/file/vtk/vtkwriter.hh>
+#include <dune/grid/io/file/vtk/vtuwriter.hh>
 
 namespace Dune {
 
@@ -15,6 +32,17 @@ namespace Dune {
    * Writes arbitrary grid functions (living on cells or vertices of a grid)
    * to a file suitable for easy visualization with
    * <a href="http://www.vtk.org/">The Visualization Toolkit (VTK)</a>.
+   *
+   * If the writer is constructed with maxPending > 0, the files are written
+   * asynchronously: write() only copies the grid and the function values
+   * into a VTK::VTUStage and returns.  A background thread encodes the
+   * staged data and writes the .vtu/.pvtu/.pvd files.  At most maxPending
+   * time steps are held in memory; if the background thread falls behind,
+   * write() blocks until a time step has been written.  In this mode the
+   * processes do not synchronize, i.e. the .pvtu file may be written before
+   * the pieces of the other processes are complete.  Use flush() to wait
+   * for all files.  Asynchronous writing requires pthreads, without them
+   * the files are written synchronously.
    */
   template< class GridView >
   class VTKSequenceWriter : public VTKWriter<GridView> {
@@ -22,22 +50,93 @@ namespace Dune {
     typedef VTKSequenceWriter<GridView> ThisType;
     std::string name_,path_,extendpath_;
     std::vector<double> timesteps_;
+
+    //! the files of one time step
+    struct Job
+    {
+      VTK::VTUStage stage;
+      VTK::OutputType type;
+      std::string pieceName;
+      // header and pvd file are only written if the name is not empty
+      std::string headerName;
+      std::string header;
+      std::string pvdName;
+      std::string pvd;
+    };
+
+    unsigned maxPending_;
+#if HAVE_PTHREAD
+    // time steps waiting to be written; the front one is in progress
+    std::deque<shared_ptr<Job> > queue_;
+    pthread_t thread_;
+    pthread_mutex_t mutex_;
+    pthread_cond_t jobAdded_;
+    pthread_cond_t jobDone_;
+    bool running_;
+    bool stop_;
+    // message of the first error in the background thread
+    std::string error_;
+#endif
+
   public:
+    /**
+     * @brief Construct a VTKSequenceWriter
+     *
+     * @param gridView   The gridView the grid functions live on.
+     * @param name       Base name of the output files.
+     * @param path       Directory for the .pvtu files.
+     * @param extendpath Directory for the .vtu files, relative to path.
+     * @param dm         The data mode.
+     * @param maxPending Maximum number of time steps waiting to be written
+     *                   by the background thread.  0 (the default) writes
+     *                   the files synchronously in write().
+     */
     explicit VTKSequenceWriter ( const GridView &gridView,
                                  const std::string& name,
                                  const std::string& path,
                                  const std::string& extendpath,
-                                 VTK::DataMode dm = VTK::conforming )
+                                 VTK::DataMode dm = VTK::conforming,
+                                 unsigned maxPending = 0 )
       : BaseType(gridView,dm),
         name_(name), path_(path),
-        extendpath_(extendpath)
-    {}
-    ~VTKSequenceWriter() {}
+        extendpath_(extendpath),
+        maxPending_(maxPending)
+    {
+#if HAVE_PTHREAD
+      running_ = false;
+      stop_ = false;
+      pthread_mutex_init(&mutex_, 0);
+      pthread_cond_init(&jobAdded_, 0);
+      pthread_cond_init(&jobDone_, 0);
+#endif
+    }
+
+    //! writes all pending time steps before destruction
+    ~VTKSequenceWriter()
+    {
+#if HAVE_PTHREAD
+      if (running_)
+      {
+        pthread_mutex_lock(&mutex_);
+        stop_ = true;
+        pthread_cond_signal(&jobAdded_);
+        pthread_mutex_unlock(&mutex_);
+        pthread_join(thread_, 0);
+        if (!error_.empty())
+          std::cerr << "VTKSequenceWriter: " << error_ << std::endl;
+      }
+      pthread_cond_destroy(&jobDone_);
+      pthread_cond_destroy(&jobAdded_);
+      pthread_mutex_destroy(&mutex_);
+#endif
+    }
 
     /**
      * \brief Writes VTK data for the given time.
      * \param time The time(step) for the data to be written.
      * \param ot VTK output type.
+     *
+     * \throw IOError Writing a previous time step in the background failed.
      */
     void write (double time, VTK::OutputType ot = VTK::ascii)
     {
@@ -48,36 +147,40 @@ namespace Dune {
       /* make sure the directory exists */
       // mkdir("vtk", 777);
 
+#if HAVE_PTHREAD
+      if (maxPending_ > 0)
+      {
+        enqueue(stage(count, ot));
+        return;
+      }
+#endif
+
       /* write VTK file */
-      std::string pvtuName = BaseType::pwrite(seqName(count), path_,extendpath_,ot);
+      BaseType::pwrite(seqName(count), path_,extendpath_,ot);
 
       /* write pvd file ... only on rank 0 */
-      if (this->gridView_.comm().rank()==0) {
-        std::ofstream pvdFile;
-        pvdFile.exceptions(std::ios_base::badbit | std::ios_base::failbit |
-                           std::ios_base::eofbit);
-        std::string pvdname = name_ + ".pvd";
-        pvdFile.open(pvdname.c_str());
-        pvdFile << "<?xml version=\"1.0\"?> \n"
-                << "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"LittleEndian\"> \n"
-                << "<Collection> \n";
-        for (unsigned int i=0; i<=count; i++)
-        {
-          // filename
-          std::string piecepath = concatPaths(path_, extendpath_);
-          std::string fullname =
-            this->getParallelPieceName(seqName(i), piecepath,
-                                       this->gridView_.comm().rank(),
-                                       this->gridView_.comm().size());
-          pvdFile << "<DataSet timestep=\"" << timesteps_[i]
-                  << "\" group=\"\" part=\"0\" name=\"\" file=\""
-                  << fullname << "\"/> \n";
-        }
-        pvdFile << "</Collection> \n"
-                << "</VTKFile> \n" << std::flush;
-        pvdFile.close();
-      }
+      if (this->gridView_.comm().rank()==0)
+        writeFile(name_ + ".pvd", pvdContents(count));
+    }
+
+    /**
+     * \brief Wait until all time steps have been written.
+     *
+     * Does nothing if the files are written synchronously.
+     *
+     * \throw IOError Writing a time step in the background failed.
+     */
+    void flush ()
+    {
+#if HAVE_PTHREAD
+      pthread_mutex_lock(&mutex_);
+      while (!queue_.empty())
+        pthread_cond_wait(&jobDone_, &mutex_);
+      checkError();
+      pthread_mutex_unlock(&mutex_);
+#endif
     }
+
   private:
 
     // create sequence name
@@ -89,6 +192,158 @@ namespace Dune {
       return n.str();
     }
 
+    // contents of the pvd file for the time steps 0,...,count
+    std::string pvdContents(unsigned int count) const
+    {
+      std::ostringstream pvdFile;
+      pvdFile << "<?xml version=\"1.0\"?> \n"
+              << "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"LittleEndian\"> \n"
+              << "<Collection> \n";
+      for (unsigned int i=0; i<=count; i++)
+      {
+        // filename
+        std::string piecepath = concatPaths(path_, extendpath_);
+        std::string fullname =
+          this->getParallelPieceName(seqName(i), piecepath,
+                                     this->gridView_.comm().rank(),
+                                     this->gridView_.comm().size());
+        pvdFile << "<DataSet timestep=\"" << timesteps_[i]
+                << "\" group=\"\" part=\"0\" name=\"\" file=\""
+                << fullname << "\"/> \n";
+      }
+      pvdFile << "</Collection> \n"
+              << "</VTKFile> \n";
+      return pvdFile.str();
+    }
+
+    // write a string to a file
+    static void writeFile(const std::string& name, const std::string& contents)
+    {
+      std::ofstream file;
+      file.exceptions(std::ios_base::badbit | std::ios_base::failbit |
+                      std::ios_base::eofbit);
+      file.open(name.c_str());
+      file << contents << std::flush;
+      file.close();
+    }
+
+    // copy everything needed to write time step count
+    shared_ptr<Job> stage(unsigned int count, VTK::OutputType ot)
+    {
+      const int rank = this->gridView_.comm().rank();
+      const int size = this->gridView_.comm().size();
+      const std::string piecepath = concatPaths(path_, extendpath_);
+
+      shared_ptr<Job> job(new Job);
+      this->stageDataFile(job->stage);
+      job->type = ot;
+      job->pieceName = this->getParallelPieceName(seqName(count), piecepath,
+                                                  rank, size);
+      if (rank == 0)
+      {
+        std::ostringstream header;
+        this->writeParallelHeader(header, seqName(count),
+                                  relativePath(path_, piecepath), size);
+        job->headerName = this->getParallelHeaderName(seqName(count), path_,
+                                                      size);
+        job->header = header.str();
+        job->pvdName = name_ + ".pvd";
+        job->pvd = pvdContents(count);
+      }
+      return job;
+    }
+
+    // write the files of a staged time step
+    static void writeJob(const Job& job)
+    {
+      std::ofstream file;
+      file.exceptions(std::ios_base::badbit | std::ios_base::failbit |
+                      std::ios_base::eofbit);
+      file.open(job.pieceName.c_str(), std::ios::binary);
+      job.stage.write(file, job.type);
+      file.close();
+
+      if (!job.headerName.empty())
+        writeFile(job.headerName, job.header);
+      if (!job.pvdName.empty())
+        writeFile(job.pvdName, job.pvd);
+    }
+
+#if HAVE_PTHREAD
+    // hand a time step to the background thread, block if the queue is full
+    void enqueue(const shared_ptr<Job>& job)
+    {
+      pthread_mutex_lock(&mutex_);
+      if (!running_)
+      {
+        if (pthread_create(&thread_, 0, &ThisType::run, this) != 0)
+        {
+          pthread_mutex_unlock(&mutex_);
+          DUNE_THROW(IOError, "VTKSequenceWriter: could not start the "
+                     "writer thread");
+        }
+        running_ = true;
+      }
+      while (queue_.size() >= maxPending_ && error_.empty())
+        pthread_cond_wait(&jobDone_, &mutex_);
+      checkError();
+      queue_.push_back(job);
+      pthread_cond_signal(&jobAdded_);
+      pthread_mutex_unlock(&mutex_);
+    }
+
+    // throw the error of the background thread; mutex_ must be locked
+    void checkError()
+    {
+      if (error_.empty())
+        return;
+      std::string error = error_;
+      error_.clear();
+      pthread_mutex_unlock(&mutex_);
+      DUNE_THROW(IOError, "VTKSequenceWriter: " << error);
+    }
+
+    static void* run(void* self)
+    {
+      static_cast<ThisType*>(self)->work();
+      return 0;
+    }
+
+    // main loop of the background thread
+    void work()
+    {
+      pthread_mutex_lock(&mutex_);
+      while (true)
+      {
+        while (queue_.empty() && !stop_)
+          pthread_cond_wait(&jobAdded_, &mutex_);
+        if (queue_.empty())
+          break;
+
+        shared_ptr<Job> job = queue_.front();
+        pthread_mutex_unlock(&mutex_);
+
+        std::string error;
+        try {
+          writeJob(*job);
+        }
+        catch (Dune::Exception& e) {
+          error = e.what();
+        }
+        catch (std::exception& e) {
+          error = e.what();
+        }
+
+        pthread_mutex_lock(&mutex_);
+        if (!error.empty() && error_.empty())
+          error_ = error;
+        queue_.pop_front();
+        pthread_cond_broadcast(&jobDone_);
+      }
+      pthread_mutex_unlock(&mutex_);
+    }
+#endif
+
     // do not inherit pwrite
     void pwrite();
   };
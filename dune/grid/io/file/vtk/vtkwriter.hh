@@ -4,8 +4,11 @@
 #ifndef DUNE_VTKWRITER_HH
 #define DUNE_VTKWRITER_HH
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -26,6 +29,7 @@
 #include <dune/grid/io/file/vtk/dataarraywriter.hh>
 #include <dune/grid/io/file/vtk/function.hh>
 #include <dune/grid/io/file/vtk/pvtuwriter.hh>
+#include <dune/grid/io/file/vtk/sharedvtuwriter.hh>
 #include <dune/grid/io/file/vtk/streams.hh>
 #include <dune/grid/io/file/vtk/vtuwriter.hh>
 
@@ -339,11 +343,21 @@ namespace Dune
      *
      * @param gridView The gridView the grid functions live on. (E. g. a LevelGridView.)
      * @param dm The data mode.
+     * @param coordPrecision Precision of the vertex coordinates in the file.
      */
     explicit VTKWriter ( const GridView &gridView,
-                         VTK::DataMode dm = VTK::conforming )
+                         VTK::DataMode dm = VTK::conforming,
+                         VTK::Precision coordPrecision = VTK::float32 )
       : gridView_( gridView ),
-        datamode( dm )
+        coordPrecision_( coordPrecision ),
+        datamode( dm ),
+        cellOrder( -1 ),
+        vertexOrder( -1 ),
+        cacheGrid_( false ),
+        gridToken_( 0 ),
+        cachedToken_( 0 ),
+        cachedCells_( -1 ),
+        cachedVertices_( -1 )
     { }
 
     /**
@@ -379,9 +393,11 @@ namespace Dune
      * @param v The container with the values of the grid function for each cell.
      * @param name A name to identify the grid function.
      * @param ncomps Number of components (default is 1).
+     * @param prec Precision of the values in the file (default is float32).
      */
     template<class V>
-    void addCellData (const V& v, const std::string &name, int ncomps = 1)
+    void addCellData (const V& v, const std::string &name, int ncomps = 1,
+                      VTK::Precision prec = VTK::float32)
     {
       typedef P0VTKFunction<GridView, V> Function;
       for (int c=0; c<ncomps; ++c) {
@@ -389,7 +405,8 @@ namespace Dune
         compName << name;
         if (ncomps>1)
           compName << "[" << c << "]";
-        VTKFunction* p = new Function(gridView_, v, compName.str(), ncomps, c);
+        VTKFunction* p = new Function(gridView_, v, compName.str(), ncomps, c,
+                                      prec);
         celldata.push_back(VTKFunctionPtr(p));
       }
     }
@@ -427,9 +444,11 @@ namespace Dune
      * @param v The container with the values of the grid function for each cell.
      * @param name A name to identify the grid function.
      * @param ncomps Number of components (default is 1).
+     * @param prec Precision of the values in the file (default is float32).
      */
     template<class V>
-    void addVertexData (const V& v, const std::string &name, int ncomps=1)
+    void addVertexData (const V& v, const std::string &name, int ncomps=1,
+                        VTK::Precision prec = VTK::float32)
     {
       typedef P1VTKFunction<GridView, V> Function;
       for (int c=0; c<ncomps; ++c) {
@@ -437,7 +456,8 @@ namespace Dune
         compName << name;
         if (ncomps>1)
           compName << "[" << c << "]";
-        VTKFunction* p = new Function(gridView_, v, compName.str(), ncomps, c);
+        VTKFunction* p = new Function(gridView_, v, compName.str(), ncomps, c,
+                                      prec);
         vertexdata.push_back(VTKFunctionPtr(p));
       }
     }
@@ -449,6 +469,47 @@ namespace Dune
       vertexdata.clear();
     }
 
+    /**
+     * @brief Keep the grid information between calls of write()
+     *
+     * The vertex numbering, the coordinates, the connectivity, the offsets
+     * and the cell types are computed in the first call of write() and
+     * reused by later calls, so that writing several time steps on the same
+     * grid only evaluates the registered functions.  The cached information
+     * is rebuilt if the number of cells or vertices of the grid view
+     * changes or the grid token has changed, see gridChanged() and
+     * setGridToken().  Any other modification of the grid (e.g. moved
+     * vertices or adaptation which does not change the number of entities)
+     * must be announced by one of these methods.
+     *
+     * @param enable Whether to cache the grid information.
+     */
+    void cacheGrid (bool enable = true)
+    {
+      cacheGrid_ = enable;
+      if (!enable)
+        releaseGrid();
+    }
+
+    //! invalidate the cached grid information
+    void gridChanged ()
+    {
+      ++gridToken_;
+    }
+
+    /**
+     * @brief Set the token identifying the current state of the grid
+     *
+     * The cached grid information is rebuilt in the next call of write() if
+     * token differs from the token the cache was built with.  This is
+     * convenient if the application already counts the modifications of its
+     * grid, e.g. the number of adaptation cycles.
+     */
+    void setGridToken (unsigned long token)
+    {
+      gridToken_ = token;
+    }
+
     //! destructor
     virtual ~VTKWriter ()
     {
@@ -504,6 +565,73 @@ namespace Dune
       return pwrite( name, path, extendpath, type, gridView_.comm().rank(), gridView_.comm().size() );
     }
 
+    /** \brief write the pieces of all processes into a single file
+     *
+     * Instead of one .vtu/.vtp file per process and a .pvtu/.pvtp
+     * collection file, all processes write their pieces collectively into
+     * one .vtu/.vtp file with MPI-IO.  Each piece is an own Piece element
+     * of the file, the data is always written in appendedraw format.
+     * Without MPI, this writes the same file as write() with appendedraw.
+     *
+     * \param name Base name of the output file, without filename
+     *             extension.
+     * \returns The name of the file written.
+     *
+     * \throw IOError Failed to open or to write the file.
+     */
+    std::string writeShared ( const std::string &name )
+    {
+      VTK::VTUStage stage;
+      stageDataFile(stage);
+
+      const std::string fullname = getSerialPieceName(name, "");
+      VTK::SharedVTUWriter writer(gridView_.comm());
+      writer.write(stage, fullname);
+      return fullname;
+    }
+
+    /** \brief write the pieces of groups of processes into one file per group
+     *
+     * The processes are split into groups.  The first process of each
+     * group (the aggregator) collects the pieces of the group and writes
+     * them into one .vtu/.vtp file, in appendedraw format.  Process 0 then
+     * writes a .pvtu/.pvtp collection file referring to the files of the
+     * groups.  This reduces the number of files to the number of groups
+     * while each file is written by a single process.
+     *
+     * \param name      Base name of the output files, as for write().
+     * \param groupSize Number of consecutive processes in one group.  If
+     *                  0, the processes of each node form a group; this
+     *                  requires MPI 3.
+     * \returns The name of the collection file.
+     *
+     * \throw IOError        Failed to open or to write a file.
+     * \throw NotImplemented groupSize is 0 and MPI is older than 3.0.
+     */
+    std::string writeAggregated ( const std::string &name, int groupSize = 0 )
+    {
+      VTK::VTUStage stage;
+      stageDataFile(stage);
+
+      VTK::SharedVTUWriter writer(gridView_.comm(), groupSize);
+      writer.gather(stage, getParallelPieceName(name, "", writer.group(),
+                                                writer.groups()));
+
+      const std::string fullname = getParallelHeaderName(name, "",
+                                                         writer.groups());
+      if( gridView_.comm().rank() == 0 )
+      {
+        std::ofstream file;
+        file.open(fullname.c_str());
+        if (! file.is_open())
+          DUNE_THROW(IOError, "Could not write to parallel file " << fullname);
+        writeParallelHeader(file, name, "", writer.groups());
+        file.close();
+      }
+      gridView_.comm().barrier();
+      return fullname;
+    }
+
   protected:
     //! return name of a parallel piece file
     /**
@@ -696,7 +824,7 @@ namespace Dune
       return fullname;
     }
 
-  private:
+  protected:
     //! write header file in parallel case to stream
     /**
      * Writes a .pvtu/.pvtp file for a collection of concurrently written
@@ -750,7 +878,7 @@ namespace Dune
       {
         unsigned writecomps = (*it)->ncomps();
         if(writecomps == 2) writecomps = 3;
-        writer.addArray<float>((*it)->name(), writecomps);
+        writer.addArray((*it)->name(), writecomps, (*it)->precision());
       }
       writer.endPointData();
 
@@ -777,13 +905,13 @@ namespace Dune
       for (FunctionIterator it=celldata.begin(); it!=celldata.end(); ++it) {
         unsigned writecomps = (*it)->ncomps();
         if(writecomps == 2) writecomps = 3;
-        writer.addArray<float>((*it)->name(), writecomps);
+        writer.addArray((*it)->name(), writecomps, (*it)->precision());
       }
       writer.endCellData();
 
       // PPoints
       writer.beginPoints();
-      writer.addArray<float>("Coordinates", 3);
+      writer.addArray("Coordinates", 3, coordPrecision_);
       writer.endPoints();
 
       // Pieces
@@ -805,15 +933,30 @@ namespace Dune
         (n == 1) ? VTK::polyData : VTK::unstructuredGrid;
 
       VTK::VTUWriter writer(s, outputtype, fileType);
+      writePiece(writer);
+    }
 
+    //! copy the contents of the data file into a VTUStage
+    /**
+     * The stage can be written later by VTUStage::write(), even if the grid
+     * or the data of the registered functions have changed meanwhile.
+     */
+    void stageDataFile (VTK::VTUStage& stage)
+    {
+      VTK::FileType fileType =
+        (n == 1) ? VTK::polyData : VTK::unstructuredGrid;
+
+      VTK::VTUWriter writer(stage, fileType);
+      writePiece(writer);
+    }
+
+  private:
+    //! write the contents of the data file with the given VTUWriter
+    void writePiece (VTK::VTUWriter& writer)
+    {
       // Grid characteristics
-      vertexmapper = new VertexMapper( gridView_ );
-      if (datamode == VTK::conforming)
-      {
-        number.resize(vertexmapper->size());
-        for (std::vector<int>::size_type i=0; i<number.size(); i++) number[i] = -1;
-      }
-      countEntities(nvertices, ncells, ncorners);
+      if (!gridValid())
+        buildGrid();
 
       writer.beginMain(ncells, nvertices);
       writeAllData(writer);
@@ -824,7 +967,71 @@ namespace Dune
         writeAllData(writer);
       writer.endAppended();
 
-      delete vertexmapper; number.clear();
+      if (!cacheGrid_)
+        releaseGrid();
+    }
+
+    //! whether the grid information of the last call can be reused
+    bool gridValid () const
+    {
+      return cacheGrid_ && vertexmapper.get() != 0
+             && cachedToken_ == gridToken_
+             && cachedCells_ == gridView_.size(0)
+             && cachedVertices_ == gridView_.size(n);
+    }
+
+    //! number the vertices and count the entities
+    void buildGrid ()
+    {
+      releaseGrid();
+      vertexmapper.reset( new VertexMapper( gridView_ ) );
+      if (datamode == VTK::conforming)
+        number.assign(vertexmapper->size(), -1);
+      countEntities(nvertices, ncells, ncorners);
+
+      cachedToken_ = gridToken_;
+      cachedCells_ = gridView_.size(0);
+      cachedVertices_ = gridView_.size(n);
+    }
+
+    //! whether cellBegin() visits the elements in element mapper order
+    bool cellsInMapperOrder ()
+    {
+      if (cellOrder < 0)
+      {
+        MultipleCodimMultipleGeomTypeMapper< GridView, MCMGElementLayout >
+        mapper( gridView_ );
+        cellOrder = (mapper.size() == ncells);
+        int i = 0;
+        for (CellIterator it=cellBegin(); cellOrder && it!=cellEnd(); ++it, ++i)
+          cellOrder = (mapper.map(*it) == i);
+      }
+      return cellOrder;
+    }
+
+    //! whether vertexBegin() visits the vertices in the order of vertexmapper
+    bool verticesInMapperOrder ()
+    {
+      if (vertexOrder < 0)
+      {
+        vertexOrder = (datamode == VTK::conforming)
+                      && (int(number.size()) == nvertices);
+        for (std::size_t i=0; vertexOrder && i<number.size(); ++i)
+          vertexOrder = (number[i] == int(i));
+      }
+      return vertexOrder;
+    }
+
+    //! free the grid information
+    void releaseGrid ()
+    {
+      cellOrder = vertexOrder = -1;
+      vertexmapper.reset();
+      std::vector<int>().swap(number);
+      std::vector<double>().swap(coordinates);
+      std::vector<int>().swap(connectivity);
+      std::vector<int>().swap(offsets);
+      std::vector<unsigned char>().swap(types);
     }
 
     void writeAllData(VTK::VTUWriter& writer) {
@@ -852,6 +1059,8 @@ namespace Dune
         return "appended";
       if (outputtype==VTK::appendedbase64)
         return "appended";
+      if (outputtype==VTK::appendedcompressed)
+        return "appended";
       DUNE_THROW(IOError, "VTKWriter: unsupported OutputType" << outputtype);
     }
 
@@ -891,6 +1100,206 @@ namespace Dune
       }
     }
 
+    //! number of entities whose values are collected before they are
+    //! handed to a DataArrayWriter
+    static const unsigned blockSize = 1024;
+
+    //! write a function's values on a range of entities as one data array
+    /**
+     * \param writer VTUWriter to create the DataArrayWriter from.
+     * \param f      Function to evaluate.
+     * \param begin  Begin of the range; must provide position().
+     * \param end    End of the range.
+     * \param nitems Number of entities in the range.
+     * \param inMapperOrder Whether the range visits the entities in the
+     *               order of the mapper used by VTKFunction::values().
+     *
+     * The type of the data array is determined by f.precision().
+     */
+    template<class Iterator>
+    void writeFunction(VTK::VTUWriter& writer, const VTKFunction& f,
+                       const Iterator& begin, const Iterator& end,
+                       unsigned nitems, bool inMapperOrder = false) const
+    {
+      switch(f.precision()) {
+      case VTK::int32 :
+        writeTypedFunction<int>(writer, f, begin, end, nitems,
+                                inMapperOrder);
+        return;
+      case VTK::uint8 :
+        writeTypedFunction<unsigned char>(writer, f, begin, end, nitems,
+                                          inMapperOrder);
+        return;
+      case VTK::uint32 :
+        writeTypedFunction<unsigned>(writer, f, begin, end, nitems,
+                                     inMapperOrder);
+        return;
+      case VTK::float32 :
+        writeTypedFunction<float>(writer, f, begin, end, nitems,
+                                  inMapperOrder);
+        return;
+      case VTK::float64 :
+        writeTypedFunction<double>(writer, f, begin, end, nitems,
+                                   inMapperOrder);
+        return;
+      }
+      DUNE_THROW(IOError, "VTKWriter: unsupported Precision "
+                 << f.precision() << " of function " << f.name());
+    }
+
+    //! write a function's values with data type T
+    /**
+     * If the entities are visited in mapper order and the function
+     * provides its values as an array, the array is written directly.
+     */
+    template<class T, class Iterator>
+    void writeTypedFunction(VTK::VTUWriter& writer, const VTKFunction& f,
+                            const Iterator& begin, const Iterator& end,
+                            unsigned nitems, bool inMapperOrder) const
+    {
+      // vtk file format: a vector data always should have 3 comps (with
+      // 3rd comp = 0 in 2D case)
+      unsigned writecomps = f.ncomps();
+      if(writecomps == 2) writecomps = 3;
+      shared_ptr<VTK::DataArrayWriter<T> > p
+        (writer.makeArrayWriter<T>(f.name(), writecomps, nitems));
+      if(p->writeIsNoop())
+        return;
+
+      const VTK::ValueArray values = inMapperOrder ? f.values()
+                                                   : VTK::ValueArray();
+      if(values.data != 0 && values.size == nitems && writecomps == 1)
+        writeValueArray(*p, values);
+      else
+        writeFunctionValues(*p, f, begin, end, writecomps);
+    }
+
+    //! write the values of an array described by a ValueArray
+    template<class T>
+    static void writeValueArray(VTK::DataArrayWriter<T>& p,
+                                const VTK::ValueArray& a)
+    {
+      switch(a.type) {
+      case VTK::int32 :
+        writeValues(p, static_cast<const int*>(a.data), a.size);
+        return;
+      case VTK::uint8 :
+        writeValues(p, static_cast<const unsigned char*>(a.data), a.size);
+        return;
+      case VTK::uint32 :
+        writeValues(p, static_cast<const unsigned*>(a.data), a.size);
+        return;
+      case VTK::float32 :
+        writeValues(p, static_cast<const float*>(a.data), a.size);
+        return;
+      case VTK::float64 :
+        writeValues(p, static_cast<const double*>(a.data), a.size);
+        return;
+      }
+      DUNE_THROW(IOError, "VTKWriter: unsupported Precision " << a.type);
+    }
+
+    //! convert n values to T in blocks and write them to p
+    template<class T, class S>
+    static void writeValues(VTK::DataArrayWriter<T>& p, const S* values,
+                            std::size_t n)
+    {
+      std::vector<T> block(std::min<std::size_t>(n, blockSize));
+      for (std::size_t i=0; i<n; i+=blockSize)
+      {
+        const std::size_t m = std::min<std::size_t>(n-i, blockSize);
+        std::transform(values+i, values+i+m, block.begin(), convertValue<T,S>);
+        p.write(&block[0], m);
+      }
+    }
+
+    //! convert x to T, rounding and clamping to the range of T for integer types
+    template<class T, class S>
+    static T convertValue(S x)
+    {
+      if (!std::numeric_limits<T>::is_integer)
+        return T(x);
+      const double y = std::floor(double(x) + 0.5);
+      if (y != y)
+        return T(0);
+      if (y <= double(std::numeric_limits<T>::min()))
+        return std::numeric_limits<T>::min();
+      if (y >= double(std::numeric_limits<T>::max()))
+        return std::numeric_limits<T>::max();
+      return T(y);
+    }
+
+    //! write n values to p, no conversion needed
+    template<class T>
+    static void writeValues(VTK::DataArrayWriter<T>& p, const T* values,
+                            std::size_t n)
+    {
+      p.write(values, n);
+    }
+
+    //! evaluate a function on a range of entities and write the values
+    /**
+     * \param p          DataArrayWriter to write to.
+     * \param f          Function to evaluate.
+     * \param it         Begin of the range; must provide position().
+     * \param end        End of the range.
+     * \param writecomps Number of components per entity in the file.  If
+     *                   this is larger than f.ncomps() (vectors in 2D), the
+     *                   remaining components are written as 0.
+     *
+     * All components of blockSize entities are evaluated into one buffer
+     * by VTKFunction::evaluateAll(), converted to T and passed to p as a
+     * whole.
+     */
+    template<class T, class Iterator>
+    void writeFunctionValues(VTK::DataArrayWriter<T>& p,
+                             const VTKFunction& f, Iterator it,
+                             const Iterator& end, unsigned writecomps) const
+    {
+      std::vector<double> values(blockSize*writecomps, 0.0);
+      std::vector<T> block;
+      unsigned count = 0;
+      for (; it!=end; ++it)
+      {
+        f.evaluateAll(*it, it.position(), &values[count*writecomps]);
+        if (++count == blockSize)
+        {
+          writeBlock(p, &values[0], block, count*writecomps);
+          count = 0;
+        }
+      }
+      if (count > 0)
+        writeBlock(p, &values[0], block, count*writecomps);
+    }
+
+    //! convert n values to T using block as buffer and write them to p
+    template<class T>
+    static void writeBlock(VTK::DataArrayWriter<T>& p, const double* values,
+                           std::vector<T>& block, std::size_t n)
+    {
+      if (block.size() < n)
+        block.resize(n);
+      std::transform(values, values+n, block.begin(), convertValue<T,double>);
+      p.write(&block[0], n);
+    }
+
+    //! write all entries of v to p
+    template<class T>
+    static void writeArray(VTK::DataArrayWriter<T>& p,
+                           const std::vector<T>& v)
+    {
+      if (!v.empty())
+        p.write(&v[0], v.size());
+    }
+
+    //! write n values to p, no conversion needed
+    static void writeBlock(VTK::DataArrayWriter<double>& p,
+                           const double* values, std::vector<double>& block,
+                           std::size_t n)
+    {
+      p.write(values, n);
+    }
+
     //! write cell data
     virtual void writeCellData(VTK::VTUWriter& writer)
     {
@@ -914,25 +1323,8 @@ namespace Dune
 
       writer.beginCellData(scalars, vectors);
       for (FunctionIterator it=celldata.begin(); it!=celldata.end(); ++it)
-      {
-        // vtk file format: a vector data always should have 3 comps (with
-        // 3rd comp = 0 in 2D case)
-        unsigned writecomps = (*it)->ncomps();
-        if(writecomps == 2) writecomps = 3;
-        shared_ptr<VTK::DataArrayWriter<float> > p
-          (writer.makeArrayWriter<float>((*it)->name(), writecomps,
-                                         ncells));
-        if(!p->writeIsNoop())
-          for (CellIterator i=cellBegin(); i!=cellEnd(); ++i)
-          {
-            for (int j=0; j<(*it)->ncomps(); j++)
-              p->write((*it)->evaluate(j,*i,i.position()));
-            // vtk file format: a vector data always should have 3 comps
-            // (with 3rd comp = 0 in 2D case)
-            for (unsigned j=(*it)->ncomps(); j < writecomps; ++j)
-              p->write(0.0);
-          }
-      }
+        writeFunction(writer, **it, cellBegin(), cellEnd(), ncells,
+                      (*it)->values().data != 0 && cellsInMapperOrder());
       writer.endCellData();
     }
 
@@ -959,25 +1351,8 @@ namespace Dune
 
       writer.beginPointData(scalars, vectors);
       for (FunctionIterator it=vertexdata.begin(); it!=vertexdata.end(); ++it)
-      {
-        // vtk file format: a vector data always should have 3 comps (with
-        // 3rd comp = 0 in 2D case)
-        unsigned writecomps = (*it)->ncomps();
-        if(writecomps == 2) writecomps = 3;
-        shared_ptr<VTK::DataArrayWriter<float> > p
-          (writer.makeArrayWriter<float>((*it)->name(), writecomps,
-                                         nvertices));
-        if(!p->writeIsNoop())
-          for (VertexIterator vit=vertexBegin(); vit!=vertexEnd(); ++vit)
-          {
-            for (int j=0; j<(*it)->ncomps(); j++)
-              p->write((*it)->evaluate(j,*vit,vit.position()));
-            // vtk file format: a vector data always should have 3 comps
-            // (with 3rd comp = 0 in 2D case)
-            for (unsigned j=(*it)->ncomps(); j < writecomps; ++j)
-              p->write(0.0);
-          }
-      }
+        writeFunction(writer, **it, vertexBegin(), vertexEnd(), nvertices,
+                      (*it)->values().data != 0 && verticesInMapperOrder());
       writer.endPointData();
     }
 
@@ -986,23 +1361,47 @@ namespace Dune
     {
       writer.beginPoints();
 
-      shared_ptr<VTK::DataArrayWriter<float> > p
-        (writer.makeArrayWriter<float>("Coordinates", 3, nvertices));
-      if(!p->writeIsNoop()) {
+      switch(coordPrecision_) {
+      case VTK::float32 :
+        writeTypedGridPoints<float>(writer);
+        break;
+      case VTK::float64 :
+        writeTypedGridPoints<double>(writer);
+        break;
+      default :
+        DUNE_THROW(IOError, "VTKWriter: unsupported Precision "
+                   << coordPrecision_ << " for coordinates");
+      }
+
+      writer.endPoints();
+    }
+
+    //! write the positions of vertices with data type T
+    template<class T>
+    void writeTypedGridPoints(VTK::VTUWriter& writer)
+    {
+      shared_ptr<VTK::DataArrayWriter<T> > p
+        (writer.makeArrayWriter<T>("Coordinates", 3, nvertices));
+      if(p->writeIsNoop())
+        return;
+
+      if (coordinates.empty()) {
+        coordinates.reserve(3*nvertices);
         VertexIterator vEnd = vertexEnd();
         for (VertexIterator vit=vertexBegin(); vit!=vEnd; ++vit)
         {
           int dimw=w;
           for (int j=0; j<std::min(dimw,3); j++)
-            p->write(vit->geometry().corner(vit.localindex())[j]);
+            coordinates.push_back(vit->geometry().corner(vit.localindex())[j]);
           for (int j=std::min(dimw,3); j<3; j++)
-            p->write(0.0);
+            coordinates.push_back(0.0);
         }
       }
-      // free the VTK::DataArrayWriter before touching the stream
-      p.reset();
 
-      writer.endPoints();
+      std::vector<T> block;
+      for (std::size_t i=0; i<coordinates.size(); i+=3*blockSize)
+        writeBlock(*p, &coordinates[i], block,
+                   std::min<std::size_t>(3*blockSize, coordinates.size()-i));
     }
 
     //! write the connectivity array
@@ -1014,9 +1413,14 @@ namespace Dune
       {
         shared_ptr<VTK::DataArrayWriter<int> > p1
           (writer.makeArrayWriter<int>("connectivity", 1, ncorners));
-        if(!p1->writeIsNoop())
-          for (CornerIterator it=cornerBegin(); it!=cornerEnd(); ++it)
-            p1->write(it.id());
+        if(!p1->writeIsNoop()) {
+          if (connectivity.empty()) {
+            connectivity.reserve(ncorners);
+            for (CornerIterator it=cornerBegin(); it!=cornerEnd(); ++it)
+              connectivity.push_back(it.id());
+          }
+          writeArray(*p1, connectivity);
+        }
       }
 
       // offsets
@@ -1024,12 +1428,16 @@ namespace Dune
         shared_ptr<VTK::DataArrayWriter<int> > p2
           (writer.makeArrayWriter<int>("offsets", 1, ncells));
         if(!p2->writeIsNoop()) {
-          int offset = 0;
-          for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
-          {
-            offset += it->template count<n>();
-            p2->write(offset);
+          if (offsets.empty()) {
+            offsets.reserve(ncells);
+            int offset = 0;
+            for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
+            {
+              offset += it->template count<n>();
+              offsets.push_back(offset);
+            }
           }
+          writeArray(*p2, offsets);
         }
       }
 
@@ -1038,12 +1446,14 @@ namespace Dune
       {
         shared_ptr<VTK::DataArrayWriter<unsigned char> > p3
           (writer.makeArrayWriter<unsigned char>("types", 1, ncells));
-        if(!p3->writeIsNoop())
-          for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
-          {
-            int vtktype = VTK::geometryType(it->type());
-            p3->write(vtktype);
+        if(!p3->writeIsNoop()) {
+          if (types.empty()) {
+            types.reserve(ncells);
+            for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
+              types.push_back(VTK::geometryType(it->type()));
           }
+          writeArray(*p3, types);
+        }
       }
 
       writer.endCells();
@@ -1056,17 +1466,38 @@ namespace Dune
 
     // the grid
     GridView gridView_;
+    // precision of the vertex coordinates
+    VTK::Precision coordPrecision_;
 
     // temporary grid information
     int ncells;
     int nvertices;
     int ncorners;
   private:
-    VertexMapper* vertexmapper;
+    shared_ptr<VertexMapper> vertexmapper;
     // in conforming mode, for each vertex id (as obtained by vertexmapper)
     // hold its number in the iteration order (VertexIterator)
     std::vector<int> number;
     VTK::DataMode datamode;
+
+    // the arrays of the Points and Cells sections, computed on first use
+    std::vector<double> coordinates;
+    std::vector<int> connectivity;
+    std::vector<int> offsets;
+    std::vector<unsigned char> types;
+    // whether the entities are visited in mapper order: 1 yes, 0 no,
+    // -1 not known yet
+    int cellOrder;
+    int vertexOrder;
+
+    // keep the grid information between calls of write()
+    bool cacheGrid_;
+    // current grid token and the one the grid information was built for
+    unsigned long gridToken_;
+    unsigned long cachedToken_;
+    // number of cells and vertices of the grid view at that time
+    int cachedCells_;
+    int cachedVertices_;
   protected:
     VTK::OutputType outputtype;
   };
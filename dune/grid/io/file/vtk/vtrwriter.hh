@@ -0,0 +1,381 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_GRID_IO_FILE_VTK_VTRWRITER_HH
+#define DUNE_GRID_IO_FILE_VTK_VTRWRITER_HH
+
+#include <ostream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/indent.hh>
+
+#include <dune/grid/io/file/vtk/common.hh>
+#include <dune/grid/io/file/vtk/dataarraywriter.hh>
+#include <dune/grid/io/file/vtk/vtiwriter.hh>
+
+namespace Dune {
+
+  //! \addtogroup VTK
+  //! \{
+
+  namespace VTK {
+
+    //! Dump a .vtr file's contents to a stream
+    /**
+     * This will help generating a .vtr file for a piece of a grid which is
+     * an axis parallel box of cells given by the coordinates of the points
+     * in each direction.  Apart from the extent only these three coordinate
+     * arrays are written, the points and the cells are implicit.  Cell data
+     * is ordered by cell index, point data by point index, with the x index
+     * running fastest.  Typical use is like this:
+     * \code
+     * {
+     *   // create writer, writes begin tag
+     *   VTRWriter writer(std::cout, appendedraw);
+     *
+     *   // write the main header
+     *   writer.beginMain(wholeExtent, pieceExtent);
+     *   dump_data(writer);
+     *   writer.endMain();
+     *
+     *   // write the appended section, if required
+     *   if(writer.beginAppended())
+     *     dump_data(writer);
+     *   writer.endAppended();
+     *
+     *   // end scope so the destructor gets called and the closing tag is written
+     * }
+     * \endcode
+     *
+     * where dump_data writes the point data and cell data sections just as
+     * for a VTUWriter, followed by the coordinates section:
+     * \code
+     * writer.beginCoordinates();
+     * for(int i = 0; i < 3; ++i)
+     *   write the coordinates in direction i to
+     *     writer.makeArrayWriter<double>(name, 1, pieceExtent[2*i+1]
+     *                                             - pieceExtent[2*i] + 1);
+     * writer.endCoordinates();
+     * \endcode
+     */
+    class VTRWriter {
+    public:
+      std::ostream& stream;
+      enum Phase { main, appended } phase;
+
+    private:
+      DataArrayWriterFactory factory;
+      Indent indent;
+
+      bool doAppended;
+
+    public:
+      //! create a VTRWriter object
+      /**
+       * \param stream_    Stream to write to.
+       * \param outputType How to encode data.
+       *
+       * Create object and write header.
+       */
+      inline VTRWriter(std::ostream& stream_, OutputType outputType)
+        : stream(stream_), phase(main), factory(outputType, stream),
+          doAppended(false)
+      {
+        stream << indent << "<?xml version=\"1.0\"?>\n";
+        stream << indent << "<VTKFile"
+               << " type=\"RectilinearGrid\""
+               << " version=\"0.1\""
+               << " byte_order=\"" << getEndiannessString() << "\"";
+        if(outputType == appendedcompressed)
+          stream << " compressor=\"vtkZLibDataCompressor\"";
+        stream << ">\n";
+        ++indent;
+      }
+
+      //! write footer
+      inline ~VTRWriter() {
+        --indent;
+        stream << indent << "</VTKFile>\n"
+               << std::flush;
+      }
+
+      //! start PointData section
+      /**
+       * \param scalars Name of field to which should be marked as default
+       *                scalars field.  If this is the empty string, don't set
+       *                any default.
+       * \param vectors Name of field to which should be marked as default
+       *                vectors field.  If this is the empty string, don't set
+       *                any default.
+       */
+      inline void beginPointData(const std::string& scalars = "",
+                                 const std::string& vectors = "") {
+        if(phase == appended)
+          return;
+        stream << indent << "<PointData";
+        if(scalars != "") stream << " Scalars=\"" << scalars << "\"";
+        if(vectors != "") stream << " Vectors=\"" << vectors << "\"";
+        stream << ">\n";
+        ++indent;
+      }
+      //! finish PointData section
+      inline void endPointData() {
+        if(phase == appended)
+          return;
+        --indent;
+        stream << indent << "</PointData>\n";
+      }
+
+      //! start CellData section
+      /**
+       * \param scalars Name of field to which should be marked as default
+       *                scalars field.  If this is the empty string, don't set
+       *                any default.
+       * \param vectors Name of field to which should be marked as default
+       *                vectors field.  If this is the empty string, don't set
+       *                any default.
+       */
+      inline void beginCellData(const std::string& scalars = "",
+                                const std::string& vectors = "") {
+        if(phase == appended)
+          return;
+        stream << indent << "<CellData";
+        if(scalars != "") stream << " Scalars=\"" << scalars << "\"";
+        if(vectors != "") stream << " Vectors=\"" << vectors << "\"";
+        stream << ">\n";
+        ++indent;
+      }
+      //! finish CellData section
+      inline void endCellData() {
+        if(phase == appended)
+          return;
+        --indent;
+        stream << indent << "</CellData>\n";
+      }
+
+      //! start section for the coordinates in the three directions
+      inline void beginCoordinates() {
+        if(phase == appended)
+          return;
+        stream << indent << "<Coordinates>\n";
+        ++indent;
+      }
+      //! finish section for the coordinates
+      inline void endCoordinates() {
+        if(phase == appended)
+          return;
+        --indent;
+        stream << indent << "</Coordinates>\n";
+      }
+
+      //! start the main RectilinearGrid section
+      /**
+       * \param wholeExtent Extent of the whole grid.
+       * \param pieceExtent Extent of the piece in this file.
+       */
+      inline void beginMain(const Extent& wholeExtent,
+                            const Extent& pieceExtent) {
+        stream << indent << "<RectilinearGrid WholeExtent=\"";
+        writeExtent(stream, wholeExtent) << "\">\n";
+        ++indent;
+        stream << indent << "<Piece Extent=\"";
+        writeExtent(stream, pieceExtent) << "\">\n";
+        ++indent;
+        phase = main;
+      }
+      //! finish the main RectilinearGrid section
+      inline void endMain() {
+        factory.finish();
+        --indent;
+        stream << indent << "</Piece>\n";
+        --indent;
+        stream << indent << "</RectilinearGrid>\n";
+      }
+
+      //! start the appended data section
+      /**
+       * \returns Whether an appended section is required, see
+       *          VTUWriter::beginAppended().
+       */
+      inline bool beginAppended() {
+        doAppended = factory.beginAppended();
+        if(doAppended) {
+          stream << indent << "<AppendedData"
+                 << " encoding=\"" << factory.appendedEncoding() << "\">\n";
+          ++indent;
+          // mark begin of data
+          stream << indent << "_";
+        }
+        phase = appended;
+        return doAppended;
+      }
+      //! finish the appended data section
+      inline void endAppended() {
+        if(doAppended) {
+          stream << "\n";
+          --indent;
+          stream << indent << "</AppendedData>\n";
+        }
+      }
+
+      //! aquire a DataArrayWriter
+      /**
+       * \tparam T Type of the data to write.
+       *
+       * \param name   Name of the array to write.
+       * \param ncomps Number of components of the vectors in the array.
+       * \param nitems Number of vectors in the array (number of cells/number
+       *               of points/number of coordinates).
+       *
+       * The returned object should be freed with delete.
+       */
+      template<typename T>
+      DataArrayWriter<T>* makeArrayWriter(const std::string& name,
+                                          unsigned ncomps, unsigned nitems) {
+        return factory.make<T>(name, ncomps, nitems, indent);
+      }
+    };
+
+    //! Dump a .pvtr file's contents to a stream
+    /**
+     * Typical use is like this:
+     * \code
+     * {
+     *   PVTRWriter writer(std::cout);
+     *   writer.beginMain(wholeExtent);
+     *
+     *   writer.beginPointData();
+     *   for(each point data field)
+     *     writer.addArray(field.name, field.ncomps, field.precision);
+     *   writer.endPointData();
+     *
+     *   writer.beginCellData();
+     *   for(each cell data field)
+     *     writer.addArray(field.name, field.ncomps, field.precision);
+     *   writer.endCellData();
+     *
+     *   writer.beginCoordinates();
+     *   for(each direction)
+     *     writer.addArray(name, 1, float64);
+     *   writer.endCoordinates();
+     *
+     *   for(each serial piece)
+     *     writer.addPiece(piece.extent, piece.filename);
+     *
+     *   writer.endMain();
+     * }
+     * \endcode
+     */
+    class PVTRWriter {
+      std::ostream& stream;
+
+      Indent indent;
+
+    public:
+      //! create a PVTRWriter object and write the header
+      inline explicit PVTRWriter(std::ostream& stream_)
+        : stream(stream_)
+      {
+        stream << indent << "<?xml version=\"1.0\"?>\n";
+        stream << indent << "<VTKFile"
+               << " type=\"PRectilinearGrid\""
+               << " version=\"0.1\""
+               << " byte_order=\"" << getEndiannessString() << "\">\n";
+        ++indent;
+      }
+
+      //! write footer
+      inline ~PVTRWriter() {
+        --indent;
+        stream << indent << "</VTKFile>\n"
+               << std::flush;
+      }
+
+      //! start PointData section
+      inline void beginPointData(const std::string& scalars = "",
+                                 const std::string& vectors = "") {
+        stream << indent << "<PPointData";
+        if(scalars != "") stream << " Scalars=\"" << scalars << "\"";
+        if(vectors != "") stream << " Vectors=\"" << vectors << "\"";
+        stream << ">\n";
+        ++indent;
+      }
+      //! finish PointData section
+      inline void endPointData() {
+        --indent;
+        stream << indent << "</PPointData>\n";
+      }
+
+      //! start CellData section
+      inline void beginCellData(const std::string& scalars = "",
+                                const std::string& vectors = "") {
+        stream << indent << "<PCellData";
+        if(scalars != "") stream << " Scalars=\"" << scalars << "\"";
+        if(vectors != "") stream << " Vectors=\"" << vectors << "\"";
+        stream << ">\n";
+        ++indent;
+      }
+      //! finish CellData section
+      inline void endCellData() {
+        --indent;
+        stream << indent << "</PCellData>\n";
+      }
+
+      //! start section for the coordinates in the three directions
+      inline void beginCoordinates() {
+        stream << indent << "<PCoordinates>\n";
+        ++indent;
+      }
+      //! finish section for the coordinates
+      inline void endCoordinates() {
+        --indent;
+        stream << indent << "</PCoordinates>\n";
+      }
+
+      //! start the main PRectilinearGrid section
+      /**
+       * \param wholeExtent Extent of the whole grid.
+       * \param ghostLevel  Set the GhostLevel attribute.
+       */
+      inline void beginMain(const Extent& wholeExtent,
+                            unsigned int ghostLevel = 0) {
+        stream << indent << "<PRectilinearGrid WholeExtent=\"";
+        writeExtent(stream, wholeExtent) << "\" GhostLevel=\"" << ghostLevel
+                                         << "\">\n";
+        ++indent;
+      }
+      //! finish the main PRectilinearGrid section
+      inline void endMain() {
+        --indent;
+        stream << indent << "</PRectilinearGrid>\n";
+      }
+
+      //! Add an array to the output file
+      /**
+       * \param name   Name of the array.
+       * \param ncomps Number of components of the vectors in the array.
+       * \param prec   Precision of the array.
+       */
+      inline void addArray(const std::string& name, unsigned ncomps,
+                           Precision prec) {
+        stream << indent << "<PDataArray"
+               << " type=\"" << toString(prec) << "\""
+               << " Name=\"" << name << "\""
+               << " NumberOfComponents=\"" << ncomps << "\"/>\n";
+      }
+
+      //! Add a serial piece to the output file
+      inline void addPiece(const Extent& extent, const std::string& filename) {
+        stream << indent << "<Piece Extent=\"";
+        writeExtent(stream, extent) << "\" Source=\"" << filename << "\"/>\n";
+      }
+    };
+
+  } // namespace VTK
+
+  //! \} group VTK
+
+} // namespace Dune
+
+#endif // DUNE_GRID_IO_FILE_VTK_VTRWRITER_HH
@@ -4,11 +4,15 @@
 #ifndef DUNE_GRID_IO_FILE_VTK_VTUWRITER_HH
 #define DUNE_GRID_IO_FILE_VTK_VTUWRITER_HH
 
+#include <cstddef>
+#include <list>
 #include <ostream>
 #include <string>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/indent.hh>
+#include <dune/common/shared_ptr.hh>
 
 #include <dune/grid/io/file/vtk/common.hh>
 #include <dune/grid/io/file/vtk/dataarraywriter.hh>
@@ -20,6 +24,120 @@ namespace Dune {
 
   namespace VTK {
 
+    class VTUWriter;
+    class SharedVTUWriter;
+
+    //! In-memory copy of the contents of a .vtu/.vtp file
+    /**
+     * A VTUWriter constructed from a VTUStage does not produce any output.
+     * Instead it records the sections and copies the data arrays into the
+     * stage.  The stage can later be written to a stream with any
+     * OutputType by write(), independent of the grid and of the functions
+     * the data was taken from.  This allows to take a snapshot of the
+     * output quickly and to do the expensive encoding elsewhere, e.g. in a
+     * different thread.
+     *
+     * The data arrays must have one of the types listed in the
+     * documentation of Precision.
+     */
+    class VTUStage {
+      friend class VTUWriter;
+      friend class SharedVTUWriter;
+
+      enum Event {
+        pointDataBegin, pointDataEnd, cellDataBegin, cellDataEnd,
+        pointsBegin, pointsEnd, cellsBegin, cellsEnd, dataArray
+      };
+
+      struct Item {
+        Event event;
+        // array name or name of the default scalars field
+        std::string name;
+        // name of the default vectors field
+        std::string vectors;
+        Precision precision;
+        unsigned ncomps;
+        unsigned nitems;
+        std::vector<char> data;
+      };
+
+      FileType fileType;
+      unsigned ncells;
+      unsigned npoints;
+      // std::list, so the buffers do not move while they are written to
+      std::list<Item> items;
+
+    public:
+      //! create an empty stage
+      VTUStage()
+        : fileType(unstructuredGrid), ncells(0), npoints(0)
+      { }
+
+      //! number of bytes of array data in the stage
+      std::size_t size() const
+      {
+        std::size_t bytes = 0;
+        for (std::list<Item>::const_iterator it = items.begin();
+             it != items.end(); ++it)
+          bytes += it->data.size();
+        return bytes;
+      }
+
+      //! write the staged file contents to a stream
+      /**
+       * \param s          Stream to write to.
+       * \param outputType How to encode the data.
+       */
+      inline void write(std::ostream& s, OutputType outputType) const;
+
+      //! number of bytes of the staged arrays in an appended raw section
+      std::size_t appendedRawSize() const
+      {
+        std::size_t bytes = 0;
+        for (std::list<Item>::const_iterator it = items.begin();
+             it != items.end(); ++it)
+          if(it->event == dataArray)
+            bytes += sizeof(unsigned) + it->data.size();
+        return bytes;
+      }
+
+      //! write the Piece element for data in an appended raw section
+      /**
+       * \param s      Stream to write to.
+       * \param indent Indentation of the Piece element.
+       * \param offset Position of the first array of the piece in the
+       *               appended section.
+       *
+       * The data itself is produced by appendRawData().  This allows to
+       * put the pieces of several stages into one file.
+       */
+      inline void writeRawPiece(std::ostream& s, Indent indent,
+                                std::size_t offset) const;
+
+      //! append the contents of the appended raw section of the piece
+      inline void appendRawData(std::vector<char>& data) const;
+
+    private:
+      Item& add(Event event, const std::string& name = "",
+                const std::string& vectors = "")
+      {
+        items.push_back(Item());
+        Item& item = items.back();
+        item.event = event;
+        item.name = name;
+        item.vectors = vectors;
+        item.precision = float32;
+        item.ncomps = 0;
+        item.nitems = 0;
+        return item;
+      }
+
+      inline void replay(VTUWriter& writer) const;
+
+      template<class T>
+      inline static void replayArray(VTUWriter& writer, const Item& item);
+    };
+
     //! Dump a .vtu/.vtp files contents to a stream
     /**
      * This will help generating a .vtu/.vtp file.  Typical use is like this:
@@ -107,6 +225,15 @@ namespace Dune {
 
       bool doAppended;
 
+      // if non-null, record into this stage instead of writing
+      VTUStage* stage;
+
+      //! a stream that discards everything
+      static std::ostream& nullStream() {
+        static std::ostream s(0);
+        return s;
+      }
+
     public:
       //! create a VTUWriter object
       /**
@@ -119,7 +246,8 @@ namespace Dune {
        */
       inline VTUWriter(std::ostream& stream_, OutputType outputType,
                        FileType fileType_)
-        : stream(stream_), factory(outputType, stream)
+        : stream(stream_), factory(outputType, stream), doAppended(false),
+          stage(0)
       {
         switch(fileType_) {
         case polyData :
@@ -139,12 +267,33 @@ namespace Dune {
         stream << indent << "<VTKFile"
                << " type=\"" << fileType << "\""
                << " version=\"0.1\""
-               << " byte_order=\"" << byteOrder << "\">\n";
+               << " byte_order=\"" << byteOrder << "\"";
+        if(outputType == appendedcompressed)
+          stream << " compressor=\"vtkZLibDataCompressor\"";
+        stream << ">\n";
         ++indent;
       }
 
+      //! create a VTUWriter object recording into a VTUStage
+      /**
+       * \param stage_    Stage to record into.  Previous contents of the
+       *                  stage are discarded.
+       * \param fileType_ Whether to write PolyData (1D) or UnstructuredGrid
+       *                  (nD) format.
+       *
+       * Nothing is written to any stream; beginAppended() returns false.
+       */
+      inline VTUWriter(VTUStage& stage_, FileType fileType_)
+        : stream(nullStream()), factory(ascii, stream), doAppended(false),
+          stage(&stage_)
+      {
+        stage->items.clear();
+        stage->fileType = fileType_;
+      }
+
       //! write footer
       inline ~VTUWriter() {
+        if(stage) return;
         --indent;
         stream << indent << "</VTKFile>\n"
                << std::flush;
@@ -164,6 +313,10 @@ namespace Dune {
        */
       inline void beginPointData(const std::string& scalars = "",
                                  const std::string& vectors = "") {
+        if(stage) {
+          stage->add(VTUStage::pointDataBegin, scalars, vectors);
+          return;
+        }
         switch(phase) {
         case main :
           stream << indent << "<PointData";
@@ -178,6 +331,10 @@ namespace Dune {
       }
       //! finish PointData section
       inline void endPointData() {
+        if(stage) {
+          stage->add(VTUStage::pointDataEnd);
+          return;
+        }
         switch(phase) {
         case main :
           --indent;
@@ -202,6 +359,10 @@ namespace Dune {
        */
       inline void beginCellData(const std::string& scalars = "",
                                 const std::string& vectors = "") {
+        if(stage) {
+          stage->add(VTUStage::cellDataBegin, scalars, vectors);
+          return;
+        }
         switch(phase) {
         case main :
           stream << indent << "<CellData";
@@ -216,6 +377,10 @@ namespace Dune {
       }
       //! finish CellData section
       inline void endCellData() {
+        if(stage) {
+          stage->add(VTUStage::cellDataEnd);
+          return;
+        }
         switch(phase) {
         case main :
           --indent;
@@ -234,6 +399,10 @@ namespace Dune {
        * must be the number of points.
        */
       inline void beginPoints() {
+        if(stage) {
+          stage->add(VTUStage::pointsBegin);
+          return;
+        }
         switch(phase) {
         case main :
           stream << indent << "<Points>\n";
@@ -245,6 +414,10 @@ namespace Dune {
       }
       //! finish section for the point coordinates
       inline void endPoints() {
+        if(stage) {
+          stage->add(VTUStage::pointsEnd);
+          return;
+        }
         switch(phase) {
         case main :
           --indent;
@@ -270,6 +443,10 @@ namespace Dune {
        * </ul>
        */
       inline void beginCells() {
+        if(stage) {
+          stage->add(VTUStage::cellsBegin);
+          return;
+        }
         switch(phase) {
         case main :
           stream << indent << "<" << cellName << ">\n";
@@ -281,6 +458,10 @@ namespace Dune {
       }
       //! start section for the grid cells/PolyData lines
       inline void endCells() {
+        if(stage) {
+          stage->add(VTUStage::cellsEnd);
+          return;
+        }
         switch(phase) {
         case main :
           --indent;
@@ -306,6 +487,12 @@ namespace Dune {
        * </ul>
        */
       inline void beginMain(unsigned ncells, unsigned npoints) {
+        if(stage) {
+          stage->ncells = ncells;
+          stage->npoints = npoints;
+          phase = main;
+          return;
+        }
         stream << indent << "<" << fileType << ">\n";
         ++indent;
         stream << indent << "<Piece"
@@ -316,6 +503,8 @@ namespace Dune {
       }
       //! finish the main PolyData/UnstructuredGrid section
       inline void endMain() {
+        if(stage) return;
+        factory.finish();
         --indent;
         stream << indent << "</Piece>\n";
         --indent;
@@ -341,6 +530,10 @@ namespace Dune {
        * function.
        */
       inline bool beginAppended() {
+        if(stage) {
+          phase = appended;
+          return false;
+        }
         doAppended = factory.beginAppended();
         if(doAppended) {
           const std::string& encoding = factory.appendedEncoding();
@@ -378,10 +571,136 @@ namespace Dune {
       template<typename T>
       DataArrayWriter<T>* makeArrayWriter(const std::string& name,
                                           unsigned ncomps, unsigned nitems) {
+        if(stage) {
+          VTUStage::Item& item = stage->add(VTUStage::dataArray, name);
+          item.precision = PrecisionTraits<T>::value;
+          item.ncomps = ncomps;
+          item.nitems = nitems;
+          return new BufferDataArrayWriter<T>(item.data, ncomps, nitems);
+        }
         return factory.make<T>(name, ncomps, nitems, indent);
       }
     };
 
+    inline void VTUStage::write(std::ostream& s, OutputType outputType) const
+    {
+      VTUWriter writer(s, outputType, fileType);
+
+      writer.beginMain(ncells, npoints);
+      replay(writer);
+      writer.endMain();
+
+      if(writer.beginAppended())
+        replay(writer);
+      writer.endAppended();
+    }
+
+    inline void VTUStage::replay(VTUWriter& writer) const
+    {
+      for (std::list<Item>::const_iterator it = items.begin();
+           it != items.end(); ++it)
+        switch(it->event) {
+        case pointDataBegin : writer.beginPointData(it->name, it->vectors); break;
+        case pointDataEnd :   writer.endPointData(); break;
+        case cellDataBegin :  writer.beginCellData(it->name, it->vectors); break;
+        case cellDataEnd :    writer.endCellData(); break;
+        case pointsBegin :    writer.beginPoints(); break;
+        case pointsEnd :      writer.endPoints(); break;
+        case cellsBegin :     writer.beginCells(); break;
+        case cellsEnd :       writer.endCells(); break;
+        case dataArray :
+          switch(it->precision) {
+          case int32 :   replayArray<int>(writer, *it); break;
+          case uint8 :   replayArray<unsigned char>(writer, *it); break;
+          case uint32 :  replayArray<unsigned>(writer, *it); break;
+          case float32 : replayArray<float>(writer, *it); break;
+          case float64 : replayArray<double>(writer, *it); break;
+          }
+          break;
+        }
+    }
+
+    inline void VTUStage::writeRawPiece(std::ostream& s, Indent indent,
+                                        std::size_t offset) const
+    {
+      const std::string cellName = fileType == polyData ? "Lines" : "Cells";
+
+      s << indent << "<Piece"
+        << " NumberOf" << cellName << "=\"" << ncells << "\""
+        << " NumberOfPoints=\"" << npoints << "\">\n";
+      ++indent;
+      for (std::list<Item>::const_iterator it = items.begin();
+           it != items.end(); ++it)
+        switch(it->event) {
+        case pointDataBegin :
+        case cellDataBegin :
+          s << indent << (it->event == pointDataBegin ? "<PointData"
+                                                      : "<CellData");
+          if(it->name != "") s << " Scalars=\"" << it->name << "\"";
+          if(it->vectors != "") s << " Vectors=\"" << it->vectors << "\"";
+          s << ">\n";
+          ++indent;
+          break;
+        case pointDataEnd :
+          --indent;
+          s << indent << "</PointData>\n";
+          break;
+        case cellDataEnd :
+          --indent;
+          s << indent << "</CellData>\n";
+          break;
+        case pointsBegin :
+          s << indent << "<Points>\n";
+          ++indent;
+          break;
+        case pointsEnd :
+          --indent;
+          s << indent << "</Points>\n";
+          break;
+        case cellsBegin :
+          s << indent << "<" << cellName << ">\n";
+          ++indent;
+          break;
+        case cellsEnd :
+          --indent;
+          s << indent << "</" << cellName << ">\n";
+          break;
+        case dataArray :
+          s << indent << "<DataArray type=\"" << toString(it->precision)
+            << "\" Name=\"" << it->name << "\" "
+            << "NumberOfComponents=\"" << it->ncomps << "\" "
+            << "format=\"appended\" offset=\"" << offset << "\" />\n";
+          offset += sizeof(unsigned) + it->data.size();
+          break;
+        }
+      --indent;
+      s << indent << "</Piece>\n";
+    }
+
+    inline void VTUStage::appendRawData(std::vector<char>& data) const
+    {
+      data.reserve(data.size() + appendedRawSize());
+      for (std::list<Item>::const_iterator it = items.begin();
+           it != items.end(); ++it)
+        if(it->event == dataArray) {
+          // same header as written by NakedRawDataArrayWriter
+          const unsigned bytes = it->data.size();
+          const char* header = reinterpret_cast<const char*>(&bytes);
+          data.insert(data.end(), header, header + sizeof(unsigned));
+          data.insert(data.end(), it->data.begin(), it->data.end());
+        }
+    }
+
+    template<class T>
+    inline void VTUStage::replayArray(VTUWriter& writer, const Item& item)
+    {
+      shared_ptr<DataArrayWriter<T> > p
+        (writer.makeArrayWriter<T>(item.name, item.ncomps, item.nitems));
+      if(!p->writeIsNoop() && !item.data.empty())
+        p->write(reinterpret_cast<const T*>(&item.data[0]),
+                 item.data.size()/sizeof(T));
+    }
+
   } // namespace VTK
 
   //! \} group VTK
@@ -3,6 +3,7 @@
 #ifndef DUNE_SGRID_HH
 #define DUNE_SGRID_HH
 
+#include <cmath>
 #include <limits>
 #include <vector>
 #include <stack>
@@ -1367,6 +1368,57 @@ namespace Dune {
                                                               this->getRealImplementation(seed).index());
     }
 
+    /** \brief Find the element of the given level containing a point.
+
+       The element is computed directly from the coordinates of the point,
+       i.e. the cost does not depend on the grid size.
+
+       \exception GridError The point is outside of the grid.
+     */
+    typename Traits::template Codim<0>::EntityPointer
+    findEntity (const FieldVector<ctype,dimworld>& x, int level) const
+    {
+      array<int,dim> z;
+      if (!locate(level,x,z))
+        DUNE_THROW(GridError, "Coordinate " << x << " is outside the grid.");
+      return SEntityPointer<0,const SGrid<dim,dimworld> >(this,level,n(level,z));
+    }
+
+    /** \brief Find the elements of the given level containing a range of points.
+
+       For each point in [begin,end) the seed of the containing element is
+       written to out.
+
+       \exception GridError A point is outside of the grid.
+     */
+    template<class InputIterator, class OutputIterator>
+    OutputIterator findEntitySeeds (InputIterator begin, InputIterator end, OutputIterator out, int level) const
+    {
+      typedef typename Traits::template Codim<0>::EntitySeed EntitySeed;
+      array<int,dim> z;
+      for (; begin!=end; ++begin, ++out)
+      {
+        if (!locate(level,*begin,z))
+          DUNE_THROW(GridError, "Coordinate " << *begin << " is outside the grid.");
+        *out = EntitySeed(SEntitySeed<0,const SGrid<dim,dimworld> >(level,n(level,z)));
+      }
+      return out;
+    }
+
+    /** \brief Find the elements of the given level containing a range of points.
+
+       For each point in [begin,end) the level index of the containing element
+       is written to out, or -1 if the point is outside of the grid.
+     */
+    template<class InputIterator, class OutputIterator>
+    OutputIterator findIndices (InputIterator begin, InputIterator end, OutputIterator out, int level) const
+    {
+      array<int,dim> z;
+      for (; begin!=end; ++begin, ++out)
+        *out = locate(level,*begin,z) ? n(level,z) : -1;
+      return out;
+    }
+
     /*! The communication interface
           @tparam T array class holding data associated with the entities
           @tparam P type used to gather/scatter data in and out of the message buffer
@@ -1551,6 +1603,9 @@ namespace Dune {
     //! map expanded coordinates to position
     FieldVector<ctype, dimworld> pos (int level, array<int,dim>& z) const;
 
+    //! compute expanded coordinates of the element containing x, return false if there is none
+    bool locate (int level, const FieldVector<ctype, dimworld>& x, array<int,dim>& z) const;
+
     //! compute codim from coordinate
     int calc_codim (int level, const array<int,dim>& z) const;
 
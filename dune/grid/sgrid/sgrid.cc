@@ -704,6 +704,23 @@ namespace Dune {
     return x;
   }
 
+  template<int dim, int dimworld, typename ctype>
+  inline bool SGrid<dim,dimworld,ctype>::locate (int level, const FieldVector<ctype, dimworld>& x, array<int,dim>& z) const
+  {
+    for (int k=0; k<dim; k++)
+    {
+      const ctype t = (x[k]-low[k])/h[level][k];
+      int c = int(std::floor(t));
+      // points on the boundary belong to the boundary elements
+      if (c==N[level][k] && t-c<1e-8) c--;
+      if (c==-1 && c+1-t<1e-8) c++;
+      if (c<0 || c>=N[level][k])
+        return false;
+      z[k] = 2*c+1;
+    }
+    return true;
+  }
+
   template<int dim, int dimworld, typename ctype>
   inline int SGrid<dim,dimworld,ctype>::calc_codim (int level, const array<int,dim>& z) const
   {
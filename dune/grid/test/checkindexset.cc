@@ -5,6 +5,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <iterator>
 
 #include <dune/common/fvector.hh>
 #include <dune/geometry/referenceelements.hh>
@@ -520,6 +521,43 @@ namespace Dune
   }
 
 
+  // check that subIndices yields the same indices as subIndex
+  template< class GridView >
+  void checkSubIndices ( const GridView &view, int codim )
+  {
+    const int dim = GridView :: dimension;
+    typedef typename GridView :: IndexSet IndexSetType;
+    typedef typename IndexSetType :: IndexType IndexType;
+    const IndexSetType &lset = view.indexSet();
+
+    std::vector< IndexType > indices;
+    typedef typename GridView :: template Codim< 0 > :: Iterator Iterator;
+    const Iterator endit = view.template end< 0 >();
+    for( Iterator it = view.template begin< 0 >(); it != endit; ++it )
+    {
+      const ReferenceElement< typename GridView :: ctype, dim > &refElem
+        = ReferenceElements< typename GridView :: ctype, dim >::general( it->type() );
+      indices.clear();
+      lset.subIndices( *it, codim, std::back_inserter( indices ) );
+      if( int( indices.size() ) != refElem.size( codim ) )
+      {
+        std::cerr << "Error: subIndices( entity, " << codim << " ) yields " << indices.size()
+                  << " indices, but the entity has " << refElem.size( codim ) << " subentities" << std::endl;
+        assert( int( indices.size() ) == refElem.size( codim ) );
+        continue;
+      }
+      for( int i = 0; i < refElem.size( codim ); ++i )
+      {
+        if( indices[ i ] != lset.subIndex( *it, i, codim ) )
+        {
+          std::cerr << "Error: subIndices( entity, " << codim << " )[ " << i
+                    << " ] != subIndex( entity, " << i << ", " << codim << " )" << std::endl;
+          assert( indices[ i ] == lset.subIndex( *it, i, codim ) );
+        }
+      }
+    }
+  }
+
   template< class Grid, class GridView, class OutputStream, int codim, bool hasCodim >
   struct CheckIndexSet
   {
@@ -527,6 +565,7 @@ namespace Dune
                                 OutputStream &sout, bool levelIndex )
     {
       checkIndexSetForCodim< codim >( grid, view, sout, levelIndex );
+      checkSubIndices( view, codim );
       typedef Dune :: Capabilities :: hasEntity< Grid, codim-1 > hasNextCodim;
       CheckIndexSet< Grid, GridView, OutputStream, codim-1, hasNextCodim :: v >
       :: checkIndexSet( grid, view, sout, levelIndex );
@@ -554,6 +593,7 @@ namespace Dune
                                 OutputStream &sout, bool levelIndex )
     {
       checkIndexSetForCodim< 0 >( grid, view, sout, levelIndex );
+      checkSubIndices( view, 0 );
     }
   };
 
@@ -0,0 +1,66 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_GRID_TEST_CHECKPOINTLOCATION_CC
+#define DUNE_GRID_TEST_CHECKPOINTLOCATION_CC
+
+#include <iterator>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/grid/common/exceptions.hh>
+
+/** \brief check the analytic point location of structured grids
+ *
+ *  For each element on each level, the element containing its center must be
+ *  the element itself. This is checked for findEntity, findEntitySeeds and
+ *  findIndices.
+ */
+template< class Grid >
+void checkPointLocation ( const Grid &grid )
+{
+  typedef typename Grid::LevelGridView GridView;
+  typedef typename GridView::template Codim< 0 >::Iterator Iterator;
+  typedef typename Grid::template Codim< 0 >::EntityPointer EntityPointer;
+  typedef typename Grid::template Codim< 0 >::EntitySeed EntitySeed;
+  typedef typename Iterator::Entity::Geometry::GlobalCoordinate GlobalCoordinate;
+
+  for( int level = 0; level <= grid.maxLevel(); ++level )
+  {
+    const GridView gridView = grid.levelView( level );
+    const typename GridView::IndexSet &indexSet = gridView.indexSet();
+
+    std::vector< GlobalCoordinate > centers;
+    std::vector< int > indices;
+    const Iterator end = gridView.template end< 0 >();
+    for( Iterator it = gridView.template begin< 0 >(); it != end; ++it )
+    {
+      centers.push_back( it->geometry().center() );
+      indices.push_back( indexSet.index( *it ) );
+
+      const EntityPointer ep = grid.findEntity( centers.back(), level );
+      if( int( indexSet.index( *ep ) ) != indices.back() )
+        DUNE_THROW( Dune::GridError, "findEntity returned wrong element for "
+                    << centers.back() << " on level " << level << "." );
+    }
+
+    std::vector< int > found;
+    grid.findIndices( centers.begin(), centers.end(), std::back_inserter( found ), level );
+    std::vector< EntitySeed > seeds;
+    grid.findEntitySeeds( centers.begin(), centers.end(), std::back_inserter( seeds ), level );
+    if( (found.size() != indices.size()) || (seeds.size() != indices.size()) )
+      DUNE_THROW( Dune::GridError, "Wrong number of elements found on level " << level << "." );
+
+    for( std::size_t i = 0; i < indices.size(); ++i )
+    {
+      if( found[ i ] != indices[ i ] )
+        DUNE_THROW( Dune::GridError, "findIndices returned wrong index for "
+                    << centers[ i ] << " on level " << level << "." );
+      if( int( indexSet.index( *grid.entityPointer( seeds[ i ] ) ) ) != indices[ i ] )
+        DUNE_THROW( Dune::GridError, "findEntitySeeds returned wrong seed for "
+                    << centers[ i ] << " on level " << level << "." );
+    }
+  }
+}
+
+#endif // #ifndef DUNE_GRID_TEST_CHECKPOINTLOCATION_CC
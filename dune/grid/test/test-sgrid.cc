@@ -12,6 +12,7 @@
 #include "checkgeometryinfather.cc"
 #include "checkintersectionit.cc"
 #include "checkpartition.cc"
+#include "checkpointlocation.cc"
 
 template<int d, int w>
 void runtest()
@@ -27,6 +28,7 @@ void runtest()
   checkGeometryInFather(g);
   checkIntersectionIterator(g);
   checkPartitionType( g.leafView() );
+  checkPointLocation(g);
   // check geometry lifetime
   checkGeometryLifetime( g.leafView() );
 
@@ -4,9 +4,13 @@
 
 #include <config.h>
 
+#include <cmath>
 #include <iostream>
+#include <set>
+#include <vector>
 
 #include <dune/grid/yaspgrid.hh>
+#include <dune/grid/common/mcmgmapper.hh>
 
 #include "gridcheck.cc"
 #include "checkcommunicate.cc"
@@ -14,9 +18,181 @@
 #include "checkintersectionit.cc"
 #include "checkadaptation.cc"
 #include "checkpartition.cc"
+#include "checkpointlocation.cc"
 
 int rank;
 
+// data handle communicating one double per vertex
+template<class Mapper>
+class VertexDataHandle
+  : public Dune::CommDataHandleIF<VertexDataHandle<Mapper>,double>
+{
+public:
+  VertexDataHandle (const Mapper& mapper, std::vector<double>& data, int dim)
+    : mapper_(mapper), data_(data), dim_(dim)
+  {}
+
+  bool contains (int dim, int codim) const
+  {
+    return codim==dim_;
+  }
+
+  bool fixedsize (int dim, int codim) const
+  {
+    return true;
+  }
+
+  template<class Entity>
+  size_t size (const Entity& e) const
+  {
+    return 1;
+  }
+
+  template<class Buffer, class Entity>
+  void gather (Buffer& buf, const Entity& e) const
+  {
+    buf.write(data_[mapper_.map(e)]);
+  }
+
+  template<class Buffer, class Entity>
+  void scatter (Buffer& buf, const Entity& e, size_t n)
+  {
+    buf.read(data_[mapper_.map(e)]);
+  }
+
+private:
+  const Mapper& mapper_;
+  std::vector<double>& data_;
+  int dim_;
+};
+
+namespace Dune {
+  // gather and scatter only touch the entry of their own entity
+  template<class Mapper>
+  struct IsThreadSafeDataHandle< VertexDataHandle<Mapper> >
+  {
+    static const bool v = true;
+  };
+}
+
+// check that the split-phase communication distributes interior/border data to all vertices
+template <int dim>
+void check_yasp_split_phase(const Dune::YaspGrid<dim>& grid)
+{
+  typedef Dune::YaspGrid<dim> Grid;
+  typedef typename Grid::LeafGridView GV;
+  typedef typename GV::template Codim<dim>::Iterator VertexIterator;
+  typedef Dune::LeafMultipleCodimMultipleGeomTypeMapper<Grid,Dune::MCMGVertexLayout> Mapper;
+
+  GV gv = grid.leafView();
+  Mapper mapper(grid);
+  std::vector<double> data(mapper.size(),-1.0);
+
+  for (VertexIterator it=gv.template begin<dim>(); it!=gv.template end<dim>(); ++it)
+    if (it->partitionType()==Dune::InteriorEntity || it->partitionType()==Dune::BorderEntity)
+    {
+      Dune::FieldVector<double,dim> x = it->geometry().corner(0);
+      data[mapper.map(*it)] = x.one_norm();
+    }
+
+  VertexDataHandle<Mapper> handle(mapper,data,dim);
+  grid.communicateBegin(handle,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+  grid.communicateEnd(handle,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+
+  for (VertexIterator it=gv.template begin<dim>(); it!=gv.template end<dim>(); ++it)
+  {
+    Dune::FieldVector<double,dim> x = it->geometry().corner(0);
+    if (std::abs(data[mapper.map(*it)]-x.one_norm())>1e-12)
+      DUNE_THROW(Dune::GridError, "split-phase communication delivered wrong vertex data");
+  }
+}
+
+// check that communicateVector distributes interior/border data of one codim to all entities
+template <int dim, int codim>
+void check_yasp_vector_communication(const Dune::YaspGrid<dim>& grid)
+{
+  typedef Dune::YaspGrid<dim> Grid;
+  typedef typename Grid::LeafGridView GV;
+  typedef typename GV::template Codim<codim>::Iterator Iterator;
+
+  GV gv = grid.leafView();
+  const typename GV::IndexSet& is = gv.indexSet();
+  std::vector<double> data(is.size(codim),-1.0);
+
+  for (Iterator it=gv.template begin<codim>(); it!=gv.template end<codim>(); ++it)
+    if (it->partitionType()==Dune::InteriorEntity || it->partitionType()==Dune::BorderEntity)
+      data[is.index(*it)] = it->geometry().center().one_norm();
+
+  grid.communicateVector(data,codim,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+
+  for (Iterator it=gv.template begin<codim>(); it!=gv.template end<codim>(); ++it)
+    if (std::abs(data[is.index(*it)]-it->geometry().center().one_norm())>1e-12)
+      DUNE_THROW(Dune::GridError, "vector communication delivered wrong data for codim " << codim);
+}
+
+// check iteration, indices and ids of the entities of one codim on a grid view:
+// every entity is visited once, indices and ids are unique, and the subentities
+// of the elements are the iterated entities with the same center
+template <class GridView, int codim>
+void check_yasp_entities(const GridView& gv)
+{
+  typedef typename GridView::Grid Grid;
+  typedef typename GridView::template Codim<0>::Iterator ElementIterator;
+  typedef typename GridView::template Codim<codim>::Iterator Iterator;
+  typedef typename GridView::template Codim<codim>::EntityPointer EntityPointer;
+  typedef typename Grid::GlobalIdSet::IdType IdType;
+  const int dim = GridView::dimension;
+
+  const typename GridView::IndexSet& is = gv.indexSet();
+  const int n = is.size(codim);
+  std::vector<Dune::FieldVector<double,dim> > center(n);
+  std::vector<int> visited(n,0);
+  std::set<IdType> ids;
+  int count = 0;
+  for (Iterator it=gv.template begin<codim>(); it!=gv.template end<codim>(); ++it, ++count)
+  {
+    const int index = is.index(*it);
+    if (index<0 || index>=n)
+      DUNE_THROW(Dune::GridError, "index " << index << " of codim " << codim << " out of range");
+    if (visited[index]++)
+      DUNE_THROW(Dune::GridError, "index " << index << " of codim " << codim << " is not unique");
+    if (!ids.insert(gv.grid().globalIdSet().id(*it)).second)
+      DUNE_THROW(Dune::GridError, "id of codim " << codim << " entity " << index << " is not unique");
+    center[index] = it->geometry().center();
+
+    const EntityPointer ep = gv.grid().entityPointer(it->seed());
+    if (is.index(*ep) != index || (ep->geometry().center()-center[index]).two_norm()>1e-12)
+      DUNE_THROW(Dune::GridError, "entity seed of codim " << codim << " entity " << index << " is not unique");
+  }
+  if (count!=n)
+    DUNE_THROW(Dune::GridError, "iterated " << count << " entities of codim " << codim
+               << ", but the index set has " << n);
+
+  for (ElementIterator it=gv.template begin<0>(); it!=gv.template end<0>(); ++it)
+    for (int i=0; i<it->template count<codim>(); i++)
+    {
+      const Dune::FieldVector<double,dim> x = it->template subEntity<codim>(i)->geometry().center();
+      if ((x-center[is.subIndex(*it,i,codim)]).two_norm()>1e-12)
+        DUNE_THROW(Dune::GridError, "subentity " << i << " of codim " << codim
+                   << " differs from the iterated entity with the same index");
+    }
+}
+
+// run check_yasp_entities for all faces and edges on all levels and the leaf
+template <int dim>
+void check_yasp_faces_and_edges(const Dune::YaspGrid<dim>& grid)
+{
+  typedef Dune::YaspGrid<dim> Grid;
+  const int edgeCodim = (dim>1) ? dim-1 : 1;
+  for (int l=0; l<=grid.maxLevel(); ++l)
+  {
+    check_yasp_entities<typename Grid::LevelGridView,1>(grid.levelView(l));
+    check_yasp_entities<typename Grid::LevelGridView,edgeCodim>(grid.levelView(l));
+  }
+  check_yasp_entities<typename Grid::LeafGridView,1>(grid.leafView());
+  check_yasp_entities<typename Grid::LeafGridView,edgeCodim>(grid.leafView());
+}
+
 template <int dim>
 void check_yasp(bool p0=false) {
   typedef Dune::FieldVector<double,dim> fTupel;
@@ -49,6 +225,15 @@ void check_yasp(bool p0=false) {
   checkCommunication(grid,-1,Dune::dvverb);
   for(int l=0; l<=grid.maxLevel(); ++l)
     checkCommunication(grid,l,Dune::dvverb);
+  check_yasp_split_phase(grid);
+  check_yasp_vector_communication<dim,0>(grid);
+  check_yasp_vector_communication<dim,1>(grid);
+  check_yasp_vector_communication<dim,(dim>1) ? dim-1 : 1>(grid);
+  check_yasp_vector_communication<dim,dim>(grid);
+  // check iteration, indices and ids of faces and edges
+  check_yasp_faces_and_edges(grid);
+  // check the analytic point location
+  checkPointLocation(grid);
 
   // check geometry lifetime
   checkGeometryLifetime( grid.leafView() );
@@ -61,6 +246,41 @@ void check_yasp(bool p0=false) {
   checkPartitionType( grid.leafView() );
 }
 
+template <int dim>
+void check_yasp_tensor() {
+  std::cout << std::endl << "YaspGrid<" << dim << "> tensor product" << std::endl << std::endl;
+
+  // graded coordinates, the first direction is refined towards zero
+  Dune::array<std::vector<double>,dim> coords;
+  for (int k=0; k<dim; k++)
+  {
+    const int n = (k==0) ? 6 : 2;
+    for (int i=0; i<=n; i++)
+      coords[k].push_back((k==0) ? std::pow(double(i)/n,2) : 0.5*i);
+  }
+
+#if HAVE_MPI
+  Dune::YaspGrid<dim> grid(MPI_COMM_WORLD,coords,std::bitset<dim>(0),1);
+#else
+  Dune::YaspGrid<dim> grid(coords,std::bitset<dim>(0),1);
+#endif
+
+  gridcheck(grid);
+
+  grid.globalRefine(1);
+
+  gridcheck(grid);
+
+  // check communication interface
+  checkCommunication(grid,-1,Dune::dvverb);
+  // check iteration, indices and ids of faces and edges
+  check_yasp_faces_and_edges(grid);
+  // check the analytic point location
+  checkPointLocation(grid);
+  // check the intersection iterator and the geometries it returns
+  checkIntersectionIterator(grid);
+}
+
 int main (int argc , char **argv) {
   try {
 #if HAVE_MPI
@@ -77,6 +297,9 @@ int main (int argc , char **argv) {
     //check_yasp<2>(true);
     check_yasp<3>();
     //check_yasp<3>(true);
+    check_yasp_tensor<1>();
+    check_yasp_tensor<2>();
+    check_yasp_tensor<3>();
     //check_yasp<4>();
 
   } catch (Dune::Exception &e) {
@@ -82,6 +82,53 @@ namespace Dune {
     }
 
 
+    //! get indices of all subEntities of given codim of a codim 0 entity in one pass
+    template<int cc, class OutputIterator>
+    OutputIterator subIndices (const typename GridImp::Traits::template Codim<cc>::Entity& e,
+                               unsigned int codim,
+                               OutputIterator out) const
+    {
+      if (cc==dim || codim==0)
+      {
+        *out = UG_NS<dim>::levelIndex(grid_->getRealImplementation(e).getTarget());
+        return ++out;
+      }
+
+      // element, type and reference element are looked up only once
+      const typename UG_NS<dim>::Element* target = grid_->getRealImplementation(e).getTarget();
+      const GeometryType type = e.type();
+      const ReferenceElement<double,dim>& refElement = ReferenceElements<double,dim>::general(type);
+      const int n = refElement.size(codim);
+
+      if (codim==dim)
+      {
+        for (int i=0; i<n; i++, ++out)
+          *out = UG_NS<dim>::levelIndex(UG_NS<dim>::Corner(target,UGGridRenumberer<dim>::verticesDUNEtoUG(i,type)));
+        return out;
+      }
+
+      if (codim==dim-1)
+      {
+        for (int i=0; i<n; i++, ++out)
+        {
+          int a=refElement.subEntity(i,dim-1,0,dim);
+          int b=refElement.subEntity(i,dim-1,1,dim);
+          *out = UG_NS<dim>::levelIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(target,UGGridRenumberer<dim>::verticesDUNEtoUG(a,type)),
+                                                            UG_NS<dim>::Corner(target,UGGridRenumberer<dim>::verticesDUNEtoUG(b,type))));
+        }
+        return out;
+      }
+
+      if (codim==1)
+      {
+        for (int i=0; i<n; i++, ++out)
+          *out = UG_NS<dim>::levelIndex(UG_NS<dim>::SideVector(target,UGGridRenumberer<dim>::facesDUNEtoUG(i,type)));
+        return out;
+      }
+
+      DUNE_THROW(GridError, "UGGrid<" << dim << "," << dim << ">::subIndices isn't implemented for codim==" << codim );
+    }
+
     //! get number of entities of given codim, type and on this level
     int size (int codim) const {
       if (codim==0)
@@ -233,6 +280,53 @@ namespace Dune {
       DUNE_THROW(GridError, "UGGrid<" << dim << "," << dim << ">::subLeafIndex isn't implemented for codim==" << codim );
     }
 
+    //! get indices of all subEntities of given codim of a codim 0 entity in one pass
+    template<int cc, class OutputIterator>
+    OutputIterator subIndices (const typename remove_const<GridImp>::type::Traits::template Codim<cc>::Entity& e,
+                               unsigned int codim,
+                               OutputIterator out) const
+    {
+      if (cc==dim || codim==0)
+      {
+        *out = UG_NS<dim>::leafIndex(grid_.getRealImplementation(e).getTarget());
+        return ++out;
+      }
+
+      // element, type and reference element are looked up only once
+      const typename UG_NS<dim>::Element* target = grid_.getRealImplementation(e).getTarget();
+      const GeometryType type = e.type();
+      const ReferenceElement<double,dim>& refElement = ReferenceElements<double,dim>::general(type);
+      const int n = refElement.size(codim);
+
+      if (codim==dim)
+      {
+        for (int i=0; i<n; i++, ++out)
+          *out = UG_NS<dim>::leafIndex(UG_NS<dim>::Corner(target,UGGridRenumberer<dim>::verticesDUNEtoUG(i,type)));
+        return out;
+      }
+
+      if (codim==dim-1)
+      {
+        for (int i=0; i<n; i++, ++out)
+        {
+          int a=refElement.subEntity(i,dim-1,0,dim);
+          int b=refElement.subEntity(i,dim-1,1,dim);
+          *out = UG_NS<dim>::leafIndex(UG_NS<dim>::GetEdge(UG_NS<dim>::Corner(target,UGGridRenumberer<dim>::verticesDUNEtoUG(a,type)),
+                                                           UG_NS<dim>::Corner(target,UGGridRenumberer<dim>::verticesDUNEtoUG(b,type))));
+        }
+        return out;
+      }
+
+      if (codim==1)
+      {
+        for (int i=0; i<n; i++, ++out)
+          *out = UG_NS<dim>::leafIndex(UG_NS<dim>::SideVector(target,UGGridRenumberer<dim>::facesDUNEtoUG(i,type)));
+        return out;
+      }
+
+      DUNE_THROW(GridError, "UGGrid<" << dim << "," << dim << ">::subIndices isn't implemented for codim==" << codim );
+    }
+
     //! get number of entities of given codim and type
     int size (GeometryType type) const
     {
@@ -517,6 +611,20 @@ namespace Dune {
     const GridImp& grid_;
   };
 
+  //! UGGridLevelIndexSet provides a native subIndices method
+  template<class GridImp>
+  struct IndexSetHasSubIndices< UGGridLevelIndexSet<GridImp> >
+  {
+    static const bool v = true;
+  };
+
+  //! UGGridLeafIndexSet provides a native subIndices method
+  template<class GridImp>
+  struct IndexSetHasSubIndices< UGGridLeafIndexSet<GridImp> >
+  {
+    static const bool v = true;
+  };
+
 }  // namespace Dune
 
 #endif
@@ -0,0 +1,73 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_UTILITY_ALLTOALL_HH
+#define DUNE_GRID_UTILITY_ALLTOALL_HH
+
+/** \file
+    \brief Exchange of variable sized data between all processes
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+
+namespace Dune
+{
+
+  /** \brief send a vector of values to each process and receive one from each
+   *
+   *  Collective operation on all processes of comm.  The values are
+   *  transferred as bytes, so T has to be a type which can be copied with
+   *  memcpy.
+   *
+   *  \param[in]   comm     the communicator
+   *  \param[in]   send     send[p] is sent to process p, there must be one
+   *                        vector for each process of comm
+   *  \param[out]  receive  receive[p] is the vector sent by process p
+   */
+  template< class T >
+  inline void allToAll ( MPI_Comm comm,
+                         const std::vector< std::vector< T > > &send,
+                         std::vector< std::vector< T > > &receive )
+  {
+    int size;
+    MPI_Comm_size( comm, &size );
+
+    std::vector< int > sendCount( size ), sendOffset( size+1, 0 );
+    for( int p = 0; p < size; ++p )
+    {
+      sendCount[ p ] = send[ p ].size();
+      sendOffset[ p+1 ] = sendOffset[ p ] + sendCount[ p ];
+    }
+    std::vector< int > receiveCount( size ), receiveOffset( size+1, 0 );
+    MPI_Alltoall( &sendCount[ 0 ], 1, MPI_INT, &receiveCount[ 0 ], 1, MPI_INT, comm );
+    for( int p = 0; p < size; ++p )
+      receiveOffset[ p+1 ] = receiveOffset[ p ] + receiveCount[ p ];
+
+    // counts are in units of T, so large messages do not overflow int
+    MPI_Datatype type;
+    MPI_Type_contiguous( sizeof( T ), MPI_BYTE, &type );
+    MPI_Type_commit( &type );
+
+    std::vector< T > sendBuffer( sendOffset[ size ] + 1 );
+    for( int p = 0; p < size; ++p )
+      std::copy( send[ p ].begin(), send[ p ].end(), sendBuffer.begin() + sendOffset[ p ] );
+    std::vector< T > receiveBuffer( receiveOffset[ size ] + 1 );
+    MPI_Alltoallv( &sendBuffer[ 0 ], &sendCount[ 0 ], &sendOffset[ 0 ], type,
+                   &receiveBuffer[ 0 ], &receiveCount[ 0 ], &receiveOffset[ 0 ], type, comm );
+    MPI_Type_free( &type );
+
+    receive.resize( size );
+    for( int p = 0; p < size; ++p )
+      receive[ p ].assign( receiveBuffer.begin() + receiveOffset[ p ],
+                           receiveBuffer.begin() + receiveOffset[ p+1 ] );
+  }
+
+} // namespace Dune
+
+#endif // #if HAVE_MPI
+
+#endif // #ifndef DUNE_GRID_UTILITY_ALLTOALL_HH
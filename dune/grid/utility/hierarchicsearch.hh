@@ -10,9 +10,13 @@
    containing a given point.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <limits>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <dune/common/classname.hh>
 #include <dune/common/exceptions.hh>
@@ -26,6 +30,18 @@ namespace Dune
 
   /**
      @brief Search an IndexSet for an Entity containing a given point.
+
+     The elements of the macro grid are sorted into a uniform grid of bins
+     covering their bounding boxes. A query only inspects the macro elements
+     whose bounding box overlaps the bin containing the point, and then
+     descends the hierarchy as before. Non-affine macro elements (e.g. curved
+     boundary elements) are not bounded by their corners and are therefore
+     inspected for every query. The bins are set up on the first query;
+     call update() if the macro grid changes (e.g. after load balancing).
+
+     For coherent sequences of points (e.g. particle traces) the search can
+     start from a previously found element and walk through its neighbors
+     towards the point; if the walk fails, the bin search is used.
    */
   template<class Grid, class IS>
   class HierarchicSearch
@@ -48,6 +64,15 @@ namespace Dune
     //! type of HierarchicIterator
     typedef typename Grid::HierarchicIterator HierarchicIterator;
 
+    //! type of EntitySeed
+    typedef typename Grid::template Codim<0>::EntitySeed EntitySeed;
+
+    //! type of global coordinates
+    typedef FieldVector<ct,dimw> GlobalCoordinate;
+
+    //! maximal number of elements visited by the neighbor walk
+    static const int maxWalkSteps = 16;
+
     static std::string formatEntityInformation ( const Entity &e ) {
       const typename Entity::Geometry &geo = e.geometry();
       std::ostringstream info;
@@ -115,7 +140,8 @@ namespace Dune
     /**
        @brief Construct a HierarchicSearch object from a Grid and an IndexSet
      */
-    HierarchicSearch(const Grid & g, const IS & is) : grid_(g), indexSet_(is) {}
+    HierarchicSearch(const Grid & g, const IS & is)
+      : grid_(g), indexSet_(is), initialized_(false) {}
 
     /**
        @brief Search the IndexSet of this HierarchicSearch for an Entity
@@ -137,24 +163,37 @@ namespace Dune
     template<PartitionIteratorType partition>
     EntityPointer findEntity(const FieldVector<ct,dimw>& global) const
     {
-      typedef typename Grid::template Partition<partition>::LevelGridView
-      LevelGV;
-      const LevelGV &gv = grid_.template levelView<partition>(0);
-
-      //! type of LevelIterator
-      typedef typename LevelGV::template Codim<0>::Iterator LevelIterator;
-
       // type of element geometry
       typedef typename Entity::Geometry Geometry;
       // type of local coordinate
       typedef typename Geometry::LocalCoordinate LocalCoordinate;
 
-      // loop over macro level
-      LevelIterator it = gv.template begin<0>();
-      LevelIterator end = gv.template end<0>();
-      for (; it != end; ++it)
+      if( !initialized_ )
+        update();
+
+      // only the macro elements registered in the bin of global and the
+      // non-affine macro elements are candidates, visited in macro grid order
+      const int bin = findBin( global );
+      int k = (bin >= 0) ? binOffset_[ bin ] : 0;
+      const int kEnd = (bin >= 0) ? binOffset_[ bin+1 ] : 0;
+      std::vector< int >::const_iterator nonAffine = nonAffine_.begin();
+      while( (k < kEnd) || (nonAffine != nonAffine_.end()) )
       {
-        const Entity &entity = *it;
+        int m;
+        if( (nonAffine == nonAffine_.end()) || ((k < kEnd) && (binElements_[ k ] < *nonAffine)) )
+        {
+          m = binElements_[ k++ ];
+          if( !insideBox( m, global ) )
+            continue;
+        }
+        else
+          m = *nonAffine++;
+
+        if( !contains( partitionTypes_[ m ], partition ) )
+          continue;
+
+        const EntityPointer ep = grid_.entityPointer( seeds_[ m ] );
+        const Entity &entity = *ep;
         const Geometry &geo = entity.geometry();
 
         LocalCoordinate local = geo.local( global );
@@ -166,16 +205,377 @@ namespace Dune
 
         // return if we found the leaf, else search through the child entites
         if( indexSet_.contains( entity ) )
-          return EntityPointer( entity );
+          return ep;
         else
           return hFindEntity( entity, global );
       }
       DUNE_THROW( GridError, "Coordinate " << global << " is outside the grid." );
     }
 
+    /**
+       @brief Search for an Entity containing point global, starting at hint.
+
+       The search walks from hint through the neighbors towards global. If
+       this does not succeed within a few steps (or hint is not part of the
+       IndexSet), the regular search is used. The returned element contains
+       global, but if global lies on a face shared by several elements, any
+       of them may be returned, and which one may depend on hint.
+
+       \exception GridError No element of the coarse grid contains the given
+                            coordinate.
+     */
+    template<PartitionIteratorType partition>
+    EntityPointer findEntity(const FieldVector<ct,dimw>& global,
+                             const EntityPointer& hint) const
+    {
+      if( int(dim) == int(dimw) && indexSet_.contains( *hint ) )
+      {
+        EntityPointer current( hint );
+        for( int step = 0; step < maxWalkSteps; ++step )
+        {
+          const int face = walkDirection( *current, global );
+          if( face == -2 )
+            break;
+          if( face == -1 )
+          {
+            // global is inside of current
+            if( contains( current->partitionType(), partition ) )
+              return current;
+            break;
+          }
+
+          // cross the face pointing towards global
+          typedef typename Grid::LeafIntersectionIterator IntersectionIterator;
+          IntersectionIterator it = current->ileafbegin();
+          for( int i = 0; i < face; ++i )
+            ++it;
+          current = it->outside();
+          if( !indexSet_.contains( *current ) )
+            break;
+        }
+      }
+      return findEntity<partition>( global );
+    }
+
+    //! Search for an Entity containing point global, starting at hint.
+    EntityPointer findEntity(const FieldVector<ct,dimw>& global,
+                             const EntityPointer& hint) const
+    { return findEntity<All_Partition>(global, hint); }
+
+    /**
+       @brief Search for the Entities containing a range of points.
+
+       For each point in [begin,end) the EntityPointer of the containing
+       Entity is written to out. If walk is true, the search for each point
+       starts at the Entity found for the previous point, which pays off if
+       consecutive points are close to each other.
+
+       \exception GridError No element of the coarse grid contains one of the
+                            given coordinates.
+     */
+    template<PartitionIteratorType partition, class InputIterator, class OutputIterator>
+    OutputIterator findEntities(InputIterator begin, InputIterator end,
+                                OutputIterator out, bool walk = true) const
+    {
+      if( begin == end )
+        return out;
+
+      EntityPointer last = findEntity<partition>( *begin );
+      *out = last;
+      ++out;
+      for( ++begin; begin != end; ++begin, ++out )
+      {
+        if( walk )
+        {
+          last = findEntity<partition>( *begin, last );
+          *out = last;
+        }
+        else
+          *out = findEntity<partition>( *begin );
+      }
+      return out;
+    }
+
+    //! Search for the Entities containing a range of points.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator findEntities(InputIterator begin, InputIterator end,
+                                OutputIterator out, bool walk = true) const
+    { return findEntities<All_Partition>(begin, end, out, walk); }
+
+    /**
+       @brief Set up the bins for the macro grid.
+
+       This is done automatically by the first query. It has to be called
+       again if the macro grid changes.
+     */
+    void update() const
+    {
+      typedef typename Grid::template Partition<All_Partition>::LevelGridView LevelGV;
+      typedef typename LevelGV::template Codim<0>::Iterator LevelIterator;
+      typedef typename Entity::Geometry Geometry;
+
+      seeds_.clear();
+      partitionTypes_.clear();
+      lower_.clear();
+      upper_.clear();
+      nonAffine_.clear();
+
+      // bounding boxes of the macro elements
+      GlobalCoordinate gridLower( std::numeric_limits<ct>::max() );
+      GlobalCoordinate gridUpper( -std::numeric_limits<ct>::max() );
+      const LevelGV &gv = grid_.template levelView<All_Partition>(0);
+      const LevelIterator end = gv.template end<0>();
+      for( LevelIterator it = gv.template begin<0>(); it != end; ++it )
+      {
+        const Geometry &geo = it->geometry();
+        GlobalCoordinate lower = geo.corner( 0 );
+        GlobalCoordinate upper = geo.corner( 0 );
+        for( int i = 1; i < geo.corners(); ++i )
+        {
+          const GlobalCoordinate corner = geo.corner( i );
+          for( int k = 0; k < dimw; ++k )
+          {
+            lower[ k ] = std::min( lower[ k ], corner[ k ] );
+            upper[ k ] = std::max( upper[ k ], corner[ k ] );
+          }
+        }
+        // enlarge the box a bit to catch points on the boundary
+        for( int k = 0; k < dimw; ++k )
+        {
+          const ct eps = 1e-8 * std::max( upper[ k ] - lower[ k ], ct( 1 ) );
+          lower[ k ] -= eps;
+          upper[ k ] += eps;
+          gridLower[ k ] = std::min( gridLower[ k ], lower[ k ] );
+          gridUpper[ k ] = std::max( gridUpper[ k ], upper[ k ] );
+        }
+        // the corners do not bound a non-affine element, so it is not
+        // registered in the bins but tested for every query instead
+        if( !geo.affine() )
+          nonAffine_.push_back( seeds_.size() );
+        seeds_.push_back( it->seed() );
+        partitionTypes_.push_back( it->partitionType() );
+        lower_.push_back( lower );
+        upper_.push_back( upper );
+      }
+
+      const int n = seeds_.size();
+      origin_ = gridLower;
+
+      // choose the bin size such that there is about one element per bin;
+      // directions in which the grid is (nearly) flat, e.g. the normal of a
+      // surface grid, only get the enlargement of the boxes and one bin
+      GlobalCoordinate extent( 0 );
+      ct diameter = 0;
+      for( int k = 0; k < dimw; ++k )
+      {
+        extent[ k ] = (n > 0) ? gridUpper[ k ] - gridLower[ k ] : ct( 0 );
+        diameter += extent[ k ] * extent[ k ];
+      }
+      diameter = std::sqrt( diameter );
+      int extended = 0;
+      ct volume = 1;
+      for( int k = 0; k < dimw; ++k )
+        if( extent[ k ] > 1e-6 * diameter )
+        {
+          volume *= extent[ k ];
+          ++extended;
+        }
+      const ct h = (extended > 0) ? std::pow( volume / ct( std::max( n, 1 ) ), ct( 1 ) / ct( extended ) ) : ct( 1 );
+      for( int k = 0; k < dimw; ++k )
+      {
+        if( extent[ k ] > 1e-6 * diameter )
+          bins_[ k ] = std::max( 1, std::min( int( std::ceil( extent[ k ] / h ) ), std::max( n, 1 ) ) );
+        else
+          bins_[ k ] = 1;
+      }
+
+      // the rounding above may still give many more bins than elements,
+      // so halve the largest number of bins until there are O(n) bins
+      const double maxBins = 4.0 * std::max( n, 1 );
+      while( true )
+      {
+        double product = 1;
+        int largest = 0;
+        for( int k = 0; k < dimw; ++k )
+        {
+          product *= bins_[ k ];
+          if( bins_[ k ] > bins_[ largest ] )
+            largest = k;
+        }
+        if( product <= maxBins )
+          break;
+        bins_[ largest ] = (bins_[ largest ] + 1) / 2;
+      }
+
+      int totalBins = 1;
+      for( int k = 0; k < dimw; ++k )
+      {
+        binWidth_[ k ] = (extent[ k ] > 0) ? extent[ k ] / ct( bins_[ k ] ) : ct( 1 );
+        totalBins *= bins_[ k ];
+      }
+
+      // count the elements per bin, then fill the bins (in the order of the macro grid)
+      std::vector< bool > binned( n, true );
+      for( std::size_t i = 0; i < nonAffine_.size(); ++i )
+        binned[ nonAffine_[ i ] ] = false;
+      binOffset_.assign( totalBins+1, 0 );
+      for( int m = 0; m < n; ++m )
+        if( binned[ m ] )
+          forEachBin( m, BinCounter( binOffset_ ) );
+      for( int b = 0; b < totalBins; ++b )
+        binOffset_[ b+1 ] += binOffset_[ b ];
+      binElements_.resize( binOffset_[ totalBins ] );
+      std::vector< int > position( binOffset_.begin(), binOffset_.end()-1 );
+      for( int m = 0; m < n; ++m )
+        if( binned[ m ] )
+          forEachBin( m, BinFiller( position, binElements_, m ) );
+
+      initialized_ = true;
+    }
+
   private:
+    // does partition contain entities of partition type pt?
+    static bool contains ( PartitionType pt, PartitionIteratorType partition )
+    {
+      switch( partition )
+      {
+      case Interior_Partition :
+        return pt == InteriorEntity;
+      case InteriorBorder_Partition :
+        return pt == InteriorEntity || pt == BorderEntity;
+      case Overlap_Partition :
+        return pt != FrontEntity && pt != GhostEntity;
+      case OverlapFront_Partition :
+        return pt != GhostEntity;
+      case Ghost_Partition :
+        return pt == GhostEntity;
+      default :
+        return true;
+      }
+    }
+
+    // is global inside the bounding box of the m-th macro element?
+    bool insideBox ( int m, const GlobalCoordinate &global ) const
+    {
+      for( int k = 0; k < dimw; ++k )
+        if( global[ k ] < lower_[ m ][ k ] || global[ k ] > upper_[ m ][ k ] )
+          return false;
+      return true;
+    }
+
+    // index of the bin containing global, -1 if global is outside all bins
+    int findBin ( const GlobalCoordinate &global ) const
+    {
+      int bin = 0;
+      for( int k = dimw-1; k >= 0; --k )
+      {
+        const ct x = (global[ k ] - origin_[ k ]) / binWidth_[ k ];
+        if( !(x >= 0) || x > ct( bins_[ k ] ) + 1e-8 )
+          return -1;
+        // points on the upper boundary belong to the last bin
+        const int i = std::min( int( x ), bins_[ k ]-1 );
+        bin = bin*bins_[ k ] + i;
+      }
+      return bin;
+    }
+
+    // call f(bin) for all bins overlapping the bounding box of the m-th macro element
+    template< class F >
+    void forEachBin ( int m, F f ) const
+    {
+      int first[ dimw ], last[ dimw ], i[ dimw ];
+      for( int k = 0; k < dimw; ++k )
+      {
+        first[ k ] = std::max( 0, int( (lower_[ m ][ k ] - origin_[ k ]) / binWidth_[ k ] ) );
+        last[ k ] = std::min( bins_[ k ]-1, int( (upper_[ m ][ k ] - origin_[ k ]) / binWidth_[ k ] ) );
+        i[ k ] = first[ k ];
+      }
+      while( true )
+      {
+        int bin = 0;
+        for( int k = dimw-1; k >= 0; --k )
+          bin = bin*bins_[ k ] + i[ k ];
+        f( bin );
+
+        int k = 0;
+        for( ; k < dimw; ++k )
+        {
+          if( ++i[ k ] <= last[ k ] )
+            break;
+          i[ k ] = first[ k ];
+        }
+        if( k == dimw )
+          return;
+      }
+    }
+
+    struct BinCounter
+    {
+      explicit BinCounter ( std::vector< int > &offset ) : offset_( offset ) {}
+      void operator() ( int bin ) { ++offset_[ bin+1 ]; }
+      std::vector< int > &offset_;
+    };
+
+    struct BinFiller
+    {
+      BinFiller ( std::vector< int > &position, std::vector< int > &elements, int m )
+        : position_( position ), elements_( elements ), m_( m ) {}
+      void operator() ( int bin ) { elements_[ position_[ bin ]++ ] = m_; }
+      std::vector< int > &position_;
+      std::vector< int > &elements_;
+      int m_;
+    };
+
+    /*
+       Return -1 if global is inside of entity. Otherwise return the number
+       of the intersection with a neighbor that global lies furthest behind,
+       or -2 if there is none.
+     */
+    int walkDirection ( const Entity &entity, const GlobalCoordinate &global ) const
+    {
+      typedef typename Entity::Geometry Geometry;
+      typedef typename Geometry::LocalCoordinate LocalCoordinate;
+      typedef typename Grid::LeafIntersectionIterator IntersectionIterator;
+
+      const Geometry &geo = entity.geometry();
+      const LocalCoordinate local = geo.local( global );
+      if( ReferenceElements< double, dim >::general( geo.type() ).checkInside( local ) )
+        return -1;
+
+      int face = 0, best = -1;
+      ct bestDistance = 0;
+      const IntersectionIterator end = entity.ileafend();
+      for( IntersectionIterator it = entity.ileafbegin(); it != end; ++it, ++face )
+      {
+        if( !it->neighbor() )
+          continue;
+        GlobalCoordinate d = global;
+        d -= it->geometry().center();
+        const ct distance = d * it->centerUnitOuterNormal();
+        if( distance > bestDistance )
+        {
+          bestDistance = distance;
+          best = face;
+        }
+      }
+      return (best >= 0) ? best : -2;
+    }
+
     const Grid& grid_;
     const IS&   indexSet_;
+
+    // the bins, set up by update()
+    mutable bool initialized_;
+    mutable std::vector< EntitySeed > seeds_;              // seeds of the macro elements
+    mutable std::vector< PartitionType > partitionTypes_;  // partition types of the macro elements
+    mutable std::vector< GlobalCoordinate > lower_;        // lower corners of the bounding boxes
+    mutable std::vector< GlobalCoordinate > upper_;        // upper corners of the bounding boxes
+    mutable GlobalCoordinate origin_;                      // lower corner of the bins
+    mutable GlobalCoordinate binWidth_;                    // width of a bin in each direction
+    mutable int bins_[ dimw ];                             // number of bins in each direction
+    mutable std::vector< int > binOffset_;                 // start of each bin in binElements_
+    mutable std::vector< int > binElements_;               // macro elements of all bins
+    mutable std::vector< int > nonAffine_;                 // non-affine macro elements, not in any bin
   };
 
 } // end namespace Dune
@@ -0,0 +1,130 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+/** \file
+    \brief A unit test for the HierarchicSearch
+
+    The entities found by the bin search, the neighbor walk and the batch
+    query must be leaf elements containing the given points.
+ */
+
+#include <config.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/utility/hierarchicsearch.hh>
+
+using namespace Dune;
+
+// is x inside of e?
+template<class Entity>
+bool check (const Entity& e, const FieldVector<double,Entity::Geometry::coorddimension>& x)
+{
+  const int dim = Entity::dimension;
+  return ReferenceElements<double,dim>::general(e.type()).checkInside(e.geometry().local(x));
+}
+
+template<class Grid>
+void checkHierarchicSearch (const Grid& grid)
+{
+  typedef typename Grid::LeafGridView GridView;
+  typedef typename GridView::IndexSet IndexSet;
+  typedef typename Grid::template Codim<0>::EntityPointer EntityPointer;
+  typedef FieldVector<double,Grid::dimensionworld> GlobalCoordinate;
+
+  const GridView gridView = grid.leafView();
+  HierarchicSearch<Grid,IndexSet> search(grid,gridView.indexSet());
+
+  // a trace of points through the domain (unit cube)
+  std::vector<GlobalCoordinate> points;
+  const int n = 200;
+  for (int i=0; i<=n; i++)
+  {
+    GlobalCoordinate x;
+    for (int k=0; k<Grid::dimensionworld; k++)
+      x[k] = 0.5+0.45*std::sin((k+1)*6.0*i/n);
+    points.push_back(x);
+  }
+  // random points
+  std::srand(42);
+  for (int i=0; i<n; i++)
+  {
+    GlobalCoordinate x;
+    for (int k=0; k<Grid::dimensionworld; k++)
+      x[k] = double(std::rand())/RAND_MAX;
+    points.push_back(x);
+  }
+
+  for (size_t i=0; i<points.size(); i++)
+  {
+    EntityPointer ep = search.findEntity(points[i]);
+    if (!gridView.indexSet().contains(*ep) || !check(*ep,points[i]))
+      DUNE_THROW(GridError, "findEntity returned wrong element for " << points[i]);
+  }
+
+  for (int walk=0; walk<2; walk++)
+  {
+    std::vector<EntityPointer> result;
+    search.findEntities(points.begin(),points.end(),std::back_inserter(result),walk);
+    if (result.size()!=points.size())
+      DUNE_THROW(GridError, "findEntities returned " << result.size() << " elements for "
+                                                     << points.size() << " points");
+    for (size_t i=0; i<points.size(); i++)
+      if (!gridView.indexSet().contains(*result[i]) || !check(*result[i],points[i]))
+        DUNE_THROW(GridError, "findEntities (walk=" << walk << ") returned wrong element for " << points[i]);
+  }
+
+  // points outside of the domain must be reported
+  GlobalCoordinate outside(2.0);
+  bool thrown = false;
+  try {
+    search.findEntity(outside);
+  }
+  catch (GridError&) {
+    thrown = true;
+  }
+  if (!thrown)
+    DUNE_THROW(GridError, "findEntity did not throw for a point outside of the grid");
+}
+
+int main (int argc, char** argv) try
+{
+  // initialize MPI if neccessary
+  Dune::MPIHelper::instance(argc, argv);
+
+  {
+    Dune::FieldVector<double,2> L(1.0);
+    Dune::array<int,2> s;
+    std::fill(s.begin(), s.end(), 8);
+    YaspGrid<2> grid(L,s);
+    checkHierarchicSearch(grid);
+    grid.globalRefine(2);
+    checkHierarchicSearch(grid);
+  }
+
+  {
+    Dune::FieldVector<double,3> L(1.0);
+    Dune::array<int,3> s;
+    std::fill(s.begin(), s.end(), 4);
+    YaspGrid<3> grid(L,s);
+    grid.globalRefine(1);
+    checkHierarchicSearch(grid);
+  }
+
+  return 0;
+}
+catch (Exception &e) {
+  std::cerr << e << std::endl;
+  return 1;
+} catch (...) {
+  std::cerr << "Generic exception!" << std::endl;
+  return 2;
+}
@@ -6,6 +6,8 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <map>
 #include <stack>
 
 // either include stdint.h or provide fallback for uint8_t
@@ -17,6 +19,8 @@ typedef unsigned char uint8_t;
 
 #include <dune/grid/common/grid.hh>     // the grid base classes
 #include <dune/grid/yaspgrid/grids.hh>  // the yaspgrid base classes
+#include <dune/grid/yaspgrid/yaspgridcommplan.hh> // persistent communication plans
+#include <dune/grid/yaspgrid/yaspgridthreads.hh> // threaded loops of the communication
 #include <dune/grid/common/capabilities.hh> // the capabilities
 #include <dune/common/misc.hh>
 #include <dune/common/shared_ptr.hh>
@@ -143,10 +147,32 @@ namespace Dune {
     {
       if (data.contains(dim,codim))
       {
-        DUNE_THROW(GridError, "interface communication not implemented");
+        if (codim!=1 && codim!=dim-1)
+          DUNE_THROW(GridError, "interface communication not implemented");
+        g.template communicateCodim<DataHandle,codim>(data,iftype,dir,level);
       }
       YaspCommunicateMeta<dim,codim-1>::comm(g,data,iftype,dir,level);
     }
+
+    template<class G, class DataHandle>
+    static void commBegin (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level)
+    {
+      if (data.contains(dim,codim))
+      {
+        if (codim!=1 && codim!=dim-1)
+          DUNE_THROW(GridError, "interface communication not implemented");
+        g.template communicateCodimBegin<DataHandle,codim>(data,iftype,dir,level);
+      }
+      YaspCommunicateMeta<dim,codim-1>::commBegin(g,data,iftype,dir,level);
+    }
+
+    template<class G, class DataHandle>
+    static void commEnd (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level)
+    {
+      if (data.contains(dim,codim) && (codim==1 || codim==dim-1))
+        g.template communicateCodimEnd<DataHandle,codim>(data,iftype,dir,level);
+      YaspCommunicateMeta<dim,codim-1>::commEnd(g,data,iftype,dir,level);
+    }
   };
 
   template<int dim>
@@ -158,6 +184,22 @@ namespace Dune {
         g.template communicateCodim<DataHandle,dim>(data,iftype,dir,level);
       YaspCommunicateMeta<dim,dim-1>::comm(g,data,iftype,dir,level);
     }
+
+    template<class G, class DataHandle>
+    static void commBegin (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level)
+    {
+      if (data.contains(dim,dim))
+        g.template communicateCodimBegin<DataHandle,dim>(data,iftype,dir,level);
+      YaspCommunicateMeta<dim,dim-1>::commBegin(g,data,iftype,dir,level);
+    }
+
+    template<class G, class DataHandle>
+    static void commEnd (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level)
+    {
+      if (data.contains(dim,dim))
+        g.template communicateCodimEnd<DataHandle,dim>(data,iftype,dir,level);
+      YaspCommunicateMeta<dim,dim-1>::commEnd(g,data,iftype,dir,level);
+    }
   };
 
   template<int dim>
@@ -168,6 +210,20 @@ namespace Dune {
       if (data.contains(dim,0))
         g.template communicateCodim<DataHandle,0>(data,iftype,dir,level);
     }
+
+    template<class G, class DataHandle>
+    static void commBegin (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level)
+    {
+      if (data.contains(dim,0))
+        g.template communicateCodimBegin<DataHandle,0>(data,iftype,dir,level);
+    }
+
+    template<class G, class DataHandle>
+    static void commEnd (const G& g, DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level)
+    {
+      if (data.contains(dim,0))
+        g.template communicateCodimEnd<DataHandle,0>(data,iftype,dir,level);
+    }
   };
 
 
@@ -178,8 +234,8 @@ namespace Dune {
      \ingroup GridImplementations
 
      YaspGrid stands for yet another structured parallel grid.
-     It implements the dune grid interface for structured grids with codim 0
-     and dim, with arbitrary overlap (including zero),
+     It implements the dune grid interface for structured grids with codim 0,
+     1, dim-1 and dim, with arbitrary overlap (including zero),
      periodic boundaries and fast implementation allowing on-the-fly computations.
 
      \tparam dim The dimension of the grid and its surrounding world
@@ -257,9 +313,11 @@ namespace Dune {
     //! shorthand for base class data types
     typedef MultiYGrid<dim,ctype> YMG;
     typedef typename MultiYGrid<dim,ctype>::YGridLevelIterator YGLI;
+    typedef typename MultiYGrid<dim,ctype>::iTupel iTupel;
     typedef typename SubYGrid<dim,ctype>::TransformingSubIterator TSI;
     typedef typename MultiYGrid<dim,ctype>::Intersection IS;
     typedef typename std::deque<IS>::const_iterator ISIT;
+    typedef YaspCommunicationPlan<dim,ctype> CommPlan;
 
     /*! Constructor for a YaspGrid, they are all forwarded to the base class
        @param comm MPI communicator where this mesh is distributed to
@@ -394,10 +452,86 @@ namespace Dune {
       init();
     }
 
+    /*! Constructor for a tensor product YaspGrid
+
+       The cells are given by the vertex positions in each direction, i.e. the grid
+       has coords[i].size()-1 cells in direction i. The positions must be strictly
+       increasing. Only the 1d coordinate arrays are stored, refinement bisects the
+       cells.
+       @param comm MPI communicator where this mesh is distributed to
+       @param coords vertex positions in each direction
+       @param periodic tells if direction is periodic or not
+       @param overlap size of overlap on coarsest grid (same in all directions)
+       @param lb pointer to an overloaded YLoadBalance instance
+     */
+    YaspGrid (Dune::MPIHelper::MPICommunicator comm,
+              const Dune::array<std::vector<ctype>, dim>& coords,
+              std::bitset<dim> periodic = std::bitset<dim>(0),
+              int overlap = 1,
+              const YLoadBalance<dim>* lb = YMG::defaultLoadbalancer())
+#if HAVE_MPI
+      : YMG(comm,extent(coords),cells(coords),periodic,overlap,lb), ccobj(comm),
+        keep_ovlp(true), adaptRefCount(0), adaptActive(false)
+#else
+      : YMG(extent(coords),cells(coords),periodic,overlap,lb),
+        keep_ovlp(true), adaptRefCount(0), adaptActive(false)
+#endif
+    {
+      this->setCoordinates(coords);
+      init();
+    }
+
+    /*! Constructor for a sequential tensor product YaspGrid
+
+       Sequential here means that the whole grid is living on one process even if your program is running
+       in parallel.
+       @param coords vertex positions in each direction
+       @param periodic tells if direction is periodic or not
+       @param overlap size of overlap on coarsest grid (same in all directions)
+       @param lb pointer to an overloaded YLoadBalance instance
+     */
+    YaspGrid (const Dune::array<std::vector<ctype>, dim>& coords,
+              std::bitset<dim> periodic = std::bitset<dim>(0),
+              int overlap = 1,
+              const YLoadBalance<dim>* lb = YMG::defaultLoadbalancer())
+#if HAVE_MPI
+      : YMG(MPI_COMM_SELF,extent(coords),cells(coords),periodic,overlap,lb), ccobj(MPI_COMM_SELF),
+        keep_ovlp(true), adaptRefCount(0), adaptActive(false)
+#else
+      : YMG(extent(coords),cells(coords),periodic,overlap,lb),
+        keep_ovlp(true), adaptRefCount(0), adaptActive(false)
+#endif
+    {
+      this->setCoordinates(coords);
+      init();
+    }
+
   private:
     // do not copy this class
     YaspGrid(const YaspGrid&);
 
+    // extension of the domain of a tensor product grid
+    static Dune::FieldVector<ctype, dim> extent (const Dune::array<std::vector<ctype>, dim>& coords)
+    {
+      Dune::FieldVector<ctype, dim> L;
+      for (int i=0; i<dim; i++)
+      {
+        if (coords[i].size()<2)
+          DUNE_THROW(GridError, "at least two coordinates are needed in direction " << i);
+        L[i] = coords[i].back()-coords[i].front();
+      }
+      return L;
+    }
+
+    // number of cells of a tensor product grid
+    static Dune::array<int, dim> cells (const Dune::array<std::vector<ctype>, dim>& coords)
+    {
+      Dune::array<int, dim> s;
+      for (int i=0; i<dim; i++)
+        s[i] = std::max(int(coords[i].size())-1,1);
+      return s;
+    }
+
   public:
 
     /*! Return maximum level defined in this grid. Levels are numbered
@@ -411,6 +545,8 @@ namespace Dune {
       if (refCount < -maxLevel())
         DUNE_THROW(GridError, "Only " << maxLevel() << " levels left. " <<
                    "Coarsening " << -refCount << " levels requested!");
+      // communication plans refer to the intersections of the grid levels
+      commplans.clear();
       for (int k=refCount; k<0; k++)
       {
         MultiYGrid<dim,ctype>::coarsen();
@@ -558,8 +694,70 @@ namespace Dune {
         return YaspEntityPointer<codim,GridImp>(this,g,
                                                 TSI(g.vertex_overlap(), this->getRealImplementation(seed).coord()));
       default :
-        DUNE_THROW(GridError, "YaspEntityPointer: codim not implemented");
+        if (MultiYGrid<dim,ctype>::orientations(codim)==0)
+          DUNE_THROW(GridError, "YaspEntityPointer: codim not implemented");
+        return YaspEntityPointer<codim,GridImp>(this,g,
+                                                TSI(g.entity_overlapfront(this->getRealImplementation(seed).orientation()),
+                                                    this->getRealImplementation(seed).coord()));
+      }
+    }
+
+    /** \brief Find the element of the given level containing a point.
+
+       The cell coordinates are computed directly from the point, i.e. the cost
+       does not depend on the grid size (for tensor product grids it is
+       logarithmic in the number of cells per direction). Points in the overlap are found as
+       well; in periodic directions points outside of the domain are mapped
+       back into it.
+
+       \exception GridError The point is not inside the cells of this process.
+     */
+    typename Traits::template Codim<0>::EntityPointer
+    findEntity (const FieldVector<ctype,dim>& x, int level) const
+    {
+      YGLI g = MultiYGrid<dim,ctype>::begin(level);
+      iTupel coord;
+      if (!locate(g,x,coord))
+        DUNE_THROW(GridError, "Coordinate " << x << " is outside the grid on level " << level << ".");
+      return YaspEntityPointer<0,GridImp>(this,g,TSI(g.cell_overlap(),coord));
+    }
+
+    /** \brief Find the elements of the given level containing a range of points.
+
+       For each point in [begin,end) the seed of the containing element is
+       written to out.
+
+       \exception GridError A point is not inside the cells of this process.
+     */
+    template<class InputIterator, class OutputIterator>
+    OutputIterator findEntitySeeds (InputIterator begin, InputIterator end, OutputIterator out, int level) const
+    {
+      typedef typename Traits::template Codim<0>::EntitySeed EntitySeed;
+      YGLI g = MultiYGrid<dim,ctype>::begin(level);
+      iTupel coord;
+      for (; begin!=end; ++begin, ++out)
+      {
+        if (!locate(g,*begin,coord))
+          DUNE_THROW(GridError, "Coordinate " << *begin << " is outside the grid on level " << level << ".");
+        *out = EntitySeed(YaspEntitySeed<0,GridImp>(level,coord));
       }
+      return out;
+    }
+
+    /** \brief Find the elements of the given level containing a range of points.
+
+       For each point in [begin,end) the level index of the containing element
+       is written to out, or -1 if the point is not inside the cells of this
+       process.
+     */
+    template<class InputIterator, class OutputIterator>
+    OutputIterator findIndices (InputIterator begin, InputIterator end, OutputIterator out, int level) const
+    {
+      YGLI g = MultiYGrid<dim,ctype>::begin(level);
+      iTupel coord;
+      for (; begin!=end; ++begin, ++out)
+        *out = locate(g,*begin,coord) ? g.cell_overlap().index(coord) : -1;
+      return out;
     }
 
     //! return size (= distance in graph) of overlap region
@@ -638,274 +836,166 @@ namespace Dune {
       YaspCommunicateMeta<dim,dim>::comm(*this,data,iftype,dir,this->maxLevel());
     }
 
+    /*! \brief Start a split-phase communication on a given level
+
+       Gathers the data of all codims and posts the messages, then returns
+       immediately. The data is scattered by communicateEnd(), which has to be
+       called with the same arguments. In between, the data handle must stay
+       alive and the grid must not be modified. Entities that are not in the
+       receiving part of the interface (e.g. interior elements) can safely be
+       worked on in the meantime.
+
+       Only one split-phase communication per level, interface and direction
+       may be pending at a time.
+     */
+    template<class DataHandleImp, class DataType>
+    void communicateBegin (CommDataHandleIF<DataHandleImp,DataType> & data, InterfaceType iftype, CommunicationDirection dir, int level) const
+    {
+      YaspCommunicateMeta<dim,dim>::commBegin(*this,data,iftype,dir,level);
+    }
+
+    //! complete a split-phase communication on a given level started by communicateBegin()
+    template<class DataHandleImp, class DataType>
+    void communicateEnd (CommDataHandleIF<DataHandleImp,DataType> & data, InterfaceType iftype, CommunicationDirection dir, int level) const
+    {
+      YaspCommunicateMeta<dim,dim>::commEnd(*this,data,iftype,dir,level);
+    }
+
+    //! start a split-phase communication on the leaf grid, see communicateBegin(data,iftype,dir,level)
+    template<class DataHandleImp, class DataType>
+    void communicateBegin (CommDataHandleIF<DataHandleImp,DataType> & data, InterfaceType iftype, CommunicationDirection dir) const
+    {
+      YaspCommunicateMeta<dim,dim>::commBegin(*this,data,iftype,dir,this->maxLevel());
+    }
+
+    //! complete a split-phase communication on the leaf grid started by communicateBegin()
+    template<class DataHandleImp, class DataType>
+    void communicateEnd (CommDataHandleIF<DataHandleImp,DataType> & data, InterfaceType iftype, CommunicationDirection dir) const
+    {
+      YaspCommunicateMeta<dim,dim>::commEnd(*this,data,iftype,dir,this->maxLevel());
+    }
+
     /*! The new communication interface
 
        communicate objects for one codim
      */
     template<class DataHandle, int codim>
     void communicateCodim (DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level) const
+    {
+      communicateCodimBegin<DataHandle,codim>(data,iftype,dir,level);
+      communicateCodimEnd<DataHandle,codim>(data,iftype,dir,level);
+    }
+
+    /*! start communication of objects for one codim
+
+       Gathers the data into the send buffers and posts all messages.
+       In the variable size case the sizes are exchanged before this method returns.
+       Faces and edges are communicated with one plan per orientation.
+
+       If libdunegrid is compiled with OpenMP and IsThreadSafeDataHandle is true
+       for a fixed size data handle, gather and scatter are done with several threads.
+     */
+    template<class DataHandle, int codim>
+    void communicateCodimBegin (DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level) const
     {
       // check input
       if (!data.contains(dim,codim)) return; // should have been checked outside
 
-      // data types
-      typedef typename DataHandle::DataType DataType;
-
       // access to grid level
       YGLI g = MultiYGrid<dim,ctype>::begin(level);
 
-      // find send/recv lists or throw error
-      const std::deque<IS>* sendlist=0;
-      const std::deque<IS>* recvlist=0;
-      if (codim==0) // the elements
+      for (int j=0; j<MultiYGrid<dim,ctype>::orientations(codim); j++)
       {
-        if (iftype==InteriorBorder_InteriorBorder_Interface)
-          return; // there is nothing to do in this case
-        if (iftype==InteriorBorder_All_Interface)
-        {
-          sendlist = &g.send_cell_interior_overlap();
-          recvlist = &g.recv_cell_overlap_interior();
-        }
-        if (iftype==Overlap_OverlapFront_Interface || iftype==Overlap_All_Interface || iftype==All_All_Interface)
-        {
-          sendlist = &g.send_cell_overlap_overlap();
-          recvlist = &g.recv_cell_overlap_overlap();
-        }
+        // get the communication plan for this level, codim, orientation, interface and direction
+        CommPlan* plan = communicationPlan(g,codim,MultiYGrid<dim,ctype>::orientation(codim,j),iftype,dir);
+        if (plan==0) continue; // there is nothing to do in this case
+        communicatePlanBegin<DataHandle,codim>(data,g,*plan);
       }
-      if (codim==dim) // the vertices
-      {
-        if (iftype==InteriorBorder_InteriorBorder_Interface)
-        {
-          sendlist = &g.send_vertex_interiorborder_interiorborder();
-          recvlist = &g.recv_vertex_interiorborder_interiorborder();
-        }
+    }
 
-        if (iftype==InteriorBorder_All_Interface)
-        {
-          sendlist = &g.send_vertex_interiorborder_overlapfront();
-          recvlist = &g.recv_vertex_overlapfront_interiorborder();
-        }
-        if (iftype==Overlap_OverlapFront_Interface || iftype==Overlap_All_Interface)
-        {
-          sendlist = &g.send_vertex_overlap_overlapfront();
-          recvlist = &g.recv_vertex_overlapfront_overlap();
-        }
-        if (iftype==All_All_Interface)
-        {
-          sendlist = &g.send_vertex_overlapfront_overlapfront();
-          recvlist = &g.recv_vertex_overlapfront_overlapfront();
-        }
-      }
+    /*! complete communication of objects for one codim
 
-      // change communication direction?
-      if (dir==BackwardCommunication)
-        std::swap(sendlist,recvlist);
+       Waits for the messages posted by communicateCodimBegin() and scatters the data.
+     */
+    template<class DataHandle, int codim>
+    void communicateCodimEnd (DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int level) const
+    {
+      // check input
+      if (!data.contains(dim,codim)) return; // should have been checked outside
 
-      int cnt;
+      // access to grid level
+      YGLI g = MultiYGrid<dim,ctype>::begin(level);
 
-      // Size computation (requires communication if variable size)
-      std::vector<int> send_size(sendlist->size(),-1);    // map rank to total number of objects (of type DataType) to be sent
-      std::vector<int> recv_size(recvlist->size(),-1);    // map rank to total number of objects (of type DataType) to be recvd
-      std::vector<size_t*> send_sizes(sendlist->size(),static_cast<size_t*>(0)); // map rank to array giving number of objects per entity to be sent
-      std::vector<size_t*> recv_sizes(recvlist->size(),static_cast<size_t*>(0)); // map rank to array giving number of objects per entity to be recvd
-      if (data.fixedsize(dim,codim))
+      for (int j=0; j<MultiYGrid<dim,ctype>::orientations(codim); j++)
       {
-        // fixed size: just take a dummy entity, size can be computed without communication
-        cnt=0;
-        for (ISIT is=sendlist->begin(); is!=sendlist->end(); ++is)
-        {
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
-          send_size[cnt] = is->grid.totalsize() * data.size(*it);
-          cnt++;
-        }
-        cnt=0;
-        for (ISIT is=recvlist->begin(); is!=recvlist->end(); ++is)
-        {
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
-          recv_size[cnt] = is->grid.totalsize() * data.size(*it);
-          cnt++;
-        }
+        // get the communication plan, it has been set up in communicateCodimBegin
+        CommPlan* plan = communicationPlan(g,codim,MultiYGrid<dim,ctype>::orientation(codim,j),iftype,dir);
+        if (plan==0) continue; // there is nothing to do in this case
+        communicatePlanEnd<DataHandle,codim>(data,g,*plan);
       }
-      else
-      {
-        // variable size case: sender side determines the size
-        cnt=0;
-        for (ISIT is=sendlist->begin(); is!=sendlist->end(); ++is)
-        {
-          // allocate send buffer for sizes per entitiy
-          size_t *buf = new size_t[is->grid.totalsize()];
-          send_sizes[cnt] = buf;
-
-          // loop over entities and ask for size
-          int i=0; size_t n=0;
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubend()));
-          for ( ; it!=tsubend; ++it)
-          {
-            buf[i] = data.size(*it);
-            n += buf[i];
-            i++;
-          }
-
-          // now we know the size for this rank
-          send_size[cnt] = n;
+    }
 
-          // hand over send request to torus class
-          MultiYGrid<dim,ctype>::torus().send(is->rank,buf,is->grid.totalsize()*sizeof(size_t));
-          cnt++;
-        }
+    /*! \brief communicate a vector indexed by the level index set of one codim
 
-        // allocate recv buffers for sizes and store receive request
-        cnt=0;
-        for (ISIT is=recvlist->begin(); is!=recvlist->end(); ++is)
-        {
-          // allocate recv buffer
-          size_t *buf = new size_t[is->grid.totalsize()];
-          recv_sizes[cnt] = buf;
+       This is a fast path for fixed size data with one value per entity stored
+       in a std::vector, e.g. indexed by a mapper whose layout contains one codim
+       only. No entities are constructed: the values of each message are copied
+       row by row using the offsets and sizes of the intersection subgrids. The
+       buffers of the communication plans are reused, so repeated exchanges do
+       not allocate. The messages are compatible with communicate() for a data
+       handle sending one value per entity.
 
-          // hand over recv request to torus class
-          MultiYGrid<dim,ctype>::torus().recv(is->rank,buf,is->grid.totalsize()*sizeof(size_t));
-          cnt++;
-        }
-
-        // exchange all size buffers now
-        MultiYGrid<dim,ctype>::torus().exchange();
+       The type T is sent as raw bytes and must be trivially copyable.
+     */
+    template<class T>
+    void communicateVector (std::vector<T>& data, int codim, InterfaceType iftype, CommunicationDirection dir, int level) const
+    {
+      if (level<0 || level>maxLevel()) DUNE_THROW(RangeError, "level out of range");
+      const int n = MultiYGrid<dim,ctype>::orientations(codim);
+      if (n==0)
+        DUNE_THROW(GridError, "communication for codim " << codim << " not implemented");
+      if (int(data.size())<size(level,codim))
+        DUNE_THROW(GridError, "vector of size " << data.size() << " is too small for "
+                                                << size(level,codim) << " entities of codim " << codim);
 
-        // release send size buffers
-        cnt=0;
-        for (ISIT is=sendlist->begin(); is!=sendlist->end(); ++is)
-        {
-          delete[] send_sizes[cnt];
-          send_sizes[cnt] = 0;
-          cnt++;
-        }
+      // access to grid level
+      YGLI g = MultiYGrid<dim,ctype>::begin(level);
 
-        // process receive size buffers
-        cnt=0;
-        for (ISIT is=recvlist->begin(); is!=recvlist->end(); ++is)
+      // fill the send buffers and start the exchange for all orientations
+      for (int j=0; j<n; j++)
+      {
+        const int m = MultiYGrid<dim,ctype>::orientation(codim,j);
+        CommPlan* plan = communicationPlan(g,codim,m,iftype,dir);
+        if (plan==0) continue;
+        T* base = &data[0] + ((codim>0 && codim<dim) ? g.entity_offset(m) : 0);
+        for (int i=0; i<plan->sends(); i++)
         {
-          // get recv buffer
-          size_t *buf = recv_sizes[cnt];
-
-          // compute total size
-          size_t n=0;
-          for (int i=0; i<is->grid.totalsize(); ++i)
-            n += buf[i];
-
-          // ... and store it
-          recv_size[cnt] = n;
-          ++cnt;
+          const SubYGrid<dim,ctype>& grid = plan->send(i).is->grid;
+          copyRows(grid,base,plan->template sendBuffer<T>(i,grid.totalsize()),true);
         }
+        for (int i=0; i<plan->recvs(); i++)
+          plan->template recvBuffer<T>(i,plan->recv(i).is->grid.totalsize());
+        plan->start();
       }
 
-
-      // allocate & fill the send buffers & store send request
-      std::vector<DataType*> sends(sendlist->size(), static_cast<DataType*>(0)); // store pointers to send buffers
-      cnt=0;
-      for (ISIT is=sendlist->begin(); is!=sendlist->end(); ++is)
+      // wait for the messages and copy the received values
+      for (int j=0; j<n; j++)
       {
-        //      std::cout << "[" << this->comm().rank() << "] "
-        //                << " send " << " dest=" << is->rank
-        //                << " size=" << send_size[cnt]
-        //                << std::endl;
-
-        // allocate send buffer
-        DataType *buf = new DataType[send_size[cnt]];
-
-        // remember send buffer
-        sends[cnt] = buf;
-
-        // make a message buffer
-        MessageBuffer<DataType> mb(buf);
-
-        // fill send buffer; iterate over cells in intersection
-        typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-        it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
-        typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-        tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubend()));
-        for ( ; it!=tsubend; ++it)
-          data.gather(mb,*it);
-
-        // hand over send request to torus class
-        MultiYGrid<dim,ctype>::torus().send(is->rank,buf,send_size[cnt]*sizeof(DataType));
-        cnt++;
+        const int m = MultiYGrid<dim,ctype>::orientation(codim,j);
+        CommPlan* plan = communicationPlan(g,codim,m,iftype,dir);
+        if (plan==0) continue;
+        plan->finish();
+        T* base = &data[0] + ((codim>0 && codim<dim) ? g.entity_offset(m) : 0);
+        for (int i=0; i<plan->recvs(); i++)
+          copyRows(plan->recv(i).is->grid,base,plan->template recvBuffer<T>(i),false);
       }
+    }
 
-      // allocate recv buffers and store receive request
-      std::vector<DataType*> recvs(recvlist->size(),static_cast<DataType*>(0)); // store pointers to send buffers
-      cnt=0;
-      for (ISIT is=recvlist->begin(); is!=recvlist->end(); ++is)
-      {
-        //      std::cout << "[" << this->comm().rank() << "] "
-        //                << " recv " << "  src=" << is->rank
-        //                << " size=" << recv_size[cnt]
-        //                << std::endl;
-
-        // allocate recv buffer
-        DataType *buf = new DataType[recv_size[cnt]];
-
-        // remember recv buffer
-        recvs[cnt] = buf;
-
-        // hand over recv request to torus class
-        MultiYGrid<dim,ctype>::torus().recv(is->rank,buf,recv_size[cnt]*sizeof(DataType));
-        cnt++;
-      }
-
-      // exchange all buffers now
-      MultiYGrid<dim,ctype>::torus().exchange();
-
-      // release send buffers
-      cnt=0;
-      for (ISIT is=sendlist->begin(); is!=sendlist->end(); ++is)
-      {
-        delete[] sends[cnt];
-        sends[cnt] = 0;
-        cnt++;
-      }
-
-      // process receive buffers and delete them
-      cnt=0;
-      for (ISIT is=recvlist->begin(); is!=recvlist->end(); ++is)
-      {
-        // get recv buffer
-        DataType *buf = recvs[cnt];
-
-        // make a message buffer
-        MessageBuffer<DataType> mb(buf);
-
-        // copy data from receive buffer; iterate over cells in intersection
-        if (data.fixedsize(dim,codim))
-        {
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
-          size_t n=data.size(*it);
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubend()));
-          for ( ; it!=tsubend; ++it)
-            data.scatter(mb,*it,n);
-        }
-        else
-        {
-          int i=0;
-          size_t *sbuf = recv_sizes[cnt];
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          it(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubbegin()));
-          typename Traits::template Codim<codim>::template Partition<All_Partition>::LevelIterator
-          tsubend(YaspLevelIterator<codim,All_Partition,GridImp>(this,g,is->grid.tsubend()));
-          for ( ; it!=tsubend; ++it)
-            data.scatter(mb,*it,sbuf[i++]);
-          delete[] sbuf;
-        }
-
-        // delete buffer
-        delete[] buf; // hier krachts !
-        cnt++;
-      }
+    //! communicate a vector indexed by the leaf index set of one codim, see above
+    template<class T>
+    void communicateVector (std::vector<T>& data, int codim, InterfaceType iftype, CommunicationDirection dir) const
+    {
+      communicateVector(data,codim,iftype,dir,maxLevel());
     }
 
     // The new index sets from DDM 11.07.2005
@@ -957,6 +1047,9 @@ namespace Dune {
     std::vector< shared_ptr< YaspIndexSet<const YaspGrid<dim> > > > indexsets;
     YaspGlobalIdSet<const YaspGrid<dim> > theglobalidset;
 
+    // communication plans, built on first use for (level,codim,interface,direction)
+    mutable std::map<int, shared_ptr<CommPlan> > commplans;
+
     // number of boundary segments of the level 0 grid
     int nBSegments;
 
@@ -1007,6 +1100,407 @@ namespace Dune {
       mutable int j;
     };
 
+    // position of x in cell units in direction k of a tensor product level, found by bisection
+    ctype tensorCell (const YGLI& g, int k, ctype x) const
+    {
+      const ctype lower = g.vertexPosition(k,0);
+      const ctype L = g.vertexPosition(k,g.cell_global().size(k))-lower;
+      // shift periodic copies into the domain
+      int shift = 0;
+      if (this->periodic(k))
+      {
+        shift = int(std::floor((x-lower)/L));
+        x -= shift*L;
+      }
+      int a = 0, b = g.cell_global().size(k);
+      if (x<lower)
+        return (x-lower)/(g.vertexPosition(k,1)-lower) + shift*b;
+      if (x>g.vertexPosition(k,b))
+        return b + (x-g.vertexPosition(k,b))/(g.vertexPosition(k,b)-g.vertexPosition(k,b-1)) + shift*b;
+      while (b-a>1)
+      {
+        const int m = (a+b)/2;
+        if (x<g.vertexPosition(k,m)) b = m; else a = m;
+      }
+      return a + (x-g.vertexPosition(k,a))/(g.vertexPosition(k,a+1)-g.vertexPosition(k,a))
+             + shift*g.cell_global().size(k);
+    }
+
+    // compute the coordinates of the cell of level g containing x, return false if there is none
+    bool locate (const YGLI& g, const FieldVector<ctype,dim>& x, iTupel& coord) const
+    {
+      const SubYGrid<dim,ctype>& cells = g.cell_overlap();
+      const YGrid<dim,ctype>& global = g.cell_global();
+      for (int k=0; k<dim; k++)
+      {
+        // cell c has its center at c*h+shift
+        ctype t = (x[k]-cells.shift(k))/cells.meshsize(k) + 0.5;
+        if (g.tensor())
+          t = tensorCell(g,k,x[k]);
+        int c = int(std::floor(t));
+        if (this->periodic(k) && (c<cells.min(k) || c>cells.max(k)))
+        {
+          // map into the domain, then try the periodic copies in the overlap
+          const int n = global.size(k);
+          c = global.origin(k) + ((c-global.origin(k))%n+n)%n;
+          if (c>cells.max(k)) c -= n;
+          if (c<cells.min(k)) c += n;
+        }
+        else
+        {
+          // points on the boundary of the domain belong to the boundary cells
+          if (c==global.max(k)+1 && t-c<1e-8) c--;
+          if (c==global.min(k)-1 && c+1-t<1e-8) c++;
+        }
+        if (c<cells.min(k) || c>cells.max(k))
+          return false;
+        coord[k] = c;
+      }
+      return true;
+    }
+
+    /*! copy the values of the entities of a subgrid between a vector and a
+       message buffer; the entities of a row in direction 0 are consecutive
+     */
+    template<class T>
+    static void copyRows (const SubYGrid<dim,ctype>& grid, T* data, T* buffer, bool pack)
+    {
+      if (grid.totalsize()==0) return;
+
+      // increments of the lexicographic numbering in the enclosing grid
+      int increment[dim];
+      increment[0] = 1;
+      for (int k=1; k<dim; k++)
+        increment[k] = increment[k-1]*grid.supersize(k-1);
+
+      // loop over all rows
+      const int length = grid.size(0);
+      const int rows = grid.totalsize()/length;
+      iTupel coord(0);
+      for (int row=0; row<rows; row++, buffer+=length)
+      {
+        T* start = data;
+        for (int k=0; k<dim; k++)
+          start += (grid.offset(k)+coord[k])*increment[k];
+        if (pack)
+          std::copy(start,start+length,buffer);
+        else
+          std::copy(buffer,buffer+length,start);
+
+        // move to the next row
+        for (int k=1; k<dim; k++)
+        {
+          if (++coord[k]<grid.size(k)) break;
+          coord[k] = 0;
+        }
+      }
+    }
+
+    //! gather the data of one communication plan into its send buffers and start the exchange
+    template<class DataHandle, int codim>
+    void communicatePlanBegin (DataHandle& data, const YGLI& g, CommPlan& plan) const
+    {
+      // data types
+      typedef typename DataHandle::DataType DataType;
+      typedef YaspEntityPointer<codim,GridImp> EntityPointerImp;
+
+      // Size computation (requires communication if variable size)
+      if (data.fixedsize(dim,codim))
+      {
+        // fixed size: just take a dummy entity, size can be computed without communication
+        for (int i=0; i<plan.sends(); i++)
+        {
+          const IS& is = *plan.send(i).is;
+          EntityPointerImp ep(this,g,is.grid.tsubbegin());
+          plan.template sendBuffer<DataType>(i,is.grid.totalsize() * data.size(ep.dereference()));
+        }
+        for (int i=0; i<plan.recvs(); i++)
+        {
+          const IS& is = *plan.recv(i).is;
+          EntityPointerImp ep(this,g,is.grid.tsubbegin());
+          plan.template recvBuffer<DataType>(i,is.grid.totalsize() * data.size(ep.dereference()));
+        }
+      }
+      else
+      {
+        // variable size case: sender side determines the size
+        for (int i=0; i<plan.sends(); i++)
+        {
+          typename CommPlan::Message& m = plan.send(i);
+
+          // loop over entities and ask for size
+          int k=0; size_t n=0;
+          EntityPointerImp ep(this,g,m.is->grid.tsubbegin());
+          const TSI tsubend = m.is->grid.tsubend();
+          for (TSI& it=ep.transformingsubiterator(); it!=tsubend; ++it)
+          {
+            m.sizes[k] = data.size(ep.dereference());
+            n += m.sizes[k];
+            k++;
+          }
+
+          // now we know the size for this message
+          plan.template sendBuffer<DataType>(i,n);
+        }
+
+        // exchange all size buffers now
+        plan.exchangeSizes();
+
+        // compute total size of the received messages
+        for (int i=0; i<plan.recvs(); i++)
+        {
+          const typename CommPlan::Message& m = plan.recv(i);
+          size_t n=0;
+          for (size_t k=0; k<m.sizes.size(); ++k)
+            n += m.sizes[k];
+          plan.template recvBuffer<DataType>(i,n);
+        }
+      }
+
+      // fill the send buffers
+      if (IsThreadSafeDataHandle<DataHandle>::v && data.fixedsize(dim,codim) && Yasp::threadsAvailable())
+      {
+        threadedGatherScatter<DataHandle,codim>(data,g,plan,true);
+        plan.start();
+        return;
+      }
+      for (int i=0; i<plan.sends(); i++)
+      {
+        const IS& is = *plan.send(i).is;
+
+        // make a message buffer
+        MessageBuffer<DataType> mb(plan.template sendBuffer<DataType>(i));
+
+        // fill send buffer; iterate over entities in intersection
+        EntityPointerImp ep(this,g,is.grid.tsubbegin());
+        const TSI tsubend = is.grid.tsubend();
+        for (TSI& it=ep.transformingsubiterator(); it!=tsubend; ++it)
+          data.gather(mb,ep.dereference());
+      }
+
+      // start the exchange of all buffers
+      plan.start();
+    }
+
+    //! wait for the exchange of one communication plan and scatter the data from its receive buffers
+    template<class DataHandle, int codim>
+    void communicatePlanEnd (DataHandle& data, const YGLI& g, CommPlan& plan) const
+    {
+      // data types
+      typedef typename DataHandle::DataType DataType;
+      typedef YaspEntityPointer<codim,GridImp> EntityPointerImp;
+
+      // wait for all buffers
+      plan.finish();
+
+      if (IsThreadSafeDataHandle<DataHandle>::v && data.fixedsize(dim,codim) && Yasp::threadsAvailable())
+      {
+        threadedGatherScatter<DataHandle,codim>(data,g,plan,false);
+        return;
+      }
+
+      // process receive buffers
+      for (int i=0; i<plan.recvs(); i++)
+      {
+        const typename CommPlan::Message& m = plan.recv(i);
+
+        // make a message buffer
+        MessageBuffer<DataType> mb(plan.template recvBuffer<DataType>(i));
+
+        // copy data from receive buffer; iterate over entities in intersection
+        EntityPointerImp ep(this,g,m.is->grid.tsubbegin());
+        const TSI tsubend = m.is->grid.tsubend();
+        TSI& it = ep.transformingsubiterator();
+        if (data.fixedsize(dim,codim))
+        {
+          size_t n=data.size(ep.dereference());
+          for ( ; it!=tsubend; ++it)
+            data.scatter(mb,ep.dereference(),n);
+        }
+        else
+        {
+          int k=0;
+          for ( ; it!=tsubend; ++it)
+            data.scatter(mb,ep.dereference(),m.sizes[k++]);
+        }
+      }
+    }
+
+    //! the arguments of gatherScatterRow() for Yasp::parallelFor()
+    template<class DataHandle, int codim>
+    struct GatherScatterRows
+    {
+      const YaspGrid* grid;
+      DataHandle* data;
+      const YGLI* g;
+      CommPlan* plan;
+      bool gather;
+      std::size_t n;
+      const std::vector<int>* firstrow;
+
+      static void run (int r, void* context)
+      {
+        const GatherScatterRows& rows = *static_cast<const GatherScatterRows*>(context);
+        rows.grid->template gatherScatterRow<DataHandle,codim>(*rows.data,*rows.g,*rows.plan,
+                                                               rows.gather,rows.n,*rows.firstrow,r);
+      }
+    };
+
+    /*! gather into the send buffers (or scatter from the receive buffers) of a
+       plan with several threads. The rows in direction 0 of all messages are
+       distributed over the threads, each row is a contiguous part of its message.
+       Requires a thread safe data handle with fixed size.
+     */
+    template<class DataHandle, int codim>
+    void threadedGatherScatter (DataHandle& data, const YGLI& g, CommPlan& plan, bool gather) const
+    {
+      typedef YaspEntityPointer<codim,GridImp> EntityPointerImp;
+
+      const int messages = gather ? plan.sends() : plan.recvs();
+      if (messages==0) return;
+
+      // number of objects per entity, taken from a dummy entity
+      const IS& first = *(gather ? plan.send(0) : plan.recv(0)).is;
+      EntityPointerImp dummy(this,g,first.grid.tsubbegin());
+      const std::size_t n = data.size(dummy.dereference());
+
+      // number the rows of all messages consecutively
+      std::vector<int> firstrow(messages+1,0);
+      for (int i=0; i<messages; i++)
+      {
+        const SubYGrid<dim,ctype>& grid = (gather ? plan.send(i) : plan.recv(i)).is->grid;
+        firstrow[i+1] = firstrow[i] + ((grid.totalsize()>0) ? grid.totalsize()/grid.size(0) : 0);
+      }
+
+      GatherScatterRows<DataHandle,codim> rows = { this, &data, &g, &plan, gather, n, &firstrow };
+      Yasp::parallelFor(firstrow[messages],&GatherScatterRows<DataHandle,codim>::run,&rows);
+    }
+
+    //! gather or scatter the row r of the rows numbered by threadedGatherScatter()
+    template<class DataHandle, int codim>
+    void gatherScatterRow (DataHandle& data, const YGLI& g, CommPlan& plan, bool gather,
+                           std::size_t n, const std::vector<int>& firstrow, int r) const
+    {
+      typedef typename DataHandle::DataType DataType;
+      typedef YaspEntityPointer<codim,GridImp> EntityPointerImp;
+
+      // message and row within the message
+      const int i = std::upper_bound(firstrow.begin(),firstrow.end(),r)-firstrow.begin()-1;
+      const int row = r-firstrow[i];
+      const SubYGrid<dim,ctype>& grid = (gather ? plan.send(i) : plan.recv(i)).is->grid;
+      const int length = grid.size(0);
+
+      // first entity of the row
+      iTupel coord;
+      coord[0] = grid.origin(0);
+      for (int k=1, q=row; k<dim; k++)
+      {
+        coord[k] = grid.origin(k)+q%grid.size(k);
+        q /= grid.size(k);
+      }
+
+      DataType* p = gather ? plan.template sendBuffer<DataType>(i) : plan.template recvBuffer<DataType>(i);
+      MessageBuffer<DataType> mb(p+std::size_t(row)*length*n);
+      EntityPointerImp ep(this,g,grid.tsubbegin(coord));
+      TSI& it = ep.transformingsubiterator();
+      for (int e=0; e<length; e++, ++it)
+        if (gather)
+          data.gather(mb,ep.dereference());
+        else
+          data.scatter(mb,ep.dereference(),n);
+    }
+
+    /*! return the communication plan for the given level, codim, orientation, interface and direction
+       (0 if there is nothing to communicate)
+     */
+    CommPlan* communicationPlan (const YGLI& g, int codim, int orientation, InterfaceType iftype, CommunicationDirection dir) const
+    {
+      const int key = ((((g.level()*(dim+1)+codim)*5+iftype)*2+dir)<<dim)+orientation;
+      typename std::map<int, shared_ptr<CommPlan> >::iterator it = commplans.find(key);
+      if (it!=commplans.end())
+        return it->second.get();
+
+      // find send/recv lists
+      const std::deque<IS>* sendlist=0;
+      const std::deque<IS>* recvlist=0;
+      if (codim==0) // the elements
+      {
+        if (iftype==InteriorBorder_All_Interface)
+        {
+          sendlist = &g.send_cell_interior_overlap();
+          recvlist = &g.recv_cell_overlap_interior();
+        }
+        if (iftype==Overlap_OverlapFront_Interface || iftype==Overlap_All_Interface || iftype==All_All_Interface)
+        {
+          sendlist = &g.send_cell_overlap_overlap();
+          recvlist = &g.recv_cell_overlap_overlap();
+        }
+      }
+      if (codim==dim) // the vertices
+      {
+        if (iftype==InteriorBorder_InteriorBorder_Interface)
+        {
+          sendlist = &g.send_vertex_interiorborder_interiorborder();
+          recvlist = &g.recv_vertex_interiorborder_interiorborder();
+        }
+
+        if (iftype==InteriorBorder_All_Interface)
+        {
+          sendlist = &g.send_vertex_interiorborder_overlapfront();
+          recvlist = &g.recv_vertex_overlapfront_interiorborder();
+        }
+        if (iftype==Overlap_OverlapFront_Interface || iftype==Overlap_All_Interface)
+        {
+          sendlist = &g.send_vertex_overlap_overlapfront();
+          recvlist = &g.recv_vertex_overlapfront_overlap();
+        }
+        if (iftype==All_All_Interface)
+        {
+          sendlist = &g.send_vertex_overlapfront_overlapfront();
+          recvlist = &g.recv_vertex_overlapfront_overlapfront();
+        }
+      }
+
+      if (codim>0 && codim<dim) // faces and edges of the given orientation
+      {
+        if (iftype==InteriorBorder_InteriorBorder_Interface)
+        {
+          sendlist = &g.send_entity_interiorborder_interiorborder(orientation);
+          recvlist = &g.recv_entity_interiorborder_interiorborder(orientation);
+        }
+        if (iftype==InteriorBorder_All_Interface)
+        {
+          sendlist = &g.send_entity_interiorborder_overlapfront(orientation);
+          recvlist = &g.recv_entity_overlapfront_interiorborder(orientation);
+        }
+        if (iftype==Overlap_OverlapFront_Interface || iftype==Overlap_All_Interface)
+        {
+          sendlist = &g.send_entity_overlap_overlapfront(orientation);
+          recvlist = &g.recv_entity_overlapfront_overlap(orientation);
+        }
+        if (iftype==All_All_Interface)
+        {
+          sendlist = &g.send_entity_overlapfront_overlapfront(orientation);
+          recvlist = &g.recv_entity_overlapfront_overlapfront(orientation);
+        }
+      }
+
+      // no interface, e.g. InteriorBorder_InteriorBorder_Interface for elements
+      if (sendlist==0 || recvlist==0)
+      {
+        commplans[key] = shared_ptr<CommPlan>();
+        return 0;
+      }
+
+      // change communication direction?
+      if (dir==BackwardCommunication)
+        std::swap(sendlist,recvlist);
+
+      shared_ptr<CommPlan> plan(new CommPlan(MultiYGrid<dim,ctype>::torus(),*sendlist,*recvlist));
+      commplans[key] = plan;
+      return plan.get();
+    }
+
     void setsizes ()
     {
       for (YGLI g=MultiYGrid<dim,ctype>::begin(); g!=MultiYGrid<dim,ctype>::end(); ++g)
@@ -1055,12 +1549,23 @@ namespace Dune {
     template<int cd, PartitionIteratorType pitype>
     YaspLevelIterator<cd,pitype,GridImp> levelbegin (int level) const
     {
-      dune_static_assert( cd == dim || cd == 0 ,
-                          "YaspGrid only supports Entities with codim=dim and codim=0");
+      dune_static_assert( cd == dim || cd == 0 || cd == 1 || cd == dim-1,
+                          "YaspGrid only supports Entities with codim 0, 1, dim-1 and dim");
       YGLI g = MultiYGrid<dim,ctype>::begin(level);
       if (level<0 || level>maxLevel()) DUNE_THROW(RangeError, "level out of range");
       if (pitype==Ghost_Partition)
         return levelend <cd, pitype> (level);
+      if (cd>0 && cd<dim)   // faces and edges, start with the first nonempty orientation
+      {
+        for (int j=0; j<MultiYGrid<dim,ctype>::orientations(cd); j++)
+        {
+          const SubYGrid<dim,ctype>& grid =
+            YaspLevelIterator<cd,pitype,GridImp>::entityGrid(g,MultiYGrid<dim,ctype>::orientation(cd,j));
+          if (!grid.empty())
+            return YaspLevelIterator<cd,pitype,GridImp>(this,g,grid.tsubbegin());
+        }
+        return levelend <cd, pitype> (level);
+      }
       if (cd==0)   // the elements
       {
         if (pitype<=InteriorBorder_Partition)
@@ -1086,10 +1591,18 @@ namespace Dune {
     template<int cd, PartitionIteratorType pitype>
     YaspLevelIterator<cd,pitype,GridImp> levelend (int level) const
     {
-      dune_static_assert( cd == dim || cd == 0 ,
-                          "YaspGrid only supports Entities with codim=dim and codim=0");
+      dune_static_assert( cd == dim || cd == 0 || cd == 1 || cd == dim-1,
+                          "YaspGrid only supports Entities with codim 0, 1, dim-1 and dim");
       YGLI g = MultiYGrid<dim,ctype>::begin(level);
       if (level<0 || level>maxLevel()) DUNE_THROW(RangeError, "level out of range");
+      if (cd>0 && cd<dim)   // faces and edges, the iterator stops at the end of the last nonempty orientation
+      {
+        int j=MultiYGrid<dim,ctype>::orientations(cd)-1;
+        while (j>0 && YaspLevelIterator<cd,pitype,GridImp>::entityGrid(g,MultiYGrid<dim,ctype>::orientation(cd,j)).empty())
+          j--;
+        return YaspLevelIterator<cd,pitype,GridImp>(this,g,
+                 YaspLevelIterator<cd,pitype,GridImp>::entityGrid(g,MultiYGrid<dim,ctype>::orientation(cd,j)).tsubend());
+      }
       if (cd==0)   // the elements
       {
         if (pitype<=InteriorBorder_Partition)
@@ -1147,34 +1660,22 @@ namespace Dune {
       static const bool v = true;
     };
 
-    /** \brief YaspGrid has codim=0 entities (elements)
+    /** \brief YaspGrid has elements, faces, edges and vertices (codim 0, 1, dim-1 and dim)
        \ingroup YaspGrid
      */
-    template<int dim>
-    struct hasEntity< YaspGrid<dim>, 0 >
+    template<int dim, int codim>
+    struct hasEntity< YaspGrid<dim>, codim >
     {
-      static const bool v = true;
+      static const bool v = (codim==0 || codim==1 || codim==dim-1 || codim==dim);
     };
 
-    /** \brief YaspGrid has codim=dim entities (vertices)
+    /** \brief YaspGrid can communicate all of its entities
        \ingroup YaspGrid
      */
-    template<int dim>
-    struct hasEntity< YaspGrid<dim>, dim >
+    template< int dim, int codim >
+    struct canCommunicate< YaspGrid< dim >, codim >
     {
-      static const bool v = true;
-    };
-
-    template< int dim >
-    struct canCommunicate< YaspGrid< dim >, 0 >
-    {
-      static const bool v = true;
-    };
-
-    template< int dim >
-    struct canCommunicate< YaspGrid< dim >, dim >
-    {
-      static const bool v = true;
+      static const bool v = (codim==0 || codim==1 || codim==dim-1 || codim==dim);
     };
 
     /** \brief YaspGrid is parallel
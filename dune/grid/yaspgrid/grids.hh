@@ -81,12 +81,16 @@ namespace Dune {
 
     //! Make an empty YGrid with origin 0
     YGrid () :
-      _origin(0), _size(0), _h(0.0), _r(0.0)
+      _origin(0), _size(0), _h(0.0), _r(0.0), _orientation(0)
     {}
 
-    //! Make YGrid from origin and size arrays
-    YGrid (iTupel o, iTupel s, fTupel h, fTupel r) :
-      _origin(o), _size(s), _h(h), _r(r)
+    /*! Make YGrid from origin and size arrays
+
+       The orientation is only used by grids of faces and edges, see
+       MultiYGrid::orientation.
+     */
+    YGrid (iTupel o, iTupel s, fTupel h, fTupel r, int orientation = 0) :
+      _origin(o), _size(s), _h(h), _r(r), _orientation(orientation)
     {
 #ifndef NDEBUG
       for (int i=0; i<d; ++i)
@@ -256,14 +260,14 @@ namespace Dune {
         // offset to own origin
         offset[i] = neworigin[i]-_origin[i];
       }
-      return SubYGrid<d,ct>(neworigin,newsize,offset,_size,_h,_r);
+      return SubYGrid<d,ct>(neworigin,newsize,offset,_size,_h,_r,_orientation);
     }
 
     //! return grid moved by the vector v
     YGrid<d,ct> move (iTupel v) const
     {
       for (int i=0; i<d; i++) v[i] += _origin[i];
-      return YGrid<d,ct>(v,_size,_h,_r);
+      return YGrid<d,ct>(v,_size,_h,_r,_orientation);
     }
 
     /*! Iterator class allows one to run over all cells of a grid.
@@ -536,6 +540,7 @@ namespace Dune {
     iTupel _size;
     fTupel _h;        //!< mesh size per direction
     fTupel _r;        //!< shift per direction
+    int _orientation; //!< bit mask of the directions a face or edge extends in
   };
 
   //! Output operator for grids
@@ -594,8 +599,8 @@ namespace Dune {
     SubYGrid () {}
 
     //! Make SubYGrid from origin, size, offset and supersize
-    SubYGrid (iTupel origin, iTupel size, iTupel offset, iTupel supersize, fTupel h, fTupel r)
-      : YGrid<d,ct>::YGrid(origin,size,h,r), _offset(offset), _supersize(supersize)
+    SubYGrid (iTupel origin, iTupel size, iTupel offset, iTupel supersize, fTupel h, fTupel r, int orientation = 0)
+      : YGrid<d,ct>::YGrid(origin,size,h,r,orientation), _offset(offset), _supersize(supersize)
     {
       for (int i=0; i<d; ++i)
       {
@@ -670,7 +675,7 @@ namespace Dune {
         // offset to my supergrid
         offset[i] = _offset[i]+neworigin[i]-this->origin(i);
       }
-      return SubYGrid<d,ct>(neworigin,newsize,offset,_supersize,this->meshsize(),this->shift());
+      return SubYGrid<d,ct>(neworigin,newsize,offset,_supersize,this->meshsize(),this->shift(),this->orientation());
     }
 
     /*! SubIterator is an Iterator that provides in addition the consecutive
@@ -844,7 +849,7 @@ namespace Dune {
     class TransformingSubIterator : public SubIterator {
     public:
       //! Make iterator pointing to first cell in a grid.
-      TransformingSubIterator (const SubYGrid<d,ct>& r) : SubIterator(r)
+      TransformingSubIterator (const SubYGrid<d,ct>& r) : SubIterator(r), _orientation(r.orientation())
       {
         for (int i=0; i<d; ++i) _h[i] = r.meshsize(i);
         for (int i=0; i<d; ++i) _begin[i] = r.origin(i)*r.meshsize(i)+r.shift(i);
@@ -852,7 +857,7 @@ namespace Dune {
       }
 
       //! Make iterator pointing to given cell in a grid.
-      TransformingSubIterator (const SubYGrid<d,ct>& r, const iTupel& coord) : SubIterator(r,coord)
+      TransformingSubIterator (const SubYGrid<d,ct>& r, const iTupel& coord) : SubIterator(r,coord), _orientation(r.orientation())
       {
         for (int i=0; i<d; ++i) _h[i] = r.meshsize(i);
         for (int i=0; i<d; ++i) _begin[i] = r.origin(i)*r.meshsize(i)+r.shift(i);
@@ -861,11 +866,11 @@ namespace Dune {
 
       //! Make transforming iterator from iterator (used for automatic conversion of end)
       TransformingSubIterator (const SubIterator& i) :
-        SubIterator(i)
+        SubIterator(i), _orientation(0)
       {}
 
       TransformingSubIterator (const TransformingSubIterator & t) :
-        SubIterator(t), _h(t._h), _begin(t._begin), _position(t._position)
+        SubIterator(t), _h(t._h), _begin(t._begin), _position(t._position), _orientation(t._orientation)
       {}
 
       //! Make iterator pointing to given cell in a grid.
@@ -930,6 +935,18 @@ namespace Dune {
         return _h;
       }
 
+      //! Return shift of the grid in direction i, i.e. position minus coordinate times mesh size
+      ct shift (int i) const
+      {
+        return _begin[i]-this->_origin[i]*_h[i];
+      }
+
+      //! Return orientation of the grid of faces or edges iterated over
+      int orientation () const
+      {
+        return _orientation;
+      }
+
       //! Move cell position by dist cells in direction i.
       void move (int i, int dist)
       {
@@ -950,6 +967,7 @@ namespace Dune {
       fTupel _h;        //!< mesh size per direction
       fTupel _begin;    //!< position of origin of grid
       fTupel _position; //!< current position
+      int _orientation; //!< orientation of the grid (see MultiYGrid::orientation)
     };
 
     //! return iterator to first element of index set
@@ -967,8 +985,11 @@ namespace Dune {
     //! return subiterator to last element of index set
     TransformingSubIterator tsubend () const
     {
-      SubIterator endit = subend();
-      return TransformingSubIterator(endit);
+      // construct from the grid so that mesh size and shift are valid at the end, too
+      iTupel last;
+      for (int i=0; i<d; i++) last[i] = this->max(i);
+      last[0] += 1;
+      return TransformingSubIterator(*this,last);
     }
 
   private:
@@ -1716,9 +1737,31 @@ namespace Dune {
       std::deque<Intersection> send_vertex_interiorborder_overlapfront; // each intersection is a subgrid of overlapfront
       std::deque<Intersection> recv_vertex_overlapfront_interiorborder; // each intersection is a subgrid of overlapfront
 
+      // face and edge (codim 1 and d-1) data, indexed by orientation (see MultiYGrid::orientation)
+      SubYGrid<d,ct> entity_overlapfront[1<<d];   // all entities of one orientation
+      SubYGrid<d,ct> entity_overlap[1<<d];        // subgrid containing only overlap
+      SubYGrid<d,ct> entity_interiorborder[1<<d]; // subgrid containing only interior and border
+      SubYGrid<d,ct> entity_interior[1<<d];       // subgrid containing only interior
+      int entity_offset[1<<d];                    // first consecutive index of entities of one orientation
+
+      std::deque<Intersection> send_entity_overlapfront_overlapfront[1<<d]; // each intersection is a subgrid of overlapfront
+      std::deque<Intersection> recv_entity_overlapfront_overlapfront[1<<d]; // each intersection is a subgrid of overlapfront
+
+      std::deque<Intersection> send_entity_overlap_overlapfront[1<<d]; // each intersection is a subgrid of overlapfront
+      std::deque<Intersection> recv_entity_overlapfront_overlap[1<<d]; // each intersection is a subgrid of overlapfront
+
+      std::deque<Intersection> send_entity_interiorborder_interiorborder[1<<d]; // each intersection is a subgrid of overlapfront
+      std::deque<Intersection> recv_entity_interiorborder_interiorborder[1<<d]; // each intersection is a subgrid of overlapfront
+
+      std::deque<Intersection> send_entity_interiorborder_overlapfront[1<<d]; // each intersection is a subgrid of overlapfront
+      std::deque<Intersection> recv_entity_overlapfront_interiorborder[1<<d]; // each intersection is a subgrid of overlapfront
+
       // general
       MultiYGrid<d,ct>* mg;  // each grid level knows its multigrid
       int overlap;           // in mesh cells on this level
+
+      // vertex positions per direction of tensor product grids, empty for equidistant grids
+      std::vector<ct> coords[d];
     };
 
     //! define types used for arguments
@@ -1821,6 +1864,43 @@ namespace Dune {
       // add level
       _maxlevel++;
       _levels[_maxlevel] = makelevel(_LL,s,_periodic,o_interior,s_interior,overlap);
+
+      // tensor product grids: insert the midpoints of the coarse cells
+      if (!cg.coords[0].empty())
+        for (int i=0; i<d; i++)
+        {
+          const std::vector<ct>& cc = cg.coords[i];
+          std::vector<ct>& fc = _levels[_maxlevel].coords[i];
+          fc.resize(2*cc.size()-1);
+          for (std::size_t j=0; j+1<cc.size(); j++)
+          {
+            fc[2*j] = cc[j];
+            fc[2*j+1] = 0.5*(cc[j]+cc[j+1]);
+          }
+          fc.back() = cc.back();
+        }
+    }
+
+    /*! \brief make the coarsest level a tensor product grid
+
+       coords[i] contains the s[i]+1 vertex positions in direction i in increasing
+       order. The topology of the grid (and therefore the parallel decomposition)
+       does not depend on the coordinates, only the geometry of the entities.
+       Must be called before the grid is refined.
+     */
+    void setCoordinates (const Dune::array<std::vector<ct>,d>& coords)
+    {
+      if (_maxlevel!=0)
+        DUNE_THROW(GridError, "coordinates can only be set on the coarsest level");
+      for (int i=0; i<d; i++)
+      {
+        if (int(coords[i].size())!=_levels[0].cell_global.size(i)+1)
+          DUNE_THROW(GridError, "wrong number of coordinates in direction " << i);
+        for (std::size_t j=0; j+1<coords[i].size(); j++)
+          if (!(coords[i][j]<coords[i][j+1]))
+            DUNE_THROW(GridError, "coordinates in direction " << i << " are not strictly increasing");
+        _levels[0].coords[i] = coords[i];
+      }
     }
 
     //! do a global mesh coarsening; delete _maxlevel level
@@ -1851,6 +1931,42 @@ namespace Dune {
       return _periodic[i];
     }
 
+    /*! \brief number of orientations of the entities of codimension cc
+
+       The orientation of an entity is a bit mask where bit k is set if the
+       entity extends in direction k, i.e. its coordinate in direction k is a
+       cell coordinate, otherwise it is a vertex coordinate. Orientations are
+       available for elements, vertices, faces (codim 1) and edges (codim d-1).
+     */
+    static int orientations (int cc)
+    {
+      if (cc==0 || cc==d) return 1;
+      if (cc==1 || cc==d-1) return d;
+      return 0;
+    }
+
+    /*! \brief the j-th orientation of codimension cc
+
+       The order is the one of the consecutive indices: faces are ordered by
+       their normal direction, edges by decreasing tangential direction.
+     */
+    static int orientation (int cc, int j)
+    {
+      if (cc==0) return (1<<d)-1;
+      if (cc==d) return 0;
+      if (cc==1) return ((1<<d)-1)^(1<<j);
+      return 1<<(d-1-j);
+    }
+
+    //! position of orientation m in the list of orientations of codimension cc, -1 if not found
+    static int orientationIndex (int cc, int m)
+    {
+      for (int j=0; j<orientations(cc); j++)
+        if (orientation(cc,j)==m)
+          return j;
+      return -1;
+    }
+
     //! provides access to a given grid level
     class YGridLevelIterator {
     private:
@@ -1948,6 +2064,41 @@ namespace Dune {
         return i->cell_interior;
       }
 
+      //! return true if this level has tensor product coordinates
+      bool tensor () const
+      {
+        return !i->coords[0].empty();
+      }
+
+      /*! \brief global position of the vertex layer c in direction k
+
+         Works for all vertices of the overlap, in periodic directions the
+         position is shifted by multiples of the domain size.
+       */
+      ct vertexPosition (int k, int c) const
+      {
+        if (!tensor())
+          return c*i->cell_global.meshsize(k);
+        const std::vector<ct>& x = i->coords[k];
+        const int n = x.size()-1;
+        if (c>=0 && c<=n)
+          return x[c];
+        const int q = (c>=0) ? c/n : -((n-1-c)/n);
+        return x[c-q*n] + q*(x[n]-x[0]);
+      }
+
+      //! midpoint and extension of the cell with the given coordinates
+      void cellGeometry (const iTupel& coord, fTupel& midpoint, fTupel& extension) const
+      {
+        for (int k=0; k<d; k++)
+        {
+          const ct lower = vertexPosition(k,coord[k]);
+          const ct upper = vertexPosition(k,coord[k]+1);
+          midpoint[k] = 0.5*(lower+upper);
+          extension[k] = upper-lower;
+        }
+      }
+
 
       //! access to intersection lists
       const std::deque<Intersection>& send_cell_overlap_overlap () const
@@ -2027,6 +2178,66 @@ namespace Dune {
       {
         return i->recv_vertex_overlapfront_interiorborder;
       }
+
+      //! reference to grid of faces or edges with orientation m, up to front
+      const SubYGrid<d,ct>& entity_overlapfront (int m) const
+      {
+        return i->entity_overlapfront[m];
+      }
+      //! reference to overlap grid of faces or edges with orientation m; is subgrid of overlapfront grid
+      const SubYGrid<d,ct>& entity_overlap (int m) const
+      {
+        return i->entity_overlap[m];
+      }
+      //! reference to interiorborder grid of faces or edges with orientation m; is subgrid of overlapfront grid
+      const SubYGrid<d,ct>& entity_interiorborder (int m) const
+      {
+        return i->entity_interiorborder[m];
+      }
+      //! reference to interior grid of faces or edges with orientation m; is subgrid of overlapfront grid
+      const SubYGrid<d,ct>& entity_interior (int m) const
+      {
+        return i->entity_interior[m];
+      }
+      //! first consecutive index of the faces or edges with orientation m
+      int entity_offset (int m) const
+      {
+        return i->entity_offset[m];
+      }
+
+      //! access to intersection lists of faces or edges with orientation m
+      const std::deque<Intersection>& send_entity_overlapfront_overlapfront (int m) const
+      {
+        return i->send_entity_overlapfront_overlapfront[m];
+      }
+      const std::deque<Intersection>& recv_entity_overlapfront_overlapfront (int m) const
+      {
+        return i->recv_entity_overlapfront_overlapfront[m];
+      }
+      const std::deque<Intersection>& send_entity_overlap_overlapfront (int m) const
+      {
+        return i->send_entity_overlap_overlapfront[m];
+      }
+      const std::deque<Intersection>& recv_entity_overlapfront_overlap (int m) const
+      {
+        return i->recv_entity_overlapfront_overlap[m];
+      }
+      const std::deque<Intersection>& send_entity_interiorborder_interiorborder (int m) const
+      {
+        return i->send_entity_interiorborder_interiorborder[m];
+      }
+      const std::deque<Intersection>& recv_entity_interiorborder_interiorborder (int m) const
+      {
+        return i->recv_entity_interiorborder_interiorborder[m];
+      }
+      const std::deque<Intersection>& send_entity_interiorborder_overlapfront (int m) const
+      {
+        return i->send_entity_interiorborder_overlapfront[m];
+      }
+      const std::deque<Intersection>& recv_entity_overlapfront_interiorborder (int m) const
+      {
+        return i->recv_entity_overlapfront_interiorborder[m];
+      }
     };
 
     //! return iterator pointing to coarsest level
@@ -2306,6 +2517,58 @@ namespace Dune {
       intersections(g.vertex_interiorborder,g.vertex_overlapfront,g.cell_global.size(),
                     g.send_vertex_interiorborder_overlapfront,g.recv_vertex_overlapfront_interiorborder);
 
+      // now the faces and edges. In the directions where an entity extends it
+      // takes the ranges of the cell grids, in the other directions those of the vertex grids
+      for (int cc=1; cc<d; cc++)
+      {
+        if (cc!=1 && cc!=d-1) continue; // middle codimensions are not supported
+        int entityoffset = 0;
+        for (int j=0; j<orientations(cc); j++)
+        {
+          const int m = orientation(cc,j);
+          iTupel o_of, s_of, o_o, s_o, o_ib, s_ib, o_i, s_i;
+          for (int i=0; i<d; i++)
+          {
+            if (m&(1<<i))
+            {
+              r[i] = 0.5*h[i];
+              o_of[i] = o_o[i] = g.cell_overlap.origin(i);
+              s_of[i] = s_o[i] = g.cell_overlap.size(i);
+              o_ib[i] = o_i[i] = g.cell_interior.origin(i);
+              s_ib[i] = s_i[i] = g.cell_interior.size(i);
+            }
+            else
+            {
+              r[i] = 0.0;
+              o_of[i] = g.vertex_overlapfront.origin(i); s_of[i] = g.vertex_overlapfront.size(i);
+              o_o[i] = g.vertex_overlap.origin(i); s_o[i] = g.vertex_overlap.size(i);
+              o_ib[i] = g.vertex_interiorborder.origin(i); s_ib[i] = g.vertex_interiorborder.size(i);
+              o_i[i] = g.vertex_interior.origin(i); s_i[i] = g.vertex_interior.size(i);
+            }
+          }
+          g.entity_overlapfront[m] = SubYGrid<d,ct>(YGrid<d,ct>(o_of,s_of,h,r,m));
+          for (int i=0; i<d; i++) offset[i] = o_o[i]-o_of[i];
+          g.entity_overlap[m] = SubYGrid<d,ct>(o_o,s_o,offset,s_of,h,r,m);
+          for (int i=0; i<d; i++) offset[i] = o_ib[i]-o_of[i];
+          g.entity_interiorborder[m] = SubYGrid<d,ct>(o_ib,s_ib,offset,s_of,h,r,m);
+          for (int i=0; i<d; i++) offset[i] = o_i[i]-o_of[i];
+          g.entity_interior[m] = SubYGrid<d,ct>(o_i,s_i,offset,s_of,h,r,m);
+
+          g.entity_offset[m] = entityoffset;
+          entityoffset += g.entity_overlapfront[m].totalsize();
+
+          // compute intersections for this orientation
+          intersections(g.entity_overlapfront[m],g.entity_overlapfront[m],g.cell_global.size(),
+                        g.send_entity_overlapfront_overlapfront[m],g.recv_entity_overlapfront_overlapfront[m]);
+          intersections(g.entity_overlap[m],g.entity_overlapfront[m],g.cell_global.size(),
+                        g.send_entity_overlap_overlapfront[m],g.recv_entity_overlapfront_overlap[m]);
+          intersections(g.entity_interiorborder[m],g.entity_interiorborder[m],g.cell_global.size(),
+                        g.send_entity_interiorborder_interiorborder[m],g.recv_entity_interiorborder_interiorborder[m]);
+          intersections(g.entity_interiorborder[m],g.entity_overlapfront[m],g.cell_global.size(),
+                        g.send_entity_interiorborder_overlapfront[m],g.recv_entity_overlapfront_interiorborder[m]);
+        }
+      }
+
       // return the whole thing
       return g;
     }
@@ -0,0 +1,304 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_YASPGRIDCOMMPLAN_HH
+#define DUNE_GRID_YASPGRIDCOMMPLAN_HH
+
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/grid/common/exceptions.hh>
+#include <dune/grid/yaspgrid/grids.hh>
+
+/** \file
+ * \brief The YaspCommunicationPlan class
+ */
+
+namespace Dune {
+
+  /** \brief Persistent description of one nearest neighbor exchange of a YaspGrid.
+
+     A plan is built once per grid level, codimension, interface and direction.
+     It remembers the send and receive intersections (and therefore the order in
+     which the entities of each message are visited) and owns one buffer per
+     message. Buffers are only enlarged, never released, so repeated exchanges
+     of the same data do not allocate.
+
+     In the parallel case the messages to foreign processes are handled by
+     persistent requests (MPI_Send_init / MPI_Recv_init). They are set up on the
+     first exchange and reused as long as buffer location and message size do not
+     change. Messages to the own process (periodic case) are copied with memcpy.
+
+     The exchange can be split into start() and finish() in order to overlap
+     communication with computation. Only one exchange per plan may be pending.
+
+     The objects communicated through a plan are sent as raw bytes, i.e. the data
+     type of a data handle must be trivially copyable (as for Torus::exchange).
+   */
+  template<int d, typename ct>
+  class YaspCommunicationPlan
+  {
+  public:
+    typedef typename MultiYGrid<d,ct>::Intersection Intersection;
+
+    //! one message to or from a neighboring process
+    struct Message
+    {
+      const Intersection* is;         // the subgrid and the partner process
+      std::size_t bytes;              // size of the current payload in bytes
+      std::vector<char> buffer;       // payload buffer, only grows
+      std::vector<std::size_t> sizes; // number of objects per entity (variable size only)
+    };
+
+    //! make a plan for the given send and receive lists
+    YaspCommunicationPlan (const Torus<d>& torus,
+                           const std::deque<Intersection>& sendlist,
+                           const std::deque<Intersection>& recvlist)
+      : _torus(torus), _sends(sendlist.size()), _recvs(recvlist.size()), _pending(false)
+    {
+      int cnt=0;
+      for (typename std::deque<Intersection>::const_iterator is=sendlist.begin(); is!=sendlist.end(); ++is)
+        init(_sends[cnt++],*is);
+      cnt=0;
+      for (typename std::deque<Intersection>::const_iterator is=recvlist.begin(); is!=recvlist.end(); ++is)
+        init(_recvs[cnt++],*is);
+    }
+
+    ~YaspCommunicationPlan ()
+    {
+#if HAVE_MPI
+      // active requests must not be freed
+      if (_pending && !_requests.empty())
+        MPI_Waitall(_requests.size(),&_requests[0],MPI_STATUSES_IGNORE);
+#endif
+      freeRequests();
+    }
+
+    //! number of messages to be sent
+    int sends () const
+    {
+      return _sends.size();
+    }
+
+    //! number of messages to be received
+    int recvs () const
+    {
+      return _recvs.size();
+    }
+
+    //! access to i-th message to be sent
+    Message& send (int i)
+    {
+      return _sends[i];
+    }
+
+    //! access to i-th message to be received
+    Message& recv (int i)
+    {
+      return _recvs[i];
+    }
+
+    //! resize payload of i-th send message to n objects of type T and return pointer to it
+    template<class T>
+    T* sendBuffer (int i, std::size_t n)
+    {
+      return static_cast<T*>(reserve(_sends[i],n*sizeof(T)));
+    }
+
+    //! resize payload of i-th receive message to n objects of type T and return pointer to it
+    template<class T>
+    T* recvBuffer (int i, std::size_t n)
+    {
+      return static_cast<T*>(reserve(_recvs[i],n*sizeof(T)));
+    }
+
+    //! return pointer to current payload of i-th send message
+    template<class T>
+    T* sendBuffer (int i)
+    {
+      return reinterpret_cast<T*>(&_sends[i].buffer[0]);
+    }
+
+    //! return pointer to current payload of i-th receive message
+    template<class T>
+    T* recvBuffer (int i)
+    {
+      return reinterpret_cast<T*>(&_recvs[i].buffer[0]);
+    }
+
+    //! exchange the entity sizes stored in the messages (variable size case)
+    void exchangeSizes () const
+    {
+      for (std::size_t i=0; i<_sends.size(); i++)
+        _torus.send(_sends[i].is->rank,
+                    const_cast<std::size_t*>(&_sends[i].sizes[0]),
+                    _sends[i].sizes.size()*sizeof(std::size_t));
+      for (std::size_t i=0; i<_recvs.size(); i++)
+        _torus.recv(_recvs[i].is->rank,
+                    const_cast<std::size_t*>(&_recvs[i].sizes[0]),
+                    _recvs[i].sizes.size()*sizeof(std::size_t));
+      _torus.exchange();
+    }
+
+    //! exchange the payloads of all messages; returns when all messages are complete
+    void exchange ()
+    {
+      start();
+      finish();
+    }
+
+    //! start the exchange of the payloads; buffers must not be touched until finish() is called
+    void start ()
+    {
+      if (_pending)
+        DUNE_THROW(GridError, "communication plan is already in use by a pending exchange");
+      _pending = true;
+
+      // handle local requests first, they are matched in order
+      std::size_t j=0;
+      for (std::size_t i=0; i<_sends.size(); i++)
+      {
+        if (_sends[i].is->rank!=_torus.rank()) continue;
+        while (j<_recvs.size() && _recvs[j].is->rank!=_torus.rank()) j++;
+        if (j==_recvs.size())
+        {
+          _pending = false;
+          DUNE_THROW(GridError, "[" << _torus.rank() << "]: local send of " << _sends[i].bytes
+                     << " bytes has no matching local receive");
+        }
+        if (_sends[i].bytes!=_recvs[j].bytes)
+        {
+          _pending = false;
+          DUNE_THROW(GridError, "[" << _torus.rank() << "]: local send of " << _sends[i].bytes
+                     << " bytes does not match local receive of " << _recvs[j].bytes << " bytes");
+        }
+        memcpy(&_recvs[j].buffer[0],&_sends[i].buffer[0],_sends[i].bytes);
+        j++;
+      }
+
+#if HAVE_MPI
+      // (re)build the persistent requests if buffers have moved or sizes have changed
+      if (!requestsValid())
+      {
+        freeRequests();
+        for (std::size_t i=0; i<_sends.size(); i++)
+          if (_sends[i].is->rank!=_torus.rank())
+            addRequest(_sends[i],true);
+        for (std::size_t i=0; i<_recvs.size(); i++)
+          if (_recvs[i].is->rank!=_torus.rank())
+            addRequest(_recvs[i],false);
+      }
+
+      // start all messages
+      if (!_requests.empty())
+        MPI_Startall(_requests.size(),&_requests[0]);
+#endif
+    }
+
+    //! wait for the completion of an exchange issued by start()
+    void finish ()
+    {
+      if (!_pending)
+        DUNE_THROW(GridError, "communication plan has no pending exchange");
+#if HAVE_MPI
+      if (!_requests.empty())
+        MPI_Waitall(_requests.size(),&_requests[0],MPI_STATUSES_IGNORE);
+#endif
+      _pending = false;
+    }
+
+    //! true if an exchange has been started but not finished
+    bool pending () const
+    {
+      return _pending;
+    }
+
+  private:
+    // not copyable, the plan owns persistent requests
+    YaspCommunicationPlan (const YaspCommunicationPlan&);
+    YaspCommunicationPlan& operator= (const YaspCommunicationPlan&);
+
+    void init (Message& m, const Intersection& is)
+    {
+      m.is = &is;
+      m.bytes = 0;
+      m.buffer.resize(1); // always keep a valid buffer address
+      m.sizes.resize(is.grid.totalsize());
+    }
+
+    void* reserve (Message& m, std::size_t bytes)
+    {
+      if (bytes>m.buffer.size())
+        m.buffer.resize(bytes);
+      m.bytes = bytes;
+      return &m.buffer[0];
+    }
+
+#if HAVE_MPI
+    void addRequest (const Message& m, bool send)
+    {
+      MPI_Request request;
+      void* buffer = const_cast<char*>(&m.buffer[0]);
+      if (send)
+        MPI_Send_init(buffer,m.bytes,MPI_BYTE,m.is->rank,_torus.tag(),_torus.comm(),&request);
+      else
+        MPI_Recv_init(buffer,m.bytes,MPI_BYTE,m.is->rank,_torus.tag(),_torus.comm(),&request);
+      _requests.push_back(request);
+      _requestBuffers.push_back(&m.buffer[0]);
+      _requestBytes.push_back(m.bytes);
+    }
+
+    bool requestsValid () const
+    {
+      std::size_t k=0;
+      for (std::size_t i=0; i<_sends.size(); i++)
+        if (_sends[i].is->rank!=_torus.rank())
+        {
+          if (k>=_requestBuffers.size()
+              || _requestBuffers[k]!=&_sends[i].buffer[0] || _requestBytes[k]!=_sends[i].bytes)
+            return false;
+          k++;
+        }
+      for (std::size_t i=0; i<_recvs.size(); i++)
+        if (_recvs[i].is->rank!=_torus.rank())
+        {
+          if (k>=_requestBuffers.size()
+              || _requestBuffers[k]!=&_recvs[i].buffer[0] || _requestBytes[k]!=_recvs[i].bytes)
+            return false;
+          k++;
+        }
+      return k==_requestBuffers.size();
+    }
+#endif
+
+    void freeRequests ()
+    {
+#if HAVE_MPI
+      for (std::size_t i=0; i<_requests.size(); i++)
+        MPI_Request_free(&_requests[i]);
+      _requests.clear();
+      _requestBuffers.clear();
+      _requestBytes.clear();
+#endif
+    }
+
+    const Torus<d>& _torus;
+    std::vector<Message> _sends;
+    std::vector<Message> _recvs;
+    bool _pending;
+#if HAVE_MPI
+    std::vector<MPI_Request> _requests;
+    std::vector<const char*> _requestBuffers;
+    std::vector<std::size_t> _requestBytes;
+#endif
+  };
+
+}
+
+#endif   // DUNE_GRID_YASPGRIDCOMMPLAN_HH
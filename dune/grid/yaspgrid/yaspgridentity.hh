@@ -10,7 +10,8 @@
 
    We have specializations for codim==0 (elements) and
    codim=dim (vertices).
-   The general version throws a GridError.
+   The general version implements faces (codim 1) and edges (codim dim-1),
+   other codimensions are not supported.
  */
 //========================================================================
 
@@ -24,83 +25,140 @@ namespace Dune {
   class YaspEntity
     :  public EntityDefaultImplementation <codim,dim,GridImp,YaspEntity>
   {
+    typedef typename GridImp::Traits::template Codim<codim>::GeometryImpl GeometryImpl;
+
   public:
     typedef typename GridImp::ctype ctype;
 
+    typedef typename MultiYGrid<dim,ctype>::YGridLevelIterator YGLI;
+    typedef typename SubYGrid<dim,ctype>::TransformingSubIterator TSI;
+
     typedef typename GridImp::template Codim<codim>::Geometry Geometry;
+    typedef typename GridImp::template Codim<codim>::EntitySeed EntitySeed;
+
+    //! define the type used for persisitent indices
+    typedef typename GridImp::PersistentIndexType PersistentIndexType;
+
+    //! define type used for coordinates in grid module
+    typedef typename YGrid<dim,ctype>::iTupel iTupel;
+
+    // constructor
+    YaspEntity (const GridImp* yg, const YGLI& g, const TSI& it)
+      : _yg(yg), _it(it), _g(g)
+    {}
 
     //! level of this element
-    int level () const
-    {
-      DUNE_THROW(GridError, "YaspEntity not implemented");
-    }
+    int level () const { return _g.level(); }
 
-    //! index is unique and consecutive per level and codim used for access to degrees of freedom
-    int index () const
-    {
-      DUNE_THROW(GridError, "YaspEntity not implemented");
+    //! index is unique and consecutive per level
+    int index () const { return compressedIndex(); }
+
+    /** \brief Return the entity seed which contains sufficient information
+     *  to generate the entity again and uses as little memory as possible
+     */
+    EntitySeed seed () const {
+      return EntitySeed(YaspEntitySeed<codim,GridImp>(_g.level(), _it.coord(), _it.orientation()));
     }
 
     //! geometry of this entity
     Geometry geometry () const
     {
-      DUNE_THROW(GridError, "YaspEntity not implemented");
+      // the entity extends in the directions of its orientation
+      const int m = _it.orientation();
+      FieldVector<ctype,dim> lower, upper;
+      std::bitset<dim> axes;
+      for (int k=0; k<dim; k++)
+      {
+        lower[k] = _g.vertexPosition(k,_it.coord(k));
+        axes[k] = (m&(1<<k));
+        upper[k] = axes[k] ? _g.vertexPosition(k,_it.coord(k)+1) : lower[k];
+      }
+      return Geometry( GeometryImpl(lower,upper,axes) );
     }
 
     //! return partition type attribute
     PartitionType partitionType () const
     {
-      DUNE_THROW(GridError, "YaspEntity not implemented");
+      const int m = _it.orientation();
+      if (_g.entity_interior(m).inside(_it.coord())) return InteriorEntity;
+      if (_g.entity_interiorborder(m).inside(_it.coord())) return BorderEntity;
+      if (_g.entity_overlap(m).inside(_it.coord())) return OverlapEntity;
+      if (_g.entity_overlapfront(m).inside(_it.coord())) return FrontEntity;
+      return GhostEntity;
+    }
+
+    //! subentity compressed index, available for the entity itself and its vertices
+    int subCompressedIndex (int i, unsigned int cc) const
+    {
+      if (cc==codim)
+        return compressedIndex();
+      if (cc==dim)
+      {
+        // vertex i of the entity, its bits refer to the directions the entity extends in
+        const int m = _it.orientation();
+        int index = 0;
+        for (int k=dim-1, bit=dim-codim-1; k>=0; --k)
+        {
+          int c = _it.coord(k)-_g.cell_overlap().origin(k);
+          if (m&(1<<k))
+          {
+            if (i&(1<<bit)) c++;
+            bit--;
+          }
+          index = index*(_g.cell_overlap().size(k)+1)+c;
+        }
+        return index;
+      }
+      DUNE_THROW(NotImplemented,"subIndex for codim " << cc << " of entities with codimension " << codim << " is not implemented");
+      return -1;
     }
 
-    const GridImp * yaspgrid() const
+    //! compressed indices of all subentities of codim cc
+    template<class OutputIterator>
+    OutputIterator subCompressedIndices (int cc, OutputIterator out) const
     {
-      DUNE_THROW(GridError, "YaspEntity not implemented");
+      const int n = (cc==dim) ? (1<<(dim-codim)) : 1;
+      for (int i=0; i<n; ++i, ++out)
+        *out = subCompressedIndex(i,cc);
+      return out;
     }
 
-    typedef typename MultiYGrid<dim,ctype>::YGridLevelIterator YGLI;
-    typedef typename SubYGrid<dim,ctype>::TransformingSubIterator TSI;
-    YaspEntity (const GridImp* yg, const YGLI& g, const TSI& it)
+    //! subentity compressed leaf index
+    int subCompressedLeafIndex (int i, unsigned int cc) const
     {
-      DUNE_THROW(GridError, "YaspEntity not implemented");
+      return subCompressedIndex(i,cc);
     }
 
+    const TSI& transformingsubiterator () const { return _it; }
+    const YGLI& gridlevel () const { return _g; }
+    const GridImp * yaspgrid () const { return _yg; }
+
+  private:
     // IndexSets needs access to the private index methods
     friend class Dune::YaspIndexSet<GridImp>;
     friend class Dune::YaspGlobalIdSet<GridImp>;
-    typedef typename GridImp::PersistentIndexType PersistentIndexType;
 
     //! globally unique, persistent index
     PersistentIndexType persistentIndex () const
     {
-      DUNE_THROW(GridError, "YaspEntity not implemented");
+      return YaspEntity<0,dim,GridImp>::entityPersistentIndex(_g,_it.coord(),_it.orientation(),codim);
     }
 
     //! consecutive, codim-wise, level-wise index
     int compressedIndex () const
     {
-      DUNE_THROW(GridError, "YaspEntity not implemented");
+      return _g.entity_offset(_it.orientation())+_it.superindex();
     }
 
     //! consecutive, codim-wise, level-wise index
     int compressedLeafIndex () const
     {
-      DUNE_THROW(GridError, "YaspEntity not implemented");
-    }
-
-    //! subentity compressed index (not available here)
-    int subCompressedIndex (int, unsigned int ) const
-    {
-      DUNE_THROW(NotImplemented,"subIndex for entities with codimension > 0 is not implemented");
-      return -1;
+      return compressedIndex();
     }
 
-    //! subentity compressed leaf index (not available here)
-    int subCompressedLeafIndex (int, unsigned int ) const
-    {
-      DUNE_THROW(NotImplemented,"subIndex for entities with codimension > 0 is not implemented");
-      return -1;
-    }
+    const GridImp * _yg;    // access to YaspGrid
+    const TSI& _it;         // position in the grid level
+    const YGLI& _g;         // access to grid level
   };
 
 
@@ -177,6 +235,12 @@ namespace Dune {
     //! geometry of this entity
     Geometry geometry () const {
       // the element geometry
+      if (_g.tensor())
+      {
+        FieldVector<ctype,dim> midpoint, extension;
+        _g.cellGeometry(_it.coord(),midpoint,extension);
+        return Geometry( GeometryImpl(midpoint,extension) );
+      }
       GeometryImpl _geometry(_it.position(),_it.meshsize());
       return Geometry( _geometry );
     }
@@ -197,8 +261,8 @@ namespace Dune {
     template<int cc>
     typename Codim<cc>::EntityPointer subEntity (int i) const
     {
-      dune_static_assert( cc == dim || cc == 0 ,
-                          "YaspGrid only supports Entities with codim=dim and codim=0");
+      dune_static_assert( cc == dim || cc == 0 || cc == 1 || cc == dim-1,
+                          "YaspGrid only supports Entities with codim 0, 1, dim-1 and dim");
       // coordinates of the cell == coordinates of lower left corner
       if (cc==dim)
       {
@@ -214,6 +278,29 @@ namespace Dune {
       {
         return YaspEntityPointer<cc,GridImp>(_yg,_g,_it);
       }
+      if (cc==1) // faces, numbered as in subCompressedIndex
+      {
+        int ivar=i/2;
+        iTupel coord = _it.coord();
+        if (i%2) coord[ivar] += 1;
+        return YaspEntityPointer<cc,GridImp>(_yg,_g,_g.entity_overlapfront(((1<<dim)-1)^(1<<ivar)).tsubbegin(coord));
+      }
+      if (cc==dim-1) // edges, numbered as in subCompressedIndex
+      {
+        static unsigned int edge[ 12 ] = { 0, 1, 2, 3, 4, 5, 8, 9, 6, 7, 10, 11 };
+        i = edge[i];
+        int m=1<<(dim-1);
+        int ifix=(dim-1)-(i/m);
+        iTupel coord = _it.coord();
+        int bit=1;
+        for (int k=0; k<dim; k++)
+        {
+          if (k==ifix) continue;
+          if ((i%m)&bit) coord[k] += 1;
+          bit *= 2;
+        }
+        return YaspEntityPointer<cc,GridImp>(_yg,_g,_g.entity_overlapfront(1<<ifix).tsubbegin(coord));
+      }
       DUNE_THROW(GridError, "codim " << cc << " (dim=" << dim << ") not (yet) implemented");
     }
 
@@ -344,6 +431,46 @@ namespace Dune {
       return YaspHierarchicIterator<GridImp>(_yg,_g,_it,_g.level());
     }
 
+    /*! \brief globally unique, persistent index of a face or an edge
+
+       The entity is given by its coordinates and orientation on the grid level.
+       Ids are assigned using the doubled grid, i.e. a coordinate c becomes
+       2c+1 in the directions the entity extends in and 2c otherwise.
+     */
+    static PersistentIndexType entityPersistentIndex (const YGLI& g, const iTupel& coord, int m, int cc)
+    {
+      const iTupel& size = g.cell_global().size();
+
+      // adjust for periodic boundaries and transform to the doubled grid
+      int c[dim];
+      for (int k=0; k<dim; k++)
+      {
+        c[k] = coord[k];
+        if (g.mg()->periodic(k))
+        {
+          if (c[k]<0) c[k] += size[k];
+          if (c[k]>=size[k]) c[k] -= size[k];
+        }
+        c[k] = 2*c[k] + ((m&(1<<k)) ? 1 : 0);
+      }
+
+      // encode codim
+      PersistentIndexType id(cc);
+
+      // encode level
+      id = id << yaspgrid_level_bits;
+      id = id+PersistentIndexType(g.level());
+
+      // encode coordinates
+      for (int k=dim-1; k>=0; k--)
+      {
+        id = id << yaspgrid_dim_bits;
+        id = id+PersistentIndexType(c[k]);
+      }
+
+      return id;
+    }
+
   private:
     // IndexSets needs access to the private index methods
     friend class Dune::YaspIndexSet<GridImp>;
@@ -452,34 +579,14 @@ namespace Dune {
 
       if (cc==1) // faces, i.e. for dim=2 codim=1 is treated as a face
       {
-        // Idea: Use the doubled grid to assign coordinates to faces
-
         // ivar is the direction that varies
         int ivar=i/2;
 
-        // compute position from cell position
-        for (int k=0; k<dim; k++)
-          coord[k] = coord[k]*2 + 1; // the doubled grid
-        if (i%2)
-          coord[ivar] += 1;
-        else
-          coord[ivar] -= 1;
-
-        // encode codim
-        PersistentIndexType id(1);
-
-        // encode level
-        id = id << yaspgrid_level_bits;
-        id = id+PersistentIndexType(_g.level());
-
-        // encode coordinates
-        for (int i=dim-1; i>=0; i--)
-        {
-          id = id << yaspgrid_dim_bits;
-          id = id+PersistentIndexType(coord[i]);
-        }
+        // face coordinates, the face does not extend in direction ivar
+        iTupel ecoord = _it.coord();
+        if (i%2) ecoord[ivar] += 1;
 
-        return id;
+        return entityPersistentIndex(_g,ecoord,((1<<dim)-1)^(1<<ivar),1);
       }
 
       // map to old numbering
@@ -496,31 +603,17 @@ namespace Dune {
         // ifix is the direction that is fixed
         int ifix=(dim-1)-(i/m);
 
-        // compute position from cell position
+        // edge coordinates, the edge extends in direction ifix only
+        iTupel ecoord = _it.coord();
         int bit=1;
         for (int k=0; k<dim; k++)
         {
-          coord[k] = coord[k]*2+1;   // cell position in doubled grid
           if (k==ifix) continue;
-          if ((i%m)&bit) coord[k] += 1;else coord[k] -= 1;
+          if ((i%m)&bit) ecoord[k] += 1;
           bit *= 2;
         }
 
-        // encode codim
-        PersistentIndexType id(dim-1);
-
-        // encode level
-        id = id << yaspgrid_level_bits;
-        id = id+PersistentIndexType(_g.level());
-
-        // encode coordinates
-        for (int i=dim-1; i>=0; i--)
-        {
-          id = id << yaspgrid_dim_bits;
-          id = id+PersistentIndexType(coord[i]);
-        }
-
-        return id;
+        return entityPersistentIndex(_g,ecoord,1<<ifix,dim-1);
       }
 
       DUNE_THROW(GridError, "codim " << cc << " (dim=" << dim << ") not (yet) implemented");
@@ -626,6 +719,43 @@ namespace Dune {
       DUNE_THROW(GridError, "codim " << cc << " (dim=" << dim << ") not (yet) implemented");
     }
 
+    /*! compressed indices of all subentities of codim cc
+
+       For vertices the index of the first corner is computed once, the
+       other corners follow by adding the strides of the vertex grid.
+     */
+    template<class OutputIterator>
+    OutputIterator subCompressedIndices (int cc, OutputIterator out) const
+    {
+      if (cc==dim) // vertices
+      {
+        // lexicographic index of corner 0 and strides of the vertex grid
+        int base = _it.coord(dim-1)-_g.cell_overlap().origin(dim-1);
+        for (int k=dim-2; k>=0; --k)
+          base = (base*(_g.cell_overlap().size(k)+1))+(_it.coord(k)-_g.cell_overlap().origin(k));
+        int stride[dim];
+        stride[0] = 1;
+        for (int k=1; k<dim; ++k)
+          stride[k] = stride[k-1]*(_g.cell_overlap().size(k-1)+1);
+
+        for (int i=0; i<(1<<dim); ++i, ++out)
+        {
+          int index = base;
+          for (int k=0; k<dim; ++k)
+            if (i&(1<<k)) index += stride[k];
+          *out = index;
+        }
+        return out;
+      }
+
+      int n = 1;
+      if (cc==1) n = 2*dim;
+      else if (cc==dim-1) n = dim*(1<<(dim-1));
+      for (int i=0; i<n; ++i, ++out)
+        *out = subCompressedIndex(i,cc);
+      return out;
+    }
+
     //! subentity compressed index
     int subCompressedLeafIndex (int i, int cc) const
     {
@@ -791,6 +921,13 @@ namespace Dune {
 
     //! geometry of this entity
     Geometry geometry () const {
+      if (_g.tensor())
+      {
+        FieldVector<ctype,dim> position;
+        for (int k=0; k<dim; k++)
+          position[k] = _g.vertexPosition(k,_it.coord(k));
+        return Geometry( GeometryImpl(position) );
+      }
       GeometryImpl _geometry(_it.position());
       return Geometry( _geometry );
     }
@@ -811,6 +948,14 @@ namespace Dune {
       return compressedIndex();
     }
 
+    //! the only subentity of a vertex is the vertex itself
+    template<class OutputIterator>
+    OutputIterator subCompressedIndices (int, OutputIterator out) const
+    {
+      *out = compressedIndex();
+      return ++out;
+    }
+
     //! subentity compressed leaf index simply returns compressedLeafIndex
     int subCompressedLeafIndex (int, unsigned int ) const
     {
@@ -21,22 +21,24 @@ namespace Dune {
     //! codimension of entity pointer
     enum { codimension = codim };
 
-    //! constructor
-    YaspEntitySeed (int level, FieldVector<int, dim> coord)
-      : _l(level), _c(coord)
+    //! constructor, the orientation is only needed for faces and edges
+    YaspEntitySeed (int level, FieldVector<int, dim> coord, int orientation = 0)
+      : _l(level), _c(coord), _o(orientation)
     {}
 
     //! copy constructor
     YaspEntitySeed (const YaspEntitySeed& rhs)
-      : _l(rhs._l), _c(rhs._c)
+      : _l(rhs._l), _c(rhs._c), _o(rhs._o)
     {}
 
     int level () const { return _l; }
     const FieldVector<int, dim> & coord() const { return _c; }
+    int orientation () const { return _o; }
 
   protected:
     int _l;                  // grid level
     FieldVector<int, dim> _c; // coord in the global grid
+    int _o;                  // orientation (see MultiYGrid::orientation)
   };
 
 }  // namespace Dune
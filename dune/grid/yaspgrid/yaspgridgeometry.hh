@@ -10,12 +10,12 @@
 
    We have specializations for dim == dimworld (elements) and dim == 0
    (vertices).  The general version implements dim == dimworld-1 (faces)
-   and otherwise throws a GridError.
+   and entities of any dimension given by their lower and upper corner.
  */
 
 namespace Dune {
 
-  //! The general version can do any dimension, but constructors currently exist only for dim==dimworld-1
+  //! The general version can do any dimension, the midpoint constructor exists only for dim==dimworld-1
   template<int mydim,int cdim, class GridImp>
   class YaspGeometry : public AxisAlignedCubeGeometry<typename GridImp::ctype,mydim,cdim>
   {
@@ -49,6 +49,11 @@ namespace Dune {
       static_cast< AxisAlignedCubeGeometry<ctype,mydim,cdim> & >( *this ) = AxisAlignedCubeGeometry<ctype,mydim,cdim>(lower, upper, axes);
     }
 
+    //! constructor from lower and upper corner and the directions the entity extends in
+    YaspGeometry (const FieldVector<ctype, cdim>& lower, const FieldVector<ctype, cdim>& upper, const std::bitset<cdim>& axes)
+      : AxisAlignedCubeGeometry<ctype,mydim,cdim>(lower, upper, axes)
+    {}
+
     //! copy constructor
     YaspGeometry (const YaspGeometry& other)
       : AxisAlignedCubeGeometry<ctype,mydim,cdim>(other)
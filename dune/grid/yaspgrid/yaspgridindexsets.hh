@@ -37,7 +37,7 @@ namespace Dune {
     template<int cc>
     IndexType index (const typename GridImp::Traits::template Codim<cc>::Entity& e) const
     {
-      assert( cc == 0 || cc == GridImp::dimension );
+      assert( cc == 0 || cc == 1 || cc == GridImp::dimension-1 || cc == GridImp::dimension );
       return grid.getRealImplementation(e).compressedIndex();
     }
 
@@ -46,13 +46,28 @@ namespace Dune {
     IndexType subIndex ( const typename remove_const< GridImp >::type::Traits::template Codim< cc >::Entity &e,
                          int i, unsigned int codim ) const
     {
-      assert( cc == 0 || cc == GridImp::dimension );
+      assert( cc == 0 || cc == 1 || cc == GridImp::dimension-1 || cc == GridImp::dimension );
       if( cc == GridImp::dimension )
         return grid.getRealImplementation(e).compressedIndex();
       else
         return grid.getRealImplementation(e).subCompressedIndex(i,codim);
     }
 
+    //! get indices of all subentities of given codim of an entity in one pass
+    template< int cc, class OutputIterator >
+    OutputIterator subIndices ( const typename remove_const< GridImp >::type::Traits::template Codim< cc >::Entity &e,
+                                unsigned int codim, OutputIterator out ) const
+    {
+      assert( cc == 0 || cc == 1 || cc == GridImp::dimension-1 || cc == GridImp::dimension );
+      if( cc == GridImp::dimension )
+      {
+        *out = grid.getRealImplementation(e).compressedIndex();
+        return ++out;
+      }
+      else
+        return grid.getRealImplementation(e).subCompressedIndices(codim,out);
+    }
+
     //! get number of entities of given type and level (the level is known to the object)
     int size (GeometryType type) const
     {
@@ -84,6 +99,13 @@ namespace Dune {
     std::vector<GeometryType> mytypes[GridImp::dimension+1];
   };
 
+  //! YaspIndexSet computes all subentity indices of an element in one pass
+  template<class GridImp>
+  struct IndexSetHasSubIndices< YaspIndexSet< GridImp > >
+  {
+    static const bool v = true;
+  };
+
 }   // namespace Dune
 
 #endif  // DUNE_GRID_YASPGRIDINDEXSET_HH
@@ -238,6 +238,14 @@ namespace Dune {
     Geometry geometry () const
     {
       update();
+      if (_inside.gridlevel().tensor())
+      {
+        // face of the inside cell, computed from the coordinate vectors
+        FieldVector<ctype, dimworld> midpoint, extension;
+        _inside.gridlevel().cellGeometry(_inside.transformingsubiterator().coord(),midpoint,extension);
+        midpoint[_dir] += (-0.5+_face)*extension[_dir];
+        return Geometry( GeometryImpl(midpoint,extension,_dir) );
+      }
       GeometryImpl
       _is_global(_pos_world,_inside.transformingsubiterator().meshsize(),_dir);
       return Geometry( _is_global );
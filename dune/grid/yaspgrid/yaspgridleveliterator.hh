@@ -38,6 +38,36 @@ namespace Dune {
     void increment()
     {
       ++(this->_it);
+
+      // faces and edges: at the end of one orientation continue with the next nonempty one
+      if (codim>0 && codim<dim)
+      {
+        const int m = this->_it.orientation();
+        if (this->_it!=entityGrid(this->_g,m).tsubend())
+          return;
+        const int n = MultiYGrid<dim,ctype>::orientations(codim);
+        for (int j=MultiYGrid<dim,ctype>::orientationIndex(codim,m)+1; j<n; j++)
+        {
+          const SubYGrid<dim,ctype>& grid = entityGrid(this->_g,MultiYGrid<dim,ctype>::orientation(codim,j));
+          if (!grid.empty())
+          {
+            this->_it = grid.tsubbegin();
+            return;
+          }
+        }
+      }
+    }
+
+    //! the grid of faces or edges of orientation m iterated for the partition type
+    static const SubYGrid<dim,ctype>& entityGrid (const YGLI& g, int m)
+    {
+      if (pitype==Interior_Partition)
+        return g.entity_interior(m);
+      if (pitype==InteriorBorder_Partition)
+        return g.entity_interiorborder(m);
+      if (pitype==Overlap_Partition)
+        return g.entity_overlap(m);
+      return g.entity_overlapfront(m);
     }
   };
 
@@ -0,0 +1,23 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+#include "yaspgridthreads.hh"
+
+bool Dune::Yasp::threadsAvailable ()
+{
+#ifdef _OPENMP
+  return true;
+#else
+  return false;
+#endif
+}
+
+void Dune::Yasp::parallelFor (int n, void (*task)(int, void*), void* context)
+{
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i=0; i<n; i++)
+    task(i,context);
+}
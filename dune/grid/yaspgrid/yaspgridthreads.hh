@@ -0,0 +1,34 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_YASPGRIDTHREADS_HH
+#define DUNE_GRID_YASPGRIDTHREADS_HH
+
+/** \file
+ * \brief Threaded loops used by the communication of YaspGrid
+
+   The loops are compiled into libdunegrid, so whether they use several
+   threads only depends on how the library was built.  The inline templates
+   of YaspGrid are the same in all translation units, whether these are
+   compiled with OpenMP or not.
+ */
+
+namespace Dune {
+
+  namespace Yasp {
+
+    //! whether libdunegrid was compiled with OpenMP
+    bool threadsAvailable ();
+
+    /** \brief call task(i,context) for i=0,...,n-1
+
+       If libdunegrid was compiled with OpenMP, the calls are distributed
+       over several threads, otherwise they are done in order.  The task
+       must not throw.
+     */
+    void parallelFor (int n, void (*task)(int, void*), void* context);
+
+  } // end namespace Yasp
+
+} // end namespace Dune
+
+#endif
@@ -7,6 +7,9 @@ AC_DEFUN([DUNE_GRID_CHECKS],[
   AC_REQUIRE([DUNE_PATH_AMIRAMESH])
   AC_REQUIRE([DUNE_PATH_PSURFACE])
   AC_REQUIRE([DUNE_PATH_ALUGRID])
+  AC_REQUIRE([DUNE_PATH_ZLIB])
+  AC_REQUIRE([DUNE_PATH_PTHREAD])
+  AC_REQUIRE([DUNE_PATH_OPENMP])
   AC_REQUIRE([DUNE_EXPERIMENTAL_GRID_EXTENSIONS])
 
   DUNE_DEFINE_GRIDTYPE([ONEDGRID],[(GRIDDIM == 1) && (WORLDDIM == 1)],[Dune::OneDGrid],[dune/grid/onedgrid.hh],[dune/grid/io/file/dgfparser/dgfoned.hh])
@@ -0,0 +1,64 @@
+## -*- autoconf -*-
+# searches for OpenMP, which is used for threaded communication in YaspGrid,
+# compressed VTK output and the Gmsh reader
+
+# DUNE_PATH_OPENMP()
+#
+# shell variables:
+#   with_openmp
+#     no or yes
+#   OPENMP_CXXFLAGS
+#   HAVE_OPENMP
+#     1 or undef
+#
+# substitutions:
+#   OPENMP_CXXFLAGS
+#
+# defines:
+#   HAVE_OPENMP
+#
+# conditionals:
+#   OPENMP
+#
+# The flags are not added to the global flags, since the threaded code paths
+# are only compiled by programs that enable OpenMP themselves.
+AC_DEFUN([DUNE_PATH_OPENMP],[
+  AC_REQUIRE([AC_PROG_CXX])
+
+  AC_ARG_WITH(openmp,
+    AC_HELP_STRING([--without-openmp],[do not build the OpenMP variants of the tests]))
+
+with_openmp_found="no"
+HAVE_OPENMP=0
+if test x$with_openmp != xno ; then
+  AC_LANG_PUSH([C++])
+  # AC_OPENMP sets OPENMP_CXXFLAGS, empty if the compiler needs no flag
+  AC_OPENMP
+  ac_save_CXXFLAGS="$CXXFLAGS"
+  CXXFLAGS="$CXXFLAGS $OPENMP_CXXFLAGS"
+  AC_LINK_IFELSE([AC_LANG_PROGRAM([[#include <omp.h>]],
+      [[#ifndef _OPENMP
+        choke me
+        #endif
+        return omp_get_max_threads() < 1;]])],
+    [HAVE_OPENMP=1])
+  CXXFLAGS="$ac_save_CXXFLAGS"
+  AC_LANG_POP([C++])
+fi
+
+if test x$HAVE_OPENMP = x1 ; then
+  AC_DEFINE(HAVE_OPENMP, 1, [Define to 1 if the compiler supports OpenMP])
+
+  # set variable for summary
+  with_openmp_found="yes"
+else
+  OPENMP_CXXFLAGS=""
+fi
+AC_SUBST(OPENMP_CXXFLAGS, $OPENMP_CXXFLAGS)
+
+# also tell automake
+AM_CONDITIONAL(OPENMP, test x$HAVE_OPENMP = x1)
+
+DUNE_ADD_SUMMARY_ENTRY([OpenMP],[$with_openmp_found])
+
+])
@@ -0,0 +1,62 @@
+## -*- autoconf -*-
+# searches for pthreads, which are used for asynchronous VTK output
+
+# DUNE_PATH_PTHREAD()
+#
+# shell variables:
+#   with_pthread
+#     no or yes
+#   PTHREAD_LIBS
+#   HAVE_PTHREAD
+#     1 or undef
+#
+# substitutions:
+#   PTHREAD_LIBS
+#
+# defines:
+#   HAVE_PTHREAD
+#
+# conditionals:
+#   PTHREAD
+AC_DEFUN([DUNE_PATH_PTHREAD],[
+  AC_REQUIRE([AC_PROG_CXX])
+
+  AC_ARG_WITH(pthread,
+    AC_HELP_STRING([--without-pthread],[do not use pthreads for asynchronous VTK output]))
+
+# store values
+ac_save_LIBS="$LIBS"
+
+with_pthread_found="no"
+HAVE_PTHREAD=0
+if test x$with_pthread != xno ; then
+  AC_LANG_PUSH([C++])
+  AC_CHECK_HEADER([pthread.h],
+    [AC_CHECK_LIB([pthread], [pthread_create],
+      [HAVE_PTHREAD=1])])
+  AC_LANG_POP([C++])
+fi
+
+if test x$HAVE_PTHREAD = x1 ; then
+  PTHREAD_LIBS="-lpthread"
+  AC_DEFINE(HAVE_PTHREAD, 1, [Define to 1 if pthreads are found (used for asynchronous VTK output)])
+
+  # add to global list
+  DUNE_ADD_ALL_PKG([pthread], [], [], [$PTHREAD_LIBS])
+
+  # set variable for summary
+  with_pthread_found="yes"
+else
+  PTHREAD_LIBS=""
+fi
+AC_SUBST(PTHREAD_LIBS, $PTHREAD_LIBS)
+
+# also tell automake
+AM_CONDITIONAL(PTHREAD, test x$HAVE_PTHREAD = x1)
+
+# reset old values
+LIBS="$ac_save_LIBS"
+
+DUNE_ADD_SUMMARY_ENTRY([pthread],[$with_pthread_found])
+
+])
@@ -0,0 +1,62 @@
+## -*- autoconf -*-
+# searches for zlib, which is used for compressed VTK output
+
+# DUNE_PATH_ZLIB()
+#
+# shell variables:
+#   with_zlib
+#     no or yes
+#   ZLIB_LIBS
+#   HAVE_ZLIB
+#     1 or undef
+#
+# substitutions:
+#   ZLIB_LIBS
+#
+# defines:
+#   HAVE_ZLIB
+#
+# conditionals:
+#   ZLIB
+AC_DEFUN([DUNE_PATH_ZLIB],[
+  AC_REQUIRE([AC_PROG_CXX])
+
+  AC_ARG_WITH(zlib,
+    AC_HELP_STRING([--without-zlib],[do not use zlib for compressed VTK output]))
+
+# store values
+ac_save_LIBS="$LIBS"
+
+with_zlib_found="no"
+HAVE_ZLIB=0
+if test x$with_zlib != xno ; then
+  AC_LANG_PUSH([C++])
+  AC_CHECK_HEADER([zlib.h],
+    [AC_CHECK_LIB([z], [compress2],
+      [HAVE_ZLIB=1])])
+  AC_LANG_POP([C++])
+fi
+
+if test x$HAVE_ZLIB = x1 ; then
+  ZLIB_LIBS="-lz"
+  AC_DEFINE(HAVE_ZLIB, 1, [Define to 1 if zlib is found (used for compressed VTK output)])
+
+  # add to global list
+  DUNE_ADD_ALL_PKG([zlib], [], [], [$ZLIB_LIBS])
+
+  # set variable for summary
+  with_zlib_found="yes"
+else
+  ZLIB_LIBS=""
+fi
+AC_SUBST(ZLIB_LIBS, $ZLIB_LIBS)
+
+# also tell automake
+AM_CONDITIONAL(ZLIB, test x$HAVE_ZLIB = x1)
+
+# reset old values
+LIBS="$ac_save_LIBS"
+
+DUNE_ADD_SUMMARY_ENTRY([zlib],[$with_zlib_found])
+
+])